@@ -0,0 +1,175 @@
+#pragma once
+
+#include "symmetric_matrix3x3.h"
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <span>
+
+/*!
+Cholesky factorization S = L*L^T of a symmetric positive definite 3x3 matrix S, templated on the scalar type T,
+see Cholesky3x3 (float) and Cholesky3x3d (double).
+
+Intended for Kalman filter updates: rather than inverting the innovation covariance S and multiplying by the inverse,
+the gain K = P*H^T*S^-1 is `solve_right(P*H^T)`, which is cheaper and more stable.
+The factorization succeeds exactly when S is positive definite, so it also serves as a positive definiteness check.
+The reciprocals of the diagonal of L are stored, so the solves use multiplications rather than divisions.
+The factorization needs three square roots, so for a single solve it is slower than Matrix3x3T::inverse followed by a multiplication,
+LDLT3x3T avoids the square roots and is faster than the inverse.
+*/
+template <typename T>
+class Cholesky3x3T {
+public:
+    Cholesky3x3T() : _l{}, _r{} {}
+    explicit Cholesky3x3T(const SymmetricMatrix3x3T<T>& s) : _l{}, _r{} { (void)factorize(s); }
+    //! Factorize s, returns false if s is not positive definite, in which case the factor is set to zero
+    bool factorize(const SymmetricMatrix3x3T<T>& s) {
+        // s elements are a00, a01, a02, a11, a12, a22, _l elements are l00, l10, l11, l20, l21, l22
+        // the pivots must be positive, NaN fails the comparisons so is also rejected
+        using std::sqrt;
+        const T d0 = s[0];
+        if (d0 > T(0)) {
+            const T l00 = sqrt(d0);
+            const T r0 = T(1) / l00;
+            const T l10 = s[1]*r0;
+            const T l20 = s[2]*r0;
+            const T d1 = s[3] - l10*l10;
+            if (d1 > T(0)) {
+                const T l11 = sqrt(d1);
+                const T r1 = T(1) / l11;
+                const T l21 = (s[4] - l20*l10)*r1;
+                const T d2 = s[5] - l20*l20 - l21*l21;
+                if (d2 > T(0)) {
+                    const T l22 = sqrt(d2);
+                    _l = {{ l00, l10, l11, l20, l21, l22 }};
+                    _r = {{ r0, r1, T(1) / l22 }};
+                    return true;
+                }
+            }
+        }
+        _l.fill(T(0));
+        _r.fill(T(0));
+        return false;
+    }
+    bool is_positive_definite() const { return _r[0] > T(0); } //!< True if the factorized matrix was positive definite
+    Matrix3x3T<T> lower() const { return Matrix3x3T<T>(_l[0], T(0), T(0), _l[1], _l[2], T(0), _l[3], _l[4], _l[5]); } //!< The lower triangular factor L
+
+    //! Returns x, where S*x = b
+    xyz_type<T> solve(const xyz_type<T>& b) const {
+        // forward substitution L*y = b, then back substitution L^T*x = y
+        const T y0 = b.x*_r[0];
+        const T y1 = (b.y - _l[1]*y0)*_r[1];
+        const T y2 = (b.z - _l[3]*y0 - _l[4]*y1)*_r[2];
+        const T x2 = y2*_r[2];
+        const T x1 = (y1 - _l[4]*x2)*_r[1];
+        const T x0 = (y0 - _l[1]*x1 - _l[3]*x2)*_r[0];
+        return xyz_type<T>{ x0, x1, x2 };
+    }
+    void solve_in_place(xyz_type<T>& b) const { b = solve(b); } //!< Overwrites b with x, where S*x = b
+    Matrix3x3T<T> solve(const Matrix3x3T<T>& b) const; //!< Returns X, where S*X = B
+    Matrix3x3T<T> solve_right(const Matrix3x3T<T>& b) const; //!< Returns X, where X*S = B, eg the Kalman gain K = P*H^T*S^-1
+    void solve_in_place(Matrix3x3T<T>& b) const { b = solve(b); } //!< Overwrites B with X, where S*X = B
+    SymmetricMatrix3x3T<T> inverse() const; //!< Returns the inverse of S
+
+    T determinant() const { const T d = _l[0]*_l[2]*_l[5]; return d*d; } //!< Determinant of S
+    //! Natural logarithm of the determinant of S, eg for the Gaussian log-likelihood
+    T log_determinant() const { using std::log; return T(2)*log(_l[0]*_l[2]*_l[5]); }
+
+    //! Factorizes s[i] into out[i], out must have at least s.size() elements, returns false if any s[i] is not positive definite
+    static bool factorize_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<Cholesky3x3T> out);
+    //! Solves s[i]*out[i] = b[i], b and out must have at least s.size() elements, returns false if any s[i] is not positive definite (and sets out[i] to zero)
+    static bool solve_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<const xyz_type<T>> b, std::span<xyz_type<T>> out);
+private:
+    std::array<T, 6> _l; //!< lower triangle of L, in the order l00, l10, l11, l20, l21, l22
+    std::array<T, 3> _r; //!< reciprocals of the diagonal of L, all zero if the matrix is not positive definite
+};
+
+using Cholesky3x3 = Cholesky3x3T<float>;
+using Cholesky3x3d = Cholesky3x3T<double>;
+
+
+/*!
+LDL^T factorization S = L*D*L^T of a symmetric 3x3 matrix S, where L is unit lower triangular and D is diagonal,
+templated on the scalar type T, see LDLT3x3 (float) and LDLT3x3d (double).
+
+Unlike the Cholesky factorization it uses no square roots, and it also factorizes symmetric matrices that are non-singular
+but not positive definite. S is positive definite exactly when all the elements of D are positive.
+*/
+template <typename T>
+class LDLT3x3T {
+public:
+    [[gnu::always_inline]] constexpr LDLT3x3T() : _l{}, _d{}, _r{} {}
+    [[gnu::always_inline]] constexpr explicit LDLT3x3T(const SymmetricMatrix3x3T<T>& s) : _l{}, _d{}, _r{} { (void)factorize(s); }
+    //! Factorize s, returns false if a pivot is zero (ie s is singular), in which case the factor is set to zero
+    [[gnu::always_inline]] constexpr bool factorize(const SymmetricMatrix3x3T<T>& s) {
+        // s elements are a00, a01, a02, a11, a12, a22, _l elements are l10, l20, l21
+        // the pivot checks reject both zero and NaN
+        const T d0 = s[0];
+        if (d0 < T(0) || d0 > T(0)) {
+            const T r0 = T(1) / d0;
+            const T l10 = s[1]*r0;
+            const T l20 = s[2]*r0;
+            const T d1 = s[3] - l10*s[1];
+            if (d1 < T(0) || d1 > T(0)) {
+                const T r1 = T(1) / d1;
+                const T l21 = (s[4] - l20*s[1])*r1;
+                const T d2 = s[5] - l20*s[2] - l21*l21*d1;
+                if (d2 < T(0) || d2 > T(0)) {
+                    _l = {{ l10, l20, l21 }};
+                    _d = {{ d0, d1, d2 }};
+                    _r = {{ r0, r1, T(1) / d2 }};
+                    return true;
+                }
+            }
+        }
+        _l.fill(T(0));
+        _d.fill(T(0));
+        _r.fill(T(0));
+        return false;
+    }
+    [[gnu::always_inline]] constexpr bool is_singular() const { return _d[0] == T(0); } //!< True if the factorization failed
+    [[gnu::always_inline]] constexpr bool is_positive_definite() const { return _d[0] > T(0) && _d[1] > T(0) && _d[2] > T(0); }
+    [[gnu::always_inline]] constexpr Matrix3x3T<T> lower() const { return Matrix3x3T<T>(T(1), T(0), T(0), _l[0], T(1), T(0), _l[1], _l[2], T(1)); } //!< The unit lower triangular factor L
+    [[gnu::always_inline]] constexpr xyz_type<T> diagonal() const { return xyz_type<T>{ _d[0], _d[1], _d[2] }; } //!< The diagonal of D
+
+    //! Returns x, where S*x = b
+    [[gnu::always_inline]] constexpr xyz_type<T> solve(const xyz_type<T>& b) const {
+        // forward substitution L*y = b, then z = D^-1*y, then back substitution L^T*x = z
+        const T y1 = b.y - _l[0]*b.x;
+        const T y2 = b.z - _l[1]*b.x - _l[2]*y1;
+        const T x2 = y2*_r[2];
+        const T x1 = y1*_r[1] - _l[2]*x2;
+        const T x0 = b.x*_r[0] - _l[0]*x1 - _l[1]*x2;
+        return xyz_type<T>{ x0, x1, x2 };
+    }
+    [[gnu::always_inline]] constexpr void solve_in_place(xyz_type<T>& b) const { b = solve(b); } //!< Overwrites b with x, where S*x = b
+    //! Returns X, where S*X = B
+    [[gnu::always_inline]] constexpr Matrix3x3T<T> solve(const Matrix3x3T<T>& b) const {
+        const xyz_type<T> x0 = solve(xyz_type<T>{ b[0], b[3], b[6] });
+        const xyz_type<T> x1 = solve(xyz_type<T>{ b[1], b[4], b[7] });
+        const xyz_type<T> x2 = solve(xyz_type<T>{ b[2], b[5], b[8] });
+        return Matrix3x3T<T>(x0.x, x1.x, x2.x, x0.y, x1.y, x2.y, x0.z, x1.z, x2.z);
+    }
+    //! Returns X, where X*S = B, eg the Kalman gain K = P*H^T*S^-1
+    [[gnu::always_inline]] constexpr Matrix3x3T<T> solve_right(const Matrix3x3T<T>& b) const {
+        return Matrix3x3T<T>(solve(xyz_type<T>{ b[0], b[1], b[2] }), solve(xyz_type<T>{ b[3], b[4], b[5] }), solve(xyz_type<T>{ b[6], b[7], b[8] }));
+    }
+    [[gnu::always_inline]] constexpr void solve_in_place(Matrix3x3T<T>& b) const { b = solve(b); } //!< Overwrites B with X, where S*X = B
+
+    [[gnu::always_inline]] constexpr T determinant() const { return _d[0]*_d[1]*_d[2]; } //!< Determinant of S
+    //! Natural logarithm of the determinant of S, S must be positive definite
+    T log_determinant() const { using std::log; return log(_d[0]*_d[1]*_d[2]); }
+
+    //! Factorizes s[i] into out[i], out must have at least s.size() elements, returns false if any s[i] is singular
+    static bool factorize_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<LDLT3x3T> out);
+    //! Solves s[i]*out[i] = b[i], b and out must have at least s.size() elements, returns false if any s[i] is singular (and sets out[i] to zero)
+    static bool solve_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<const xyz_type<T>> b, std::span<xyz_type<T>> out);
+private:
+    std::array<T, 3> _l; //!< elements of L below the diagonal, in the order l10, l20, l21
+    std::array<T, 3> _d; //!< the diagonal of D, all zero if the matrix is singular
+    std::array<T, 3> _r; //!< reciprocals of the diagonal of D
+};
+
+using LDLT3x3 = LDLT3x3T<float>;
+using LDLT3x3d = LDLT3x3T<double>;
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "matrix2x2.h"
+
+#include <array>
+
+/*!
+Diagonal 2x2 matrix, templated on the scalar type T, see DiagonalMatrix2x2 (float) and DiagonalMatrix2x2d (double).
+
+Only the diagonal is stored, and the operators with Matrix2x2T and xy_type operands use the diagonal kernels.
+This replaces the Matrix2x2T *_assuming_diagonal functions.
+*/
+template <typename T>
+class DiagonalMatrix2x2T {
+public:
+    constexpr DiagonalMatrix2x2T() : _a{} {}
+    constexpr explicit DiagonalMatrix2x2T(T diagonal) : _a{{ diagonal, diagonal }} {}
+    constexpr DiagonalMatrix2x2T(T d0, T d1) : _a{{ d0, d1 }} {}
+    constexpr explicit DiagonalMatrix2x2T(const xy_type<T>& d) : _a{{ d.x, d.y }} {}
+    //! Create from the diagonal of m, the other elements are ignored
+    constexpr explicit DiagonalMatrix2x2T(const Matrix2x2T<T>& m) : _a{{ m[0], m[3] }} {}
+    constexpr Matrix2x2T<T> matrix() const { return Matrix2x2T<T>(_a[0], _a[1]); } //<! Convert to a full matrix
+    constexpr xy_type<T> diagonal() const { return xy_type<T>{ _a[0], _a[1] }; }
+public:
+    // Equality operators
+    constexpr bool operator==(const DiagonalMatrix2x2T& m) const = default;
+
+    // Index operators, these index the diagonal
+    constexpr T operator[](size_t pos) const { return _a[pos]; } //<! Index operator
+    constexpr T& operator[](size_t pos) { return _a[pos]; } //<! Index operator
+
+    // Unary operations
+    constexpr DiagonalMatrix2x2T operator+() const { return *this; } //<! Unary plus
+    constexpr DiagonalMatrix2x2T operator-() const { return DiagonalMatrix2x2T(-_a[0], -_a[1]); } //<! Unary negation
+
+    constexpr DiagonalMatrix2x2T operator*=(T k) { _a[0]*=k; _a[1]*=k; return *this; } //<! Multiplication by a scalar
+    constexpr DiagonalMatrix2x2T operator/=(T k) { const T r = T(1)/k; return operator*=(r); } //<! Division by a scalar
+    constexpr DiagonalMatrix2x2T operator+=(const DiagonalMatrix2x2T& m) { _a[0]+=m[0]; _a[1]+=m[1]; return *this; } //<! Unary addition
+    constexpr DiagonalMatrix2x2T operator-=(const DiagonalMatrix2x2T& m) { _a[0]-=m[0]; _a[1]-=m[1]; return *this; } //<! Unary subtraction
+    constexpr DiagonalMatrix2x2T operator*=(const DiagonalMatrix2x2T& m) { _a[0]*=m[0]; _a[1]*=m[1]; return *this; } //<! Unary multiplication
+
+    // Binary operations
+    constexpr DiagonalMatrix2x2T operator*(T k) const { return DiagonalMatrix2x2T(_a[0]*k, _a[1]*k); } //<! Multiplication by a scalar
+    friend constexpr DiagonalMatrix2x2T operator*(T k, const DiagonalMatrix2x2T& m) { return m*k; } //<! Pre-multiplication by a scalar
+    constexpr DiagonalMatrix2x2T operator/(T k) const { const T r = T(1)/k; return *this*r; } //<! Division by a scalar
+    constexpr DiagonalMatrix2x2T operator+(const DiagonalMatrix2x2T& m) const { return DiagonalMatrix2x2T(_a[0] + m[0], _a[1] + m[1]); } //<! Addition
+    constexpr DiagonalMatrix2x2T operator-(const DiagonalMatrix2x2T& m) const { return DiagonalMatrix2x2T(_a[0] - m[0], _a[1] - m[1]); } //<! Subtraction
+    constexpr DiagonalMatrix2x2T operator*(const DiagonalMatrix2x2T& m) const { return DiagonalMatrix2x2T(_a[0]*m[0], _a[1]*m[1]); } //<! Multiplication
+    constexpr xy_type<T> operator*(const xy_type<T>& v) const { return xy_type<T>{ _a[0]*v.x, _a[1]*v.y }; } //<! Multiplication of a vector
+
+    //! Multiplication of a full matrix, scales the rows of m
+    constexpr Matrix2x2T<T> operator*(const Matrix2x2T<T>& m) const { return Matrix2x2T<T>(_a[0]*m[0], _a[0]*m[1], _a[1]*m[2], _a[1]*m[3]); }
+    //! Post-multiplication of a full matrix, scales the columns of m
+    friend constexpr Matrix2x2T<T> operator*(const Matrix2x2T<T>& m, const DiagonalMatrix2x2T& d) { return Matrix2x2T<T>(m[0]*d[0], m[1]*d[1], m[2]*d[0], m[3]*d[1]); }
+    constexpr Matrix2x2T<T> operator+(const Matrix2x2T<T>& m) const { return m.add_to_diagonal(diagonal()); } //<! Addition of a full matrix
+    friend constexpr Matrix2x2T<T> operator+(const Matrix2x2T<T>& m, const DiagonalMatrix2x2T& d) { return m.add_to_diagonal(d.diagonal()); } //<! Addition to a full matrix
+    constexpr Matrix2x2T<T> operator-(const Matrix2x2T<T>& m) const { return (-m).add_to_diagonal(diagonal()); } //<! Subtraction of a full matrix
+    friend constexpr Matrix2x2T<T> operator-(const Matrix2x2T<T>& m, const DiagonalMatrix2x2T& d) { return m.subtract_from_diagonal(d.diagonal()); } //<! Subtraction from a full matrix
+
+    constexpr void invert_in_place() { _a[0] = T(1) / _a[0]; _a[1] = T(1) / _a[1]; } //<! Invert matrix in-place, the diagonal elements must be non-zero
+    constexpr DiagonalMatrix2x2T inverse() const { return DiagonalMatrix2x2T(T(1) / _a[0], T(1) / _a[1]); } //<! Returns inverse of matrix, the diagonal elements must be non-zero
+
+    constexpr void set_zero() { _a.fill(T(0)); }
+    constexpr void set_to_identity() { _a.fill(T(1)); } //<! Sets matrix to identity matrix
+    constexpr void set_to_scaled_identity(T d) { _a.fill(d); } //<! Sets diagonal of matrix to d
+
+    constexpr T determinant() const { return _a[0]*_a[1]; } //<! Matrix determinant
+    constexpr T trace() const { return _a[0] + _a[1]; }
+protected:
+    std::array<T, 2> _a;
+};
+
+using DiagonalMatrix2x2 = DiagonalMatrix2x2T<float>;
+using DiagonalMatrix2x2d = DiagonalMatrix2x2T<double>;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "matrix3x3.h"
+
+#include <array>
+
+/*!
+Diagonal 3x3 matrix, templated on the scalar type T, see DiagonalMatrix3x3 (float) and DiagonalMatrix3x3d (double).
+
+Intended for scale factor calibrations and noise matrices. Only the diagonal is stored, and the operators with
+Matrix3x3T and xyz_type operands use the diagonal kernels, eg a diagonal matrix times a full matrix scales the rows of
+the full matrix (9 multiplications rather than 27), and the inverse is three reciprocals.
+This replaces the Matrix3x3T *_assuming_diagonal functions, which store and copy all nine elements.
+*/
+template <typename T>
+class DiagonalMatrix3x3T {
+public:
+    constexpr DiagonalMatrix3x3T() : _a{} {}
+    constexpr explicit DiagonalMatrix3x3T(T diagonal) : _a{{ diagonal, diagonal, diagonal }} {}
+    constexpr DiagonalMatrix3x3T(T d0, T d1, T d2) : _a{{ d0, d1, d2 }} {}
+    constexpr explicit DiagonalMatrix3x3T(const xyz_type<T>& d) : _a{{ d.x, d.y, d.z }} {}
+    //! Create from the diagonal of m, the other elements are ignored
+    constexpr explicit DiagonalMatrix3x3T(const Matrix3x3T<T>& m) : _a{{ m[0], m[4], m[8] }} {}
+    constexpr Matrix3x3T<T> matrix() const { return Matrix3x3T<T>(_a[0], _a[1], _a[2]); } //<! Convert to a full matrix
+    constexpr xyz_type<T> diagonal() const { return xyz_type<T>{ _a[0], _a[1], _a[2] }; }
+public:
+    // Equality operators
+    constexpr bool operator==(const DiagonalMatrix3x3T& m) const = default;
+
+    // Index operators, these index the diagonal
+    constexpr T operator[](size_t pos) const { return _a[pos]; } //<! Index operator
+    constexpr T& operator[](size_t pos) { return _a[pos]; } //<! Index operator
+
+    // Unary operations
+    constexpr DiagonalMatrix3x3T operator+() const { return *this; } //<! Unary plus
+    constexpr DiagonalMatrix3x3T operator-() const { return DiagonalMatrix3x3T(-_a[0], -_a[1], -_a[2]); } //<! Unary negation
+
+    constexpr DiagonalMatrix3x3T operator*=(T k) { _a[0]*=k; _a[1]*=k; _a[2]*=k; return *this; } //<! Multiplication by a scalar
+    constexpr DiagonalMatrix3x3T operator/=(T k) { const T r = T(1)/k; return operator*=(r); } //<! Division by a scalar
+    constexpr DiagonalMatrix3x3T operator+=(const DiagonalMatrix3x3T& m) { _a[0]+=m[0]; _a[1]+=m[1]; _a[2]+=m[2]; return *this; } //<! Unary addition
+    constexpr DiagonalMatrix3x3T operator-=(const DiagonalMatrix3x3T& m) { _a[0]-=m[0]; _a[1]-=m[1]; _a[2]-=m[2]; return *this; } //<! Unary subtraction
+    constexpr DiagonalMatrix3x3T operator*=(const DiagonalMatrix3x3T& m) { _a[0]*=m[0]; _a[1]*=m[1]; _a[2]*=m[2]; return *this; } //<! Unary multiplication
+
+    // Binary operations
+    constexpr DiagonalMatrix3x3T operator*(T k) const { return DiagonalMatrix3x3T(_a[0]*k, _a[1]*k, _a[2]*k); } //<! Multiplication by a scalar
+    friend constexpr DiagonalMatrix3x3T operator*(T k, const DiagonalMatrix3x3T& m) { return m*k; } //<! Pre-multiplication by a scalar
+    constexpr DiagonalMatrix3x3T operator/(T k) const { const T r = T(1)/k; return *this*r; } //<! Division by a scalar
+    constexpr DiagonalMatrix3x3T operator+(const DiagonalMatrix3x3T& m) const { return DiagonalMatrix3x3T(_a[0] + m[0], _a[1] + m[1], _a[2] + m[2]); } //<! Addition
+    constexpr DiagonalMatrix3x3T operator-(const DiagonalMatrix3x3T& m) const { return DiagonalMatrix3x3T(_a[0] - m[0], _a[1] - m[1], _a[2] - m[2]); } //<! Subtraction
+    constexpr DiagonalMatrix3x3T operator*(const DiagonalMatrix3x3T& m) const { return DiagonalMatrix3x3T(_a[0]*m[0], _a[1]*m[1], _a[2]*m[2]); } //<! Multiplication
+    constexpr xyz_type<T> operator*(const xyz_type<T>& v) const { return xyz_type<T>{ _a[0]*v.x, _a[1]*v.y, _a[2]*v.z }; } //<! Multiplication of a vector
+
+    //! Multiplication of a full matrix, scales the rows of m
+    constexpr Matrix3x3T<T> operator*(const Matrix3x3T<T>& m) const {
+        return Matrix3x3T<T>(
+            _a[0]*m[0], _a[0]*m[1], _a[0]*m[2],
+            _a[1]*m[3], _a[1]*m[4], _a[1]*m[5],
+            _a[2]*m[6], _a[2]*m[7], _a[2]*m[8]
+        );
+    }
+    //! Post-multiplication of a full matrix, scales the columns of m
+    friend constexpr Matrix3x3T<T> operator*(const Matrix3x3T<T>& m, const DiagonalMatrix3x3T& d) {
+        return Matrix3x3T<T>(
+            m[0]*d[0], m[1]*d[1], m[2]*d[2],
+            m[3]*d[0], m[4]*d[1], m[5]*d[2],
+            m[6]*d[0], m[7]*d[1], m[8]*d[2]
+        );
+    }
+    constexpr Matrix3x3T<T> operator+(const Matrix3x3T<T>& m) const { return m.add_to_diagonal(diagonal()); } //<! Addition of a full matrix
+    friend constexpr Matrix3x3T<T> operator+(const Matrix3x3T<T>& m, const DiagonalMatrix3x3T& d) { return m.add_to_diagonal(d.diagonal()); } //<! Addition to a full matrix
+    constexpr Matrix3x3T<T> operator-(const Matrix3x3T<T>& m) const { return (-m).add_to_diagonal(diagonal()); } //<! Subtraction of a full matrix
+    friend constexpr Matrix3x3T<T> operator-(const Matrix3x3T<T>& m, const DiagonalMatrix3x3T& d) { return m.subtract_from_diagonal(d.diagonal()); } //<! Subtraction from a full matrix
+
+    constexpr void invert_in_place() { _a[0] = T(1) / _a[0]; _a[1] = T(1) / _a[1]; _a[2] = T(1) / _a[2]; } //<! Invert matrix in-place, the diagonal elements must be non-zero
+    constexpr DiagonalMatrix3x3T inverse() const { return DiagonalMatrix3x3T(T(1) / _a[0], T(1) / _a[1], T(1) / _a[2]); } //<! Returns inverse of matrix, the diagonal elements must be non-zero
+
+    constexpr void set_zero() { _a.fill(T(0)); }
+    constexpr void set_to_identity() { _a.fill(T(1)); } //<! Sets matrix to identity matrix
+    constexpr void set_to_scaled_identity(T d) { _a.fill(d); } //<! Sets diagonal of matrix to d
+
+    constexpr T determinant() const { return _a[0]*_a[1]*_a[2]; } //<! Matrix determinant
+    constexpr T trace() const { return _a[0] + _a[1] + _a[2]; }
+protected:
+    std::array<T, 3> _a;
+};
+
+using DiagonalMatrix3x3 = DiagonalMatrix3x3T<float>;
+using DiagonalMatrix3x3d = DiagonalMatrix3x3T<double>;
@@ -0,0 +1,153 @@
+#include "fast_trigonometry.h"
+#include "fast_trigonometry_simd.h"
+#include "simd_float.h"
+
+#include <algorithm>
+
+namespace {
+
+using V = simd_float_t;
+
+// SIMD versions of FastTrigonometry::sin_poly5r and FastTrigonometry::cos_poly6r, using the same operation order
+[[gnu::always_inline]] inline V sin_poly5r_simd(V r, V r2, V c1, V c3, V c5) { return r*(c1 + r2*(c3 + r2*c5)); }
+[[gnu::always_inline]] inline V cos_poly6r_simd(V r2, V c2, V c4, V c6) { return V::broadcast(1.0F) + r2*(c2 + r2*(c4 + r2*c6)); }
+
+} // end namespace
+
+// SIMD versions of FastTrigonometry::atan_poly11r, FastTrigonometry::asin_poly9, and FastTrigonometry::acos_poly4, using the same operation order
+// these are members of FastTrigonometrySimd, which is a friend of FastTrigonometry, since they use the private coefficients
+[[gnu::always_inline]] inline V FastTrigonometrySimd::atan_poly11r(V r)
+{
+    using F = FastTrigonometry;
+    const V r2 = r*r;
+    return r*(V::broadcast(F::ATAN_C1) + r2*(V::broadcast(F::ATAN_C3) + r2*(V::broadcast(F::ATAN_C5) + r2*(V::broadcast(F::ATAN_C7) + r2*(V::broadcast(F::ATAN_C9) + r2*V::broadcast(F::ATAN_C11))))));
+}
+
+[[gnu::always_inline]] inline V FastTrigonometrySimd::asin_poly9(V x)
+{
+    using F = FastTrigonometry;
+    const V x2 = x*x;
+    return x*(V::broadcast(F::ASIN_C1) + x2*(V::broadcast(F::ASIN_C3) + x2*(V::broadcast(F::ASIN_C5) + x2*(V::broadcast(F::ASIN_C7) + x2*V::broadcast(F::ASIN_C9)))));
+}
+
+[[gnu::always_inline]] inline V FastTrigonometrySimd::acos_poly4(V x)
+{
+    using F = FastTrigonometry;
+    return V::broadcast(F::ACOS_C0) + x*(V::broadcast(F::ACOS_C1) + x*(V::broadcast(F::ACOS_C2) + x*(V::broadcast(F::ACOS_C3) + x*V::broadcast(F::ACOS_C4))));
+}
+
+/*!
+Note that the range reduction uses V::round, which rounds halfway cases away from zero (as `roundf` does in the scalar functions),
+and is exact, so the quadrant and remainder r are the same as those calculated by the scalar functions
+(other than where the compiler fuses the multiply and subtract that give r).
+
+The last (partial) block is zero padded and processed by the same SIMD code, so there is no scalar tail loop.
+*/
+void FastTrigonometry::sin_batch(std::span<const float> x, std::span<float> sin)
+{
+    const V two_over_pi = V::broadcast(TWO_OVER_PI);
+    const V c1 = V::broadcast(SIN_C1);
+    const V c3 = V::broadcast(SIN_C3);
+    const V c5 = V::broadcast(SIN_C5);
+    const V c2 = V::broadcast(COS_C2);
+    const V c4 = V::broadcast(COS_C4);
+    const V c6 = V::broadcast(COS_C6);
+
+    for (size_t ii = 0; ii < x.size(); ii += V::WIDTH) {
+        const size_t count = std::min(V::WIDTH, x.size() - ii);
+        const V t = V::load_partial(&x[ii], count) * two_over_pi;
+        const V q = V::round(t);
+        const V r = t - q;
+        const V r2 = r*r;
+        // odd quadrant: use cos, even quadrant: use sin, negate for quadrants 2 and 3
+        const V s = V::select(V::bit_set(q, 1), cos_poly6r_simd(r2, c2, c4, c6), sin_poly5r_simd(r, r2, c1, c3, c5));
+        V::negate_if(V::bit_set(q, 2), s).store_partial(&sin[ii], count);
+    }
+}
+
+void FastTrigonometry::cos_batch(std::span<const float> x, std::span<float> cos)
+{
+    const V two_over_pi = V::broadcast(TWO_OVER_PI);
+    const V c1 = V::broadcast(SIN_C1);
+    const V c3 = V::broadcast(SIN_C3);
+    const V c5 = V::broadcast(SIN_C5);
+    const V c2 = V::broadcast(COS_C2);
+    const V c4 = V::broadcast(COS_C4);
+    const V c6 = V::broadcast(COS_C6);
+
+    for (size_t ii = 0; ii < x.size(); ii += V::WIDTH) {
+        const size_t count = std::min(V::WIDTH, x.size() - ii);
+        const V t = V::load_partial(&x[ii], count) * two_over_pi;
+        const V q = V::round(t);
+        const V r = t - q;
+        const V r2 = r*r;
+        // odd quadrant: use -sin, even quadrant: use cos, negate for quadrants 2 and 3
+        const V c = V::select(V::bit_set(q, 1), -sin_poly5r_simd(r, r2, c1, c3, c5), cos_poly6r_simd(r2, c2, c4, c6));
+        V::negate_if(V::bit_set(q, 2), c).store_partial(&cos[ii], count);
+    }
+}
+
+void FastTrigonometry::sin_cos_batch(std::span<const float> x, std::span<float> sin, std::span<float> cos)
+{
+    const V two_over_pi = V::broadcast(TWO_OVER_PI);
+    const V c1 = V::broadcast(SIN_C1);
+    const V c3 = V::broadcast(SIN_C3);
+    const V c5 = V::broadcast(SIN_C5);
+    const V c2 = V::broadcast(COS_C2);
+    const V c4 = V::broadcast(COS_C4);
+    const V c6 = V::broadcast(COS_C6);
+
+    for (size_t ii = 0; ii < x.size(); ii += V::WIDTH) {
+        const size_t count = std::min(V::WIDTH, x.size() - ii);
+        const V t = V::load_partial(&x[ii], count) * two_over_pi;
+        const V q = V::round(t);
+        const V r = t - q;
+        const V r2 = r*r;
+        const V sb = sin_poly5r_simd(r, r2, c1, c3, c5);
+        const V cb = cos_poly6r_simd(r2, c2, c4, c6);
+        // map values according to quadrant
+        const simd_mask_t odd = V::bit_set(q, 1);
+        const simd_mask_t negate = V::bit_set(q, 2);
+        V::negate_if(negate, V::select(odd, cb, sb)).store_partial(&sin[ii], count);
+        V::negate_if(negate, V::select(odd, -sb, cb)).store_partial(&cos[ii], count);
+    }
+}
+
+/*!
+Uses the same operation order as the scalar function, the range reduction is done using lane selects.
+*/
+simd_float_t FastTrigonometrySimd::atan2(simd_float_t y, simd_float_t x)
+{
+    using F = FastTrigonometry;
+    const V abs_x = V::abs(x);
+    const V abs_y = V::abs(y);
+    const V max = V::max(abs_x, abs_y);
+    // atan2(0, 0) gives 0/0 here, but that lane is replaced by zero below
+    const V r = atan_poly11r(V::min(abs_x, abs_y) / max);
+    const V a = V::select(abs_y > abs_x, V::broadcast(F::HALF_PI) - r, r);
+    const V b = V::select(x < V::zero(), V::broadcast(F::M_PI_F) - a, a);
+    return V::select(max <= V::zero(), V::zero(), V::negate_if(y < V::zero(), b));
+}
+
+simd_float_t FastTrigonometrySimd::asin(simd_float_t x)
+{
+    const V a = V::min(V::abs(x), V::broadcast(1.0F));
+    const V r = V::broadcast(FastTrigonometry::HALF_PI) - V::sqrt(V::broadcast(1.0F) - a)*acos_poly4(a);
+    return V::select(a <= V::broadcast(0.5F), asin_poly9(x), V::negate_if(x < V::zero(), r));
+}
+
+void FastTrigonometry::atan2_batch(std::span<const float> y, std::span<const float> x, std::span<float> atan2)
+{
+    for (size_t ii = 0; ii < x.size(); ii += V::WIDTH) {
+        const size_t count = std::min(V::WIDTH, x.size() - ii);
+        FastTrigonometrySimd::atan2(V::load_partial(&y[ii], count), V::load_partial(&x[ii], count)).store_partial(&atan2[ii], count);
+    }
+}
+
+void FastTrigonometry::asin_batch(std::span<const float> x, std::span<float> asin)
+{
+    for (size_t ii = 0; ii < x.size(); ii += V::WIDTH) {
+        const size_t count = std::min(V::WIDTH, x.size() - ii);
+        FastTrigonometrySimd::asin(V::load_partial(&x[ii], count)).store_partial(&asin[ii], count);
+    }
+}
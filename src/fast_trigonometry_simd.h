@@ -0,0 +1,22 @@
+#pragma once
+
+#include "fast_trigonometry.h"
+#include "simd_float.h"
+
+/*!
+SIMD versions of the FastTrigonometry inverse trigonometric functions, operating on simd_float_t.
+These are kept separate from fast_trigonometry.h, so that including that header (directly, or via quaternion.h) does not pull in
+the SSE/AVX/NEON intrinsics headers.
+*/
+class FastTrigonometrySimd {
+private:
+    // SIMD versions of FastTrigonometry::atan_poly11r, FastTrigonometry::asin_poly9, and FastTrigonometry::acos_poly4, defined in fast_trigonometry.cpp
+    static simd_float_t atan_poly11r(simd_float_t r);
+    static simd_float_t asin_poly9(simd_float_t x);
+    static simd_float_t acos_poly4(simd_float_t x);
+public:
+    //! Branchless version of FastTrigonometry::atan2, the range reduction is done using lane selects
+    static simd_float_t atan2(simd_float_t y, simd_float_t x);
+    //! Branchless version of FastTrigonometry::asin
+    static simd_float_t asin(simd_float_t x);
+};
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "matrix3x3.h"
+
+#include <array>
+#include <concepts>
+#include <type_traits>
+
+/*!
+Opt-in expression templates for xyz_type and Matrix3x3T.
+
+The ordinary operators evaluate each operation into a temporary, so `p1 + x*ex + y*ey + z*ez` creates six intermediate vectors
+and `F*P*F.transpose() + Q` creates four intermediate matrices.
+Wrapping an operand in lazy() makes the operators build an expression instead, which is evaluated in a single pass, element by element,
+when it is converted to xyz_type or Matrix3x3T:
+
+    const xyz_t p = lazy(p1) + x*lazy(ex) + y*lazy(ey) + z*lazy(ez);
+    const Matrix3x3 FPFt = lazy(F)*P*lazy(F).transpose() + Q;
+
+Once one operand of an operator is an expression, the other operand may be a plain vector or matrix.
+
+Sums, differences, negation, scaling, and transposition are evaluated lazily.
+Matrix products are evaluated when the product expression is constructed, directly into the expression's own storage,
+since evaluating them lazily would recalculate each element of the left operand three times.
+Transposed operands of a product are read in place, without making a transposed copy.
+
+Expressions hold copies of their operands, so they may be stored (eg using auto), but they are re-evaluated each time they are converted.
+The arithmetic is done in the same order as the ordinary operators, so the results agree with theirs to within a few ulps, see simd_float.h.
+
+Note that with GCC at -O2 the ordinary operators are fully inlined and their temporaries are already eliminated, so both forms compile to
+the same number of stores, see the lazy expression benchmarks in test_benchmark.
+*/
+
+template <typename A> class xyz_negation_expression;
+template <typename A> class xyz_scaled_expression;
+template <typename A> class matrix3x3_negation_expression;
+template <typename A> class matrix3x3_scaled_expression;
+template <typename A> class matrix3x3_transpose_expression;
+
+/*!
+Base class of vector expressions, E is the derived class, which provides x(), y(), and z().
+*/
+template <typename T, typename E>
+class xyz_expression {
+public:
+    constexpr xyz_type<T> eval() const { const E& e = static_cast<const E&>(*this); return xyz_type<T>{ e.x(), e.y(), e.z() }; } //!< Evaluate the expression
+    constexpr operator xyz_type<T>() const { return eval(); } // NOLINT(google-explicit-constructor,hicpp-explicit-conversions) implicit, so expressions can initialize vectors
+    constexpr xyz_negation_expression<E> operator-() const { return xyz_negation_expression<E>(static_cast<const E&>(*this)); } //<! Unary negation
+    constexpr xyz_scaled_expression<E> operator*(T k) const { return xyz_scaled_expression<E>(static_cast<const E&>(*this), k); } //<! Multiplication by a scalar
+    friend constexpr xyz_scaled_expression<E> operator*(T k, const xyz_expression& e) { return e*k; } //<! Pre-multiplication by a scalar
+    constexpr xyz_scaled_expression<E> operator/(T k) const { return *this*(T(1)/k); } //<! Division by a scalar, uses multiplication by the reciprocal, as xyz_type does
+};
+
+/*!
+Base class of matrix expressions, E is the derived class, which provides operator()(row, column).
+*/
+template <typename T, typename E>
+class matrix3x3_expression {
+public:
+    //! Evaluate the expression, directly into the elements of the matrix, without zero filling it first
+    constexpr Matrix3x3T<T> eval() const {
+        const E& e = static_cast<const E&>(*this);
+        return Matrix3x3T<T>(e(0, 0), e(0, 1), e(0, 2), e(1, 0), e(1, 1), e(1, 2), e(2, 0), e(2, 1), e(2, 2));
+    }
+    constexpr operator Matrix3x3T<T>() const { return eval(); } // NOLINT(google-explicit-constructor,hicpp-explicit-conversions) implicit, so expressions can initialize matrices
+    constexpr matrix3x3_transpose_expression<E> transpose() const { return matrix3x3_transpose_expression<E>(static_cast<const E&>(*this)); } //<! Transpose, without copying
+    constexpr matrix3x3_negation_expression<E> operator-() const { return matrix3x3_negation_expression<E>(static_cast<const E&>(*this)); } //<! Unary negation
+    constexpr matrix3x3_scaled_expression<E> operator*(T k) const { return matrix3x3_scaled_expression<E>(static_cast<const E&>(*this), k); } //<! Multiplication by a scalar
+    friend constexpr matrix3x3_scaled_expression<E> operator*(T k, const matrix3x3_expression& e) { return e*k; } //<! Pre-multiplication by a scalar
+    constexpr matrix3x3_scaled_expression<E> operator/(T k) const { return *this*(T(1)/k); } //<! Division by a scalar, uses multiplication by the reciprocal, as Matrix3x3T does
+};
+
+template <typename E>
+concept is_xyz_expression = requires { typename E::value_type; } && std::derived_from<E, xyz_expression<typename E::value_type, E>>;
+template <typename E>
+concept is_matrix3x3_expression = requires { typename E::value_type; } && std::derived_from<E, matrix3x3_expression<typename E::value_type, E>>;
+
+/*!
+Vector expression leaf, holding a copy of the vector.
+*/
+template <typename T>
+class xyz_leaf_expression : public xyz_expression<T, xyz_leaf_expression<T>> {
+public:
+    using value_type = T;
+    constexpr explicit xyz_leaf_expression(const xyz_type<T>& v) : _v(v) {}
+    constexpr T x() const { return _v.x; }
+    constexpr T y() const { return _v.y; }
+    constexpr T z() const { return _v.z; }
+private:
+    xyz_type<T> _v;
+};
+
+/*!
+Matrix expression leaf, holding a copy of the matrix.
+*/
+template <typename T>
+class matrix3x3_leaf_expression : public matrix3x3_expression<T, matrix3x3_leaf_expression<T>> {
+public:
+    using value_type = T;
+    constexpr explicit matrix3x3_leaf_expression(const Matrix3x3T<T>& m) : _m(m) {}
+    constexpr T operator()(size_t row, size_t column) const { return _m[row*3 + column]; }
+private:
+    Matrix3x3T<T> _m;
+};
+
+//! Start an expression, the operators applied to the result are evaluated lazily
+template <typename T>
+constexpr xyz_leaf_expression<T> lazy(const xyz_type<T>& v) { return xyz_leaf_expression<T>(v); }
+//! Start an expression, the operators applied to the result are evaluated lazily
+template <typename T>
+constexpr matrix3x3_leaf_expression<T> lazy(const Matrix3x3T<T>& m) { return matrix3x3_leaf_expression<T>(m); }
+
+// Operands of the expression operators: expressions are used as they are, plain vectors and matrices are wrapped in a leaf
+template <typename E> requires is_xyz_expression<E>
+constexpr const E& xyz_operand(const E& e) { return e; }
+template <typename T>
+constexpr xyz_leaf_expression<T> xyz_operand(const xyz_type<T>& v) { return xyz_leaf_expression<T>(v); }
+template <typename E> requires is_matrix3x3_expression<E>
+constexpr const E& matrix3x3_operand(const E& e) { return e; }
+template <typename T>
+constexpr matrix3x3_leaf_expression<T> matrix3x3_operand(const Matrix3x3T<T>& m) { return matrix3x3_leaf_expression<T>(m); }
+
+template <typename A>
+using xyz_operand_t = std::remove_cvref_t<decltype(xyz_operand(std::declval<const A&>()))>;
+template <typename A>
+using matrix3x3_operand_t = std::remove_cvref_t<decltype(matrix3x3_operand(std::declval<const A&>()))>;
+
+template <typename A>
+concept is_xyz_operand = requires(const A& a) { xyz_operand(a); };
+template <typename A>
+concept is_matrix3x3_operand = requires(const A& a) { matrix3x3_operand(a); };
+
+template <typename A, typename B>
+class xyz_sum_expression : public xyz_expression<typename A::value_type, xyz_sum_expression<A, B>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr xyz_sum_expression(const A& a, const B& b) : _a(a), _b(b) {}
+    constexpr value_type x() const { return _a.x() + _b.x(); }
+    constexpr value_type y() const { return _a.y() + _b.y(); }
+    constexpr value_type z() const { return _a.z() + _b.z(); }
+private:
+    A _a;
+    B _b;
+};
+
+template <typename A, typename B>
+class xyz_difference_expression : public xyz_expression<typename A::value_type, xyz_difference_expression<A, B>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr xyz_difference_expression(const A& a, const B& b) : _a(a), _b(b) {}
+    constexpr value_type x() const { return _a.x() - _b.x(); }
+    constexpr value_type y() const { return _a.y() - _b.y(); }
+    constexpr value_type z() const { return _a.z() - _b.z(); }
+private:
+    A _a;
+    B _b;
+};
+
+template <typename A>
+class xyz_negation_expression : public xyz_expression<typename A::value_type, xyz_negation_expression<A>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr explicit xyz_negation_expression(const A& a) : _a(a) {}
+    constexpr value_type x() const { return -_a.x(); }
+    constexpr value_type y() const { return -_a.y(); }
+    constexpr value_type z() const { return -_a.z(); }
+private:
+    A _a;
+};
+
+template <typename A>
+class xyz_scaled_expression : public xyz_expression<typename A::value_type, xyz_scaled_expression<A>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr xyz_scaled_expression(const A& a, value_type k) : _a(a), _k(k) {}
+    constexpr value_type x() const { return _a.x()*_k; }
+    constexpr value_type y() const { return _a.y()*_k; }
+    constexpr value_type z() const { return _a.z()*_k; }
+private:
+    A _a;
+    value_type _k;
+};
+
+//! Product of a matrix expression and a vector expression
+template <typename M, typename A>
+class matrix3x3_vector_product_expression : public xyz_expression<typename A::value_type, matrix3x3_vector_product_expression<M, A>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr matrix3x3_vector_product_expression(const M& m, const A& a) : _m(m), _a(a) {}
+    constexpr value_type x() const { return _m(0, 0)*_a.x() + _m(0, 1)*_a.y() + _m(0, 2)*_a.z(); }
+    constexpr value_type y() const { return _m(1, 0)*_a.x() + _m(1, 1)*_a.y() + _m(1, 2)*_a.z(); }
+    constexpr value_type z() const { return _m(2, 0)*_a.x() + _m(2, 1)*_a.y() + _m(2, 2)*_a.z(); }
+private:
+    M _m;
+    A _a;
+};
+
+template <typename A, typename B>
+class matrix3x3_sum_expression : public matrix3x3_expression<typename A::value_type, matrix3x3_sum_expression<A, B>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr matrix3x3_sum_expression(const A& a, const B& b) : _a(a), _b(b) {}
+    constexpr value_type operator()(size_t row, size_t column) const { return _a(row, column) + _b(row, column); }
+private:
+    A _a;
+    B _b;
+};
+
+template <typename A, typename B>
+class matrix3x3_difference_expression : public matrix3x3_expression<typename A::value_type, matrix3x3_difference_expression<A, B>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr matrix3x3_difference_expression(const A& a, const B& b) : _a(a), _b(b) {}
+    constexpr value_type operator()(size_t row, size_t column) const { return _a(row, column) - _b(row, column); }
+private:
+    A _a;
+    B _b;
+};
+
+template <typename A>
+class matrix3x3_negation_expression : public matrix3x3_expression<typename A::value_type, matrix3x3_negation_expression<A>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr explicit matrix3x3_negation_expression(const A& a) : _a(a) {}
+    constexpr value_type operator()(size_t row, size_t column) const { return -_a(row, column); }
+private:
+    A _a;
+};
+
+template <typename A>
+class matrix3x3_scaled_expression : public matrix3x3_expression<typename A::value_type, matrix3x3_scaled_expression<A>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr matrix3x3_scaled_expression(const A& a, value_type k) : _a(a), _k(k) {}
+    constexpr value_type operator()(size_t row, size_t column) const { return _a(row, column)*_k; }
+private:
+    A _a;
+    value_type _k;
+};
+
+template <typename A>
+class matrix3x3_transpose_expression : public matrix3x3_expression<typename A::value_type, matrix3x3_transpose_expression<A>> {
+public:
+    using value_type = typename A::value_type;
+    constexpr explicit matrix3x3_transpose_expression(const A& a) : _a(a) {}
+    constexpr value_type operator()(size_t row, size_t column) const { return _a(column, row); }
+private:
+    A _a;
+};
+
+/*!
+Matrix product, evaluated on construction, see the comment at the top of this file.
+The elements are summed in the same order as Matrix3x3T::operator*.
+*/
+template <typename T>
+class matrix3x3_product_expression : public matrix3x3_expression<T, matrix3x3_product_expression<T>> {
+public:
+    using value_type = T;
+    template <typename A, typename B>
+    constexpr matrix3x3_product_expression(const A& a, const B& b) : _a{{
+        element(a, b, 0, 0), element(a, b, 0, 1), element(a, b, 0, 2),
+        element(a, b, 1, 0), element(a, b, 1, 1), element(a, b, 1, 2),
+        element(a, b, 2, 0), element(a, b, 2, 1), element(a, b, 2, 2)
+    }} {}
+    constexpr T operator()(size_t row, size_t column) const { return _a[row*3 + column]; }
+private:
+    template <typename A, typename B>
+    static constexpr T element(const A& a, const B& b, size_t row, size_t column) { return a(row, 0)*b(0, column) + a(row, 1)*b(1, column) + a(row, 2)*b(2, column); }
+    std::array<T, 9> _a;
+};
+
+// Binary operators, at least one operand must be an expression, so the ordinary operators on plain vectors and matrices are unaffected
+
+template <typename A, typename B> requires is_xyz_operand<A> && is_xyz_operand<B> && (is_xyz_expression<A> || is_xyz_expression<B>)
+constexpr xyz_sum_expression<xyz_operand_t<A>, xyz_operand_t<B>> operator+(const A& a, const B& b) //<! Addition
+{
+    return xyz_sum_expression<xyz_operand_t<A>, xyz_operand_t<B>>(xyz_operand(a), xyz_operand(b));
+}
+
+template <typename A, typename B> requires is_xyz_operand<A> && is_xyz_operand<B> && (is_xyz_expression<A> || is_xyz_expression<B>)
+constexpr xyz_difference_expression<xyz_operand_t<A>, xyz_operand_t<B>> operator-(const A& a, const B& b) //<! Subtraction
+{
+    return xyz_difference_expression<xyz_operand_t<A>, xyz_operand_t<B>>(xyz_operand(a), xyz_operand(b));
+}
+
+template <typename A, typename B> requires is_matrix3x3_operand<A> && is_matrix3x3_operand<B> && (is_matrix3x3_expression<A> || is_matrix3x3_expression<B>)
+constexpr matrix3x3_sum_expression<matrix3x3_operand_t<A>, matrix3x3_operand_t<B>> operator+(const A& a, const B& b) //<! Addition
+{
+    return matrix3x3_sum_expression<matrix3x3_operand_t<A>, matrix3x3_operand_t<B>>(matrix3x3_operand(a), matrix3x3_operand(b));
+}
+
+template <typename A, typename B> requires is_matrix3x3_operand<A> && is_matrix3x3_operand<B> && (is_matrix3x3_expression<A> || is_matrix3x3_expression<B>)
+constexpr matrix3x3_difference_expression<matrix3x3_operand_t<A>, matrix3x3_operand_t<B>> operator-(const A& a, const B& b) //<! Subtraction
+{
+    return matrix3x3_difference_expression<matrix3x3_operand_t<A>, matrix3x3_operand_t<B>>(matrix3x3_operand(a), matrix3x3_operand(b));
+}
+
+template <typename A, typename B> requires is_matrix3x3_operand<A> && is_matrix3x3_operand<B> && (is_matrix3x3_expression<A> || is_matrix3x3_expression<B>)
+constexpr matrix3x3_product_expression<typename matrix3x3_operand_t<A>::value_type> operator*(const A& a, const B& b) //<! Multiplication, evaluated immediately
+{
+    return matrix3x3_product_expression<typename matrix3x3_operand_t<A>::value_type>(matrix3x3_operand(a), matrix3x3_operand(b));
+}
+
+template <typename M, typename A> requires is_matrix3x3_operand<M> && is_xyz_operand<A> && (is_matrix3x3_expression<M> || is_xyz_expression<A>)
+constexpr matrix3x3_vector_product_expression<matrix3x3_operand_t<M>, xyz_operand_t<A>> operator*(const M& m, const A& a) //<! Multiplication of a vector
+{
+    return matrix3x3_vector_product_expression<matrix3x3_operand_t<M>, xyz_operand_t<A>>(matrix3x3_operand(m), xyz_operand(a));
+}
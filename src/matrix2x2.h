@@ -2,39 +2,44 @@
 
 #include "xy_type.h"
 #include <array>
+#include <cmath>
 #include <limits>
 
-class Matrix2x2 {
+/*!
+2x2 matrix, templated on the scalar type T, see Matrix2x2 (float) and Matrix2x2d (double).
+*/
+template <typename T>
+class Matrix2x2T {
 public:
-    Matrix2x2() { _a.fill(0.0F); }
-    explicit Matrix2x2(float diagonal) { _a.fill(0.0F); _a[0] = diagonal; _a[3] = diagonal; }
-    Matrix2x2(float d0, float d1) { _a.fill(0.0F); _a[0] = d0; _a[3] = d1; } //<! Set the matrix diagonal
-    explicit Matrix2x2(const std::array<float, 4>& a) : _a(a) {}
-    explicit Matrix2x2(const float a[4]) : _a({{ a[0], a[1], a[2], a[3] }}) {}
-    Matrix2x2(float a0, float a1, float a2, float a3) : _a({{ a0, a1, a2, a3 }}) {}
-    Matrix2x2(const xy_t& v0, const xy_t& v1) { _a[0] = v0.x; _a[1] = v0.y, _a[2] = v1.x; _a[3] = v1.y; }
+    [[gnu::always_inline]] constexpr Matrix2x2T() : _a{} {}
+    [[gnu::always_inline]] constexpr explicit Matrix2x2T(T diagonal) : _a{{ diagonal, T(0), T(0), diagonal }} {}
+    [[gnu::always_inline]] constexpr Matrix2x2T(T d0, T d1) : _a{{ d0, T(0), T(0), d1 }} {} //<! Set the matrix diagonal
+    [[gnu::always_inline]] constexpr explicit Matrix2x2T(const std::array<T, 4>& a) : _a(a) {}
+    [[gnu::always_inline]] constexpr explicit Matrix2x2T(const T a[4]) : _a({{ a[0], a[1], a[2], a[3] }}) {}
+    [[gnu::always_inline]] constexpr Matrix2x2T(T a0, T a1, T a2, T a3) : _a({{ a0, a1, a2, a3 }}) {}
+    [[gnu::always_inline]] constexpr Matrix2x2T(const xy_type<T>& v0, const xy_type<T>& v1) : _a({{ v0.x, v0.y, v1.x, v1.y }}) {}
 public:
     // Equality operators
-    bool operator!=(const Matrix2x2& m) const { for (size_t ii = 0; ii < _a.size(); ++ii) { if (_a[ii] != m[ii]) {return true;} } return false; } //<! Inequality operator
-    bool operator==(const Matrix2x2& m) const { return !operator!=(m); } //<! Equality operator
+    [[gnu::always_inline]] constexpr bool operator!=(const Matrix2x2T& m) const { for (size_t ii = 0; ii < _a.size(); ++ii) { if (_a[ii] != m[ii]) {return true;} } return false; } //<! Inequality operator
+    [[gnu::always_inline]] constexpr bool operator==(const Matrix2x2T& m) const { return !operator!=(m); } //<! Equality operator
 
     // Index operators
-    float operator[](size_t pos) const { return _a[pos]; } //<! Index operator
-    float& operator[](size_t pos) { return _a[pos]; } //<! Index operator
+    [[gnu::always_inline]] constexpr T operator[](size_t pos) const { return _a[pos]; } //<! Index operator
+    [[gnu::always_inline]] constexpr T& operator[](size_t pos) { return _a[pos]; } //<! Index operator
 
     // Unary operations
-    Matrix2x2 operator+() const { return *this; } //<! Unary plus
-    Matrix2x2 operator-() const { Matrix2x2 m; for (size_t ii = 0; ii < _a.size(); ++ii) {m[ii] = -_a[ii];} return m; } //<! Unary negation
+    [[gnu::always_inline]] constexpr Matrix2x2T operator+() const { return *this; } //<! Unary plus
+    [[gnu::always_inline]] constexpr Matrix2x2T operator-() const { return Matrix2x2T(-_a[0], -_a[1], -_a[2], -_a[3]); } //<! Unary negation
 
     // cppcheck-suppress useStlAlgorithm
-    Matrix2x2 operator*=(float k) { for (float& a : _a) { a*=k; } return *this; } //<! Multiplication by a scalar
-    Matrix2x2 operator/=(float k) { const float r = 1.0F/k; return operator*=(r); } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr Matrix2x2T operator*=(T k) { for (T& a : _a) { a*=k; } return *this; } //<! Multiplication by a scalar
+    [[gnu::always_inline]] constexpr Matrix2x2T operator/=(T k) { const T r = T(1)/k; return operator*=(r); } //<! Division by a scalar
 
-    Matrix2x2 operator+=(const Matrix2x2& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] += m[ii];} return *this; } //<! Unary addition
-    Matrix2x2 operator-=(const Matrix2x2& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] -= m[ii];} return *this; } //<! Unary subtraction
+    [[gnu::always_inline]] constexpr Matrix2x2T operator+=(const Matrix2x2T& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] += m[ii];} return *this; } //<! Unary addition
+    [[gnu::always_inline]] constexpr Matrix2x2T operator-=(const Matrix2x2T& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] -= m[ii];} return *this; } //<! Unary subtraction
     //! Unary multiplication
-    Matrix2x2 operator*=(const Matrix2x2& m) {
-        std::array<float, 4> a {{
+    [[gnu::always_inline]] constexpr Matrix2x2T operator*=(const Matrix2x2T& m) {
+        std::array<T, 4> a {{
             _a[0]*m[0] + _a[1]*m[2],    _a[0]*m[1] + _a[1]*m[3],
             _a[2]*m[0] + _a[3]*m[2],    _a[2]*m[1] + _a[3]*m[3],
         }};
@@ -43,87 +48,103 @@ public:
     }
 
     // Binary operations
-    Matrix2x2 operator*(float k) const { Matrix2x2 m; for (size_t ii = 0; ii < _a.size(); ++ii) { m[ii] = _a[ii]*k; } return m; } //<! Multiplication by a scalar
-    friend Matrix2x2 operator*(float k, const Matrix2x2& m) { return m*k; } //<! Pre-multiplication by a scalar
-    Matrix2x2 operator/(float k) const { const float r = 1.0F/k; return *this*r; } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr Matrix2x2T operator*(T k) const { return Matrix2x2T(_a[0]*k, _a[1]*k, _a[2]*k, _a[3]*k); } //<! Multiplication by a scalar
+    [[gnu::always_inline]] friend constexpr Matrix2x2T operator*(T k, const Matrix2x2T& m) { return m*k; } //<! Pre-multiplication by a scalar
+    [[gnu::always_inline]] constexpr Matrix2x2T operator/(T k) const { const T r = T(1)/k; return *this*r; } //<! Division by a scalar
 
-    xy_t operator*(const xy_t& v) const { return xy_t { _a[0]*v.x + _a[1]*v.y, _a[2]*v.x + _a[3]*v.y }; } //<! Multiplication of a vector
+    [[gnu::always_inline]] constexpr xy_type<T> operator*(const xy_type<T>& v) const { return xy_type<T> { _a[0]*v.x + _a[1]*v.y, _a[2]*v.x + _a[3]*v.y }; } //<! Multiplication of a vector
 
-    Matrix2x2 operator+(const Matrix2x2& m) const { Matrix2x2 ret; for (size_t ii = 0; ii < _a.size(); ++ii) { ret[ii] = _a[ii] + m[ii]; } return ret; } //<! Addition
-    Matrix2x2 operator-(const Matrix2x2& m) const { Matrix2x2 ret; for (size_t ii = 0; ii < _a.size(); ++ii) { ret[ii] = _a[ii] - m[ii]; } return ret; } //<! Subtraction
+    [[gnu::always_inline]] constexpr Matrix2x2T operator+(const Matrix2x2T& m) const { return Matrix2x2T(_a[0] + m[0], _a[1] + m[1], _a[2] + m[2], _a[3] + m[3]); } //<! Addition
+    [[gnu::always_inline]] constexpr Matrix2x2T operator-(const Matrix2x2T& m) const { return Matrix2x2T(_a[0] - m[0], _a[1] - m[1], _a[2] - m[2], _a[3] - m[3]); } //<! Subtraction
     //! Multiplication
-    Matrix2x2 operator*(const Matrix2x2& m) const {
-        return Matrix2x2(
+    [[gnu::always_inline]] constexpr Matrix2x2T operator*(const Matrix2x2T& m) const {
+        return Matrix2x2T(
             _a[0]*m[0] + _a[1]*m[2],    _a[0]*m[1] + _a[1]*m[3],
             _a[2]*m[0] + _a[3]*m[2],    _a[2]*m[1] + _a[3]*m[3]
         );
     }
 
-    void set_zero() { _a.fill(0.0F); }
-    void set_ones() { _a.fill(1.0F); }
-    void set_constant(float value) { _a.fill(value); }
+    [[gnu::always_inline]] constexpr void set_zero() { _a.fill(T(0)); }
+    [[gnu::always_inline]] constexpr void set_ones() { _a.fill(T(1)); }
+    [[gnu::always_inline]] constexpr void set_constant(T value) { _a.fill(value); }
 
-    void set_to_identity() { _a.fill(0.0F); _a[0] = 1.0F; _a[3] = 1.0F; } //<! Sets matrix to identity matrix
-    void set_to_scaled_identity(float d) { _a.fill(0.0F); _a[0] = d; _a[3] = d; } //<! Sets diagonal of matrix to d
+    [[gnu::always_inline]] constexpr void set_to_identity() { _a.fill(T(0)); _a[0] = T(1); _a[3] = T(1); } //<! Sets matrix to identity matrix
+    [[gnu::always_inline]] constexpr void set_to_scaled_identity(T d) { _a.fill(T(0)); _a[0] = d; _a[3] = d; } //<! Sets diagonal of matrix to d
 
-    void set_row(size_t row, const xy_t& value) {
+    [[gnu::always_inline]] constexpr void set_row(size_t row, const xy_type<T>& value) {
         if (row == 0) {
             _a[0] = value.x; _a[1] = value.y;
         } else {
             _a[2] = value.x; _a[3] = value.y;
         }
     }
-    xy_t get_row(size_t row) { return (row == 0) ? xy_t{_a[0],_a[1]} : xy_t{_a[2],_a[3]}; }
-    void set_column(size_t column, const xy_t& value) {
+    [[gnu::always_inline]] constexpr xy_type<T> get_row(size_t row) { return (row == 0) ? xy_type<T>{_a[0],_a[1]} : xy_type<T>{_a[2],_a[3]}; }
+    [[gnu::always_inline]] constexpr void set_column(size_t column, const xy_type<T>& value) {
         if (column == 0) {
             _a[0] = value.x; _a[2] = value.y;
         } else {
             _a[1] = value.x; _a[3] = value.y;
         }
     }
-    xy_t get_column(size_t column) { return (column == 0) ? xy_t{_a[0],_a[2]} : xy_t{_a[1],_a[3]}; }
+    [[gnu::always_inline]] constexpr xy_type<T> get_column(size_t column) { return (column == 0) ? xy_type<T>{_a[0],_a[2]} : xy_type<T>{_a[1],_a[3]}; }
 
-    void add_to_diagonal_in_place(const xy_t& v) { _a[0]+=v.x; _a[3]+=v.y; } //<! Add vector to diagonal of matrix, in-place
-    void subtract_from_diagonal_in_place(const xy_t& v) { _a[0]-=v.x, _a[3]-=v.y; } //<! Subtract vector from diagonal of matrix, in-place
+    [[gnu::always_inline]] constexpr void add_to_diagonal_in_place(const xy_type<T>& v) { _a[0]+=v.x; _a[3]+=v.y; } //<! Add vector to diagonal of matrix, in-place
+    [[gnu::always_inline]] constexpr void subtract_from_diagonal_in_place(const xy_type<T>& v) { _a[0]-=v.x, _a[3]-=v.y; } //<! Subtract vector from diagonal of matrix, in-place
+    // The *_assuming_diagonal functions are retained for compatibility, DiagonalMatrix2x2T stores only the diagonal and should be preferred
     //! Multiply by matrix, in-place, assuming both matrices are diagonal
-     void multiply_assuming_diagonal_in_place(const Matrix2x2& m) { _a[0]*=m[0]; _a[3]*=m[3]; }
+     [[gnu::always_inline]] constexpr void multiply_assuming_diagonal_in_place(const Matrix2x2T& m) { _a[0]*=m[0]; _a[3]*=m[3]; }
 
-    Matrix2x2 add_to_diagonal(const xy_t& v) const { return Matrix2x2 (_a[0]+v.x, _a[1], _a[2], _a[3]+v.y); } //<! Add vector to diagonal of matrix
-    Matrix2x2 subtract_from_diagonal(const xy_t& v) const { return Matrix2x2 (_a[0]-v.x, _a[1], _a[2], _a[3]-v.y); } //<! Subtract vector from diagonal of matrix
+    [[gnu::always_inline]] constexpr Matrix2x2T add_to_diagonal(const xy_type<T>& v) const { return Matrix2x2T (_a[0]+v.x, _a[1], _a[2], _a[3]+v.y); } //<! Add vector to diagonal of matrix
+    [[gnu::always_inline]] constexpr Matrix2x2T subtract_from_diagonal(const xy_type<T>& v) const { return Matrix2x2T (_a[0]-v.x, _a[1], _a[2], _a[3]-v.y); } //<! Subtract vector from diagonal of matrix
     //! Multiply by matrix, assuming both matrices are diagonal
-    Matrix2x2 multiply_assuming_diagonal(const Matrix2x2& m) const { return Matrix2x2 (_a[0]*m[0], 0.0F, 0.0F, _a[3]*m[3]); }
+    [[gnu::always_inline]] constexpr Matrix2x2T multiply_assuming_diagonal(const Matrix2x2T& m) const { return Matrix2x2T (_a[0]*m[0], T(0), T(0), _a[3]*m[3]); }
 
-    void transpose_in_place() { float t = _a[1]; _a[1]= _a[2]; _a[2] = t; } //<! Transposes matrix, in=place
-    Matrix2x2 transpose() const { return Matrix2x2(_a[0], _a[2], _a[1], _a[3]); } //<! Returns transpose of matrix
+    [[gnu::always_inline]] constexpr void transpose_in_place() { T t = _a[1]; _a[1]= _a[2]; _a[2] = t; } //<! Transposes matrix, in=place
+    [[gnu::always_inline]] constexpr Matrix2x2T transpose() const { return Matrix2x2T(_a[0], _a[2], _a[1], _a[3]); } //<! Returns transpose of matrix
 
-    void adjoint_in_place() { float t = _a[0]; _a[0] = _a[3], _a[1]= -_a[1]; _a[2] = -_a[2], _a[3] = t; } //<! Transposes matrix, in=place
-    Matrix2x2 adjoint() const { return Matrix2x2(_a[3], -_a[1], -_a[2], _a[0]); } //<! Returns transpose of matrix
+    [[gnu::always_inline]] constexpr void adjoint_in_place() { T t = _a[0]; _a[0] = _a[3], _a[1]= -_a[1]; _a[2] = -_a[2], _a[3] = t; } //<! Transposes matrix, in=place
+    [[gnu::always_inline]] constexpr Matrix2x2T adjoint() const { return Matrix2x2T(_a[3], -_a[1], -_a[2], _a[0]); } //<! Returns transpose of matrix
 
     //! Invert matrix, in-place
     bool invert_in_place() {
-        const float det = _a[0]*_a[3] -_a[1]*_a[2];
-        if ((fabsf(det) <= std::numeric_limits<float>::epsilon())) {
+        const T det = _a[0]*_a[3] -_a[1]*_a[2];
+        using std::abs;
+        if ((abs(det) <= std::numeric_limits<T>::epsilon())) {
             return false;
         }
-        const float t = _a[0];
+        const T t = _a[0];
         _a[0] = _a[3]/det;
         _a[1] = -_a[1]/det;
         _a[2] = -_a[2]/det;
         _a[3] = t/det;
         return true;
     }
-    Matrix2x2 inverse() const { Matrix2x2 ret = *this; (void)ret.invert_in_place(); return ret; } //<! Returns inverse of matrix
-
-    void invert_in_place_assuming_diagonal() { _a[0] = 1.0F / _a[0]; _a[3] = 1.0F / _a[3]; } //<! Invert matrix in-place, assuming it is a diagonal matrix
-    Matrix2x2 inverse_assuming_diagonal() const { Matrix2x2 ret = *this; ret.invert_in_place_assuming_diagonal(); return ret; } //<! Returns inverse of matrix, assuming it is diagonal
-
-    float determinant() const { return _a[0]*_a[3] -_a[1]*_a[2]; } //<! Matrix determinant
-
-    float sum() const { return _a[0] + _a[1] + _a[2] + _a[3]; }
-    float mean() const { return sum()/4.0F; }
-    float prod() const { return _a[0]*_a[1]*_a[2]*_a[3]; }
-    float trace() const { return _a[0] + _a[3]; }
-    float discriminant() const { const float t = trace(); return t*t - 4.0F*determinant(); }
+    Matrix2x2T inverse() const { Matrix2x2T ret = *this; (void)ret.invert_in_place(); return ret; } //<! Returns inverse of matrix
+
+    [[gnu::always_inline]] constexpr void invert_in_place_assuming_diagonal() { _a[0] = T(1) / _a[0]; _a[3] = T(1) / _a[3]; } //<! Invert matrix in-place, assuming it is a diagonal matrix
+    [[gnu::always_inline]] constexpr Matrix2x2T inverse_assuming_diagonal() const { Matrix2x2T ret = *this; ret.invert_in_place_assuming_diagonal(); return ret; } //<! Returns inverse of matrix, assuming it is diagonal
+
+    [[gnu::always_inline]] constexpr T determinant() const { return _a[0]*_a[3] -_a[1]*_a[2]; } //<! Matrix determinant
+
+    [[gnu::always_inline]] constexpr T sum() const { return _a[0] + _a[1] + _a[2] + _a[3]; }
+    [[gnu::always_inline]] constexpr T mean() const { return sum()/T(4); }
+    [[gnu::always_inline]] constexpr T prod() const { return _a[0]*_a[1]*_a[2]*_a[3]; }
+    [[gnu::always_inline]] constexpr T trace() const { return _a[0] + _a[3]; }
+    [[gnu::always_inline]] constexpr T discriminant() const { const T t = trace(); return t*t - T(4)*determinant(); }
+    //! Eigenvalues, largest first, (trace ± sqrt(discriminant))/2, both NaN if the discriminant is negative (ie the eigenvalues are complex)
+    xy_type<T> eigenvalues() const {
+        const T d = discriminant();
+        if (d < T(0)) {
+            return xy_type<T>{ std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::quiet_NaN() };
+        }
+        using std::sqrt;
+        const T t = trace();
+        const T s = sqrt(d);
+        return xy_type<T>{ (t + s)/T(2), (t - s)/T(2) };
+    }
 protected:
-    std::array<float, 4> _a;
+    std::array<T, 4> _a;
 };
+
+using Matrix2x2 = Matrix2x2T<float>;
+using Matrix2x2d = Matrix2x2T<double>;
@@ -2,56 +2,82 @@
 
 #include "quaternion.h"
 #include <array>
+#include <concepts>
 #include <limits>
+#include <span>
 
-class Matrix3x3 {
+class xyz_soa_t;
+
+/*!
+3x3 matrix, templated on the scalar type T, see Matrix3x3 (float) and Matrix3x3d (double).
+*/
+template <typename T>
+class Matrix3x3T {
 public:
-    Matrix3x3() { _a.fill(0.0F); }
-    explicit Matrix3x3(float diagonal) { _a.fill(0.0F); _a[0] = diagonal; _a[4] = diagonal; _a[8] = diagonal; }
-    Matrix3x3(float d0, float d1, float d2) { _a.fill(0.0F); _a[0] = d0; _a[4] = d1; _a[8] = d2; } //<! Set the matrix diagonal
-    explicit Matrix3x3(const std::array<float, 9>& a) : _a(a) {}
-    explicit Matrix3x3(const float a[9]) : _a({{ a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8] }}) {}
-    Matrix3x3(float a0, float a1, float a2, float a3, float a4, float a5, float a6, float a7, float a8) : _a({{ a0, a1, a2, a3, a4, a5, a6, a7, a8 }}) {}
-    Matrix3x3(const xyz_t& v0, const xyz_t& v1, const xyz_t& v2) {
-        _a[0] = v0.x; _a[1] = v0.y, _a[2] = v0.z;
-        _a[3] = v1.x; _a[4] = v1.y, _a[5] = v1.z;
-        _a[6] = v2.x; _a[7] = v2.y, _a[8] = v2.z;
+    [[gnu::always_inline]] constexpr Matrix3x3T() : _a{} {}
+    [[gnu::always_inline]] constexpr explicit Matrix3x3T(T diagonal) : _a{{ diagonal, T(0), T(0), T(0), diagonal, T(0), T(0), T(0), diagonal }} {}
+    [[gnu::always_inline]] constexpr Matrix3x3T(T d0, T d1, T d2) : _a{{ d0, T(0), T(0), T(0), d1, T(0), T(0), T(0), d2 }} {} //<! Set the matrix diagonal
+    [[gnu::always_inline]] constexpr explicit Matrix3x3T(const std::array<T, 9>& a) : _a(a) {}
+    [[gnu::always_inline]] constexpr explicit Matrix3x3T(const T a[9]) : _a({{ a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8] }}) {}
+    [[gnu::always_inline]] constexpr Matrix3x3T(T a0, T a1, T a2, T a3, T a4, T a5, T a6, T a7, T a8) : _a({{ a0, a1, a2, a3, a4, a5, a6, a7, a8 }}) {}
+    [[gnu::always_inline]] constexpr Matrix3x3T(const xyz_type<T>& v0, const xyz_type<T>& v1, const xyz_type<T>& v2) : _a({{ v0.x, v0.y, v0.z, v1.x, v1.y, v1.z, v2.x, v2.y, v2.z }}) {}
+    //! Create rotation matrix from quaternion,
+    //! see [Quaternion-derived rotation matrix](https://en.wikipedia.org/wiki/Quaternions_and_spatial_rotation#Quaternion-derived_rotation_matrix), uses Hamilton convention
+    [[gnu::always_inline]] constexpr explicit Matrix3x3T(const QuaternionT<T>& q) : _a({{
+        T(1) - T(2)*(q.y*q.y + q.z*q.z),    T(2)*(q.x*q.y - q.w*q.z),           T(2)*(q.w*q.y + q.x*q.z),
+        T(2)*(q.w*q.z + q.x*q.y),           T(1) - T(2)*(q.x*q.x + q.z*q.z),    T(2)*(q.y*q.z - q.w*q.x),
+        T(2)*(q.x*q.z - q.w*q.y),           T(2)*(q.w*q.x + q.y*q.z),           T(1) - T(2)*(q.x*q.x + q.y*q.y)
+    }}) {}
+    static Matrix3x3T from_euler_angles_radians(T roll_radians, T pitch_radians, T yaw_radians);
+    static Matrix3x3T from_euler_angles_degrees(T roll_degrees, T pitch_degrees, T yaw_degrees);
+    //! Compile time versions of from_euler_angles_radians and from_euler_angles_degrees, see QuaternionT::from_euler_angles_radians_constexpr
+    static consteval Matrix3x3T from_euler_angles_radians_constexpr(T roll_radians, T pitch_radians, T yaw_radians) requires std::same_as<T, float> {
+        T sin_phi {};
+        T cos_phi {};
+        FastTrigonometry::sin_cos(roll_radians, sin_phi, cos_phi);
+        T sin_theta {};
+        T cos_theta {};
+        FastTrigonometry::sin_cos(pitch_radians, sin_theta, cos_theta);
+        T sin_psi {};
+        T cos_psi {};
+        FastTrigonometry::sin_cos(yaw_radians, sin_psi, cos_psi);
+        return Matrix3x3T {
+             cos_theta*cos_psi,
+            -cos_phi*sin_psi + sin_phi*sin_theta*cos_psi,
+             sin_phi*sin_psi + cos_phi*sin_theta*cos_psi,
+             cos_theta*sin_psi,
+             cos_phi*cos_psi + sin_phi*sin_theta*sin_psi,
+            -sin_phi*cos_psi + cos_phi*sin_theta*sin_psi,
+            -sin_theta,
+             sin_phi*cos_theta,
+             cos_phi*cos_theta
+        };
     }
-    //! Create rotation matrix from quaternion
-    explicit Matrix3x3(const Quaternion& q) {
-        const float w = q.get_w();
-        const float x = q.get_x();
-        const float y = q.get_y();
-        const float z = q.get_z();
-        // see [Quaternion-derived rotation matrix](https://en.wikipedia.org/wiki/Quaternions_and_spatial_rotation#Quaternion-derived_rotation_matrix), uses Hamilton convention
-        _a[0] = 1.0F - 2.0F*(y*y + z*z);    _a[1] = 2.0F*(x*y - w*z);           _a[2] = 2.0F*(w*y + x*z);
-        _a[3] = 2.0F*(w*z + x*y);           _a[4] = 1.0F - 2.0F*(x*x + z*z);    _a[5] = 2.0F*(y*z - w*x);
-        _a[6] = 2.0F*(x*z - w*y);           _a[7] = 2.0F*(w*x + y*z);           _a[8] = 1.0F - 2.0F*(x*x + y*y);
+    static consteval Matrix3x3T from_euler_angles_degrees_constexpr(T roll_degrees, T pitch_degrees, T yaw_degrees) requires std::same_as<T, float> {
+        return from_euler_angles_radians_constexpr(roll_degrees*QuaternionT<T>::DEGREES_TO_RADIANS, pitch_degrees*QuaternionT<T>::DEGREES_TO_RADIANS, yaw_degrees*QuaternionT<T>::DEGREES_TO_RADIANS);
     }
-    static Matrix3x3 from_euler_angles_radians(float roll_radians, float pitch_radians, float yaw_radians);
-    static Matrix3x3 from_euler_angles_degrees(float roll_degrees, float pitch_degrees, float yaw_degrees);
 public:
     // Equality operators
-    bool operator!=(const Matrix3x3& m) const { for (size_t ii = 0; ii < _a.size(); ++ii) { if (_a[ii] != m[ii]) {return true;} } return false; } //<! Inequality operator
-    bool operator==(const Matrix3x3& m) const { return !operator!=(m); } //<! Equality operator
+    [[gnu::always_inline]] constexpr bool operator!=(const Matrix3x3T& m) const { for (size_t ii = 0; ii < _a.size(); ++ii) { if (_a[ii] != m[ii]) {return true;} } return false; } //<! Inequality operator
+    [[gnu::always_inline]] constexpr bool operator==(const Matrix3x3T& m) const { return !operator!=(m); } //<! Equality operator
 
     // Index operators
-    float operator[](size_t pos) const { return _a[pos]; } //<! Index operator
-    float& operator[](size_t pos) { return _a[pos]; } //<! Index operator
+    [[gnu::always_inline]] constexpr T operator[](size_t pos) const { return _a[pos]; } //<! Index operator
+    [[gnu::always_inline]] constexpr T& operator[](size_t pos) { return _a[pos]; } //<! Index operator
 
     // Unary operations
-    Matrix3x3 operator+() const { return *this; } //<! Unary plus
-    Matrix3x3 operator-() const { Matrix3x3 m; for (size_t ii = 0; ii < _a.size(); ++ii) {m[ii] = -_a[ii];} return m; } //<! Unary negation
+    [[gnu::always_inline]] constexpr Matrix3x3T operator+() const { return *this; } //<! Unary plus
+    [[gnu::always_inline]] constexpr Matrix3x3T operator-() const { return Matrix3x3T(-_a[0], -_a[1], -_a[2], -_a[3], -_a[4], -_a[5], -_a[6], -_a[7], -_a[8]); } //<! Unary negation
 
     // cppcheck-suppress useStlAlgorithm
-    Matrix3x3 operator*=(float k) { for (float& a : _a) { a*=k; } return *this; } //<! Multiplication by a scalar
-    Matrix3x3 operator/=(float k) { const float r = 1.0F/k; return operator*=(r); } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr Matrix3x3T operator*=(T k) { for (T& a : _a) { a*=k; } return *this; } //<! Multiplication by a scalar
+    [[gnu::always_inline]] constexpr Matrix3x3T operator/=(T k) { const T r = T(1)/k; return operator*=(r); } //<! Division by a scalar
 
-    Matrix3x3 operator+=(const Matrix3x3& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] += m[ii];} return *this; } //<! Unary addition
-    Matrix3x3 operator-=(const Matrix3x3& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] -= m[ii];} return *this; } //<! Unary subtraction
+    [[gnu::always_inline]] constexpr Matrix3x3T operator+=(const Matrix3x3T& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] += m[ii];} return *this; } //<! Unary addition
+    [[gnu::always_inline]] constexpr Matrix3x3T operator-=(const Matrix3x3T& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] -= m[ii];} return *this; } //<! Unary subtraction
     //! Unary multiplication
-    Matrix3x3 operator*=(const Matrix3x3& m) {
-        std::array<float, 9> a {{
+    [[gnu::always_inline]] constexpr Matrix3x3T operator*=(const Matrix3x3T& m) {
+        std::array<T, 9> a {{
             _a[0]*m[0] + _a[1]*m[3] + _a[2]*m[6],   _a[0]*m[1] + _a[1]*m[4] + _a[2]*m[7],   _a[0]*m[2] + _a[1]*m[5] + _a[2]*m[8],
             _a[3]*m[0] + _a[4]*m[3] + _a[5]*m[6],   _a[3]*m[1] + _a[4]*m[4] + _a[5]*m[7],   _a[3]*m[2] + _a[4]*m[5] + _a[5]*m[8],
             _a[6]*m[0] + _a[7]*m[3] + _a[8]*m[6],   _a[6]*m[1] + _a[7]*m[4] + _a[8]*m[7],   _a[6]*m[2] + _a[7]*m[5] + _a[8]*m[8]
@@ -61,31 +87,35 @@ public:
     }
 
     // Binary operations
-    Matrix3x3 operator*(float k) const { Matrix3x3 m; for (size_t ii = 0; ii < _a.size(); ++ii) { m[ii] = _a[ii]*k; } return m; } //<! Multiplication by a scalar
-    friend Matrix3x3 operator*(float k, const Matrix3x3& m) { return m*k; } //<! Pre-multiplication by a scalar
-    Matrix3x3 operator/(float k) const { const float r = 1.0F/k; return *this*r; } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr Matrix3x3T operator*(T k) const { return Matrix3x3T(_a[0]*k, _a[1]*k, _a[2]*k, _a[3]*k, _a[4]*k, _a[5]*k, _a[6]*k, _a[7]*k, _a[8]*k); } //<! Multiplication by a scalar
+    [[gnu::always_inline]] friend constexpr Matrix3x3T operator*(T k, const Matrix3x3T& m) { return m*k; } //<! Pre-multiplication by a scalar
+    [[gnu::always_inline]] constexpr Matrix3x3T operator/(T k) const { const T r = T(1)/k; return *this*r; } //<! Division by a scalar
+
+    [[gnu::always_inline]] constexpr xyz_type<T> operator*(const xyz_type<T>& v) const { return xyz_type<T> { _a[0]*v.x + _a[1]*v.y + _a[2]*v.z, _a[3]*v.x + _a[4]*v.y + _a[5]*v.z, _a[6]*v.x + _a[7]*v.y + _a[8]*v.z, }; } //<! Multiplication of a vector
 
-    xyz_t operator*(const xyz_t& v) const { return xyz_t { _a[0]*v.x + _a[1]*v.y + _a[2]*v.z, _a[3]*v.x + _a[4]*v.y + _a[5]*v.z, _a[6]*v.x + _a[7]*v.y + _a[8]*v.z, }; } //<! Multiplication of a vector
+    // Batched multiplication, implemented in matrix3x3_soa.cpp, see matrix3x3_soa_t for batched multiplication of arrays of matrices
+    void multiply(std::span<const xyz_type<T>> v, std::span<xyz_type<T>> out) const requires std::same_as<T, float>; //!< out[i] = (*this)*v[i], out may be the same array as v
+    void multiply(const xyz_soa_t& v, xyz_soa_t& out) const requires std::same_as<T, float>; //!< out[i] = (*this)*v[i]
 
-    Matrix3x3 operator+(const Matrix3x3& m) const { Matrix3x3 ret; for (size_t ii = 0; ii < _a.size(); ++ii) { ret[ii] = _a[ii] + m[ii]; } return ret; } //<! Addition
-    Matrix3x3 operator-(const Matrix3x3& m) const { Matrix3x3 ret; for (size_t ii = 0; ii < _a.size(); ++ii) { ret[ii] = _a[ii] - m[ii]; } return ret; } //<! Subtraction
+    [[gnu::always_inline]] constexpr Matrix3x3T operator+(const Matrix3x3T& m) const { return Matrix3x3T(_a[0] + m[0], _a[1] + m[1], _a[2] + m[2], _a[3] + m[3], _a[4] + m[4], _a[5] + m[5], _a[6] + m[6], _a[7] + m[7], _a[8] + m[8]); } //<! Addition
+    [[gnu::always_inline]] constexpr Matrix3x3T operator-(const Matrix3x3T& m) const { return Matrix3x3T(_a[0] - m[0], _a[1] - m[1], _a[2] - m[2], _a[3] - m[3], _a[4] - m[4], _a[5] - m[5], _a[6] - m[6], _a[7] - m[7], _a[8] - m[8]); } //<! Subtraction
     //! Multiplication
-    Matrix3x3 operator*(const Matrix3x3& m) const {
-        return Matrix3x3 (
+    [[gnu::always_inline]] constexpr Matrix3x3T operator*(const Matrix3x3T& m) const {
+        return Matrix3x3T (
             _a[0]*m[0] + _a[1]*m[3] + _a[2]*m[6],   _a[0]*m[1] + _a[1]*m[4] + _a[2]*m[7],   _a[0]*m[2] + _a[1]*m[5] + _a[2]*m[8],
             _a[3]*m[0] + _a[4]*m[3] + _a[5]*m[6],   _a[3]*m[1] + _a[4]*m[4] + _a[5]*m[7],   _a[3]*m[2] + _a[4]*m[5] + _a[5]*m[8],
             _a[6]*m[0] + _a[7]*m[3] + _a[8]*m[6],   _a[6]*m[1] + _a[7]*m[4] + _a[8]*m[7],   _a[6]*m[2] + _a[7]*m[5] + _a[8]*m[8]
         );
     }
 
-    void set_zero() { _a.fill(0.0F); }
-    void set_ones() { _a.fill(1.0F); }
-    void set_constant(float value) { _a.fill(value); }
+    [[gnu::always_inline]] constexpr void set_zero() { _a.fill(T(0)); }
+    [[gnu::always_inline]] constexpr void set_ones() { _a.fill(T(1)); }
+    [[gnu::always_inline]] constexpr void set_constant(T value) { _a.fill(value); }
 
-    void set_to_identity() { _a.fill(0.0F); _a[0] = 1.0F; _a[4] = 1.0F; _a[8] = 1.0F; } //<! Sets matrix to identity matrix
-    void set_to_scaled_identity(float d) { _a.fill(0.0F); _a[0] = d; _a[4] = d; _a[8] = d; } //<! Sets diagonal of matrix to d
+    [[gnu::always_inline]] constexpr void set_to_identity() { _a.fill(T(0)); _a[0] = T(1); _a[4] = T(1); _a[8] = T(1); } //<! Sets matrix to identity matrix
+    [[gnu::always_inline]] constexpr void set_to_scaled_identity(T d) { _a.fill(T(0)); _a[0] = d; _a[4] = d; _a[8] = d; } //<! Sets diagonal of matrix to d
 
-    void set_row(size_t row, const xyz_t& value) {
+    [[gnu::always_inline]] constexpr void set_row(size_t row, const xyz_type<T>& value) {
         if (row == 0) {
             _a[0] = value.x; _a[1] = value.y; _a[2] = value.z;
         } else if(row == 1) {
@@ -94,8 +124,8 @@ public:
             _a[6] = value.x; _a[7] = value.y; _a[8] = value.z;
         }
     }
-    xyz_t get_row(size_t row) { return (row == 0) ? xyz_t{_a[0],_a[1],_a[2]} : (row == 1) ? xyz_t{_a[3],_a[4],_a[5]} : xyz_t{_a[6],_a[7],_a[8]}; }
-    void set_column(size_t column, const xyz_t& value) {
+    [[gnu::always_inline]] constexpr xyz_type<T> get_row(size_t row) { return (row == 0) ? xyz_type<T>{_a[0],_a[1],_a[2]} : (row == 1) ? xyz_type<T>{_a[3],_a[4],_a[5]} : xyz_type<T>{_a[6],_a[7],_a[8]}; }
+    [[gnu::always_inline]] constexpr void set_column(size_t column, const xyz_type<T>& value) {
         if (column == 0) {
             _a[0] = value.x; _a[3] = value.y; _a[6] = value.z;
         } else if(column == 1) {
@@ -104,35 +134,87 @@ public:
             _a[2] = value.x; _a[5] = value.y; _a[8] = value.z;
         }
     }
-    xyz_t get_column(size_t column) { return (column == 0) ? xyz_t{_a[0],_a[3],_a[6]} : (column == 1) ? xyz_t{_a[1],_a[4],_a[7]} : xyz_t{_a[2],_a[5],_a[8]}; }
+    [[gnu::always_inline]] constexpr xyz_type<T> get_column(size_t column) { return (column == 0) ? xyz_type<T>{_a[0],_a[3],_a[6]} : (column == 1) ? xyz_type<T>{_a[1],_a[4],_a[7]} : xyz_type<T>{_a[2],_a[5],_a[8]}; }
 
-    void add_to_diagonal_in_place(const xyz_t& v) { _a[0]+=v.x; _a[4]+=v.y; _a[8]+=v.z; } //<! Add vector to diagonal of matrix, in-place
-    void subtract_from_diagonal_in_place(const xyz_t& v) { _a[0]-=v.x, _a[4]-=v.y; _a[8]-=v.z; } //<! Subtract vector from diagonal of matrix, in-place
+    [[gnu::always_inline]] constexpr void add_to_diagonal_in_place(const xyz_type<T>& v) { _a[0]+=v.x; _a[4]+=v.y; _a[8]+=v.z; } //<! Add vector to diagonal of matrix, in-place
+    [[gnu::always_inline]] constexpr void subtract_from_diagonal_in_place(const xyz_type<T>& v) { _a[0]-=v.x, _a[4]-=v.y; _a[8]-=v.z; } //<! Subtract vector from diagonal of matrix, in-place
+    // The *_assuming_diagonal functions are retained for compatibility, DiagonalMatrix3x3T stores only the diagonal and should be preferred
     //! Multiply by matrix, in-place, assuming both matrices are diagonal
-     void multiply_assuming_diagonal_in_place(const Matrix3x3& m) { _a[0]*=m[0]; _a[4]*=m[4]; _a[8]*=m[8]; }
+     [[gnu::always_inline]] constexpr void multiply_assuming_diagonal_in_place(const Matrix3x3T& m) { _a[0]*=m[0]; _a[4]*=m[4]; _a[8]*=m[8]; }
 
-    Matrix3x3 add_to_diagonal(const xyz_t& v) const { return Matrix3x3 (_a[0]+v.x, _a[1], _a[2], _a[3], _a[4]+v.y, _a[5], _a[6], _a[7], _a[8]+v.z); } //<! Add vector to diagonal of matrix
-    Matrix3x3 subtract_from_diagonal(const xyz_t& v) const { return Matrix3x3 (_a[0]-v.x, _a[1], _a[2], _a[3], _a[4]-v.y, _a[5], _a[6], _a[7], _a[8]-v.z); } //<! Subtract vector from diagonal of matrix
+    [[gnu::always_inline]] constexpr Matrix3x3T add_to_diagonal(const xyz_type<T>& v) const { return Matrix3x3T (_a[0]+v.x, _a[1], _a[2], _a[3], _a[4]+v.y, _a[5], _a[6], _a[7], _a[8]+v.z); } //<! Add vector to diagonal of matrix
+    [[gnu::always_inline]] constexpr Matrix3x3T subtract_from_diagonal(const xyz_type<T>& v) const { return Matrix3x3T (_a[0]-v.x, _a[1], _a[2], _a[3], _a[4]-v.y, _a[5], _a[6], _a[7], _a[8]-v.z); } //<! Subtract vector from diagonal of matrix
     //! Multiply by matrix, assuming both matrices are diagonal
-    Matrix3x3 multiply_assuming_diagonal(const Matrix3x3& m) const { return Matrix3x3 (_a[0]*m[0], 0.0F, 0.0F, 0.0F, _a[4]*m[4], 0.0F, 0.0F, 0.0F, _a[8]*m[8]); }
+    [[gnu::always_inline]] constexpr Matrix3x3T multiply_assuming_diagonal(const Matrix3x3T& m) const { return Matrix3x3T (_a[0]*m[0], T(0), T(0), T(0), _a[4]*m[4], T(0), T(0), T(0), _a[8]*m[8]); }
+
+    // Fused kernels, without the intermediate matrices of the equivalent expressions, they use the same operation order as those expressions
+    // (on and above the diagonal, in the case of the congruence transforms), so agree with them to within a few ulps, see simd_float.h
+    //! Multiply by the transpose of m, that is return (*this)*m.transpose()
+    [[gnu::always_inline]] constexpr Matrix3x3T multiply_transpose(const Matrix3x3T& m) const {
+        return Matrix3x3T (
+            _a[0]*m[0] + _a[1]*m[1] + _a[2]*m[2],   _a[0]*m[3] + _a[1]*m[4] + _a[2]*m[5],   _a[0]*m[6] + _a[1]*m[7] + _a[2]*m[8],
+            _a[3]*m[0] + _a[4]*m[1] + _a[5]*m[2],   _a[3]*m[3] + _a[4]*m[4] + _a[5]*m[5],   _a[3]*m[6] + _a[4]*m[7] + _a[5]*m[8],
+            _a[6]*m[0] + _a[7]*m[1] + _a[8]*m[2],   _a[6]*m[3] + _a[7]*m[4] + _a[8]*m[5],   _a[6]*m[6] + _a[7]*m[7] + _a[8]*m[8]
+        );
+    }
+    //! Multiply the transpose of this matrix by m, that is return transpose()*m
+    [[gnu::always_inline]] constexpr Matrix3x3T transpose_multiply(const Matrix3x3T& m) const {
+        return Matrix3x3T (
+            _a[0]*m[0] + _a[3]*m[3] + _a[6]*m[6],   _a[0]*m[1] + _a[3]*m[4] + _a[6]*m[7],   _a[0]*m[2] + _a[3]*m[5] + _a[6]*m[8],
+            _a[1]*m[0] + _a[4]*m[3] + _a[7]*m[6],   _a[1]*m[1] + _a[4]*m[4] + _a[7]*m[7],   _a[1]*m[2] + _a[4]*m[5] + _a[7]*m[8],
+            _a[2]*m[0] + _a[5]*m[3] + _a[8]*m[6],   _a[2]*m[1] + _a[5]*m[4] + _a[8]*m[7],   _a[2]*m[2] + _a[5]*m[5] + _a[8]*m[8]
+        );
+    }
+    //! Multiply by m and add c, that is return (*this)*m + c
+    [[gnu::always_inline]] constexpr Matrix3x3T multiply_add(const Matrix3x3T& m, const Matrix3x3T& c) const {
+        return Matrix3x3T (
+            _a[0]*m[0] + _a[1]*m[3] + _a[2]*m[6] + c[0],   _a[0]*m[1] + _a[1]*m[4] + _a[2]*m[7] + c[1],   _a[0]*m[2] + _a[1]*m[5] + _a[2]*m[8] + c[2],
+            _a[3]*m[0] + _a[4]*m[3] + _a[5]*m[6] + c[3],   _a[3]*m[1] + _a[4]*m[4] + _a[5]*m[7] + c[4],   _a[3]*m[2] + _a[4]*m[5] + _a[5]*m[8] + c[5],
+            _a[6]*m[0] + _a[7]*m[3] + _a[8]*m[6] + c[6],   _a[6]*m[1] + _a[7]*m[4] + _a[8]*m[7] + c[7],   _a[6]*m[2] + _a[7]*m[5] + _a[8]*m[8] + c[8]
+        );
+    }
+    //! Congruence transform of the symmetric matrix p, that is return (*this)*p*transpose(), eg for covariance propagation.
+    //! Only the six elements on and above the diagonal are calculated (using 45 rather than 54 multiplications),
+    //! the elements below the diagonal are copies of them, so the result is exactly symmetric.
+    [[gnu::always_inline]] constexpr Matrix3x3T congruence(const Matrix3x3T& p) const {
+        const Matrix3x3T fp = *this*p;
+        const T a00 = fp[0]*_a[0] + fp[1]*_a[1] + fp[2]*_a[2];
+        const T a01 = fp[0]*_a[3] + fp[1]*_a[4] + fp[2]*_a[5];
+        const T a02 = fp[0]*_a[6] + fp[1]*_a[7] + fp[2]*_a[8];
+        const T a11 = fp[3]*_a[3] + fp[4]*_a[4] + fp[5]*_a[5];
+        const T a12 = fp[3]*_a[6] + fp[4]*_a[7] + fp[5]*_a[8];
+        const T a22 = fp[6]*_a[6] + fp[7]*_a[7] + fp[8]*_a[8];
+        return Matrix3x3T(a00, a01, a02, a01, a11, a12, a02, a12, a22);
+    }
+    //! Congruence transform of the symmetric matrix p, plus the symmetric matrix q, that is return (*this)*p*transpose() + q, eg for the EKF covariance prediction
+    [[gnu::always_inline]] constexpr Matrix3x3T congruence_add(const Matrix3x3T& p, const Matrix3x3T& q) const {
+        const Matrix3x3T fp = *this*p;
+        const T a00 = fp[0]*_a[0] + fp[1]*_a[1] + fp[2]*_a[2] + q[0];
+        const T a01 = fp[0]*_a[3] + fp[1]*_a[4] + fp[2]*_a[5] + q[1];
+        const T a02 = fp[0]*_a[6] + fp[1]*_a[7] + fp[2]*_a[8] + q[2];
+        const T a11 = fp[3]*_a[3] + fp[4]*_a[4] + fp[5]*_a[5] + q[4];
+        const T a12 = fp[3]*_a[6] + fp[4]*_a[7] + fp[5]*_a[8] + q[5];
+        const T a22 = fp[6]*_a[6] + fp[7]*_a[7] + fp[8]*_a[8] + q[8];
+        return Matrix3x3T(a00, a01, a02, a01, a11, a12, a02, a12, a22);
+    }
 
-    void transpose_in_place() { float t = _a[1]; _a[1]= _a[3]; _a[3] = t; t = _a[2]; _a[2]= _a[6]; _a[6] = t; t = _a[5]; _a[5]= _a[7]; _a[7] = t; } //<! Transposes matrix, in=place
-    Matrix3x3 transpose() const { return Matrix3x3(_a[0], _a[3], _a[6], _a[1], _a[4], _a[7], _a[2], _a[5], _a[8]); } //<! Returns transpose of matrix
+    [[gnu::always_inline]] constexpr void transpose_in_place() { T t = _a[1]; _a[1]= _a[3]; _a[3] = t; t = _a[2]; _a[2]= _a[6]; _a[6] = t; t = _a[5]; _a[5]= _a[7]; _a[7] = t; } //<! Transposes matrix, in=place
+    [[gnu::always_inline]] constexpr Matrix3x3T transpose() const { return Matrix3x3T(_a[0], _a[3], _a[6], _a[1], _a[4], _a[7], _a[2], _a[5], _a[8]); } //<! Returns transpose of matrix
 
     //! Invert matrix, in-place
-    void adjoint_in_place() {
+    [[gnu::always_inline]] constexpr void adjoint_in_place() {
         // a b c
         // d e f
         // g h i
-        const float A =   _a[4]*_a[8] - _a[5]*_a[7];  //  (e*i - f*h)
-        const float B = -(_a[3]*_a[8] - _a[5]*_a[6]); // -(d*i - f*g)
-        const float C =   _a[3]*_a[7] - _a[4]*_a[6];  //  (d*h - e*g)
-        const float D = -(_a[1]*_a[8] - _a[2]*_a[7]); // -(b*i - c*h)
-        const float E =   _a[0]*_a[8] - _a[2]*_a[6];  //  (a*i - c*g)
-        const float F = -(_a[0]*_a[7] - _a[1]*_a[6]); // -(a*h - b*g)
-        const float G =   _a[1]*_a[5] - _a[2]*_a[4];  //  (b*f - c*e)
-        const float H = -(_a[0]*_a[5] - _a[2]*_a[3]); // -(a*f - c*d)
-        const float I =   _a[0]*_a[4] - _a[1]*_a[3];  //  (a*e - b*d)
+        const T A =   _a[4]*_a[8] - _a[5]*_a[7];  //  (e*i - f*h)
+        const T B = -(_a[3]*_a[8] - _a[5]*_a[6]); // -(d*i - f*g)
+        const T C =   _a[3]*_a[7] - _a[4]*_a[6];  //  (d*h - e*g)
+        const T D = -(_a[1]*_a[8] - _a[2]*_a[7]); // -(b*i - c*h)
+        const T E =   _a[0]*_a[8] - _a[2]*_a[6];  //  (a*i - c*g)
+        const T F = -(_a[0]*_a[7] - _a[1]*_a[6]); // -(a*h - b*g)
+        const T G =   _a[1]*_a[5] - _a[2]*_a[4];  //  (b*f - c*e)
+        const T H = -(_a[0]*_a[5] - _a[2]*_a[3]); // -(a*f - c*d)
+        const T I =   _a[0]*_a[4] - _a[1]*_a[3];  //  (a*e - b*d)
 
         // A D G
         // B E H
@@ -141,51 +223,57 @@ public:
         _a[3] = B;  _a[4] = E;  _a[5] = H;
         _a[6] = C;  _a[7] = F;  _a[8] = I;
     }
-    Matrix3x3 adjoint() const { Matrix3x3 ret = *this; (void)ret.adjoint_in_place(); return ret; } //<! Returns adjoint of matrix
+    [[gnu::always_inline]] constexpr Matrix3x3T adjoint() const { Matrix3x3T ret = *this; (void)ret.adjoint_in_place(); return ret; } //<! Returns adjoint of matrix
 
     //! Invert matrix, in-place
     bool invert_in_place() {
         // a b c
         // d e f
         // g h i
-        const float A =   _a[4]*_a[8] - _a[5]*_a[7];  //  (e*i - f*h)
-        const float B = -(_a[3]*_a[8] - _a[5]*_a[6]); // -(d*i - f*g)
-        const float C =   _a[3]*_a[7] - _a[4]*_a[6];  //  (d*h - e*g)
-        const float D = -(_a[1]*_a[8] - _a[2]*_a[7]); // -(b*i - c*h)
-        const float E =   _a[0]*_a[8] - _a[2]*_a[6];  //  (a*i - c*g)
-        const float F = -(_a[0]*_a[7] - _a[1]*_a[6]); // -(a*h - b*g)
-        const float G =   _a[1]*_a[5] - _a[2]*_a[4];  //  (b*f - c*e)
-        const float H = -(_a[0]*_a[5] - _a[2]*_a[3]); // -(a*f - c*d)
-        const float I =   _a[0]*_a[4] - _a[1]*_a[3];  //  (a*e - b*d)
-
-        const float det = _a[0]*A + _a[1]*B + _a[2]*C; // a*A + b*B + c*C;
-
-        if ((fabsf(det) <= std::numeric_limits<float>::epsilon())) {
+        const T A =   _a[4]*_a[8] - _a[5]*_a[7];  //  (e*i - f*h)
+        const T B = -(_a[3]*_a[8] - _a[5]*_a[6]); // -(d*i - f*g)
+        const T C =   _a[3]*_a[7] - _a[4]*_a[6];  //  (d*h - e*g)
+        const T D = -(_a[1]*_a[8] - _a[2]*_a[7]); // -(b*i - c*h)
+        const T E =   _a[0]*_a[8] - _a[2]*_a[6];  //  (a*i - c*g)
+        const T F = -(_a[0]*_a[7] - _a[1]*_a[6]); // -(a*h - b*g)
+        const T G =   _a[1]*_a[5] - _a[2]*_a[4];  //  (b*f - c*e)
+        const T H = -(_a[0]*_a[5] - _a[2]*_a[3]); // -(a*f - c*d)
+        const T I =   _a[0]*_a[4] - _a[1]*_a[3];  //  (a*e - b*d)
+
+        const T det = _a[0]*A + _a[1]*B + _a[2]*C; // a*A + b*B + c*C;
+
+        using std::abs;
+        if ((abs(det) <= std::numeric_limits<T>::epsilon())) {
             return false;
         }
 
+        // multiply by the reciprocal of det, rather than doing nine divisions, as matrix3x3_soa_t::inverse does, so the results agree to within a few ulps
+        const T r = T(1) / det;
         // A D G
         // B E H
         // C F I
-        _a[0] = A/det;  _a[1] = D/det;  _a[2] = G/det;
-        _a[3] = B/det;  _a[4] = E/det;  _a[5] = H/det;
-        _a[6] = C/det;  _a[7] = F/det;  _a[8] = I/det;
+        _a[0] = A*r;  _a[1] = D*r;  _a[2] = G*r;
+        _a[3] = B*r;  _a[4] = E*r;  _a[5] = H*r;
+        _a[6] = C*r;  _a[7] = F*r;  _a[8] = I*r;
 
         return true;
     }
-    Matrix3x3 inverse() const { Matrix3x3 ret = *this; (void)ret.invert_in_place(); return ret; } //<! Returns inverse of matrix
+    Matrix3x3T inverse() const { Matrix3x3T ret = *this; (void)ret.invert_in_place(); return ret; } //<! Returns inverse of matrix
 
-    void invert_in_place_assuming_diagonal() { _a[0] = 1.0F / _a[0]; _a[4] = 1.0F / _a[4]; _a[8] = 1.0F / _a[8]; } //<! Invert matrix in-place, assuming it is a diagonal matrix
-    Matrix3x3 inverse_assuming_diagonal() const { Matrix3x3 ret = *this; ret.invert_in_place_assuming_diagonal(); return ret; } //<! Returns inverse of matrix, assuming it is diagonal
+    [[gnu::always_inline]] constexpr void invert_in_place_assuming_diagonal() { _a[0] = T(1) / _a[0]; _a[4] = T(1) / _a[4]; _a[8] = T(1) / _a[8]; } //<! Invert matrix in-place, assuming it is a diagonal matrix
+    [[gnu::always_inline]] constexpr Matrix3x3T inverse_assuming_diagonal() const { Matrix3x3T ret = *this; ret.invert_in_place_assuming_diagonal(); return ret; } //<! Returns inverse of matrix, assuming it is diagonal
 
-    float determinant() const { return _a[0]*(_a[4]*_a[8] - _a[5]*_a[7]) - _a[1]*(_a[3]*_a[8] - _a[5]*_a[6]) + _a[2]*(_a[3]*_a[7] - _a[4]*_a[6]); } //<! Matrix determinant
+    [[gnu::always_inline]] constexpr T determinant() const { return _a[0]*(_a[4]*_a[8] - _a[5]*_a[7]) - _a[1]*(_a[3]*_a[8] - _a[5]*_a[6]) + _a[2]*(_a[3]*_a[7] - _a[4]*_a[6]); } //<! Matrix determinant
 
-    float sum() const { return _a[0] + _a[1] + _a[2] + _a[3] + _a[4] + _a[5] + _a[6] + _a[7] + _a[8]; }
-    float mean() const { return sum()/9.0F; }
-    float prod() const { return _a[0]*_a[1]*_a[2]*_a[3]*_a[4]*_a[5]*_a[6]*_a[7]*_a[8]; }
-    float trace() const { return _a[0] + _a[4] + _a[8]; }
+    [[gnu::always_inline]] constexpr T sum() const { return _a[0] + _a[1] + _a[2] + _a[3] + _a[4] + _a[5] + _a[6] + _a[7] + _a[8]; }
+    [[gnu::always_inline]] constexpr T mean() const { return sum()/T(9); }
+    [[gnu::always_inline]] constexpr T prod() const { return _a[0]*_a[1]*_a[2]*_a[3]*_a[4]*_a[5]*_a[6]*_a[7]*_a[8]; }
+    [[gnu::always_inline]] constexpr T trace() const { return _a[0] + _a[4] + _a[8]; }
 
-    Quaternion quaternion() const;
+    QuaternionT<T> quaternion() const;
 protected:
-    std::array<float, 9> _a;
+    std::array<T, 9> _a;
 };
+
+using Matrix3x3 = Matrix3x3T<float>;
+using Matrix3x3d = Matrix3x3T<double>;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "matrix3x3.h"
+#include "xyzw_type.h"
+
+
+/*!
+3x3 matrix stored as three padded columns, each held in a single 128-bit register, see xyzw_t.
+
+Storing columns, rather than rows, means the product of a matrix and a vector is
+column0*v.x + column1*v.y + column2*v.z, that is three broadcast multiply-adds with no horizontal additions,
+and the products of two matrices is three matrix-vector products.
+The terms are added in the same order as in Matrix3x3, so the results agree with those of Matrix3x3 to within a few ulps, see simd_float.h.
+*/
+class Matrix3x3Simd {
+public:
+    Matrix3x3Simd() : _c{{ simd_float4_t::zero(), simd_float4_t::zero(), simd_float4_t::zero() }} {}
+    explicit Matrix3x3Simd(const Matrix3x3& m) : _c{{
+        simd_float4_t::set(m[0], m[3], m[6], 0.0F),
+        simd_float4_t::set(m[1], m[4], m[7], 0.0F),
+        simd_float4_t::set(m[2], m[5], m[8], 0.0F)
+    }} {}
+    //! Construct from columns
+    Matrix3x3Simd(const xyzw_t& c0, const xyzw_t& c1, const xyzw_t& c2) : _c{{ c0.get_xyzw(), c1.get_xyzw(), c2.get_xyzw() }} {}
+    //! Conversion to Matrix3x3
+    Matrix3x3 matrix() const {
+        const xyz_t c0 = column(0).xyz();
+        const xyz_t c1 = column(1).xyz();
+        const xyz_t c2 = column(2).xyz();
+        return Matrix3x3(c0.x, c1.x, c2.x, c0.y, c1.y, c2.y, c0.z, c1.z, c2.z);
+    }
+    xyzw_t column(size_t index) const { return xyzw_t(_c[index]); }
+    void set_to_identity() { _c = {{ simd_float4_t::set(1.0F, 0.0F, 0.0F, 0.0F), simd_float4_t::set(0.0F, 1.0F, 0.0F, 0.0F), simd_float4_t::set(0.0F, 0.0F, 1.0F, 0.0F) }}; }
+public:
+    // Equality operators
+    bool operator==(const Matrix3x3Simd& m) const { return column(0) == m.column(0) && column(1) == m.column(1) && column(2) == m.column(2); } //<! Equality operator
+    bool operator!=(const Matrix3x3Simd& m) const { return !operator==(m); } //<! Inequality operator
+
+    // Unary operations
+    Matrix3x3Simd operator+() const { return *this; } //<! Unary plus
+    Matrix3x3Simd operator-() const { return Matrix3x3Simd(-column(0), -column(1), -column(2)); } //<! Unary negation
+
+    Matrix3x3Simd operator+=(const Matrix3x3Simd& m) { *this = *this + m; return *this; } //<! Unary addition
+    Matrix3x3Simd operator-=(const Matrix3x3Simd& m) { *this = *this - m; return *this; } //<! Unary subtraction
+    Matrix3x3Simd operator*=(float k) { *this = *this*k; return *this; } //<! Multiplication by a scalar
+    Matrix3x3Simd operator*=(const Matrix3x3Simd& m) { *this = *this*m; return *this; } //<! Unary multiplication
+
+    // Binary operations
+    Matrix3x3Simd operator+(const Matrix3x3Simd& m) const { return Matrix3x3Simd(column(0) + m.column(0), column(1) + m.column(1), column(2) + m.column(2)); } //<! Addition
+    Matrix3x3Simd operator-(const Matrix3x3Simd& m) const { return Matrix3x3Simd(column(0) - m.column(0), column(1) - m.column(1), column(2) - m.column(2)); } //<! Subtraction
+    Matrix3x3Simd operator*(float k) const { return Matrix3x3Simd(column(0)*k, column(1)*k, column(2)*k); } //<! Multiplication by a scalar
+    friend Matrix3x3Simd operator*(float k, const Matrix3x3Simd& m) { return m*k; } //<! Pre-multiplication by a scalar
+    //! Multiplication of a vector, column0*v.x + column1*v.y + column2*v.z
+    xyzw_t operator*(const xyzw_t& v) const {
+        const simd_float4_t a = v.get_xyzw();
+        return xyzw_t(_c[0]*a.broadcast_lane<0>() + _c[1]*a.broadcast_lane<1>() + _c[2]*a.broadcast_lane<2>());
+    }
+    xyz_t operator*(const xyz_t& v) const { return (*this*xyzw_t(v)).xyz(); } //<! Multiplication of a vector
+    //! Multiplication, column j of the product is the product of this and column j of m
+    Matrix3x3Simd operator*(const Matrix3x3Simd& m) const { return Matrix3x3Simd(*this*m.column(0), *this*m.column(1), *this*m.column(2)); }
+
+    Matrix3x3Simd transpose() const {
+        const xyzw_t c0 = column(0);
+        const xyzw_t c1 = column(1);
+        const xyzw_t c2 = column(2);
+        return Matrix3x3Simd(xyzw_t(c0.get_x(), c1.get_x(), c2.get_x()), xyzw_t(c0.get_y(), c1.get_y(), c2.get_y()), xyzw_t(c0.get_z(), c1.get_z(), c2.get_z()));
+    }
+private:
+    std::array<simd_float4_t, 3> _c; //!< columns
+};
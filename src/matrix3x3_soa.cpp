@@ -0,0 +1,355 @@
+#include "matrix3x3_soa.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace {
+
+using V = simd_float_t;
+using planes_t = std::array<V, matrix3x3_soa_t::PLANE_COUNT>; //!< simd_float_t::WIDTH matrices, one per lane
+
+// The kernels below use the same operation order as Matrix3x3::operator*, so agree with it to within a few ulps, see simd_float.h.
+
+[[gnu::always_inline]] inline planes_t multiply(const planes_t& a, const planes_t& b)
+{
+    return planes_t {{
+        a[0]*b[0] + a[1]*b[3] + a[2]*b[6],   a[0]*b[1] + a[1]*b[4] + a[2]*b[7],   a[0]*b[2] + a[1]*b[5] + a[2]*b[8],
+        a[3]*b[0] + a[4]*b[3] + a[5]*b[6],   a[3]*b[1] + a[4]*b[4] + a[5]*b[7],   a[3]*b[2] + a[4]*b[5] + a[5]*b[8],
+        a[6]*b[0] + a[7]*b[3] + a[8]*b[6],   a[6]*b[1] + a[7]*b[4] + a[8]*b[7],   a[6]*b[2] + a[7]*b[5] + a[8]*b[8]
+    }};
+}
+
+[[gnu::always_inline]] inline void multiply(const planes_t& a, V x, V y, V z, V& out_x, V& out_y, V& out_z)
+{
+    out_x = a[0]*x + a[1]*y + a[2]*z;
+    out_y = a[3]*x + a[4]*y + a[5]*z;
+    out_z = a[6]*x + a[7]*y + a[8]*z;
+}
+
+[[gnu::always_inline]] inline V determinant(const planes_t& a)
+{
+    return a[0]*(a[4]*a[8] - a[5]*a[7]) - a[1]*(a[3]*a[8] - a[5]*a[6]) + a[2]*(a[3]*a[7] - a[4]*a[6]);
+}
+
+//! Branchless version of Matrix3x3::invert_in_place, singular lanes are returned unchanged
+[[gnu::always_inline]] inline planes_t inverse(const planes_t& a, simd_mask_t& singular)
+{
+    const V A =   a[4]*a[8] - a[5]*a[7];  //  (e*i - f*h)
+    const V B = -(a[3]*a[8] - a[5]*a[6]); // -(d*i - f*g)
+    const V C =   a[3]*a[7] - a[4]*a[6];  //  (d*h - e*g)
+    const V D = -(a[1]*a[8] - a[2]*a[7]); // -(b*i - c*h)
+    const V E =   a[0]*a[8] - a[2]*a[6];  //  (a*i - c*g)
+    const V F = -(a[0]*a[7] - a[1]*a[6]); // -(a*h - b*g)
+    const V G =   a[1]*a[5] - a[2]*a[4];  //  (b*f - c*e)
+    const V H = -(a[0]*a[5] - a[2]*a[3]); // -(a*f - c*d)
+    const V I =   a[0]*a[4] - a[1]*a[3];  //  (a*e - b*d)
+
+    const V det = a[0]*A + a[1]*B + a[2]*C;
+    singular = V::abs(det) <= V::broadcast(std::numeric_limits<float>::epsilon());
+    const V r = V::broadcast(1.0F) / det;
+
+    return planes_t {{
+        V::select(singular, a[0], A*r), V::select(singular, a[1], D*r), V::select(singular, a[2], G*r),
+        V::select(singular, a[3], B*r), V::select(singular, a[4], E*r), V::select(singular, a[5], H*r),
+        V::select(singular, a[6], C*r), V::select(singular, a[7], F*r), V::select(singular, a[8], I*r)
+    }};
+}
+
+//! Same operation order as Matrix3x3(const Quaternion&)
+[[gnu::always_inline]] inline planes_t from_quaternion(V w, V x, V y, V z)
+{
+    const V one = V::broadcast(1.0F);
+    const V two = V::broadcast(2.0F);
+    return planes_t {{
+        one - two*(y*y + z*z),  two*(x*y - w*z),        two*(w*y + x*z),
+        two*(w*z + x*y),        one - two*(x*x + z*z),  two*(y*z - w*x),
+        two*(x*z - w*y),        two*(w*x + y*z),        one - two*(x*x + y*y)
+    }};
+}
+
+/*!
+Branchless version of Matrix3x3::quaternion.
+All four forms are calculated, and then the form chosen by the scalar decision tree is selected in each lane.
+Uses the same operation order as the scalar function, so agrees with it to within a few ulps (see simd_float.h) when reciprocal_sqrtf
+is `1.0F / sqrtf()`, and to within the reciprocal square root error otherwise.
+*/
+void to_quaternion(const planes_t& a, V& w, V& x, V& y, V& z) // not declared inline, since it is too large to inline with SSE2
+{
+    const V one = V::broadcast(1.0F);
+    const simd_mask_t use_xy = a[8] < V::zero();
+    const simd_mask_t use_x = a[0] > a[4];
+    const simd_mask_t use_z = a[0] < -a[4];
+
+    const V tx = one + (a[0] - a[4]) - a[8]; // 4xx
+    const V ty = one - (a[0] - a[4]) - a[8]; // 4yy
+    const V tz = one - a[0] - (a[4] - a[8]); // 4zz
+    const V tw = one + a[0] + a[4] + a[8]; // 4ww
+
+    const V wx = a[7] - a[5]; // 4xw
+    const V wy = a[2] - a[6]; // 4wy
+    const V wz = a[3] - a[1]; // 4wz
+    const V xy = a[1] + a[3]; // 4xy
+    const V xz = a[2] + a[6]; // 4xz
+    const V yz = a[5] + a[7]; // 4yz
+
+    // x-form: (wx, tx, xy, xz), y-form: (wy, xy, ty, yz), z-form: (wz, xz, yz, tz), w-form: (tw, wx, wy, wz)
+    const V t = V::select(use_xy, V::select(use_x, tx, ty), V::select(use_z, tz, tw));
+    const V qw = V::select(use_xy, V::select(use_x, wx, wy), V::select(use_z, wz, tw));
+    const V qx = V::select(use_xy, V::select(use_x, tx, xy), V::select(use_z, xz, wx));
+    const V qy = V::select(use_xy, V::select(use_x, xy, ty), V::select(use_z, yz, wy));
+    const V qz = V::select(use_xy, V::select(use_x, xz, yz), V::select(use_z, tz, wz));
+
+    const V k = V::broadcast(0.5F) * V::reciprocal_sqrt<rsqrt_precision_e::FULL>(t);
+    w = qw*k;
+    x = qx*k;
+    y = qy*k;
+    z = qz*k;
+}
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+//! Load the nine planes of a block of WIDTH matrices, planes_t is not value-initialized first, since that is not optimized away
+[[gnu::always_inline]] inline planes_t load_planes(const float* p)
+{
+    static constexpr size_t W = V::WIDTH;
+    return planes_t {{
+        V::load_aligned(p),       V::load_aligned(p + W),   V::load_aligned(p + 2*W),
+        V::load_aligned(p + 3*W), V::load_aligned(p + 4*W), V::load_aligned(p + 5*W),
+        V::load_aligned(p + 6*W), V::load_aligned(p + 7*W), V::load_aligned(p + 8*W)
+    }};
+}
+
+[[gnu::always_inline]] inline planes_t broadcast_planes(const Matrix3x3& m)
+{
+    return planes_t {{
+        V::broadcast(m[0]), V::broadcast(m[1]), V::broadcast(m[2]),
+        V::broadcast(m[3]), V::broadcast(m[4]), V::broadcast(m[5]),
+        V::broadcast(m[6]), V::broadcast(m[7]), V::broadcast(m[8])
+    }};
+}
+
+[[gnu::always_inline]] inline void store_planes(float* p, const planes_t& a)
+{
+    for (size_t kk = 0; kk < a.size(); ++kk) {
+        a[kk].store_aligned(p + kk*V::WIDTH);
+    }
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+} // end namespace
+
+matrix3x3_soa_t::matrix3x3_soa_t(const matrix3x3_soa_t& other) = default;
+matrix3x3_soa_t::matrix3x3_soa_t(matrix3x3_soa_t&& other) noexcept = default;
+matrix3x3_soa_t& matrix3x3_soa_t::operator=(const matrix3x3_soa_t& other) = default;
+matrix3x3_soa_t& matrix3x3_soa_t::operator=(matrix3x3_soa_t&& other) noexcept = default;
+matrix3x3_soa_t::~matrix3x3_soa_t() = default;
+
+void matrix3x3_soa_t::resize(size_t size)
+{
+    // as for xyz_soa_t::resize, elements beyond the old size may hold stale values, or values written to the padding by the batch functions,
+    // so all matrices from the old size onwards, including the padding lanes, are zeroed
+    const size_t keep = std::min(_size, size);
+    _size = size;
+    const size_t padded = V::padded_size(size);
+    _a.resize(padded*PLANE_COUNT);
+    for (size_t ii = keep; ii < padded; ++ii) {
+        for (size_t kk = 0; kk < PLANE_COUNT; ++kk) {
+            _a[index(ii, kk)] = 0.0F;
+        }
+    }
+}
+
+void matrix3x3_soa_t::from_matrix(std::span<const Matrix3x3> m)
+{
+    resize(m.size());
+    for (size_t ii = 0; ii < m.size(); ++ii) {
+        set(ii, m[ii]);
+    }
+}
+
+void matrix3x3_soa_t::to_matrix(std::span<Matrix3x3> m) const
+{
+    for (size_t ii = 0; ii < _size; ++ii) {
+        m[ii] = operator[](ii);
+    }
+}
+
+Matrix3x3 matrix3x3_soa_t::operator[](size_t pos) const
+{
+    Matrix3x3 m;
+    for (size_t kk = 0; kk < PLANE_COUNT; ++kk) {
+        m[kk] = _a[index(pos, kk)];
+    }
+    return m;
+}
+
+void matrix3x3_soa_t::set(size_t pos, const Matrix3x3& m)
+{
+    for (size_t kk = 0; kk < PLANE_COUNT; ++kk) {
+        _a[index(pos, kk)] = m[kk];
+    }
+}
+
+void matrix3x3_soa_t::from_quaternion(std::span<const Quaternion> q)
+{
+    static_assert(sizeof(Quaternion) == 4*sizeof(float));
+    resize(q.size());
+    float* pa = _a.data();
+    V::for_each_block_in(q, [pa](const Quaternion* pq, size_t ii) {
+        V w {};
+        V x {};
+        V y {};
+        V z {};
+        V::load_interleaved4(reinterpret_cast<const float*>(pq), w, x, y, z); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        store_planes(pa + ii*PLANE_COUNT, ::from_quaternion(w, x, y, z)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic) storage is padded to a multiple of WIDTH matrices
+    });
+}
+
+void matrix3x3_soa_t::to_quaternion(std::span<Quaternion> q) const
+{
+    static_assert(sizeof(Quaternion) == 4*sizeof(float));
+    const float* pa = _a.data();
+    V::for_each_block_out(q.first(_size), [pa](Quaternion* pq, size_t ii) {
+        V w {};
+        V x {};
+        V y {};
+        V z {};
+        ::to_quaternion(load_planes(pa + ii*PLANE_COUNT), w, x, y, z); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic) storage is padded to a multiple of WIDTH matrices
+        V::store_interleaved4(reinterpret_cast<float*>(pq), w, x, y, z); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    });
+}
+
+void matrix3x3_soa_t::multiply(const matrix3x3_soa_t& m, matrix3x3_soa_t& out) const
+{
+    out.resize(_size);
+    const float* pa = _a.data();
+    const float* pb = m._a.data();
+    float* po = out._a.data();
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) storage is padded to a multiple of WIDTH matrices
+    for (size_t ii = 0; ii < _a.size(); ii += PLANE_COUNT*V::WIDTH) {
+        store_planes(po + ii, ::multiply(load_planes(pa + ii), load_planes(pb + ii)));
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+void matrix3x3_soa_t::multiply(const xyz_soa_t& v, xyz_soa_t& out) const
+{
+    out.resize(_size);
+    const float* pa = _a.data();
+    const float* px = v.x().data();
+    const float* py = v.y().data();
+    const float* pz = v.z().data();
+    float* ox = out.x().data();
+    float* oy = out.y().data();
+    float* oz = out.z().data();
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) arrays are padded to a multiple of WIDTH
+    for (size_t ii = 0; ii < _size; ii += V::WIDTH) {
+        const planes_t a = load_planes(pa + ii*PLANE_COUNT);
+        V x {};
+        V y {};
+        V z {};
+        ::multiply(a, V::load_aligned(px + ii), V::load_aligned(py + ii), V::load_aligned(pz + ii), x, y, z);
+        x.store_aligned(ox + ii);
+        y.store_aligned(oy + ii);
+        z.store_aligned(oz + ii);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+void matrix3x3_soa_t::determinant(std::span<float> out) const
+{
+    const float* pa = _a.data();
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) storage is padded to a multiple of WIDTH matrices
+    for (size_t ii = 0; ii < _size; ii += V::WIDTH) {
+        ::determinant(load_planes(pa + ii*PLANE_COUNT)).store_partial(&out[ii], std::min(V::WIDTH, _size - ii));
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+size_t matrix3x3_soa_t::inverse(matrix3x3_soa_t& out, std::span<uint32_t> singular) const
+{
+    static_assert(32 % V::WIDTH == 0); // so a block of lanes does not straddle two mask words
+    out.resize(_size);
+    std::fill(singular.begin(), singular.begin() + static_cast<std::ptrdiff_t>(singular_mask_size()), 0U);
+    size_t singular_count = 0;
+    const float* pa = _a.data();
+    float* po = out._a.data();
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) storage is padded to a multiple of WIDTH matrices
+    for (size_t ii = 0; ii < _size; ii += V::WIDTH) {
+        simd_mask_t mask {};
+        store_planes(po + ii*PLANE_COUNT, ::inverse(load_planes(pa + ii*PLANE_COUNT), mask));
+        // ignore the padding lanes
+        const size_t count = std::min(V::WIDTH, _size - ii);
+        const uint32_t bits = mask.bits() & static_cast<uint32_t>((uint64_t{1} << count) - 1);
+        singular[ii/32] |= bits << (ii%32);
+        singular_count += static_cast<size_t>(std::popcount(bits));
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    return singular_count;
+}
+
+/*!
+Multiply an array of vectors by the matrices, element by element.
+*/
+void matrix3x3_soa_t::multiply(std::span<const xyz_t> v, std::span<xyz_t> out) const
+{
+    static_assert(sizeof(xyz_t) == 3*sizeof(float));
+    const float* pa = _a.data();
+    V::for_each_block(v.first(_size), out, [pa](const xyz_t* pv, xyz_t* po, size_t ii) {
+        V x {};
+        V y {};
+        V z {};
+        V::load_interleaved3(&pv->x, x, y, z);
+        ::multiply(load_planes(pa + ii*PLANE_COUNT), x, y, z, x, y, z); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic) storage is padded to a multiple of WIDTH matrices
+        V::store_interleaved3(&po->x, x, y, z);
+    });
+}
+
+/*!
+Multiply an array of vectors by this matrix.
+
+The matrix elements are broadcast once, and then applied to simd_float_t::WIDTH vectors at a time.
+*/
+template <typename T>
+void Matrix3x3T<T>::multiply(std::span<const xyz_type<T>> v, std::span<xyz_type<T>> out) const requires std::same_as<T, float>
+{
+    static_assert(sizeof(xyz_t) == 3*sizeof(float));
+    const planes_t a = broadcast_planes(*this);
+    V::for_each_block(v, out, [&a](const xyz_t* pv, xyz_t* po, size_t ii) {
+        (void)ii;
+        V x {};
+        V y {};
+        V z {};
+        V::load_interleaved3(&pv->x, x, y, z);
+        ::multiply(a, x, y, z, x, y, z);
+        V::store_interleaved3(&po->x, x, y, z);
+    });
+}
+
+template <typename T>
+void Matrix3x3T<T>::multiply(const xyz_soa_t& v, xyz_soa_t& out) const requires std::same_as<T, float>
+{
+    const planes_t a = broadcast_planes(*this);
+    const size_t count = v.size();
+    out.resize(count);
+    const float* px = v.x().data();
+    const float* py = v.y().data();
+    const float* pz = v.z().data();
+    float* ox = out.x().data();
+    float* oy = out.y().data();
+    float* oz = out.z().data();
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) arrays are padded to a multiple of WIDTH
+    for (size_t ii = 0; ii < count; ii += V::WIDTH) {
+        V x {};
+        V y {};
+        V z {};
+        ::multiply(a, V::load_aligned(px + ii), V::load_aligned(py + ii), V::load_aligned(pz + ii), x, y, z);
+        x.store_aligned(ox + ii);
+        y.store_aligned(oy + ii);
+        z.store_aligned(oz + ii);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+template void Matrix3x3::multiply(std::span<const xyz_t> v, std::span<xyz_t> out) const;
+template void Matrix3x3::multiply(const xyz_soa_t& v, xyz_soa_t& out) const;
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "matrix3x3.h"
+#include "xyz_soa.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*!
+Interleaved structure of arrays container of 3x3 matrices.
+
+The matrices are stored in blocks of simd_float_t::WIDTH matrices. Each block holds nine planes, one per matrix element,
+each of simd_float_t::WIDTH floats. So element k of matrix i is at index (i/WIDTH*9 + k)*WIDTH + i%WIDTH.
+This means each SIMD lane handles one matrix, and the batched functions below process simd_float_t::WIDTH matrices per instruction.
+
+Interleaving the planes (rather than having nine separate arrays, as xyz_soa_t does for its three components) means
+the kernels read one contiguous stream per container, rather than nine streams that alias each other in the cache.
+
+The storage is padded to a multiple of simd_float_t::WIDTH matrices, so the kernels have no scalar tail loop.
+Where a function takes a second container, it must be the same size as this one.
+*/
+class matrix3x3_soa_t {
+public:
+    using array_t = xyz_soa_t::array_t;
+    static constexpr size_t PLANE_COUNT = 9;
+public:
+    matrix3x3_soa_t() = default;
+    explicit matrix3x3_soa_t(size_t size) { resize(size); }
+    explicit matrix3x3_soa_t(std::span<const Matrix3x3> m) { from_matrix(m); }
+    explicit matrix3x3_soa_t(std::span<const Quaternion> q) { from_quaternion(q); }
+    // special member functions are defined out of line, since they are too large to inline
+    matrix3x3_soa_t(const matrix3x3_soa_t& other);
+    matrix3x3_soa_t(matrix3x3_soa_t&& other) noexcept;
+    matrix3x3_soa_t& operator=(const matrix3x3_soa_t& other);
+    matrix3x3_soa_t& operator=(matrix3x3_soa_t&& other) noexcept;
+    ~matrix3x3_soa_t();
+    void from_matrix(std::span<const Matrix3x3> m); //!< Convert from array of matrices
+    void to_matrix(std::span<Matrix3x3> m) const; //!< Convert to array of matrices, m must have at least size() elements
+    std::vector<Matrix3x3> to_vector() const { std::vector<Matrix3x3> m(_size); to_matrix(m); return m; } //!< Convert to vector of Matrix3x3
+    void from_quaternion(std::span<const Quaternion> q); //!< Convert from array of quaternions, this[i] = Matrix3x3(q[i])
+    /*!
+    Convert to array of quaternions, q[i] = this[i].quaternion(), q must have at least size() elements.
+    Branchless: all four of the x-, y-, z-, and w-forms used by Matrix3x3::quaternion are calculated, and the same form is selected per lane.
+    */
+    void to_quaternion(std::span<Quaternion> q) const;
+public:
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    void resize(size_t size);
+    void clear() { resize(0); }
+
+    Matrix3x3 operator[](size_t pos) const; //<! Index operator
+    void set(size_t pos, const Matrix3x3& m);
+
+    float element(size_t pos, size_t k) const { return _a[index(pos, k)]; } //!< Element k of matrix pos
+public:
+    void multiply(const matrix3x3_soa_t& m, matrix3x3_soa_t& out) const; //!< out[i] = this[i]*m[i], out may be the same container as this or m
+    void multiply(const xyz_soa_t& v, xyz_soa_t& out) const; //!< out[i] = this[i]*v[i], out may be the same container as v
+    void multiply(std::span<const xyz_t> v, std::span<xyz_t> out) const; //!< out[i] = this[i]*v[i], v must have at least size() elements, out may be the same array as v
+
+    void determinant(std::span<float> out) const; //!< Matrix determinants, out must have at least size() elements
+    /*!
+    Invert the matrices, using a single reciprocal of each determinant and the same operation order as Matrix3x3::invert_in_place,
+    so the results agree with it to within a few ulps, see simd_float.h.
+    Singular matrices (those with |det| <= epsilon, as in Matrix3x3::invert_in_place) are left unchanged, and are flagged in the
+    singular bit mask: bit i%32 of singular[i/32] is set if matrix i is singular. singular must have at least singular_mask_size() elements.
+    Returns the number of singular matrices.
+    */
+    size_t inverse(matrix3x3_soa_t& out, std::span<uint32_t> singular) const;
+    size_t invert_in_place(std::span<uint32_t> singular) { return inverse(*this, singular); } //!< Invert the matrices, in-place, see inverse
+    size_t singular_mask_size() const { return (_size + 31) / 32; } // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+private:
+    static size_t index(size_t pos, size_t k) { return (pos/simd_float_t::WIDTH*PLANE_COUNT + k)*simd_float_t::WIDTH + pos%simd_float_t::WIDTH; }
+private:
+    array_t _a {};
+    size_t _size {0};
+};
@@ -0,0 +1,335 @@
+#pragma once
+
+#include "matrix3x3.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+/*!
+N by M matrix, templated on the scalar type T, see Matrix<N, M> (float) and Matrixd<N, M> (double).
+
+Intended for the state covariances of Kalman filters (eg 6x6, 9x9, 12x12, and 15x15), without the compile time and flash costs of a
+general purpose linear algebra library. Elements are stored in row-major order. All sizes are compile-time constants, so the loops
+have constant bounds.
+
+The innermost loops of the products are unrolled at compile time, using fold expressions over a std::index_sequence.
+Without this GCC at -O2 leaves them as loops (unless the size is a multiple of the vector width), and for 15x15 the unrolled
+multiplication is more than four times faster. The multiplication runs along a row of the result, ie is contiguous in memory.
+It is register blocked: the loop along the row of the left operand is also unrolled, so each row of the result is accumulated
+in registers, and when the row length is even but not a multiple of four, pairs of rows are accumulated together, so the
+sums fill whole 4 float SIMD registers. For 6x6 this more than halves the time of the multiplication, which is then on par with Eigen.
+The larger functions (products, congruence transforms and the Cholesky functions) are defined after the class, rather than
+being constexpr, since for the larger sizes they are too big to be inlined.
+*/
+template <typename T, size_t N, size_t M>
+class MatrixT {
+public:
+    static constexpr size_t ROWS = N;
+    static constexpr size_t COLUMNS = M;
+public:
+    constexpr MatrixT() : _a{} {}
+    constexpr explicit MatrixT(T diagonal) requires (N == M) : _a{} { for (size_t ii = 0; ii < N; ++ii) { _a[ii*M + ii] = diagonal; } }
+    constexpr explicit MatrixT(const std::array<T, N*M>& a) : _a(a) {}
+public:
+    // Equality operators
+    constexpr bool operator==(const MatrixT& m) const = default;
+
+    // Index operators
+    constexpr T operator[](size_t pos) const { return _a[pos]; } //<! Index operator
+    constexpr T& operator[](size_t pos) { return _a[pos]; } //<! Index operator
+    constexpr T operator()(size_t row, size_t column) const { return _a[row*M + column]; } //<! Element at row, column
+    constexpr T& operator()(size_t row, size_t column) { return _a[row*M + column]; } //<! Element at row, column
+
+    // Unary operations
+    constexpr MatrixT operator+() const { return *this; } //<! Unary plus
+    constexpr MatrixT operator-() const { MatrixT ret; for (size_t ii = 0; ii < N*M; ++ii) { ret[ii] = -_a[ii]; } return ret; } //<! Unary negation
+
+    // cppcheck-suppress useStlAlgorithm
+    constexpr MatrixT operator*=(T k) { for (T& a : _a) { a*=k; } return *this; } //<! Multiplication by a scalar
+    constexpr MatrixT operator/=(T k) { const T r = T(1)/k; return operator*=(r); } //<! Division by a scalar
+    constexpr MatrixT operator+=(const MatrixT& m) { for (size_t ii = 0; ii < N*M; ++ii) {_a[ii] += m[ii];} return *this; } //<! Unary addition
+    constexpr MatrixT operator-=(const MatrixT& m) { for (size_t ii = 0; ii < N*M; ++ii) {_a[ii] -= m[ii];} return *this; } //<! Unary subtraction
+
+    // Binary operations
+    constexpr MatrixT operator*(T k) const { MatrixT ret = *this; ret *= k; return ret; } //<! Multiplication by a scalar
+    friend constexpr MatrixT operator*(T k, const MatrixT& m) { return m*k; } //<! Pre-multiplication by a scalar
+    constexpr MatrixT operator/(T k) const { const T r = T(1)/k; return *this*r; } //<! Division by a scalar
+    constexpr MatrixT operator+(const MatrixT& m) const { MatrixT ret = *this; ret += m; return ret; } //<! Addition
+    constexpr MatrixT operator-(const MatrixT& m) const { MatrixT ret = *this; ret -= m; return ret; } //<! Subtraction
+
+    template <size_t P>
+    MatrixT<T, N, P> operator*(const MatrixT<T, M, P>& m) const; //!< Multiplication
+    template <size_t P>
+    MatrixT<T, M, P> transpose_multiply(const MatrixT<T, N, P>& m) const; //!< Returns this^T*m, without forming the transpose
+    template <size_t P>
+    MatrixT<T, N, P> multiply_transpose(const MatrixT<T, P, M>& m) const; //!< Returns this*m^T, without forming the transpose
+
+    //! Symmetric update, returns F*P*F^T (where F is this matrix), eg for covariance propagation.
+    //! Only the elements on and above the diagonal are calculated, the elements below the diagonal are copies of them, so the result is exactly symmetric.
+    MatrixT<T, N, N> congruence(const MatrixT<T, M, M>& p) const;
+    MatrixT<T, N, N> congruence_add(const MatrixT<T, M, M>& p, const MatrixT<T, N, N>& q) const; //!< Returns F*P*F^T + Q
+
+    //! Returns transpose of matrix
+    constexpr MatrixT<T, M, N> transpose() const {
+        MatrixT<T, M, N> ret;
+        for (size_t row = 0; row < N; ++row) {
+            for (size_t column = 0; column < M; ++column) {
+                ret[column*N + row] = _a[row*M + column];
+            }
+        }
+        return ret;
+    }
+
+    // Block operations, the block position and size are template parameters, so they are checked at compile time
+    //! Returns the BN by BM block with top left element at row R, column C
+    template <size_t R, size_t C, size_t BN, size_t BM>
+    constexpr MatrixT<T, BN, BM> get_block() const requires (R + BN <= N && C + BM <= M) {
+        MatrixT<T, BN, BM> ret;
+        for (size_t row = 0; row < BN; ++row) {
+            for (size_t column = 0; column < BM; ++column) {
+                ret[row*BM + column] = _a[(R + row)*M + C + column];
+            }
+        }
+        return ret;
+    }
+    //! Sets the block with top left element at row R, column C
+    template <size_t R, size_t C, size_t BN, size_t BM>
+    constexpr void set_block(const MatrixT<T, BN, BM>& b) requires (R + BN <= N && C + BM <= M) {
+        for (size_t row = 0; row < BN; ++row) {
+            for (size_t column = 0; column < BM; ++column) {
+                _a[(R + row)*M + C + column] = b[row*BM + column];
+            }
+        }
+    }
+    //! Returns the 3x3 block with top left element at row R, column C
+    template <size_t R, size_t C>
+    constexpr Matrix3x3T<T> get_matrix3x3() const requires (R + 3 <= N && C + 3 <= M) {
+        return Matrix3x3T<T>(
+            _a[R*M + C],       _a[R*M + C + 1],       _a[R*M + C + 2],
+            _a[(R + 1)*M + C], _a[(R + 1)*M + C + 1], _a[(R + 1)*M + C + 2],
+            _a[(R + 2)*M + C], _a[(R + 2)*M + C + 1], _a[(R + 2)*M + C + 2]
+        );
+    }
+    //! Sets the 3x3 block with top left element at row R, column C
+    template <size_t R, size_t C>
+    constexpr void set_matrix3x3(const Matrix3x3T<T>& m) requires (R + 3 <= N && C + 3 <= M) {
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t column = 0; column < 3; ++column) {
+                _a[(R + row)*M + C + column] = m[row*3 + column];
+            }
+        }
+    }
+    //! Returns the column vector in rows R to R+2 of column C, eg the velocity in a state vector
+    template <size_t R, size_t C>
+    constexpr xyz_type<T> get_xyz() const requires (R + 3 <= N && C < M) { return xyz_type<T>{ _a[R*M + C], _a[(R + 1)*M + C], _a[(R + 2)*M + C] }; }
+    //! Sets the column vector in rows R to R+2 of column C
+    template <size_t R, size_t C>
+    constexpr void set_xyz(const xyz_type<T>& v) requires (R + 3 <= N && C < M) { _a[R*M + C] = v.x; _a[(R + 1)*M + C] = v.y; _a[(R + 2)*M + C] = v.z; }
+
+    constexpr void set_zero() { _a.fill(T(0)); }
+    constexpr void set_to_identity() requires (N == M) { _a.fill(T(0)); for (size_t ii = 0; ii < N; ++ii) { _a[ii*M + ii] = T(1); } } //<! Sets matrix to identity matrix
+    constexpr T trace() const requires (N == M) { T ret {}; for (size_t ii = 0; ii < N; ++ii) { ret += _a[ii*M + ii]; } return ret; }
+
+    // Cholesky factorization, for symmetric positive definite matrices
+    //! Replaces the matrix with its Cholesky factor L, where L*L^T is the matrix and L is lower triangular.
+    //! Only the elements on and below the diagonal are read. Returns false, leaving the matrix unchanged, if the matrix is not positive definite.
+    bool cholesky_in_place() requires (N == M);
+    //! Solves L*L^T*X = B, where this matrix is the Cholesky factor L, overwriting B with X
+    template <size_t P>
+    void cholesky_substitute_in_place(MatrixT<T, N, P>& b) const requires (N == M);
+    //! Solves A*X = B, where A is this symmetric positive definite matrix, overwriting B with X.
+    //! Returns false, leaving B unchanged, if A is not positive definite.
+    template <size_t P>
+    bool cholesky_solve_in_place(MatrixT<T, N, P>& b) const requires (N == M);
+private:
+    template <typename, size_t, size_t>
+    friend class MatrixT; // so the products can construct their results uninitialized
+    struct uninitialized_t {};
+    //! Leaves the elements uninitialized, for results whose elements are all then written, since for the small sizes zeroing them is a significant part of the cost
+    explicit MatrixT(uninitialized_t /*unused*/) {} // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init)
+    //! sum[j] += a*m[offset + j] for each j in J, unrolled at compile time
+    template <typename U, size_t... J>
+    static constexpr void add_scaled(std::array<T, sizeof...(J)>& sum, T a, const U& m, size_t offset, std::index_sequence<J...> /*unused*/) { ((sum[J] += a*m[offset + J]), ...); }
+    //! sum[r*P + j] += _a[offset + r*M + k]*m[k*P + j] for each of the R rows r, each k in K and each j, ie the product of R rows of this matrix and m, unrolled at compile time
+    template <size_t R, size_t P, size_t... K>
+    [[gnu::always_inline]] constexpr void add_rows_product(std::array<T, R*P>& sum, size_t offset, const MatrixT<T, M, P>& m, std::index_sequence<K...> /*unused*/) const { (add_rows_scaled<R, P>(sum, offset + K, m, K*P, std::make_index_sequence<R*P>{}), ...); }
+    //! sum[j] += _a[offset + (j/P)*M]*m[offset_m + j%P] for each j in J, unrolled at compile time
+    template <size_t R, size_t P, size_t... J>
+    [[gnu::always_inline]] constexpr void add_rows_scaled(std::array<T, R*P>& sum, size_t offset, const MatrixT<T, M, P>& m, size_t offset_m, std::index_sequence<J...> /*unused*/) const { ((sum[J] += _a[offset + (J/P)*M]*m[offset_m + J%P]), ...); }
+    //! Returns the sum of a[offset_a + k]*b[offset_b + k] for each k in K, unrolled at compile time
+    template <typename U, typename V, size_t... K>
+    static constexpr T dot(const U& a, size_t offset_a, const V& b, size_t offset_b, std::index_sequence<K...> /*unused*/) { return (... + (a[offset_a + K]*b[offset_b + K])); }
+protected:
+    std::array<T, N*M> _a;
+};
+
+template <size_t N, size_t M>
+using Matrix = MatrixT<float, N, M>;
+template <size_t N, size_t M>
+using Matrixd = MatrixT<double, N, M>;
+
+
+template <typename T, size_t N, size_t M>
+template <size_t P>
+MatrixT<T, N, P> MatrixT<T, N, M>::operator*(const MatrixT<T, M, P>& m) const
+{
+    MatrixT<T, N, P> ret(typename MatrixT<T, N, P>::uninitialized_t{});
+    // rows per block, see the class description
+    constexpr size_t R = (P % 4 != 0 && P % 2 == 0) ? 2 : 1;
+    size_t row = 0;
+    for (; row + R <= N; row += R) {
+        // accumulate the rows locally, since the result may not be assumed to be distinct from m
+        std::array<T, R*P> sum {};
+        add_rows_product<R>(sum, row*M, m, std::make_index_sequence<M>{});
+        for (size_t column = 0; column < R*P; ++column) {
+            ret[row*P + column] = sum[column];
+        }
+    }
+    for (; row < N; ++row) { // the last row, when N is not a multiple of R
+        std::array<T, P> sum {};
+        add_rows_product<1>(sum, row*M, m, std::make_index_sequence<M>{});
+        for (size_t column = 0; column < P; ++column) {
+            ret[row*P + column] = sum[column];
+        }
+    }
+    return ret;
+}
+
+template <typename T, size_t N, size_t M>
+template <size_t P>
+MatrixT<T, M, P> MatrixT<T, N, M>::transpose_multiply(const MatrixT<T, N, P>& m) const
+{
+    MatrixT<T, M, P> ret;
+    for (size_t row = 0; row < M; ++row) {
+        std::array<T, P> sum {};
+        for (size_t kk = 0; kk < N; ++kk) {
+            add_scaled(sum, _a[kk*M + row], m, kk*P, std::make_index_sequence<P>{});
+        }
+        for (size_t column = 0; column < P; ++column) {
+            ret[row*P + column] = sum[column];
+        }
+    }
+    return ret;
+}
+
+template <typename T, size_t N, size_t M>
+template <size_t P>
+MatrixT<T, N, P> MatrixT<T, N, M>::multiply_transpose(const MatrixT<T, P, M>& m) const
+{
+    MatrixT<T, N, P> ret;
+    for (size_t row = 0; row < N; ++row) {
+        for (size_t column = 0; column < P; ++column) {
+            ret[row*P + column] = dot(_a, row*M, m, column*M, std::make_index_sequence<M>{});
+        }
+    }
+    return ret;
+}
+
+template <typename T, size_t N, size_t M>
+MatrixT<T, N, N> MatrixT<T, N, M>::congruence(const MatrixT<T, M, M>& p) const
+{
+    const MatrixT<T, N, M> fp = *this*p;
+    MatrixT<T, N, N> ret;
+    for (size_t row = 0; row < N; ++row) {
+        for (size_t column = row; column < N; ++column) {
+            const T sum = dot(fp, row*M, _a, column*M, std::make_index_sequence<M>{});
+            ret[row*N + column] = sum;
+            ret[column*N + row] = sum;
+        }
+    }
+    return ret;
+}
+
+template <typename T, size_t N, size_t M>
+MatrixT<T, N, N> MatrixT<T, N, M>::congruence_add(const MatrixT<T, M, M>& p, const MatrixT<T, N, N>& q) const
+{
+    const MatrixT<T, N, M> fp = *this*p;
+    MatrixT<T, N, N> ret;
+    for (size_t row = 0; row < N; ++row) {
+        for (size_t column = row; column < N; ++column) {
+            const T sum = dot(fp, row*M, _a, column*M, std::make_index_sequence<M>{}) + q[row*N + column];
+            ret[row*N + column] = sum;
+            ret[column*N + row] = sum;
+        }
+    }
+    return ret;
+}
+
+/*!
+Cholesky–Banachiewicz algorithm, calculating L row by row.
+The factorization is done in a copy, so the matrix is unchanged if it is not positive definite.
+*/
+template <typename T, size_t N, size_t M>
+bool MatrixT<T, N, M>::cholesky_in_place() requires (N == M)
+{
+    std::array<T, N*N> l {};
+    for (size_t row = 0; row < N; ++row) {
+        for (size_t column = 0; column < row; ++column) {
+            T sum = _a[row*N + column];
+            for (size_t kk = 0; kk < column; ++kk) {
+                sum -= l[row*N + kk]*l[column*N + kk];
+            }
+            l[row*N + column] = sum / l[column*N + column];
+        }
+        T d = _a[row*N + row];
+        for (size_t kk = 0; kk < row; ++kk) {
+            d -= l[row*N + kk]*l[row*N + kk];
+        }
+        // negated comparison, so that NaN is also rejected
+        if (!(d > T(0))) {
+            return false;
+        }
+        using std::sqrt;
+        l[row*N + row] = sqrt(d);
+    }
+    _a = l;
+    return true;
+}
+
+/*!
+Forward substitution to solve L*Y = B, then back substitution to solve L^T*X = Y.
+The innermost loops run along the rows of B, so all the columns of B are solved together.
+*/
+template <typename T, size_t N, size_t M>
+template <size_t P>
+void MatrixT<T, N, M>::cholesky_substitute_in_place(MatrixT<T, N, P>& b) const requires (N == M)
+{
+    for (size_t row = 0; row < N; ++row) {
+        for (size_t kk = 0; kk < row; ++kk) {
+            const T l = _a[row*N + kk];
+            for (size_t column = 0; column < P; ++column) {
+                b[row*P + column] -= l*b[kk*P + column];
+            }
+        }
+        const T r = T(1) / _a[row*N + row];
+        for (size_t column = 0; column < P; ++column) {
+            b[row*P + column] *= r;
+        }
+    }
+    for (size_t row = N; row-- > 0;) {
+        for (size_t kk = row + 1; kk < N; ++kk) {
+            const T l = _a[kk*N + row];
+            for (size_t column = 0; column < P; ++column) {
+                b[row*P + column] -= l*b[kk*P + column];
+            }
+        }
+        const T r = T(1) / _a[row*N + row];
+        for (size_t column = 0; column < P; ++column) {
+            b[row*P + column] *= r;
+        }
+    }
+}
+
+template <typename T, size_t N, size_t M>
+template <size_t P>
+bool MatrixT<T, N, M>::cholesky_solve_in_place(MatrixT<T, N, P>& b) const requires (N == M)
+{
+    MatrixT l = *this;
+    if (!l.cholesky_in_place()) {
+        return false;
+    }
+    l.cholesky_substitute_in_place(b);
+    return true;
+}
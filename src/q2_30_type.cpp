@@ -0,0 +1,258 @@
+#include "q2_30_type.h"
+
+#include <array>
+#include <bit>
+
+namespace {
+
+/*!
+1/sqrt(m) at the midpoints of the intervals [i/32, (i+1)/32), for i in [8, 32), in Q2.30.
+The maximum relative error of these estimates is about 3%, which three Newton–Raphson iterations reduce to below the resolution of Q2.30.
+*/
+constexpr std::array<uint32_t, 24> RECIPROCAL_SQRT_TABLE {
+    0x7C2DA123, 0x7575FAA4, 0x6FBA415C, 0x6AC266BA, 0x66666666, 0x6288D173,
+    0x5F137599, 0x5BF539E5, 0x5920B4DF, 0x568B3632, 0x542C1AA4, 0x51FC5140,
+    0x4FF601E0, 0x4E144AE9, 0x4C530F65, 0x4AAED0F0, 0x49249249, 0x47B1C049,
+    0x46541FB4, 0x4509BEB0, 0x43D0E917, 0x42A81EF6, 0x418E0CC8, 0x40818512
+};
+
+} // end namespace
+
+q2_30_t sqrt(q2_30_t k)
+{
+    if (k.raw <= 0) {
+        return q2_30_t{};
+    }
+    // bit by bit integer square root of k.raw * 2^30, see [Integer square root](https://en.wikipedia.org/wiki/Integer_square_root#Digit-by-digit_algorithm)
+    uint64_t n = static_cast<uint64_t>(k.raw) << q2_30_t::FRACTIONAL_BITS;
+    uint64_t root = 0;
+    uint64_t bit = uint64_t{1} << 62U;
+    while (bit > n) {
+        bit >>= 2U;
+    }
+    while (bit != 0) {
+        if (n >= root + bit) {
+            n -= root + bit;
+            root = (root >> 1U) + bit;
+        } else {
+            root >>= 1U;
+        }
+        bit >>= 2U;
+    }
+    return q2_30_t::from_raw(static_cast<int32_t>(root));
+}
+
+/*!
+k is normalized to m * 4^e, with m in [0.25, 1), so that 1/sqrt(k) = 2^-e / sqrt(m).
+The estimate y of 1/sqrt(m) is then refined using y = y*(3 - m*y*y)/2, with m held in Q0.32 and y in unsigned Q2.30, using 64 bit intermediate values.
+*/
+q2_30_t reciprocal_sqrt(q2_30_t k)
+{
+    if (k.raw <= 0) {
+        return q2_30_t::max();
+    }
+    const auto raw = static_cast<uint32_t>(k.raw);
+    const int shift = std::countl_zero(raw) & ~1; // even, so that the exponent is a whole power of 4
+    const uint64_t m = raw << static_cast<uint32_t>(shift); // Q0.32, in range [0.25, 1)
+    uint64_t y = RECIPROCAL_SQRT_TABLE[(m >> 27U) - 8]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index) m >> 27 is in range [8, 32)
+    constexpr uint64_t THREE = uint64_t{3} << q2_30_t::FRACTIONAL_BITS;
+    for (int ii = 0; ii < 3; ++ii) {
+        const uint64_t y2 = (y*y) >> q2_30_t::FRACTIONAL_BITS; // Q2.30, y2 <= 4
+        const uint64_t my2 = (m*y2) >> 32U; // Q2.30, close to 1
+        y = (y*(THREE - my2)) >> (q2_30_t::FRACTIONAL_BITS + 1);
+    }
+    // k = m * 2^(2 - shift), so 1/sqrt(k) = y * 2^(shift/2 - 1)
+    if (shift == 0) {
+        return q2_30_t::from_raw(static_cast<int32_t>((y + 1) >> 1U));
+    }
+    const uint64_t r = y << static_cast<uint32_t>(shift/2 - 1);
+    return r > INT32_MAX ? q2_30_t::max() : q2_30_t::from_raw(static_cast<int32_t>(r));
+}
+
+int Trigonometry<q2_30_t>::reduce(q2_30_t x, q2_30_t& r)
+{
+    const q2_30_t t = x * TWO_OVER_PI; // so remainder will be scaled from range [-PI/4, PI/4] to [-0.5, 0.5]
+    const int32_t q = (t.raw + (INT32_C(1) << (q2_30_t::FRACTIONAL_BITS - 1))) >> q2_30_t::FRACTIONAL_BITS; // nearest quadrant
+    r = q2_30_t::from_raw(t.raw - q*static_cast<int32_t>(q2_30_t::ONE)); // remainder in range [-0.5, 0.5]
+    return q;
+}
+
+q2_30_t Trigonometry<q2_30_t>::sin(q2_30_t x)
+{
+    q2_30_t r {};
+    const int q = reduce(x, r);
+    if (q & 1) {
+        // odd quadrant: use cos
+        const q2_30_t c = cos_poly6r(r);
+        return (q & 2) ? -c : c;
+    }
+    // even quadrant: use sin
+    const q2_30_t s = sin_poly5r(r);
+    return (q & 2) ? -s : s;
+}
+
+q2_30_t Trigonometry<q2_30_t>::cos(q2_30_t x)
+{
+    q2_30_t r {};
+    const int q = reduce(x, r);
+    if (q & 1) {
+        // odd quadrant: use sin
+        const q2_30_t s = sin_poly5r(r);
+        return (q & 2) ? s : -s;
+    }
+    // even quadrant: use cos
+    const q2_30_t c = cos_poly6r(r);
+    return (q & 2) ? -c : c;
+}
+
+void Trigonometry<q2_30_t>::sin_cos(q2_30_t x, q2_30_t& sin, q2_30_t& cos)
+{
+    q2_30_t r {};
+    const int q = reduce(x, r);
+    const q2_30_t sb = sin_poly5r(r);
+    const q2_30_t cb = cos_poly6r(r);
+
+    // map values according to quadrant
+    const q2_30_t s = (q & 1) ?  cb : sb;
+    const q2_30_t c = (q & 1) ? -sb : cb;
+
+    if (q & 2) { // negate for quadrants 2 and 3
+        sin = -s;
+        cos = -c;
+    } else {
+        sin = s;
+        cos = c;
+    }
+}
+
+template <>
+Quaternion_q2_30 Quaternion_q2_30::operator*(const Quaternion_q2_30& q) const
+{
+    using K = q2_30_t;
+    return Quaternion_q2_30(
+        K::from_product_sum(K::product(w, q.w) - K::product(x, q.x) - K::product(y, q.y) - K::product(z, q.z)),
+        K::from_product_sum(K::product(w, q.x) + K::product(x, q.w) + K::product(y, q.z) - K::product(z, q.y)),
+        K::from_product_sum(K::product(w, q.y) - K::product(x, q.z) + K::product(y, q.w) + K::product(z, q.x)),
+        K::from_product_sum(K::product(w, q.z) + K::product(x, q.y) - K::product(y, q.x) + K::product(z, q.w))
+    );
+}
+
+template <>
+Quaternion_q2_30 Quaternion_q2_30::operator*=(const Quaternion_q2_30& q)
+{
+    *this = *this * q;
+    return *this;
+}
+
+/*!
+Rotate using the equivalent rotation matrix, so the rotation coefficients are each rounded only once.
+*/
+template <>
+xyz_q2_30_t Quaternion_q2_30::rotate(const xyz_q2_30_t& v) const
+{
+    return Matrix3x3_q2_30(*this) * v;
+}
+
+namespace {
+/*!
+Returns the shift that scales a vector, with the given sum of the squares of its components in Q4.58, to have a squared magnitude in the range [0.5, 2).
+A positive shift is a left shift, and a negative shift a right shift. The sum is 0.5 when it has 6 leading zeros.
+*/
+int normalizing_shift(int64_t sum_of_squares)
+{
+    if (sum_of_squares == 0) {
+        return 0;
+    }
+    const int leading_zeros = std::countl_zero(static_cast<uint64_t>(sum_of_squares));
+    if (leading_zeros > 6) {
+        return (leading_zeros - 5) / 2;
+    }
+    if (leading_zeros < 5) {
+        return -((6 - leading_zeros) / 2);
+    }
+    return 0;
+}
+
+q2_30_t shifted(q2_30_t k, int shift)
+{
+    // a left shift cannot overflow, since the shifted component is no larger than the shifted magnitude
+    return shift >= 0 ? q2_30_t::from_raw(static_cast<int32_t>(static_cast<uint32_t>(k.raw) << static_cast<uint32_t>(shift)))
+        : q2_30_t::from_raw(k.raw >> static_cast<uint32_t>(-shift));
+}
+} // end namespace
+
+template <>
+xy_q2_30_t xy_q2_30_t::normalized() const
+{
+    using K = q2_30_t;
+    const int shift = normalizing_shift(K::product(x, x) + K::product(y, y));
+    const xy_q2_30_t v { shifted(x, shift), shifted(y, shift) };
+    return v*reciprocal_sqrt(v.magnitude_squared());
+}
+
+template <>
+xyz_q2_30_t xyz_q2_30_t::normalized() const
+{
+    using K = q2_30_t;
+    const int shift = normalizing_shift(K::product(x, x) + K::product(y, y) + K::product(z, z));
+    const xyz_q2_30_t v { shifted(x, shift), shifted(y, shift), shifted(z, shift) };
+    return v*reciprocal_sqrt(v.magnitude_squared());
+}
+
+template <>
+Quaternion_q2_30 Quaternion_q2_30::normalized() const
+{
+    using K = q2_30_t;
+    const int shift = normalizing_shift(K::product(w, w) + K::product(x, x) + K::product(y, y) + K::product(z, z));
+    const Quaternion_q2_30 q(shifted(w, shift), shifted(x, shift), shifted(y, shift), shifted(z, shift));
+    return q*reciprocal_sqrt(q.magnitude_squared());
+}
+
+template <>
+Matrix3x3_q2_30::Matrix3x3T(const Quaternion_q2_30& q)
+{
+    using K = q2_30_t;
+    constexpr int64_t ONE = K::ONE << 28U; // Q4.58
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+    _a[0] = K::from_product_sum(ONE - 2*(K::product(q.y, q.y) + K::product(q.z, q.z)));
+    _a[1] = K::from_product_sum(2*(K::product(q.x, q.y) - K::product(q.w, q.z)));
+    _a[2] = K::from_product_sum(2*(K::product(q.w, q.y) + K::product(q.x, q.z)));
+    _a[3] = K::from_product_sum(2*(K::product(q.w, q.z) + K::product(q.x, q.y)));
+    _a[4] = K::from_product_sum(ONE - 2*(K::product(q.x, q.x) + K::product(q.z, q.z)));
+    _a[5] = K::from_product_sum(2*(K::product(q.y, q.z) - K::product(q.w, q.x)));
+    _a[6] = K::from_product_sum(2*(K::product(q.x, q.z) - K::product(q.w, q.y)));
+    _a[7] = K::from_product_sum(2*(K::product(q.w, q.x) + K::product(q.y, q.z)));
+    _a[8] = K::from_product_sum(ONE - 2*(K::product(q.x, q.x) + K::product(q.y, q.y)));
+    // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+}
+
+template <>
+xyz_q2_30_t Matrix3x3_q2_30::operator*(const xyz_q2_30_t& v) const
+{
+    using K = q2_30_t;
+    return xyz_q2_30_t {
+        K::from_product_sum(K::product(_a[0], v.x) + K::product(_a[1], v.y) + K::product(_a[2], v.z)),
+        K::from_product_sum(K::product(_a[3], v.x) + K::product(_a[4], v.y) + K::product(_a[5], v.z)),
+        K::from_product_sum(K::product(_a[6], v.x) + K::product(_a[7], v.y) + K::product(_a[8], v.z))
+    };
+}
+
+template <>
+Matrix3x3_q2_30 Matrix3x3_q2_30::operator*(const Matrix3x3_q2_30& m) const
+{
+    using K = q2_30_t;
+    Matrix3x3_q2_30 ret;
+    for (size_t row = 0; row < 9; row += 3) {
+        for (size_t col = 0; col < 3; ++col) {
+            ret[row + col] = K::from_product_sum(K::product(_a[row], m[col]) + K::product(_a[row + 1], m[col + 3]) + K::product(_a[row + 2], m[col + 6])); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
+    }
+    return ret;
+}
+
+template <>
+Matrix3x3_q2_30 Matrix3x3_q2_30::operator*=(const Matrix3x3_q2_30& m)
+{
+    *this = *this * m;
+    return *this;
+}
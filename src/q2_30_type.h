@@ -0,0 +1,162 @@
+#pragma once
+
+#include "matrix3x3.h"
+#include "trigonometry.h"
+#include "xy_type.h"
+
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <utility>
+
+/*!
+Q2.30 signed fixed point number, for use as the scalar type of the vector, quaternion, and matrix templates on
+microcontrollers without a floating point unit (eg Cortex-M0 and Cortex-M3), where soft float arithmetic is slow.
+
+The range is [-2, 2), with a resolution of 2^-30 (approximately 9.3E-10), which is sufficient for unit quaternions,
+rotation matrices, and normalized vectors (including the intermediate values of QuaternionT::rotate and QuaternionT::operator*).
+All arithmetic saturates rather than overflows, and multiplication and division are rounded to nearest.
+
+Q2.30 was chosen rather than Q1.15, since the resolution of Q1.15 (approximately 3E-5) is too coarse for repeated attitude updates.
+The products are 64 bits. Cortex-M3 (ARMv7-M) has the SMULL 32x32 to 64 bit multiply, so they cost little more than a 32 bit multiply.
+Cortex-M0 (ARMv6-M) has only a 32x32 to 32 bit multiply, so each product is a call to the run time library's `__aeabi_lmul`,
+which uses several 32 bit multiplies: this is still considerably cheaper than a soft float multiply, but several times slower
+than the 16x16 bit products a Q1.15 type would need.
+
+Only the arithmetic, multiply, rotate, and normalize functions are supported: functions that use angles or constants outside
+the range [-2, 2) (eg calculate_roll_degrees) are not. sqrt, abs, and reciprocal_sqrt overloads are provided,
+which are found by argument dependent lookup, and sin and cos are provided by the Trigonometry<q2_30_t> specialization.
+*/
+struct q2_30_t {
+public:
+    static constexpr int FRACTIONAL_BITS = 30;
+    static constexpr int64_t ONE = int64_t{1} << FRACTIONAL_BITS;
+public:
+    constexpr q2_30_t() = default;
+    template <std::integral I>
+    [[gnu::always_inline]] constexpr explicit q2_30_t(I k) : raw(from_integer(k)) {}
+    template <std::floating_point F>
+    [[gnu::always_inline]] constexpr explicit q2_30_t(F f) : raw(from_floating_point(f)) {}
+    [[gnu::always_inline]] static constexpr q2_30_t from_raw(int32_t r) { q2_30_t ret; ret.raw = r; return ret; }
+    [[gnu::always_inline]] static constexpr q2_30_t max() { return from_raw(INT32_MAX); }
+    [[gnu::always_inline]] static constexpr q2_30_t min() { return from_raw(INT32_MIN); }
+    [[gnu::always_inline]] constexpr float to_float() const { return static_cast<float>(raw) * (1.0F/static_cast<float>(ONE)); }
+    //! Product of raw values, as Q4.58 (ie shifted right by 2 bits), so that sums of up to four products do not overflow
+    [[gnu::always_inline]] static constexpr int64_t product(q2_30_t a, q2_30_t b) { return (static_cast<int64_t>(a.raw)*b.raw) >> 2; }
+    //! Convert a sum of products to Q2.30, rounded to nearest and saturated
+    [[gnu::always_inline]] static constexpr q2_30_t from_product_sum(int64_t sum) { return from_raw(saturate((sum + (int64_t{1} << 27)) >> 28)); }
+public:
+    // Comparison operators
+    constexpr bool operator==(const q2_30_t& k) const = default;
+    constexpr auto operator<=>(const q2_30_t& k) const = default;
+
+    // Unary operators
+    [[gnu::always_inline]] constexpr q2_30_t operator+() const { return *this; } //<! Unary plus
+    [[gnu::always_inline]] constexpr q2_30_t operator-() const { return from_raw(saturate(-static_cast<int64_t>(raw))); } //<! Unary negation, saturating
+
+    // Binary operators
+    [[gnu::always_inline]] constexpr q2_30_t operator+(q2_30_t k) const { return from_raw(saturate(static_cast<int64_t>(raw) + k.raw)); } //<! Saturating addition
+    [[gnu::always_inline]] constexpr q2_30_t operator-(q2_30_t k) const { return from_raw(saturate(static_cast<int64_t>(raw) - k.raw)); } //<! Saturating subtraction
+    //! Saturating multiplication, rounded to nearest
+    [[gnu::always_inline]] constexpr q2_30_t operator*(q2_30_t k) const { return from_raw(saturate((static_cast<int64_t>(raw)*k.raw + ONE/2) >> FRACTIONAL_BITS)); }
+    //! Saturating division, rounded to nearest, division by zero saturates
+    [[gnu::always_inline]] constexpr q2_30_t operator/(q2_30_t k) const {
+        if (k.raw == 0) {
+            return raw < 0 ? min() : max();
+        }
+        const int64_t n = static_cast<int64_t>(raw) * ONE;
+        const int64_t d = k.raw;
+        const int64_t half = (d < 0 ? -d : d) / 2;
+        return from_raw(saturate(((n < 0) == (d < 0) ? n + half : n - half) / d));
+    }
+    [[gnu::always_inline]] constexpr q2_30_t& operator+=(q2_30_t k) { *this = *this + k; return *this; } //<! Saturating addition
+    [[gnu::always_inline]] constexpr q2_30_t& operator-=(q2_30_t k) { *this = *this - k; return *this; } //<! Saturating subtraction
+    [[gnu::always_inline]] constexpr q2_30_t& operator*=(q2_30_t k) { *this = *this * k; return *this; } //<! Saturating multiplication
+    [[gnu::always_inline]] constexpr q2_30_t& operator/=(q2_30_t k) { *this = *this / k; return *this; } //<! Saturating division
+private:
+    [[gnu::always_inline]] static constexpr int32_t saturate(int64_t k) { return k > INT32_MAX ? INT32_MAX : k < INT32_MIN ? INT32_MIN : static_cast<int32_t>(k); }
+    template <std::integral I>
+    [[gnu::always_inline]] static constexpr int32_t from_integer(I k) { return std::cmp_greater_equal(k, 2) ? INT32_MAX : std::cmp_less(k, -2) ? INT32_MIN : static_cast<int32_t>(static_cast<int64_t>(k)*ONE); }
+    template <std::floating_point F>
+    [[gnu::always_inline]] static constexpr int32_t from_floating_point(F f) {
+        const F scaled = f * static_cast<F>(ONE);
+        if (!(scaled < static_cast<F>(INT32_MAX))) {
+            return scaled < F(0) ? INT32_MIN : INT32_MAX; // includes NaN
+        }
+        if (scaled < static_cast<F>(INT32_MIN)) {
+            return INT32_MIN;
+        }
+        return static_cast<int32_t>(scaled < F(0) ? scaled - F(0.5F) : scaled + F(0.5F));
+    }
+public:
+    int32_t raw {};
+};
+
+//! Absolute value, saturating
+[[gnu::always_inline]] constexpr q2_30_t abs(q2_30_t k) { return k.raw < 0 ? -k : k; }
+//! Square root, rounded down, the square root of a negative number is zero
+q2_30_t sqrt(q2_30_t k);
+/*!
+Integer reciprocal square root, using a table lookup for the initial estimate followed by three Newton–Raphson iterations,
+accurate to a few units in the last place. Results larger than the range of q2_30_t (ie for k < 0.25) saturate,
+so normalized() is specialized for q2_30_t to first scale the components by a power of 2.
+*/
+q2_30_t reciprocal_sqrt(q2_30_t k);
+
+/*!
+Fixed point sin and cos, using the same range reduction and polynomial coefficients as FastTrigonometry::sin and FastTrigonometry::cos,
+evaluated in Q2.30 arithmetic, so the results are within a few units in the last place of the FastTrigonometry functions.
+Angles are limited to the range of q2_30_t, ie [-2, 2) radians.
+*/
+template <>
+class Trigonometry<q2_30_t> {
+private:
+    static constexpr q2_30_t SIN_C1 = q2_30_t(FastTrigonometry::SIN_C1);
+    static constexpr q2_30_t SIN_C3 = q2_30_t(FastTrigonometry::SIN_C3);
+    static constexpr q2_30_t SIN_C5 = q2_30_t(FastTrigonometry::SIN_C5);
+    static constexpr q2_30_t COS_C2 = q2_30_t(FastTrigonometry::COS_C2);
+    static constexpr q2_30_t COS_C4 = q2_30_t(FastTrigonometry::COS_C4);
+    static constexpr q2_30_t COS_C6 = q2_30_t(FastTrigonometry::COS_C6);
+    static constexpr q2_30_t TWO_OVER_PI = q2_30_t(FastTrigonometry::TWO_OVER_PI);
+    [[gnu::always_inline]] static constexpr q2_30_t sin_poly5r(q2_30_t r) {
+        const q2_30_t r2 = r * r;
+        return r*(SIN_C1 + r2*(SIN_C3 + r2*SIN_C5));
+    }
+    [[gnu::always_inline]] static constexpr q2_30_t cos_poly6r(q2_30_t r) {
+        const q2_30_t r2 = r * r;
+        return q2_30_t(1) + r2*(COS_C2 + r2*(COS_C4 + r2*COS_C6));
+    }
+    //! Reduce x to the remainder r, in range [-0.5, 0.5] and pre-scaled by 2/PI, returning the quadrant, as in FastTrigonometry::sin_cos
+    static int reduce(q2_30_t x, q2_30_t& r);
+public:
+    static q2_30_t sin(q2_30_t x);
+    static q2_30_t cos(q2_30_t x);
+    static void sin_cos(q2_30_t x, q2_30_t& sin, q2_30_t& cos);
+};
+
+using xy_q2_30_t = xy_type<q2_30_t>;
+using xyz_q2_30_t = xyz_type<q2_30_t>;
+using Quaternion_q2_30 = QuaternionT<q2_30_t>;
+using Matrix3x3_q2_30 = Matrix3x3T<q2_30_t>;
+
+/*
+The quaternion and matrix products for q2_30_t accumulate the products in 64 bits and then round and saturate once,
+rather than rounding and saturating each term, which is both more accurate and considerably smaller and faster.
+They are defined in q2_30_type.cpp.
+*/
+template <> Quaternion_q2_30 Quaternion_q2_30::operator*(const Quaternion_q2_30& q) const;
+template <> Quaternion_q2_30 Quaternion_q2_30::operator*=(const Quaternion_q2_30& q);
+template <> xyz_q2_30_t Quaternion_q2_30::rotate(const xyz_q2_30_t& v) const;
+template <> Matrix3x3_q2_30::Matrix3x3T(const Quaternion_q2_30& q);
+template <> xyz_q2_30_t Matrix3x3_q2_30::operator*(const xyz_q2_30_t& v) const;
+template <> Matrix3x3_q2_30 Matrix3x3_q2_30::operator*(const Matrix3x3_q2_30& m) const;
+template <> Matrix3x3_q2_30 Matrix3x3_q2_30::operator*=(const Matrix3x3_q2_30& m);
+
+/*
+normalized() for q2_30_t first shifts the components by a power of 2, so that the squared magnitude is in the range [0.5, 2),
+since otherwise the reciprocal square root of the squared magnitude saturates for vectors shorter than 0.5,
+and the squared magnitude itself saturates for vectors longer than sqrt(2).
+*/
+template <> xy_q2_30_t xy_q2_30_t::normalized() const;
+template <> xyz_q2_30_t xyz_q2_30_t::normalized() const;
+template <> Quaternion_q2_30 Quaternion_q2_30::normalized() const;
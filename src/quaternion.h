@@ -1,6 +1,12 @@
 #pragma once
 
+#include "fast_trigonometry.h"
+#include "trigonometry.h"
 #include "xyz_type.h"
+#include <concepts>
+#include <span>
+
+class xyz_soa_t;
 
 /*!
 Combined accelerometer and gyroscope values.
@@ -11,49 +17,100 @@ struct acc_gyro_rps_t {
     xyz_t acc;
 };
 
+/*!
+Euler angles (in radians) and their sines, cosines, and tangents, see QuaternionT::attitude.
+*/
+template <typename T>
+struct attitude_type {
+    T roll;
+    T pitch;
+    T yaw;
+    T sin_roll;
+    T cos_roll;
+    T tan_roll;
+    T sin_pitch;
+    T cos_pitch;
+    T tan_pitch;
+    T sin_yaw;
+    T cos_yaw;
+    T tan_yaw;
+};
 
-class Quaternion {
+using attitude_t = attitude_type<float>;
+using attituded_t = attitude_type<double>;
+
+/*!
+Quaternion, templated on the scalar type T, see Quaternion (float) and Quaterniond (double).
+*/
+template <typename T>
+class QuaternionT {
 public:
-    Quaternion() : w(1.0F), x(0.0F), y(0.0F), z(0.0F) {}
-    Quaternion(float w_, float x_, float y_, float z_) : w(w_), x(x_), y(y_), z(z_) {}
-    Quaternion(const xyz_t& src, const xyz_t& dst);
+    [[gnu::always_inline]] constexpr QuaternionT() : w(T(1)), x(T(0)), y(T(0)), z(T(0)) {}
+    [[gnu::always_inline]] constexpr QuaternionT(T w_, T x_, T y_, T z_) : w(w_), x(x_), y(y_), z(z_) {}
+    QuaternionT(const xyz_type<T>& src, const xyz_type<T>& dst);
 public:
-    static constexpr float M_PI_F = 3.14159265358979323846F;
-    static constexpr float M_PI_2_F = M_PI_F / 2.0F;
-    static constexpr float RADIANS_TO_DEGREES = 180.0F / M_PI_F;
-    static constexpr float DEGREES_TO_RADIANS = M_PI_F / 180.0F;
+    static constexpr T M_PI_F = static_cast<T>(3.14159265358979323846L);
+    static constexpr T M_PI_2_F = M_PI_F / T(2);
+    static constexpr T RADIANS_TO_DEGREES = T(180) / M_PI_F;
+    static constexpr T DEGREES_TO_RADIANS = M_PI_F / T(180);
 public:
-    static Quaternion from_euler_angles_radians(float roll_radians, float pitch_radians, float yaw_radians);
-    static Quaternion from_euler_angles_radians(float roll_radians, float pitch_radians);
-    static Quaternion from_euler_angles_degrees(float roll_degrees, float pitch_degrees, float yaw_degrees);
-    static Quaternion from_euler_angles_degrees(float roll_degrees, float pitch_degrees);
+    static QuaternionT from_euler_angles_radians(T roll_radians, T pitch_radians, T yaw_radians);
+    static QuaternionT from_euler_angles_radians(T roll_radians, T pitch_radians);
+    static QuaternionT from_euler_angles_degrees(T roll_degrees, T pitch_degrees, T yaw_degrees);
+    static QuaternionT from_euler_angles_degrees(T roll_degrees, T pitch_degrees);
+    /*!
+    Compile time versions of from_euler_angles_radians and from_euler_angles_degrees, so that fixed rotations
+    (eg sensor mounting or board alignment) have no run time cost. These are consteval, so can only be used in constant expressions.
+    They use the FastTrigonometry polynomial sin and cos, so agree with from_euler_angles_radians to within a few ulps
+    when LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY is defined. They are available only for float.
+    */
+    static consteval QuaternionT from_euler_angles_radians_constexpr(T roll_radians, T pitch_radians, T yaw_radians) requires std::same_as<T, float> {
+        T sin_half_roll {};
+        T cos_half_roll {};
+        FastTrigonometry::sin_cos(0.5F*roll_radians, sin_half_roll, cos_half_roll);
+        T sin_half_pitch {};
+        T cos_half_pitch {};
+        FastTrigonometry::sin_cos(0.5F*pitch_radians, sin_half_pitch, cos_half_pitch);
+        T sin_half_yaw {};
+        T cos_half_yaw {};
+        FastTrigonometry::sin_cos(0.5F*yaw_radians, sin_half_yaw, cos_half_yaw);
+        return {
+            cos_half_roll * cos_half_pitch * cos_half_yaw + sin_half_roll * sin_half_pitch * sin_half_yaw,
+            sin_half_roll * cos_half_pitch * cos_half_yaw - cos_half_roll * sin_half_pitch * sin_half_yaw,
+            cos_half_roll * sin_half_pitch * cos_half_yaw + sin_half_roll * cos_half_pitch * sin_half_yaw,
+            cos_half_roll * cos_half_pitch * sin_half_yaw - sin_half_roll * sin_half_pitch * cos_half_yaw
+        };
+    }
+    static consteval QuaternionT from_euler_angles_degrees_constexpr(T roll_degrees, T pitch_degrees, T yaw_degrees) requires std::same_as<T, float> {
+        return from_euler_angles_radians_constexpr(roll_degrees*DEGREES_TO_RADIANS, pitch_degrees*DEGREES_TO_RADIANS, yaw_degrees*DEGREES_TO_RADIANS);
+    }
 public:
-    float get_w() const { return w; }
-    float get_x() const { return x; }
-    float get_y() const { return y; }
-    float get_z() const { return z; }
-    void get_wxyz(float& w_, float& x_, float& y_, float& z_) const { w_ = w; x_ = x; y_ = y; z_ = z; }
-    void set_to_identity() { w = 1.0F; x = 0.0F; y = 0.0F; z = 0.0F; }
-    void set(float w_, float x_, float y_, float z_) { w = w_; x = x_; y = y_; z = z_; }
+    [[gnu::always_inline]] constexpr T get_w() const { return w; }
+    [[gnu::always_inline]] constexpr T get_x() const { return x; }
+    [[gnu::always_inline]] constexpr T get_y() const { return y; }
+    [[gnu::always_inline]] constexpr T get_z() const { return z; }
+    [[gnu::always_inline]] constexpr void get_wxyz(T& w_, T& x_, T& y_, T& z_) const { w_ = w; x_ = x; y_ = y; z_ = z; }
+    [[gnu::always_inline]] constexpr void set_to_identity() { w = T(1); x = T(0); y = T(0); z = T(0); }
+    [[gnu::always_inline]] constexpr void set(T w_, T x_, T y_, T z_) { w = w_; x = x_; y = y_; z = z_; }
 public:
     // Equality operators
-    bool operator==(const Quaternion& q) const { return w == q.w && x == q.x &&  y == q.y && z == q.z; }
-    bool operator!=(const Quaternion& q) const { return w != q.w || x != q.x ||  y != q.y || z != q.z; }
+    [[gnu::always_inline]] constexpr bool operator==(const QuaternionT& q) const { return w == q.w && x == q.x &&  y == q.y && z == q.z; }
+    [[gnu::always_inline]] constexpr bool operator!=(const QuaternionT& q) const { return w != q.w || x != q.x ||  y != q.y || z != q.z; }
 
     // Unary operations
-    Quaternion operator+() const { return *this; } //<! Unary plus
-    Quaternion operator-() const { return Quaternion(-w, -x, -y, -z); } //<! Unary negation
-    Quaternion conjugate() const { return Quaternion(w, -x, -y, -z); } //<! Conjugate
-
-    Quaternion operator+=(const Quaternion& q) { w += q.w; x += q.x; y += q.y; z += q.z; return *this; } //<! Addition
-    Quaternion operator-=(const Quaternion& q) { w -= q.w; x -= q.x; y -= q.y; z -= q.z; return *this; } //<! Subtraction
-    Quaternion operator*=(float k) { w*=k; x*=k; y*=k; z*=k; return *this; } //<! Multiplication by a scalar
-    friend Quaternion operator*(float k, const Quaternion& q) { return q*k; } //<! Pre-multiplication by a scalar
-    Quaternion operator/=(float k) { const float r = 1.0F/k; w*=r; x*=r; y*=r; z*=r; return *this; } //<! Division by a scalar
-    Quaternion operator*=(const Quaternion& q) {
-        const float wt = w*q.w - x*q.x - y*q.y - z*q.z;
-        const float xt = w*q.x + x*q.w + y*q.z - z*q.y;
-        const float yt = w*q.y - x*q.z + y*q.w + z*q.x;
+    [[gnu::always_inline]] constexpr QuaternionT operator+() const { return *this; } //<! Unary plus
+    [[gnu::always_inline]] constexpr QuaternionT operator-() const { return QuaternionT(-w, -x, -y, -z); } //<! Unary negation
+    [[gnu::always_inline]] constexpr QuaternionT conjugate() const { return QuaternionT(w, -x, -y, -z); } //<! Conjugate
+
+    [[gnu::always_inline]] constexpr QuaternionT operator+=(const QuaternionT& q) { w += q.w; x += q.x; y += q.y; z += q.z; return *this; } //<! Addition
+    [[gnu::always_inline]] constexpr QuaternionT operator-=(const QuaternionT& q) { w -= q.w; x -= q.x; y -= q.y; z -= q.z; return *this; } //<! Subtraction
+    [[gnu::always_inline]] constexpr QuaternionT operator*=(T k) { w*=k; x*=k; y*=k; z*=k; return *this; } //<! Multiplication by a scalar
+    [[gnu::always_inline]] friend constexpr QuaternionT operator*(T k, const QuaternionT& q) { return q*k; } //<! Pre-multiplication by a scalar
+    [[gnu::always_inline]] constexpr QuaternionT operator/=(T k) { const T r = T(1)/k; w*=r; x*=r; y*=r; z*=r; return *this; } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr QuaternionT operator*=(const QuaternionT& q) {
+        const T wt = w*q.w - x*q.x - y*q.y - z*q.z;
+        const T xt = w*q.x + x*q.w + y*q.z - z*q.y;
+        const T yt = w*q.y - x*q.z + y*q.w + z*q.x;
         z              = w*q.z + x*q.y - y*q.x + z*q.w;
         w = wt;
         x = xt;
@@ -62,12 +119,12 @@ public:
     }
 
     // Binary operations
-    Quaternion operator+(const Quaternion& q) const { return Quaternion(w + q.w, x + q.x, y + q.y, z + q.z); } //<! Addition
-    Quaternion operator-(const Quaternion& q) const { return Quaternion(w - q.w, x - q.x, y - q.y, z - q.z); } //<! Subtraction
-    Quaternion operator*(float k) const { return Quaternion(w*k, x*k, y*k, z*k); } //<! Multiplication by a scalar
-    Quaternion operator/(float k) const { const float r = 1.0F/k; return *this*r; } //<! Division by a scalar
-    Quaternion operator*(const Quaternion& q) const {
-        return Quaternion(
+    [[gnu::always_inline]] constexpr QuaternionT operator+(const QuaternionT& q) const { return QuaternionT(w + q.w, x + q.x, y + q.y, z + q.z); } //<! Addition
+    [[gnu::always_inline]] constexpr QuaternionT operator-(const QuaternionT& q) const { return QuaternionT(w - q.w, x - q.x, y - q.y, z - q.z); } //<! Subtraction
+    [[gnu::always_inline]] constexpr QuaternionT operator*(T k) const { return QuaternionT(w*k, x*k, y*k, z*k); } //<! Multiplication by a scalar
+    [[gnu::always_inline]] constexpr QuaternionT operator/(T k) const { const T r = T(1)/k; return *this*r; } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr QuaternionT operator*(const QuaternionT& q) const {
+        return QuaternionT(
             w*q.w - x*q.x - y*q.y - z*q.z,
             w*q.x + x*q.w + y*q.z - z*q.y,
             w*q.y - x*q.z + y*q.w + z*q.x,
@@ -77,14 +134,15 @@ public:
 
     /*!
     Rotate about the x-axis,
-    equivalent to *= Quaternion(cos(theta/2), sin(theta/2), 0, 0)
+    equivalent to *= QuaternionT(cos(theta/2), sin(theta/2), 0, 0)
     */
-    Quaternion rotate_x(float theta) {
-        const float c = cosf(theta/2);
-        const float s = sinf(theta/2);
-        const float wt =  w*c - x*s;
+    QuaternionT rotate_x(T theta) {
+        T s {};
+        T c {};
+        Trigonometry<T>::sin_cos(theta/T(2), s, c);
+        const T wt =  w*c - x*s;
         x              =  w*s + x*c;
-        const float yt =  y*c + z*s;
+        const T yt =  y*c + z*s;
         z              = -y*s + z*c;
         w = wt;
         y = yt;
@@ -92,13 +150,14 @@ public:
     }
     /*!
     Rotate about the y-axis.
-    equivalent to *= Quaternion(cos(theta/2), 0, sin(theta/2), 0)
+    equivalent to *= QuaternionT(cos(theta/2), 0, sin(theta/2), 0)
     */
-    Quaternion rotate_y(float theta) {
-        const float c = cosf(theta/2);
-        const float s = sinf(theta/2);
-        const float wt = w*c - y*s;
-        const float xt = x*c - z*s;
+    QuaternionT rotate_y(T theta) {
+        T s {};
+        T c {};
+        Trigonometry<T>::sin_cos(theta/T(2), s, c);
+        const T wt = w*c - y*s;
+        const T xt = x*c - z*s;
         y              = w*s + y*c;
         z              = x*s - z*c;
         w = wt;
@@ -107,58 +166,104 @@ public:
     }
     /*!
     Rotate about the z-axis,
-    equivalent to *= Quaternion(cos(theta/2), 0, 0, sin(theta/2))
+    equivalent to *= QuaternionT(cos(theta/2), 0, 0, sin(theta/2))
     */
-    Quaternion rotate_z(float theta) {
-        const float c = cosf(theta/2);
-        const float s = sinf(theta/2);
-        const float wt = w*c - z*s;
-        const float xt = x*c - y*s;
+    QuaternionT rotate_z(T theta) {
+        T s {};
+        T c {};
+        Trigonometry<T>::sin_cos(theta/T(2), s, c);
+        const T wt = w*c - z*s;
+        const T xt = x*c - y*s;
         y              = x*s + y*c;
         z              = w*s + z*c;
         w = wt;
         x = xt;
         return *this;
     }
-    xyz_t rotate(const xyz_t& v) const; //<! Rotate a vector
+    xyz_type<T> rotate(const xyz_type<T>& v) const; //<! Rotate a vector
+    void rotate(std::span<const xyz_type<T>> v, std::span<xyz_type<T>> out) const requires std::same_as<T, float>; //<! Rotate an array of vectors, out may be the same array as v
+    void rotate(const xyz_soa_t& v, xyz_soa_t& out) const requires std::same_as<T, float>; //<! Rotate a structure of arrays of vectors, out may be the same object as v
 public:
-    float magnitude_squared() const { return w*w + x*x + y*y +z*z; } //<! The square of the magnitude
-    float magnitude() const { return sqrtf(magnitude_squared()); } //<! The magnitude
-    float squared_norm() const { return magnitude_squared(); } //<! The square of the magnitude (using Eigen library naming)
-    float norm() const { return magnitude(); } //<! The  magnitude (using Eigen library naming)
-    Quaternion normalized() const; //<! Return the normalized quaternion
-    Quaternion normalize() { *this=normalized(); return *this; } //<! Normalize, in-place (using Eigen library naming)
-    Quaternion normalize_in_place() { *this=normalized(); return *this; } //<! Normalize, in-place
+    [[gnu::always_inline]] constexpr T magnitude_squared() const { return w*w + x*x + y*y +z*z; } //<! The square of the magnitude
+    T magnitude() const { using std::sqrt; return sqrt(magnitude_squared()); } //<! The magnitude
+    T squared_norm() const { return magnitude_squared(); } //<! The square of the magnitude (using Eigen library naming)
+    T norm() const { return magnitude(); } //<! The  magnitude (using Eigen library naming)
+    QuaternionT normalized() const; //<! Return the normalized quaternion
+    QuaternionT normalize() { *this=normalized(); return *this; } //<! Normalize, in-place (using Eigen library naming)
+    QuaternionT normalize_in_place() { *this=normalized(); return *this; } //<! Normalize, in-place
+    //! Normalize an array of quaternions, out may be the same array as q
+    static void normalize_batch(std::span<const QuaternionT> q, std::span<QuaternionT> out, rsqrt_precision_e precision = rsqrt_precision_e::FULL) requires std::same_as<T, float>;
 
-    xyz_t imaginary() const { return xyz_t{x, y, z}; } //<! The imaginary part of the quaternion
-    xyz_t direction_cosine_matrix_z() const { return xyz_t{2.0F*(w*y + x*z), 2.0F*(y*z - w*x), w*w - x*x - y*y + z*z }; } //!< Last column of the equivalent rotation matrix, but calculated more efficiently than a full conversion
+    [[gnu::always_inline]] constexpr T dot(const QuaternionT& q) const { return w*q.w + x*q.x + y*q.y + z*q.z; } //<! Dot product
+    [[gnu::always_inline]] constexpr xyz_type<T> imaginary() const { return xyz_type<T>{x, y, z}; } //<! The imaginary part of the quaternion
+    [[gnu::always_inline]] constexpr xyz_type<T> direction_cosine_matrix_z() const { return xyz_type<T>{T(2)*(w*y + x*z), T(2)*(y*z - w*x), w*w - x*x - y*y + z*z }; } //!< Last column of the equivalent rotation matrix, but calculated more efficiently than a full conversion
 
     // Euler angle calculations. Note that these are computationally expensive.
-    float calculate_roll_radians() const;
-    float calculate_pitch_radians() const;
-    float calculate_yaw_radians() const;
+    // Define LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY to use the faster, approximate, FastTrigonometry functions.
+    T calculate_roll_radians() const;
+    T calculate_pitch_radians() const;
+    T calculate_yaw_radians() const;
 
-    float calculate_roll_degrees() const  { return RADIANS_TO_DEGREES * calculate_roll_radians(); }
-    float calculate_pitch_degrees() const { return RADIANS_TO_DEGREES * calculate_pitch_radians(); }
-    float calculate_yaw_degrees() const   { return RADIANS_TO_DEGREES * calculate_yaw_radians(); }
+    T calculate_roll_degrees() const  { return RADIANS_TO_DEGREES * calculate_roll_radians(); }
+    T calculate_pitch_degrees() const { return RADIANS_TO_DEGREES * calculate_pitch_radians(); }
+    T calculate_yaw_degrees() const   { return RADIANS_TO_DEGREES * calculate_yaw_radians(); }
 
     // Functions to calculate the sin, cos, and tan of the Euler angles.
     // Sometimes this can avoid the computationally expensive calculation of the angles themselves.
-    float sin_roll() const;
-    float sin_roll_clipped() const;
-    float cos_roll() const;
-    float tan_roll() const { return (w*x + y*z)/(0.5F - x*x - y*y); }
-    float sin_pitch() const { return 2.0F*(w*y - x*z); }
+    T sin_roll() const;
+    T sin_roll_clipped() const;
+    T cos_roll() const;
+    [[gnu::always_inline]] constexpr T tan_roll() const { return (w*x + y*z)/(T(0.5F) - x*x - y*y); }
+    [[gnu::always_inline]] constexpr T sin_pitch() const { return T(2)*(w*y - x*z); }
     //! clip sin(pitchAngle) to +/-1.0F when pitch angle outside range [-90 degrees, 90 degrees]
-    float sin_pitch_clipped() const { const float d = w*w - y*y; return std::signbit(d) ? std::copysignf(1.0F, sin_pitch()) : sin_pitch(); }
-    float cos_pitch() const;
-    float tan_pitch() const;
-    float sin_yaw() const;
-    float cos_yaw() const;
-    float tan_yaw() const { return (w*z + x*y)/(0.5F - y*y - z*z); }
+    T sin_pitch_clipped() const { const T d = w*w - y*y; return std::signbit(d) ? std::copysign(T(1), sin_pitch()) : sin_pitch(); }
+    T cos_pitch() const;
+    T tan_pitch() const;
+    T sin_yaw() const;
+    T cos_yaw() const;
+    [[gnu::always_inline]] constexpr T tan_yaw() const { return (w*z + x*y)/(T(0.5F) - y*y - z*z); }
+
+    /*!
+    Euler angles and their sin, cos, and tan, calculated in one pass, sharing the common subexpressions.
+    The angles use the same expressions as calculate_roll_radians() etc, and the sin, cos, and tan the same expressions as sin_roll() etc,
+    so agree with them to within rounding, except that cos_pitch and tan_pitch share a single square root.
+    */
+    attitude_type<T> attitude() const;
+    /*!
+    Batched version of attitude, out must have at least as many elements as q.
+    The angles are always calculated using the FastTrigonometry functions, so are within FastTrigonometry::ATAN_MAX_ERROR of those of attitude().
+    The sin and cos always use the full precision reciprocal square root. All values may differ from attitude() by rounding,
+    which for the roll and yaw values is magnified by 1/cos_pitch near gimbal lock.
+    */
+    static void attitude_batch(std::span<const QuaternionT> q, std::span<attitude_type<T>> out) requires std::same_as<T, float>;
+
+    // Exponential and logarithm, these use Taylor series when the angle is small, avoiding the trigonometric functions and division by a small number.
+    QuaternionT exp() const; //<! Exponential, exp(w + v) = e^w * (cos|v| + v/|v| sin|v|)
+    QuaternionT log() const; //<! Logarithm, log(q) = ln|q| + v/|v| acos(w/|q|), for q = w + v
+    /*!
+    Interpolation between q0 (t = 0) and q1 (t = 1), along the shortest path.
+    q0 and q1 must be unit quaternions. nlerp is cheaper than slerp, but does not have constant angular velocity.
+    slerp uses nlerp when the angle between q0 and q1 is small, since slerp would then divide by a small number, at the cost of a small error, see SLERP_NLERP_THRESHOLD.
+    See QuaternionInterpolator for interpolation of a sequence of keyframes.
+    */
+    static QuaternionT nlerp(const QuaternionT& q0, const QuaternionT& q1, T t);
+    static QuaternionT slerp(const QuaternionT& q0, const QuaternionT& q1, T t);
+    /*!
+    slerp uses nlerp when the cosine of the angle between q0 and q1 is above this.
+    At the threshold the angle of the nlerp result differs from that of slerp by at most 5.1E-7 radians for float and 4.5E-14 radians for double.
+    */
+    static constexpr T SLERP_NLERP_THRESHOLD = std::same_as<T, double> ? T(0.99999999) : T(0.9995F);
+    /*!
+    exp and log use Taylor series when the square of the angle is below this.
+    At the threshold the relative error of the series is at most 4.2E-8 (exp) and 2.0E-7 (log) for float, and 4.2E-18 (exp) and 2.0E-17 (log) for double.
+    */
+    static constexpr T SMALL_ANGLE_SQUARED = std::same_as<T, double> ? T(1.0E-8) : T(1.0E-3F);
 public:
-    float w;
-    float x;
-    float y;
-    float z;
+    T w;
+    T x;
+    T y;
+    T z;
 };
+
+using Quaternion = QuaternionT<float>;
+using Quaterniond = QuaternionT<double>;
@@ -0,0 +1,74 @@
+#include "quaternion_interpolator.h"
+#include "trigonometry.h"
+
+#include <cmath>
+
+
+QuaternionInterpolator::QuaternionInterpolator(std::span<const float> times, std::span<const Quaternion> keyframes, interpolation_e interpolation) :
+    _times(times),
+    _keyframes(keyframes),
+    _interpolation(interpolation)
+{
+    if (_keyframes.size() >= 2) {
+        set_segment(0);
+    }
+}
+
+/*!
+Calculate the values used by Quaternion::slerp (or Quaternion::nlerp) that depend only on the keyframes, not on the query time.
+*/
+void QuaternionInterpolator::set_segment(size_t segment)
+{
+    _segment = segment;
+    _t0 = _times[segment];
+    _reciprocal_dt = 1.0F/(_times[segment + 1] - _t0);
+    _q0 = _keyframes[segment];
+    const Quaternion& q1 = _keyframes[segment + 1];
+    const float d = _q0.dot(q1);
+    _q1 = d < 0.0F ? -q1 : q1;
+    if (_interpolation == interpolation_e::NLERP || fabsf(d) > Quaternion::SLERP_NLERP_THRESHOLD) {
+        _segment_interpolation = interpolation_e::NLERP;
+        return;
+    }
+    _segment_interpolation = interpolation_e::SLERP;
+    _theta = Trigonometry<float>::acos(fabsf(d));
+    _reciprocal_sin_theta = 1.0F/Trigonometry<float>::sin(_theta);
+}
+
+Quaternion QuaternionInterpolator::interpolate(float time)
+{
+    if (_keyframes.empty()) {
+        return Quaternion{};
+    }
+    if (time <= _times.front()) {
+        return _keyframes.front();
+    }
+    if (time >= _times.back()) {
+        return _keyframes.back();
+    }
+    // search from the current segment: forwards for increasing times, backwards otherwise
+    size_t segment = _segment;
+    while (time >= _times[segment + 1]) {
+        ++segment;
+    }
+    while (time < _times[segment]) {
+        --segment;
+    }
+    if (segment != _segment) {
+        set_segment(segment);
+    }
+
+    const float t = (time - _t0)*_reciprocal_dt;
+    if (_segment_interpolation == interpolation_e::NLERP) {
+        // _q1 has already been negated if required, so this is the same as Quaternion::nlerp
+        return (_q0*(1.0F - t) + _q1*t).normalized();
+    }
+    return _q0*(Trigonometry<float>::sin((1.0F - t)*_theta)*_reciprocal_sin_theta) + _q1*(Trigonometry<float>::sin(t*_theta)*_reciprocal_sin_theta);
+}
+
+void QuaternionInterpolator::interpolate(std::span<const float> times, std::span<Quaternion> out)
+{
+    for (size_t ii = 0; ii < times.size(); ++ii) {
+        out[ii] = interpolate(times[ii]);
+    }
+}
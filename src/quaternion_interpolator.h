@@ -0,0 +1,45 @@
+#pragma once
+
+#include "quaternion.h"
+
+#include <span>
+
+/*!
+Interpolation of a sequence of timestamped quaternion keyframes, for example to resample an attitude stream to different timestamps.
+
+The keyframe times must be strictly increasing. The keyframes are not copied, so must outlive the interpolator.
+Query times before the first keyframe or after the last keyframe give the first or last keyframe.
+
+The current segment (the pair of keyframes either side of the last query time) is remembered, along with the values
+slerp calculates from the pair (the angle between them and the reciprocal of its sine). So a sequence of increasing
+query times takes amortized constant time per query: there is no binary search, and the inverse cosine is calculated
+only once per segment, rather than once per query.
+The calculations are done in the same order as in Quaternion::slerp and Quaternion::nlerp, so the results agree with them
+to within a few ulps, see simd_float.h.
+*/
+class QuaternionInterpolator {
+public:
+    enum class interpolation_e { NLERP, SLERP };
+public:
+    QuaternionInterpolator(std::span<const float> times, std::span<const Quaternion> keyframes, interpolation_e interpolation = interpolation_e::SLERP);
+public:
+    Quaternion interpolate(float time); //!< Interpolated attitude at time
+    //! Interpolated attitudes at times, which should be sorted in increasing order. out must have at least as many elements as times.
+    void interpolate(std::span<const float> times, std::span<Quaternion> out);
+    size_t segment() const { return _segment; } //!< Index of the first keyframe of the current segment
+private:
+    void set_segment(size_t segment);
+private:
+    std::span<const float> _times;
+    std::span<const Quaternion> _keyframes;
+    size_t _segment {0};
+    // values cached for the current segment
+    Quaternion _q0 {};
+    Quaternion _q1 {}; //!< negated if required, so interpolation is along the shortest path
+    float _t0 {0.0F};
+    float _reciprocal_dt {0.0F};
+    float _theta {0.0F};
+    float _reciprocal_sin_theta {0.0F};
+    interpolation_e _interpolation;
+    interpolation_e _segment_interpolation {interpolation_e::NLERP}; //!< NLERP if the keyframes of the segment are close enough for slerp to use nlerp
+};
@@ -0,0 +1,214 @@
+#include "quaternion_packed.h"
+#include "simd_float.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using V = simd_float_t;
+
+/*!
+Quantization constants for BITS bits per component.
+Components in the range [-1/sqrt(2), 1/sqrt(2)] are mapped to the integers [0, 2*HALF], with zero mapped to HALF.
+*/
+template <uint32_t BITS>
+struct smallest_three {
+    static constexpr float ONE_OVER_ROOT_TWO = 0.70710678118654752440F;
+    static constexpr float HALF = static_cast<float>((1U << (BITS - 1)) - 1);
+    static constexpr float ENCODE_SCALE = HALF / ONE_OVER_ROOT_TWO;
+    static constexpr float DECODE_SCALE = ONE_OVER_ROOT_TWO / HALF;
+
+    static uint32_t quantize(float v) {
+        const float k = std::clamp(roundf(v*ENCODE_SCALE), -HALF, HALF);
+        return static_cast<uint32_t>(k + HALF);
+    }
+    static float dequantize(uint32_t k) { return (static_cast<float>(k) - HALF)*DECODE_SCALE; }
+};
+
+template <typename P>
+P encode(const Quaternion& q)
+{
+    using S = smallest_three<P::BITS>;
+    const std::array<float, 4> c {{ q.w, q.x, q.y, q.z }};
+    uint32_t index = 0;
+    float largest = std::fabs(c[0]);
+    for (uint32_t ii = 1; ii < 4; ++ii) {
+        if (std::fabs(c[ii]) > largest) {
+            largest = std::fabs(c[ii]);
+            index = ii;
+        }
+    }
+    const bool negate = c[index] < 0.0F;
+    std::array<uint32_t, 3> k {};
+    size_t jj = 0;
+    for (uint32_t ii = 0; ii < 4; ++ii) {
+        if (ii != index) {
+            k[jj] = S::quantize(negate ? -c[ii] : c[ii]);
+            ++jj;
+        }
+    }
+    return P::pack(index, k);
+}
+
+template <typename P>
+Quaternion decode(const P& p)
+{
+    using S = smallest_three<P::BITS>;
+    const std::array<uint32_t, 3> k = p.components();
+    const float a = S::dequantize(k[0]);
+    const float b = S::dequantize(k[1]);
+    const float c = S::dequantize(k[2]);
+    const float largest = std::sqrt(std::max(1.0F - a*a - b*b - c*c, 0.0F));
+    switch (p.index()) {
+    case 0:
+        return Quaternion(largest, a, b, c);
+    case 1:
+        return Quaternion(a, largest, b, c);
+    case 2:
+        return Quaternion(a, b, largest, c);
+    default:
+        return Quaternion(a, b, c, largest);
+    }
+}
+
+/*!
+Encode V::WIDTH quaternions.
+The selection of the largest component, the sign, and the quantization are calculated in SIMD registers,
+the bit packing is then done lane by lane.
+*/
+template <typename P>
+void encode_block(const Quaternion* pq, P* pout)
+{
+    using S = smallest_three<P::BITS>;
+    V qw {};
+    V qx {};
+    V qy {};
+    V qz {};
+    V::load_interleaved4(reinterpret_cast<const float*>(pq), qw, qx, qy, qz); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+
+    // select the component with the largest magnitude, choosing the first in the case of ties, as in encode()
+    V largest = V::abs(qw);
+    V index = V::broadcast(0.0F);
+    V value = qw;
+    const std::array<V, 3> others {{ qx, qy, qz }};
+    for (size_t ii = 0; ii < others.size(); ++ii) {
+        const simd_mask_t greater = V::abs(others[ii]) > largest;
+        largest = V::select(greater, V::abs(others[ii]), largest);
+        index = V::select(greater, V::broadcast(static_cast<float>(ii + 1)), index);
+        value = V::select(greater, others[ii], value);
+    }
+    const simd_mask_t negate = value < V::broadcast(0.0F);
+    qw = V::negate_if(negate, qw);
+    qx = V::negate_if(negate, qx);
+    qy = V::negate_if(negate, qy);
+    qz = V::negate_if(negate, qz);
+
+    // the three remaining components, in order
+    const simd_mask_t index0 = index < V::broadcast(0.5F); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const simd_mask_t index_le1 = index < V::broadcast(1.5F); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const simd_mask_t index_le2 = index < V::broadcast(2.5F); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const V scale = V::broadcast(S::ENCODE_SCALE);
+    const V half = V::broadcast(S::HALF);
+    const auto quantize = [&scale, &half](V v) { return V::max(V::min(V::round(v*scale), half), -half) + half; };
+    const std::array<std::array<float, V::WIDTH>, 4> lanes = V::store_lanes<4>({{
+        index,
+        quantize(V::select(index0, qx, qw)),
+        quantize(V::select(index_le1, qy, qx)),
+        quantize(V::select(index_le2, qz, qy))
+    }});
+    for (size_t ll = 0; ll < V::WIDTH; ++ll) {
+        pout[ll] = P::pack(static_cast<uint32_t>(lanes[0][ll]), {{ static_cast<uint32_t>(lanes[1][ll]), static_cast<uint32_t>(lanes[2][ll]), static_cast<uint32_t>(lanes[3][ll]) }}); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+}
+
+/*!
+Decode V::WIDTH quaternions.
+The bit unpacking is done lane by lane, the dequantization, the reconstruction of the dropped component,
+and the reordering of the components are then calculated in SIMD registers.
+*/
+template <typename P>
+void decode_block(const P* pp, Quaternion* pout)
+{
+    using S = smallest_three<P::BITS>;
+    std::array<std::array<float, V::WIDTH>, 4> lanes {};
+    for (size_t ll = 0; ll < V::WIDTH; ++ll) {
+        const std::array<uint32_t, 3> k = pp[ll].components(); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        lanes[0][ll] = static_cast<float>(pp[ll].index()); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        lanes[1][ll] = static_cast<float>(k[0]);
+        lanes[2][ll] = static_cast<float>(k[1]);
+        lanes[3][ll] = static_cast<float>(k[2]);
+    }
+    const V index = V::load(lanes[0].data());
+    const V scale = V::broadcast(S::DECODE_SCALE);
+    const V half = V::broadcast(S::HALF);
+    const V a = (V::load(lanes[1].data()) - half)*scale;
+    const V b = (V::load(lanes[2].data()) - half)*scale;
+    const V c = (V::load(lanes[3].data()) - half)*scale;
+    const V largest = V::sqrt(V::max(V::broadcast(1.0F) - a*a - b*b - c*c, V::broadcast(0.0F)));
+
+    const simd_mask_t index0 = index < V::broadcast(0.5F); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const simd_mask_t index_le1 = index < V::broadcast(1.5F); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const simd_mask_t index_le2 = index < V::broadcast(2.5F); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    V::store_interleaved4(reinterpret_cast<float*>(pout), // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        V::select(index0, largest, a),
+        V::select(index0, a, V::select(index_le1, largest, b)),
+        V::select(index_le1, b, V::select(index_le2, largest, c)),
+        V::select(index_le2, c, largest)
+    );
+}
+
+template <typename P>
+void encode_batch(std::span<const Quaternion> q, std::span<P> out)
+{
+    static_assert(sizeof(Quaternion) == 4*sizeof(float));
+    V::for_each_block(q, out, [](const Quaternion* pq, P* pout, size_t ii) { (void)ii; encode_block(pq, pout); });
+}
+
+template <typename P>
+void decode_batch(std::span<const P> p, std::span<Quaternion> out)
+{
+    V::for_each_block(p, out, [](const P* pp, Quaternion* pout, size_t ii) { (void)ii; decode_block(pp, pout); });
+}
+
+} // end namespace
+
+quaternion_packed32_t quaternion_packed32_t::encode(const Quaternion& q)
+{
+    return ::encode<quaternion_packed32_t>(q);
+}
+
+Quaternion quaternion_packed32_t::decode() const
+{
+    return ::decode(*this);
+}
+
+void quaternion_packed32_t::encode_batch(std::span<const Quaternion> q, std::span<quaternion_packed32_t> out)
+{
+    ::encode_batch(q, out);
+}
+
+void quaternion_packed32_t::decode_batch(std::span<const quaternion_packed32_t> p, std::span<Quaternion> out)
+{
+    ::decode_batch(p, out);
+}
+
+quaternion_packed48_t quaternion_packed48_t::encode(const Quaternion& q)
+{
+    return ::encode<quaternion_packed48_t>(q);
+}
+
+Quaternion quaternion_packed48_t::decode() const
+{
+    return ::decode(*this);
+}
+
+void quaternion_packed48_t::encode_batch(std::span<const Quaternion> q, std::span<quaternion_packed48_t> out)
+{
+    ::encode_batch(q, out);
+}
+
+void quaternion_packed48_t::decode_batch(std::span<const quaternion_packed48_t> p, std::span<Quaternion> out)
+{
+    ::decode_batch(p, out);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "quaternion.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+/*!
+Compressed unit quaternions, using the "smallest three" encoding, for logging and telemetry.
+
+The component with the largest magnitude is dropped, and the other three components, which are each in the range
+[-1/sqrt(2), 1/sqrt(2)], are quantized to BITS bits. The index of the dropped component is stored in 2 bits.
+Since q and -q represent the same rotation, the sign is chosen so that the dropped component is positive,
+and it is reconstructed on decoding as sqrt(1 - a*a - b*b - c*c), so decoded quaternions are normalized.
+
+The quantization is symmetric about zero, so zero components (and in particular the identity quaternion) are encoded exactly.
+The input quaternion should be normalized.
+
+Each quantized component has an error of at most e = (1/sqrt(2))/(2^BITS - 2), and the reconstructed component has
+an error of at most 3e (when all four components are 0.5), so the angle between the quaternion and its decoded value is
+at most 2*sqrt(12)*e radians, which is MAX_ANGULAR_ERROR_DEGREES.
+
+The batch functions process simd_float_t::WIDTH quaternions at a time. They give the same encodings as the single quaternion functions,
+and decoded quaternions that agree with them to within a few ulps, see simd_float.h.
+*/
+struct quaternion_packed32_t {
+public:
+    static constexpr uint32_t BITS = 10; //!< bits per component, 2 + 3*10 = 32 bits
+    static constexpr float MAX_ANGULAR_ERROR_DEGREES = 0.28F; //!< Maximum angle between a normalized quaternion and its decoded value
+    static constexpr quaternion_packed32_t pack(uint32_t index, const std::array<uint32_t, 3>& k) {
+        return quaternion_packed32_t { (index << 3*BITS) | (k[0] << 2*BITS) | (k[1] << BITS) | k[2] };
+    }
+    constexpr uint32_t index() const { return bits >> 3*BITS; } //!< index of the dropped component, in the order w, x, y, z
+    constexpr std::array<uint32_t, 3> components() const { return {{ (bits >> 2*BITS) & MASK, (bits >> BITS) & MASK, bits & MASK }}; }
+    constexpr bool operator==(const quaternion_packed32_t& p) const = default;
+public:
+    static quaternion_packed32_t encode(const Quaternion& q);
+    Quaternion decode() const;
+    static void encode_batch(std::span<const Quaternion> q, std::span<quaternion_packed32_t> out); //!< out must have at least q.size() elements
+    static void decode_batch(std::span<const quaternion_packed32_t> p, std::span<Quaternion> out); //!< out must have at least p.size() elements
+private:
+    static constexpr uint32_t MASK = (1U << BITS) - 1;
+public:
+    uint32_t bits;
+};
+
+/*!
+48-bit version of quaternion_packed32_t, with 15 bits per component.
+The index of the dropped component is held in the top bits of the first two words.
+*/
+struct quaternion_packed48_t {
+public:
+    static constexpr uint32_t BITS = 15; //!< bits per component, 2 + 3*15 = 47 bits
+    static constexpr float MAX_ANGULAR_ERROR_DEGREES = 0.0086F; //!< Maximum angle between a normalized quaternion and its decoded value
+    static constexpr quaternion_packed48_t pack(uint32_t index, const std::array<uint32_t, 3>& k) {
+        return quaternion_packed48_t {{{
+            static_cast<uint16_t>(k[0] | ((index & 1U) << BITS)),
+            static_cast<uint16_t>(k[1] | ((index >> 1U) << BITS)),
+            static_cast<uint16_t>(k[2])
+        }}};
+    }
+    constexpr uint32_t index() const { return static_cast<uint32_t>((bits[0] >> BITS) | ((bits[1] >> BITS) << 1U)); } //!< index of the dropped component, in the order w, x, y, z
+    constexpr std::array<uint32_t, 3> components() const { return {{ bits[0] & MASK, bits[1] & MASK, bits[2] & MASK }}; }
+    constexpr bool operator==(const quaternion_packed48_t& p) const = default;
+public:
+    static quaternion_packed48_t encode(const Quaternion& q);
+    Quaternion decode() const;
+    static void encode_batch(std::span<const Quaternion> q, std::span<quaternion_packed48_t> out); //!< out must have at least q.size() elements
+    static void decode_batch(std::span<const quaternion_packed48_t> p, std::span<Quaternion> out); //!< out must have at least p.size() elements
+private:
+    static constexpr uint32_t MASK = (1U << BITS) - 1;
+public:
+    std::array<uint16_t, 3> bits;
+};
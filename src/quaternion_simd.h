@@ -0,0 +1,90 @@
+#pragma once
+
+#include "quaternion.h"
+#include "simd_float4.h"
+
+
+/*!
+Quaternion held in a single 128-bit register, as lanes {w, x, y, z}, see simd_float4_t.
+
+The Hamilton product is calculated as four broadcast multiplies of shuffled copies of the right hand operand,
+with the signs applied by exclusive or, rather than sixteen scalar multiplications.
+The terms are added in the same order as in Quaternion, so the product, conjugate, and normalized quaternion agree with
+those calculated by Quaternion to within a few ulps, see simd_float.h. rotate uses the cross product form of the rotation, so is within
+float rounding (a few ulps) of, but not identical to, Quaternion::rotate.
+
+This is intended for chains of operations, such as repeated attitude updates, where the quaternion stays in a register:
+converting to and from Quaternion on every operation would lose most of the benefit.
+*/
+class alignas(16) QuaternionSimd {
+public:
+    QuaternionSimd() : _v(simd_float4_t::set(1.0F, 0.0F, 0.0F, 0.0F)) {}
+    QuaternionSimd(float w, float x, float y, float z) : _v(simd_float4_t::set(w, x, y, z)) {}
+    explicit QuaternionSimd(const Quaternion& q) : _v(simd_float4_t::set(q.w, q.x, q.y, q.z)) {}
+    explicit QuaternionSimd(simd_float4_t v) : _v(v) {}
+public:
+    float get_w() const { return _v.get<0>(); }
+    float get_x() const { return _v.get<1>(); }
+    float get_y() const { return _v.get<2>(); }
+    float get_z() const { return _v.get<3>(); }
+    simd_float4_t get_wxyz() const { return _v; }
+    Quaternion quaternion() const { alignas(16) std::array<float, 4> q; _v.store_aligned(q.data()); return Quaternion(q[0], q[1], q[2], q[3]); } // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init)
+    void set_to_identity() { _v = simd_float4_t::set(1.0F, 0.0F, 0.0F, 0.0F); }
+public:
+    // Equality operators
+    bool operator==(const QuaternionSimd& q) const { return _v == q._v; }
+    bool operator!=(const QuaternionSimd& q) const { return _v != q._v; }
+
+    // Unary operations
+    QuaternionSimd operator+() const { return *this; } //<! Unary plus
+    QuaternionSimd operator-() const { return QuaternionSimd(_v.flip_signs(simd_float4_t::broadcast(-0.0F))); } //<! Unary negation
+    QuaternionSimd conjugate() const { return QuaternionSimd(_v.flip_signs(simd_float4_t::set(0.0F, -0.0F, -0.0F, -0.0F))); } //<! Conjugate
+
+    QuaternionSimd& operator+=(const QuaternionSimd& q) { _v = _v + q._v; return *this; } //<! Addition
+    QuaternionSimd& operator-=(const QuaternionSimd& q) { _v = _v - q._v; return *this; } //<! Subtraction
+    QuaternionSimd& operator*=(float k) { _v = _v*simd_float4_t::broadcast(k); return *this; } //<! Multiplication by a scalar
+    QuaternionSimd& operator*=(const QuaternionSimd& q) { *this = *this*q; return *this; } //<! Hamilton product
+    friend QuaternionSimd operator*(float k, const QuaternionSimd& q) { return q*k; } //<! Pre-multiplication by a scalar
+
+    // Binary operations
+    QuaternionSimd operator+(const QuaternionSimd& q) const { return QuaternionSimd(_v + q._v); } //<! Addition
+    QuaternionSimd operator-(const QuaternionSimd& q) const { return QuaternionSimd(_v - q._v); } //<! Subtraction
+    QuaternionSimd operator*(float k) const { return QuaternionSimd(_v*simd_float4_t::broadcast(k)); } //<! Multiplication by a scalar
+    /*!
+    Hamilton product, calculated as
+    w*{qw, qx, qy, qz} + x*{-qx, qw, -qz, qy} + y*{-qy, qz, qw, -qx} + z*{-qz, -qy, qx, qw}
+    */
+    QuaternionSimd operator*(const QuaternionSimd& q) const {
+        const simd_float4_t& b = q._v;
+        return QuaternionSimd(
+              _v.broadcast_lane<0>()*b
+            + (_v.broadcast_lane<1>()*b.shuffle<1, 0, 3, 2>()).flip_signs(simd_float4_t::set(-0.0F, 0.0F, -0.0F, 0.0F))
+            + (_v.broadcast_lane<2>()*b.shuffle<2, 3, 0, 1>()).flip_signs(simd_float4_t::set(-0.0F, 0.0F, 0.0F, -0.0F))
+            + (_v.broadcast_lane<3>()*b.shuffle<3, 2, 1, 0>()).flip_signs(simd_float4_t::set(-0.0F, -0.0F, 0.0F, 0.0F))
+        );
+    }
+
+    /*!
+    Rotate a vector, using v' = v + w*t + u×t, where u is the imaginary part of the quaternion and t = 2*(u×v).
+    The vector is held in lanes 1 to 3, so the w lane of the cross products is zero.
+    */
+    xyz_t rotate(const xyz_t& v) const {
+        const simd_float4_t p = simd_float4_t::set(0.0F, v.x, v.y, v.z);
+        const simd_float4_t t = cross(_v, p) + cross(_v, p);
+        const simd_float4_t r = p + _v.broadcast_lane<0>()*t + cross(_v, t);
+        return xyz_t{r.get<1>(), r.get<2>(), r.get<3>()};
+    }
+public:
+    float magnitude_squared() const { return (_v*_v).sum(); } //<! The square of the magnitude
+    float magnitude() const { return sqrtf(magnitude_squared()); } //<! The magnitude
+    QuaternionSimd normalized() const { return *this*reciprocal_sqrtf(magnitude_squared()); } //<! Return the normalized quaternion
+    QuaternionSimd& normalize_in_place() { *this = normalized(); return *this; } //<! Normalize, in-place
+    float dot(const QuaternionSimd& q) const { return (_v*q._v).sum(); } //<! Dot product
+private:
+    //! Cross product of lanes 1 to 3, lane 0 of the result is a0*b0 - a0*b0, ie zero for finite values
+    static simd_float4_t cross(simd_float4_t a, simd_float4_t b) {
+        return a.shuffle<0, 2, 3, 1>()*b.shuffle<0, 3, 1, 2>() - a.shuffle<0, 3, 1, 2>()*b.shuffle<0, 2, 3, 1>();
+    }
+private:
+    simd_float4_t _v;
+};
@@ -0,0 +1,36 @@
+#include "reciprocal_sqrt.h"
+#include "simd_float.h"
+
+#include <algorithm>
+
+namespace {
+
+using V = simd_float_t;
+
+template <rsqrt_precision_e P>
+void reciprocal_sqrt_batch(std::span<const float> x, std::span<float> out)
+{
+    // the last partial block is zero padded, the (infinite) results for the padding lanes are discarded by store_partial
+    for (size_t ii = 0; ii < x.size(); ii += V::WIDTH) {
+        const size_t count = std::min(V::WIDTH, x.size() - ii);
+        V::reciprocal_sqrt<P>(V::load_partial(&x[ii], count)).store_partial(&out[ii], count);
+    }
+}
+
+} // end namespace
+
+void reciprocal_sqrt_batch(std::span<const float> x, std::span<float> out, rsqrt_precision_e precision)
+{
+    switch (precision) {
+    case rsqrt_precision_e::ESTIMATE:
+        reciprocal_sqrt_batch<rsqrt_precision_e::ESTIMATE>(x, out);
+        break;
+    case rsqrt_precision_e::ONE_ITERATION:
+        reciprocal_sqrt_batch<rsqrt_precision_e::ONE_ITERATION>(x, out);
+        break;
+    case rsqrt_precision_e::FULL:
+    default:
+        reciprocal_sqrt_batch<rsqrt_precision_e::FULL>(x, out);
+        break;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <span>
+
+/*!
+Reciprocal square root
+Implementation of [fast inverse square root](http://en.wikipedia.org/wiki/Fast_inverse_square_root)
+using [Pizer’s optimisation](https://pizer.wordpress.com/2008/10/12/fast-inverse-square-root/) and
+using `union` rather than `reinterpret_cast` to avoid breaking strict-aliasing rules.
+
+The Xtensa floating point coprocessor (used on the ESP32) has some hardware support for reciprocal square root: it has
+an RSQRT0.S (single-precision reciprocal square root initial step) instruction.
+However benchmarking shows that FAST_RECIPROCAL_SQUARE_ROOT is approximately 3.5 times faster than `1.0F / sqrtf()`
+*/
+[[gnu::always_inline]] inline float reciprocal_sqrtf(float x)
+{
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_RECIPROCAL_SQUARE_ROOT) || defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_RECIPROCAL_SQUARE_ROOT_TWO_ITERATIONS)
+    union {
+        float f;
+        int32_t i;
+    } u { .f = x };
+
+// NOLINTBEGIN(cppcoreguidelines-pro-type-union-access)
+    u.i = 0x5f1f1412 - (u.i >> 1); // Initial estimate for Newton–Raphson method
+    // single iteration gives accuracy to 4.5 significant figures
+    u.f *= 1.69000231F - 0.714158168F * x * u.f * u.f; // First iteration
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_RECIPROCAL_SQUARE_ROOT_TWO_ITERATIONS)
+    // two iterations gives floating point accuracy to within 2 significant bits, and will pass platformio's Unity TEST_ASSERT_EQUAL_FLOAT
+    u.f *= 1.5F - (0.5F * x * u.f * u.f); // Second iteration
+#endif
+
+    return u.f;
+// NOLINTEND(cppcoreguidelines-pro-type-union-access)
+#else
+    return 1.0F / sqrtf(x);
+#endif
+}
+
+/*!
+Maximum relative error of `reciprocal_sqrtf`, which depends on the FAST_RECIPROCAL_SQUARE_ROOT macros.
+Functions that normalize using `reciprocal_sqrtf` (eg xyz_t::normalized) differ from those using `rsqrt_precision_e::FULL` by up to this amount.
+*/
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_RECIPROCAL_SQUARE_ROOT_TWO_ITERATIONS)
+inline constexpr float RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR = 8.0E-7F;
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_RECIPROCAL_SQUARE_ROOT)
+inline constexpr float RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR = 6.6E-4F;
+#else
+inline constexpr float RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR = 1.2E-7F;
+#endif
+
+/*!
+Overloads of reciprocal square root for each scalar type, so that templated code can call `reciprocal_sqrt(x)`
+and each precision gets its fastest path (other scalar types provide their own overload, found by argument dependent lookup).
+The float version is `reciprocal_sqrtf`, and so is affected by the FAST_RECIPROCAL_SQUARE_ROOT macros.
+The double version is always `1.0 / sqrt()`, since double is used when precision matters more than speed.
+*/
+[[gnu::always_inline]] inline float reciprocal_sqrt(float x) { return reciprocal_sqrtf(x); }
+[[gnu::always_inline]] inline double reciprocal_sqrt(double x) { return 1.0 / std::sqrt(x); }
+
+/*!
+Precision of the batched reciprocal square root functions.
+
+Unlike `reciprocal_sqrtf` the precision is chosen at run time, rather than by a macro, since the best choice
+depends on the caller: for example re-normalizing an almost normalized quaternion each tick needs only ONE_ITERATION.
+
+1. ESTIMATE: hardware estimate only (`rsqrtps` on x86, `vrsqrteq_f32` on NEON, the integer bit-hack on scalar targets).
+2. ONE_ITERATION: the estimate refined by one Newton–Raphson iteration.
+3. FULL: `1.0F / sqrtf(x)`, identical to `reciprocal_sqrtf` (when the FAST_RECIPROCAL_SQUARE_ROOT macros are not defined).
+
+The maximum relative errors for each SIMD backend are given by simd_float_t::RSQRT_ESTIMATE_MAX_RELATIVE_ERROR and
+simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR.
+*/
+enum class rsqrt_precision_e { ESTIMATE, ONE_ITERATION, FULL };
+
+/*!
+Batched reciprocal square root, out[i] = 1/sqrt(x[i]).
+x must be positive (the result for zero depends on the precision and the SIMD backend), out must have at least as many elements as x, and may be the same span as x.
+*/
+void reciprocal_sqrt_batch(std::span<const float> x, std::span<float> out, rsqrt_precision_e precision = rsqrt_precision_e::FULL);
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "matrix3x3.h"
+
+#include <concepts>
+#include <span>
+
+/*!
+Rotation matrix, ie an orthonormal 3x3 matrix with determinant 1, templated on the scalar type T,
+see RotationMatrix3x3 (float) and RotationMatrix3x3d (double).
+
+Since the matrix is orthonormal its inverse is its transpose, so `inverse()` and rotation by the inverse are O(1)
+rather than going through the cofactors and determinant of Matrix3x3T::inverse.
+The operations that create a RotationMatrix3x3T preserve orthonormality (up to rounding),
+and for direction cosine matrices (DCMs) that are integrated from gyro readings there are two re-orthonormalization steps:
+
+1. `renormalize_in_place`, the first-order step of Premerlani and Bizard, "Direction Cosine Matrix IMU: Theory",
+which shares the orthogonality error equally between the first two rows and uses a Taylor expansion rather than a square root
+to normalize. It is intended to be called every integration step, when the error is small.
+2. `orthonormalize_in_place`, Gram-Schmidt orthonormalization of the rows, which gives a rotation matrix (to within rounding)
+for any non-singular matrix and is used when constructing from a Matrix3x3T.
+It normalizes using 1/sqrt, so it does not depend on the FAST_RECIPROCAL_SQUARE_ROOT macros.
+*/
+template <typename T>
+class RotationMatrix3x3T {
+public:
+    [[gnu::always_inline]] constexpr RotationMatrix3x3T() : _m(T(1)) {} //<! Identity rotation
+    //! Create from a unit quaternion, see Matrix3x3T(const QuaternionT&)
+    [[gnu::always_inline]] constexpr explicit RotationMatrix3x3T(const QuaternionT<T>& q) : _m(q) {}
+    //! Create from m, which is orthonormalized using Gram-Schmidt, so m need only be approximately a rotation
+    explicit RotationMatrix3x3T(const Matrix3x3T<T>& m) : _m(m) { orthonormalize_in_place(); }
+    //! Create from m without orthonormalizing, m must already be a rotation matrix, eg from Matrix3x3T::from_euler_angles_radians_constexpr
+    [[gnu::always_inline]] static constexpr RotationMatrix3x3T from_orthonormal(const Matrix3x3T<T>& m) { RotationMatrix3x3T ret; ret._m = m; return ret; }
+    static RotationMatrix3x3T from_euler_angles_radians(T roll_radians, T pitch_radians, T yaw_radians) { return from_orthonormal(Matrix3x3T<T>::from_euler_angles_radians(roll_radians, pitch_radians, yaw_radians)); }
+    static RotationMatrix3x3T from_euler_angles_degrees(T roll_degrees, T pitch_degrees, T yaw_degrees) { return from_orthonormal(Matrix3x3T<T>::from_euler_angles_degrees(roll_degrees, pitch_degrees, yaw_degrees)); }
+    [[gnu::always_inline]] constexpr const Matrix3x3T<T>& matrix() const { return _m; } //<! The rotation as a full matrix
+    QuaternionT<T> quaternion() const { return _m.quaternion(); }
+public:
+    // Equality operators
+    [[gnu::always_inline]] constexpr bool operator==(const RotationMatrix3x3T& r) const { return _m == r._m; } //<! Equality operator
+    [[gnu::always_inline]] constexpr bool operator!=(const RotationMatrix3x3T& r) const { return _m != r._m; } //<! Inequality operator
+
+    // Index operator, there is no non-const version, since setting individual elements would break orthonormality
+    [[gnu::always_inline]] constexpr T operator[](size_t pos) const { return _m[pos]; } //<! Index operator
+
+    [[gnu::always_inline]] constexpr RotationMatrix3x3T transpose() const { return from_orthonormal(_m.transpose()); } //<! Returns transpose of matrix, which is its inverse
+    [[gnu::always_inline]] constexpr RotationMatrix3x3T inverse() const { return transpose(); } //<! Returns inverse of matrix, that is its transpose
+    [[gnu::always_inline]] constexpr void invert_in_place() { _m.transpose_in_place(); } //<! Invert matrix in-place, that is transpose it
+
+    // Composition of rotations
+    [[gnu::always_inline]] constexpr RotationMatrix3x3T operator*(const RotationMatrix3x3T& r) const { return from_orthonormal(_m*r._m); } //<! Composition, rotate by r then by this
+    [[gnu::always_inline]] constexpr RotationMatrix3x3T operator*=(const RotationMatrix3x3T& r) { _m *= r._m; return *this; } //<! Composition, in-place
+    [[gnu::always_inline]] constexpr RotationMatrix3x3T transpose_multiply(const RotationMatrix3x3T& r) const { return from_orthonormal(_m.transpose_multiply(r._m)); } //<! Returns this^T*r, ie the rotation from this to r
+    [[gnu::always_inline]] constexpr Matrix3x3T<T> operator*(const Matrix3x3T<T>& m) const { return _m*m; } //<! Multiplication of a full matrix
+    [[gnu::always_inline]] friend constexpr Matrix3x3T<T> operator*(const Matrix3x3T<T>& m, const RotationMatrix3x3T& r) { return m*r._m; } //<! Post-multiplication of a full matrix
+
+    // Rotation of vectors
+    [[gnu::always_inline]] constexpr xyz_type<T> operator*(const xyz_type<T>& v) const { return _m*v; } //<! Rotate a vector
+    //! Rotate a vector by the inverse rotation, that is multiply by the transpose, without forming the transpose
+    [[gnu::always_inline]] constexpr xyz_type<T> inverse_rotate(const xyz_type<T>& v) const {
+        return xyz_type<T> { _m[0]*v.x + _m[3]*v.y + _m[6]*v.z, _m[1]*v.x + _m[4]*v.y + _m[7]*v.z, _m[2]*v.x + _m[5]*v.y + _m[8]*v.z };
+    }
+    void rotate(std::span<const xyz_type<T>> v, std::span<xyz_type<T>> out) const requires std::same_as<T, float> { _m.multiply(v, out); } //!< out[i] = (*this)*v[i], out may be the same array as v
+    void inverse_rotate(std::span<const xyz_type<T>> v, std::span<xyz_type<T>> out) const requires std::same_as<T, float> { _m.transpose().multiply(v, out); } //!< out[i] = inverse_rotate(v[i]), out may be the same array as v
+
+    //! Squared Frobenius norm of R*R^T - I, which is zero for an exact rotation matrix
+    [[gnu::always_inline]] constexpr T orthonormality_error() const {
+        const T xx = _m[0]*_m[0] + _m[1]*_m[1] + _m[2]*_m[2] - T(1);
+        const T yy = _m[3]*_m[3] + _m[4]*_m[4] + _m[5]*_m[5] - T(1);
+        const T zz = _m[6]*_m[6] + _m[7]*_m[7] + _m[8]*_m[8] - T(1);
+        const T xy = _m[0]*_m[3] + _m[1]*_m[4] + _m[2]*_m[5];
+        const T xz = _m[0]*_m[6] + _m[1]*_m[7] + _m[2]*_m[8];
+        const T yz = _m[3]*_m[6] + _m[4]*_m[7] + _m[5]*_m[8];
+        return xx*xx + yy*yy + zz*zz + T(2)*(xy*xy + xz*xz + yz*yz);
+    }
+
+    void orthonormalize_in_place(); //!< Gram-Schmidt orthonormalization of the rows
+    void renormalize_in_place(); //!< First-order re-orthonormalization, for matrices that are already close to orthonormal
+    //! Integrate the body frame angular velocity over dt, that is R = R*(I + [omega*dt]x), followed by renormalize_in_place, for DCM attitude estimation
+    void integrate(const xyz_type<T>& angular_velocity, T dt);
+
+    // Batched versions, implemented in vector_quaternion_matrix.cpp as plain loops over the single matrix functions,
+    // they are provided for symmetry with the other batch functions and are not vectorized
+    static void orthonormalize_batch(std::span<RotationMatrix3x3T> r); //!< Gram-Schmidt orthonormalization of each matrix, in-place
+    static void renormalize_batch(std::span<RotationMatrix3x3T> r); //!< First-order re-orthonormalization of each matrix, in-place
+    //! Integrate angular_velocity[i] over dt for each r[i], in-place, angular_velocity must have at least r.size() elements
+    static void integrate_batch(std::span<RotationMatrix3x3T> r, std::span<const xyz_type<T>> angular_velocity, T dt);
+protected:
+    Matrix3x3T<T> _m;
+};
+
+using RotationMatrix3x3 = RotationMatrix3x3T<float>;
+using RotationMatrix3x3d = RotationMatrix3x3T<double>;
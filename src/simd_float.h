@@ -0,0 +1,566 @@
+#pragma once
+
+#include "reciprocal_sqrt.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+
+/*!
+Thin wrapper over the widest float SIMD register available on the target, used to write batched kernels once
+for all architectures:
+
+1. AVX2 (x86, when compiled with `-mavx2`): 8 lanes.
+2. SSE2 (all x86-64 targets): 4 lanes.
+3. NEON (AArch64): 4 lanes.
+4. Otherwise (eg microcontrollers): scalar, 1 lane.
+
+Define `LIBRARY_VECTOR_QUATERNION_MATRIX_NO_SIMD` to force the scalar implementation.
+
+Note that no fused multiply-add is used, so that results are the same as the equivalent scalar expression
+(given the compiler does not itself contract the scalar expression).
+
+Fused multiply-add contraction: the batched, SIMD, fused, and lazily evaluated kernels in this library use the same operation
+order as the functions they replace, and are documented as agreeing with them "to within a few ulps". Evaluated as written the
+results are identical, but where the target has fused multiply-add instructions (eg with `-mfma`, or on AArch64) the compiler
+may contract a multiply followed by an add into a single fused multiply-add, which omits the rounding of the product. It makes
+this choice separately for each expression, so the two forms may then differ in the last bit or two of each operation.
+Compile with `-ffp-contract=off` to make them identical.
+*/
+#if !defined(LIBRARY_VECTOR_QUATERNION_MATRIX_NO_SIMD)
+#if defined(__AVX2__)
+#define LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#define LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__)) && defined(__aarch64__)
+#define LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+
+/*!
+Lane mask, the result of a comparison of two simd_float_t values.
+*/
+struct simd_mask_t {
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_AVX2)
+    __m256 m;
+    friend simd_mask_t operator&(simd_mask_t a, simd_mask_t b) { return simd_mask_t{_mm256_and_ps(a.m, b.m)}; }
+    friend simd_mask_t operator|(simd_mask_t a, simd_mask_t b) { return simd_mask_t{_mm256_or_ps(a.m, b.m)}; }
+    simd_mask_t operator!() const { return simd_mask_t{_mm256_xor_ps(m, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; }
+    uint32_t bits() const { return static_cast<uint32_t>(_mm256_movemask_ps(m)); } //!< One bit per lane, lane 0 in the least significant bit
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2)
+    __m128 m;
+    friend simd_mask_t operator&(simd_mask_t a, simd_mask_t b) { return simd_mask_t{_mm_and_ps(a.m, b.m)}; }
+    friend simd_mask_t operator|(simd_mask_t a, simd_mask_t b) { return simd_mask_t{_mm_or_ps(a.m, b.m)}; }
+    simd_mask_t operator!() const { return simd_mask_t{_mm_xor_ps(m, _mm_castsi128_ps(_mm_set1_epi32(-1)))}; }
+    uint32_t bits() const { return static_cast<uint32_t>(_mm_movemask_ps(m)); } //!< One bit per lane, lane 0 in the least significant bit
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+    uint32x4_t m;
+    friend simd_mask_t operator&(simd_mask_t a, simd_mask_t b) { return simd_mask_t{vandq_u32(a.m, b.m)}; }
+    friend simd_mask_t operator|(simd_mask_t a, simd_mask_t b) { return simd_mask_t{vorrq_u32(a.m, b.m)}; }
+    simd_mask_t operator!() const { return simd_mask_t{vmvnq_u32(m)}; }
+    uint32_t bits() const {
+        static const uint32x4_t weights = { 1, 2, 4, 8 };
+        return vaddvq_u32(vandq_u32(m, weights));
+    }
+#else
+    bool m;
+    friend simd_mask_t operator&(simd_mask_t a, simd_mask_t b) { return simd_mask_t{a.m && b.m}; }
+    friend simd_mask_t operator|(simd_mask_t a, simd_mask_t b) { return simd_mask_t{a.m || b.m}; }
+    simd_mask_t operator!() const { return simd_mask_t{!m}; }
+    uint32_t bits() const { return m ? 1U : 0U; }
+#endif
+};
+
+
+struct simd_float_t {
+public:
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_AVX2)
+    static constexpr size_t WIDTH = 8;
+    static constexpr size_t ALIGNMENT = 32;
+    __m256 v;
+
+    static simd_float_t load(const float* p) { return simd_float_t{_mm256_loadu_ps(p)}; } //!< Unaligned load
+    static simd_float_t load_aligned(const float* p) { return simd_float_t{_mm256_load_ps(p)}; } //!< Aligned load
+    static simd_float_t broadcast(float k) { return simd_float_t{_mm256_set1_ps(k)}; } //!< Set all lanes to k
+    void store(float* p) const { _mm256_storeu_ps(p, v); } //!< Unaligned store
+    void store_aligned(float* p) const { _mm256_store_ps(p, v); } //!< Aligned store
+
+    simd_float_t operator-() const { return simd_float_t{_mm256_xor_ps(v, _mm256_set1_ps(-0.0F))}; }
+    friend simd_float_t operator+(simd_float_t a, simd_float_t b) { return simd_float_t{_mm256_add_ps(a.v, b.v)}; }
+    friend simd_float_t operator-(simd_float_t a, simd_float_t b) { return simd_float_t{_mm256_sub_ps(a.v, b.v)}; }
+    friend simd_float_t operator*(simd_float_t a, simd_float_t b) { return simd_float_t{_mm256_mul_ps(a.v, b.v)}; }
+    friend simd_float_t operator/(simd_float_t a, simd_float_t b) { return simd_float_t{_mm256_div_ps(a.v, b.v)}; }
+
+    friend simd_mask_t operator<(simd_float_t a, simd_float_t b) { return simd_mask_t{_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+    friend simd_mask_t operator<=(simd_float_t a, simd_float_t b) { return simd_mask_t{_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)}; }
+    friend simd_mask_t operator>(simd_float_t a, simd_float_t b) { return simd_mask_t{_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+    friend simd_mask_t operator>=(simd_float_t a, simd_float_t b) { return simd_mask_t{_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+
+    static simd_float_t sqrt(simd_float_t a) { return simd_float_t{_mm256_sqrt_ps(a.v)}; }
+    static simd_float_t rsqrt_estimate(simd_float_t a) { return simd_float_t{_mm256_rsqrt_ps(a.v)}; } //!< Approximate 1/sqrt(a)
+    static constexpr float RSQRT_ESTIMATE_MAX_RELATIVE_ERROR = 3.7E-4F; // 1.5*2^-12, as documented by Intel
+    static constexpr float RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR = 5.0E-7F;
+    static simd_float_t abs(simd_float_t a) { return simd_float_t{_mm256_andnot_ps(_mm256_set1_ps(-0.0F), a.v)}; }
+    static simd_float_t min(simd_float_t a, simd_float_t b) { return simd_float_t{_mm256_min_ps(a.v, b.v)}; } //!< a < b ? a : b
+    static simd_float_t max(simd_float_t a, simd_float_t b) { return simd_float_t{_mm256_max_ps(a.v, b.v)}; } //!< a > b ? a : b
+    static simd_float_t select(simd_mask_t mask, simd_float_t a, simd_float_t b) { return simd_float_t{_mm256_blendv_ps(b.v, a.v, mask.m)}; } //!< mask ? a : b
+    static simd_float_t negate_if(simd_mask_t mask, simd_float_t a) { return simd_float_t{_mm256_xor_ps(a.v, _mm256_and_ps(mask.m, _mm256_set1_ps(-0.0F)))}; } //!< mask ? -a : a
+    //! Round to nearest integer, with halfway cases rounded away from zero, as `roundf`
+    static simd_float_t round(simd_float_t a) {
+        const __m256 sign = _mm256_and_ps(a.v, _mm256_set1_ps(-0.0F));
+        const __m256 t = _mm256_round_ps(a.v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        const __m256 half = _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0F), _mm256_sub_ps(a.v, t)), _mm256_set1_ps(0.5F), _CMP_GE_OQ);
+        // or-ing in the sign ensures a zero result has the sign of a, as roundf does
+        return simd_float_t{_mm256_or_ps(_mm256_add_ps(t, _mm256_and_ps(half, _mm256_or_ps(_mm256_set1_ps(1.0F), sign))), sign)};
+    }
+    //! Lanes where the given bit of the integral value is set, integral must contain integers in the range of int32_t
+    static simd_mask_t bit_set(simd_float_t integral, int32_t bit) {
+        const __m256i b = _mm256_set1_epi32(bit);
+        return simd_mask_t{_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_cvttps_epi32(integral.v), b), b))};
+    }
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2)
+    static constexpr size_t WIDTH = 4;
+    static constexpr size_t ALIGNMENT = 16;
+    __m128 v;
+
+    static simd_float_t load(const float* p) { return simd_float_t{_mm_loadu_ps(p)}; } //!< Unaligned load
+    static simd_float_t load_aligned(const float* p) { return simd_float_t{_mm_load_ps(p)}; } //!< Aligned load
+    static simd_float_t broadcast(float k) { return simd_float_t{_mm_set1_ps(k)}; } //!< Set all lanes to k
+    void store(float* p) const { _mm_storeu_ps(p, v); } //!< Unaligned store
+    void store_aligned(float* p) const { _mm_store_ps(p, v); } //!< Aligned store
+
+    simd_float_t operator-() const { return simd_float_t{_mm_xor_ps(v, _mm_set1_ps(-0.0F))}; }
+    friend simd_float_t operator+(simd_float_t a, simd_float_t b) { return simd_float_t{_mm_add_ps(a.v, b.v)}; }
+    friend simd_float_t operator-(simd_float_t a, simd_float_t b) { return simd_float_t{_mm_sub_ps(a.v, b.v)}; }
+    friend simd_float_t operator*(simd_float_t a, simd_float_t b) { return simd_float_t{_mm_mul_ps(a.v, b.v)}; }
+    friend simd_float_t operator/(simd_float_t a, simd_float_t b) { return simd_float_t{_mm_div_ps(a.v, b.v)}; }
+
+    friend simd_mask_t operator<(simd_float_t a, simd_float_t b) { return simd_mask_t{_mm_cmplt_ps(a.v, b.v)}; }
+    friend simd_mask_t operator<=(simd_float_t a, simd_float_t b) { return simd_mask_t{_mm_cmple_ps(a.v, b.v)}; }
+    friend simd_mask_t operator>(simd_float_t a, simd_float_t b) { return simd_mask_t{_mm_cmpgt_ps(a.v, b.v)}; }
+    friend simd_mask_t operator>=(simd_float_t a, simd_float_t b) { return simd_mask_t{_mm_cmpge_ps(a.v, b.v)}; }
+
+    static simd_float_t sqrt(simd_float_t a) { return simd_float_t{_mm_sqrt_ps(a.v)}; }
+    static simd_float_t rsqrt_estimate(simd_float_t a) { return simd_float_t{_mm_rsqrt_ps(a.v)}; } //!< Approximate 1/sqrt(a)
+    static constexpr float RSQRT_ESTIMATE_MAX_RELATIVE_ERROR = 3.7E-4F; // 1.5*2^-12, as documented by Intel
+    static constexpr float RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR = 5.0E-7F;
+    static simd_float_t abs(simd_float_t a) { return simd_float_t{_mm_andnot_ps(_mm_set1_ps(-0.0F), a.v)}; }
+    static simd_float_t min(simd_float_t a, simd_float_t b) { return simd_float_t{_mm_min_ps(a.v, b.v)}; } //!< a < b ? a : b
+    static simd_float_t max(simd_float_t a, simd_float_t b) { return simd_float_t{_mm_max_ps(a.v, b.v)}; } //!< a > b ? a : b
+    static simd_float_t select(simd_mask_t mask, simd_float_t a, simd_float_t b) { return simd_float_t{_mm_or_ps(_mm_and_ps(mask.m, a.v), _mm_andnot_ps(mask.m, b.v))}; } //!< mask ? a : b
+    static simd_float_t negate_if(simd_mask_t mask, simd_float_t a) { return simd_float_t{_mm_xor_ps(a.v, _mm_and_ps(mask.m, _mm_set1_ps(-0.0F)))}; } //!< mask ? -a : a
+    //! Round to nearest integer, with halfway cases rounded away from zero, as `roundf`
+    static simd_float_t round(simd_float_t a) {
+        const __m128 sign = _mm_and_ps(a.v, _mm_set1_ps(-0.0F));
+        // SSE2 has no round instruction, so truncate by converting to integer and back,
+        // values with magnitude >= 2^23 are already integers, and so are passed through unchanged
+        const __m128 big = _mm_cmpge_ps(_mm_andnot_ps(_mm_set1_ps(-0.0F), a.v), _mm_set1_ps(8388608.0F));
+        __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+        t = _mm_or_ps(_mm_and_ps(big, a.v), _mm_andnot_ps(big, t));
+        const __m128 half = _mm_cmpge_ps(_mm_andnot_ps(_mm_set1_ps(-0.0F), _mm_sub_ps(a.v, t)), _mm_set1_ps(0.5F));
+        // or-ing in the sign ensures a zero result has the sign of a, as roundf does
+        return simd_float_t{_mm_or_ps(_mm_add_ps(t, _mm_and_ps(half, _mm_or_ps(_mm_set1_ps(1.0F), sign))), sign)};
+    }
+    //! Lanes where the given bit of the integral value is set, integral must contain integers in the range of int32_t
+    static simd_mask_t bit_set(simd_float_t integral, int32_t bit) {
+        const __m128i b = _mm_set1_epi32(bit);
+        return simd_mask_t{_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_cvttps_epi32(integral.v), b), b))};
+    }
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+    static constexpr size_t WIDTH = 4;
+    static constexpr size_t ALIGNMENT = 16;
+    float32x4_t v;
+
+    static simd_float_t load(const float* p) { return simd_float_t{vld1q_f32(p)}; } //!< Unaligned load
+    static simd_float_t load_aligned(const float* p) { return simd_float_t{vld1q_f32(p)}; } //!< Aligned load
+    static simd_float_t broadcast(float k) { return simd_float_t{vdupq_n_f32(k)}; } //!< Set all lanes to k
+    void store(float* p) const { vst1q_f32(p, v); } //!< Unaligned store
+    void store_aligned(float* p) const { vst1q_f32(p, v); } //!< Aligned store
+
+    simd_float_t operator-() const { return simd_float_t{vnegq_f32(v)}; }
+    friend simd_float_t operator+(simd_float_t a, simd_float_t b) { return simd_float_t{vaddq_f32(a.v, b.v)}; }
+    friend simd_float_t operator-(simd_float_t a, simd_float_t b) { return simd_float_t{vsubq_f32(a.v, b.v)}; }
+    friend simd_float_t operator*(simd_float_t a, simd_float_t b) { return simd_float_t{vmulq_f32(a.v, b.v)}; }
+    friend simd_float_t operator/(simd_float_t a, simd_float_t b) { return simd_float_t{vdivq_f32(a.v, b.v)}; }
+
+    friend simd_mask_t operator<(simd_float_t a, simd_float_t b) { return simd_mask_t{vcltq_f32(a.v, b.v)}; }
+    friend simd_mask_t operator<=(simd_float_t a, simd_float_t b) { return simd_mask_t{vcleq_f32(a.v, b.v)}; }
+    friend simd_mask_t operator>(simd_float_t a, simd_float_t b) { return simd_mask_t{vcgtq_f32(a.v, b.v)}; }
+    friend simd_mask_t operator>=(simd_float_t a, simd_float_t b) { return simd_mask_t{vcgeq_f32(a.v, b.v)}; }
+
+    static simd_float_t sqrt(simd_float_t a) { return simd_float_t{vsqrtq_f32(a.v)}; }
+    static simd_float_t rsqrt_estimate(simd_float_t a) { return simd_float_t{vrsqrteq_f32(a.v)}; } //!< Approximate 1/sqrt(a)
+    static constexpr float RSQRT_ESTIMATE_MAX_RELATIVE_ERROR = 4.0E-3F; // vrsqrteq_f32 gives about 8 bits
+    static constexpr float RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR = 3.0E-5F;
+    static simd_float_t abs(simd_float_t a) { return simd_float_t{vabsq_f32(a.v)}; }
+    static simd_float_t min(simd_float_t a, simd_float_t b) { return select(a < b, a, b); } //!< a < b ? a : b
+    static simd_float_t max(simd_float_t a, simd_float_t b) { return select(a > b, a, b); } //!< a > b ? a : b
+    static simd_float_t select(simd_mask_t mask, simd_float_t a, simd_float_t b) { return simd_float_t{vbslq_f32(mask.m, a.v, b.v)}; } //!< mask ? a : b
+    static simd_float_t negate_if(simd_mask_t mask, simd_float_t a) { return simd_float_t{vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a.v), vandq_u32(mask.m, vdupq_n_u32(0x80000000U))))}; } //!< mask ? -a : a
+    static simd_float_t round(simd_float_t a) { return simd_float_t{vrndaq_f32(a.v)}; } //!< Round to nearest integer, with halfway cases rounded away from zero, as `roundf`
+    //! Lanes where the given bit of the integral value is set, integral must contain integers in the range of int32_t
+    static simd_mask_t bit_set(simd_float_t integral, int32_t bit) { return simd_mask_t{vtstq_s32(vcvtq_s32_f32(integral.v), vdupq_n_s32(bit))}; }
+#else
+    static constexpr size_t WIDTH = 1;
+    static constexpr size_t ALIGNMENT = alignof(float);
+    float v;
+
+    static simd_float_t load(const float* p) { return simd_float_t{*p}; } //!< Unaligned load
+    static simd_float_t load_aligned(const float* p) { return simd_float_t{*p}; } //!< Aligned load
+    static simd_float_t broadcast(float k) { return simd_float_t{k}; } //!< Set all lanes to k
+    void store(float* p) const { *p = v; } //!< Unaligned store
+    void store_aligned(float* p) const { *p = v; } //!< Aligned store
+
+    simd_float_t operator-() const { return simd_float_t{-v}; }
+    friend simd_float_t operator+(simd_float_t a, simd_float_t b) { return simd_float_t{a.v + b.v}; }
+    friend simd_float_t operator-(simd_float_t a, simd_float_t b) { return simd_float_t{a.v - b.v}; }
+    friend simd_float_t operator*(simd_float_t a, simd_float_t b) { return simd_float_t{a.v * b.v}; }
+    friend simd_float_t operator/(simd_float_t a, simd_float_t b) { return simd_float_t{a.v / b.v}; }
+
+    friend simd_mask_t operator<(simd_float_t a, simd_float_t b) { return simd_mask_t{a.v < b.v}; }
+    friend simd_mask_t operator<=(simd_float_t a, simd_float_t b) { return simd_mask_t{a.v <= b.v}; }
+    friend simd_mask_t operator>(simd_float_t a, simd_float_t b) { return simd_mask_t{a.v > b.v}; }
+    friend simd_mask_t operator>=(simd_float_t a, simd_float_t b) { return simd_mask_t{a.v >= b.v}; }
+
+    static simd_float_t sqrt(simd_float_t a) { return simd_float_t{sqrtf(a.v)}; }
+    /*!
+    Approximate 1/sqrt(a), using the integer bit-hack with the original 0x5F3759DF constant, which is the more accurate estimate on its own.
+    */
+    static simd_float_t rsqrt_estimate(simd_float_t a) { return simd_float_t{std::bit_cast<float>(0x5F3759DF - (std::bit_cast<int32_t>(a.v) >> 1))}; }
+    /*!
+    One iteration reciprocal square root, as reciprocal_sqrtf with LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_RECIPROCAL_SQUARE_ROOT defined.
+    Its 0x5f1f1412 estimate is tuned together with its refinement coefficients, so after one iteration it is about three times
+    more accurate than 0x5F3759DF followed by the standard Newton–Raphson iteration.
+    */
+    static simd_float_t rsqrt_one_iteration(simd_float_t a) {
+        const float y = std::bit_cast<float>(0x5f1f1412 - (std::bit_cast<int32_t>(a.v) >> 1));
+        return simd_float_t{y * (1.69000231F - 0.714158168F*a.v*y*y)}; // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    }
+    static constexpr float RSQRT_ESTIMATE_MAX_RELATIVE_ERROR = 3.5E-2F;
+    static constexpr float RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR = 6.6E-4F;
+    static simd_float_t abs(simd_float_t a) { return simd_float_t{fabsf(a.v)}; }
+    static simd_float_t min(simd_float_t a, simd_float_t b) { return simd_float_t{a.v < b.v ? a.v : b.v}; } //!< a < b ? a : b
+    static simd_float_t max(simd_float_t a, simd_float_t b) { return simd_float_t{a.v > b.v ? a.v : b.v}; } //!< a > b ? a : b
+    static simd_float_t select(simd_mask_t mask, simd_float_t a, simd_float_t b) { return simd_float_t{mask.m ? a.v : b.v}; } //!< mask ? a : b
+    static simd_float_t negate_if(simd_mask_t mask, simd_float_t a) { return simd_float_t{mask.m ? -a.v : a.v}; } //!< mask ? -a : a
+    static simd_float_t round(simd_float_t a) { return simd_float_t{roundf(a.v)}; } //!< Round to nearest integer, with halfway cases rounded away from zero, as `roundf`
+    //! Lanes where the given bit of the integral value is set, integral must contain integers in the range of int32_t
+    static simd_mask_t bit_set(simd_float_t integral, int32_t bit) { return simd_mask_t{(static_cast<int32_t>(integral.v) & bit) != 0}; }
+#endif
+public:
+    static simd_float_t zero() { return broadcast(0.0F); }
+    /*!
+    Reciprocal square root, with precision P, see rsqrt_precision_e.
+    On the SIMD backends one Newton–Raphson iteration is y*(1.5 - 0.5*a*y*y), which roughly doubles the number of correct bits of the estimate,
+    the scalar backend uses the tuned refinement of reciprocal_sqrtf instead.
+    */
+    template <rsqrt_precision_e P>
+    static simd_float_t reciprocal_sqrt(simd_float_t a) {
+        if constexpr (P == rsqrt_precision_e::FULL) {
+            return broadcast(1.0F) / sqrt(a);
+        } else if constexpr (P == rsqrt_precision_e::ONE_ITERATION) {
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_AVX2) || defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2) || defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+            const simd_float_t y = rsqrt_estimate(a);
+            return y * (broadcast(1.5F) - broadcast(0.5F)*a*y*y); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+#else
+            return rsqrt_one_iteration(a);
+#endif
+        } else {
+            return rsqrt_estimate(a);
+        }
+    }
+    /*!
+    Load WIDTH interleaved pairs {a, b} (eg an array of xy_t) from 2*WIDTH floats, de-interleaving them into two registers.
+    */
+    static void load_interleaved2(const float* p, simd_float_t& a, simd_float_t& b) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2)
+        const __m128 r0 = _mm_loadu_ps(p);      // a0 b0 a1 b1
+        const __m128 r1 = _mm_loadu_ps(p + 4);  // a2 b2 a3 b3
+        a.v = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(2,0,2,0));
+        b.v = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(3,1,3,1));
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+        const float32x4x2_t t = vld2q_f32(p);
+        a.v = t.val[0];
+        b.v = t.val[1];
+#else
+        alignas(ALIGNMENT) float ta[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tb[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        for (size_t ii = 0; ii < WIDTH; ++ii) {
+            ta[ii] = p[2*ii];
+            tb[ii] = p[2*ii + 1];
+        }
+        a = load_aligned(&ta[0]);
+        b = load_aligned(&tb[0]);
+#endif
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    /*!
+    Interleave two registers and store them as WIDTH pairs {a, b} (eg an array of xy_t) in 2*WIDTH floats.
+    */
+    static void store_interleaved2(float* p, simd_float_t a, simd_float_t b) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2)
+        _mm_storeu_ps(p,     _mm_unpacklo_ps(a.v, b.v)); // a0 b0 a1 b1
+        _mm_storeu_ps(p + 4, _mm_unpackhi_ps(a.v, b.v)); // a2 b2 a3 b3
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+        const float32x4x2_t t = {{ a.v, b.v }};
+        vst2q_f32(p, t);
+#else
+        alignas(ALIGNMENT) float ta[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tb[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        a.store_aligned(&ta[0]);
+        b.store_aligned(&tb[0]);
+        for (size_t ii = 0; ii < WIDTH; ++ii) {
+            p[2*ii] = ta[ii];
+            p[2*ii + 1] = tb[ii];
+        }
+#endif
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    /*!
+    Load WIDTH interleaved triples {a, b, c} (eg an array of xyz_t) from 3*WIDTH floats, de-interleaving them into three registers.
+    */
+    static void load_interleaved3(const float* p, simd_float_t& a, simd_float_t& b, simd_float_t& c) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2)
+        const __m128 r0 = _mm_loadu_ps(p);      // a0 b0 c0 a1
+        const __m128 r1 = _mm_loadu_ps(p + 4);  // b1 c1 a2 b2
+        const __m128 r2 = _mm_loadu_ps(p + 8);  // c2 a3 b3 c3
+        const __m128 t0 = _mm_shuffle_ps(r1, r2, _MM_SHUFFLE(2,1,3,2)); // a2 b2 a3 b3
+        const __m128 t1 = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(1,0,2,1)); // b0 c0 b1 c1
+        a.v = _mm_shuffle_ps(r0, t0, _MM_SHUFFLE(2,0,3,0));
+        b.v = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3,1,2,0));
+        c.v = _mm_shuffle_ps(t1, r2, _MM_SHUFFLE(3,0,3,1));
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+        const float32x4x3_t t = vld3q_f32(p);
+        a.v = t.val[0];
+        b.v = t.val[1];
+        c.v = t.val[2];
+#else
+        alignas(ALIGNMENT) float ta[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tb[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tc[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        for (size_t ii = 0; ii < WIDTH; ++ii) {
+            ta[ii] = p[3*ii];
+            tb[ii] = p[3*ii + 1];
+            tc[ii] = p[3*ii + 2];
+        }
+        a = load_aligned(&ta[0]);
+        b = load_aligned(&tb[0]);
+        c = load_aligned(&tc[0]);
+#endif
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    /*!
+    Interleave three registers and store them as WIDTH triples {a, b, c} (eg an array of xyz_t) in 3*WIDTH floats.
+    */
+    static void store_interleaved3(float* p, simd_float_t a, simd_float_t b, simd_float_t c) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2)
+        const __m128 ab_lo = _mm_unpacklo_ps(a.v, b.v);                     // a0 b0 a1 b1
+        const __m128 ab_hi = _mm_unpackhi_ps(a.v, b.v);                     // a2 b2 a3 b3
+        const __m128 t0 = _mm_shuffle_ps(c.v, a.v, _MM_SHUFFLE(1,1,0,0));   // c0 c0 a1 a1
+        const __m128 t1 = _mm_shuffle_ps(ab_lo, c.v, _MM_SHUFFLE(1,1,3,3)); // b1 b1 c1 c1
+        const __m128 t2 = _mm_shuffle_ps(c.v, a.v, _MM_SHUFFLE(3,3,2,2));   // c2 c2 a3 a3
+        const __m128 t3 = _mm_shuffle_ps(b.v, c.v, _MM_SHUFFLE(3,3,3,3));   // b3 b3 c3 c3
+        _mm_storeu_ps(p,     _mm_shuffle_ps(ab_lo, t0, _MM_SHUFFLE(2,0,1,0))); // a0 b0 c0 a1
+        _mm_storeu_ps(p + 4, _mm_shuffle_ps(t1, ab_hi, _MM_SHUFFLE(1,0,2,0))); // b1 c1 a2 b2
+        _mm_storeu_ps(p + 8, _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(2,0,2,0)));    // c2 a3 b3 c3
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+        const float32x4x3_t t = {{ a.v, b.v, c.v }};
+        vst3q_f32(p, t);
+#else
+        alignas(ALIGNMENT) float ta[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tb[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tc[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        a.store_aligned(&ta[0]);
+        b.store_aligned(&tb[0]);
+        c.store_aligned(&tc[0]);
+        for (size_t ii = 0; ii < WIDTH; ++ii) {
+            p[3*ii] = ta[ii];
+            p[3*ii + 1] = tb[ii];
+            p[3*ii + 2] = tc[ii];
+        }
+#endif
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    /*!
+    Load WIDTH interleaved quadruples {a, b, c, d} (eg an array of Quaternion) from 4*WIDTH floats, de-interleaving them into four registers.
+    */
+    static void load_interleaved4(const float* p, simd_float_t& a, simd_float_t& b, simd_float_t& c, simd_float_t& d) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2)
+        // 4x4 transpose
+        const __m128 t0 = _mm_unpacklo_ps(_mm_loadu_ps(p), _mm_loadu_ps(p + 4));      // a0 a1 b0 b1
+        const __m128 t1 = _mm_unpackhi_ps(_mm_loadu_ps(p), _mm_loadu_ps(p + 4));      // c0 c1 d0 d1
+        const __m128 t2 = _mm_unpacklo_ps(_mm_loadu_ps(p + 8), _mm_loadu_ps(p + 12)); // a2 a3 b2 b3
+        const __m128 t3 = _mm_unpackhi_ps(_mm_loadu_ps(p + 8), _mm_loadu_ps(p + 12)); // c2 c3 d2 d3
+        a.v = _mm_movelh_ps(t0, t2);
+        b.v = _mm_movehl_ps(t2, t0);
+        c.v = _mm_movelh_ps(t1, t3);
+        d.v = _mm_movehl_ps(t3, t1);
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+        const float32x4x4_t t = vld4q_f32(p);
+        a.v = t.val[0];
+        b.v = t.val[1];
+        c.v = t.val[2];
+        d.v = t.val[3];
+#else
+        alignas(ALIGNMENT) float ta[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tb[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tc[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float td[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        for (size_t ii = 0; ii < WIDTH; ++ii) {
+            ta[ii] = p[4*ii];
+            tb[ii] = p[4*ii + 1];
+            tc[ii] = p[4*ii + 2];
+            td[ii] = p[4*ii + 3];
+        }
+        a = load_aligned(&ta[0]);
+        b = load_aligned(&tb[0]);
+        c = load_aligned(&tc[0]);
+        d = load_aligned(&td[0]);
+#endif
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    /*!
+    Interleave four registers and store them as WIDTH quadruples {a, b, c, d} (eg an array of Quaternion) in 4*WIDTH floats.
+    */
+    static void store_interleaved4(float* p, simd_float_t a, simd_float_t b, simd_float_t c, simd_float_t d) {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2)
+        // 4x4 transpose
+        const __m128 t0 = _mm_unpacklo_ps(a.v, b.v); // a0 b0 a1 b1
+        const __m128 t1 = _mm_unpackhi_ps(a.v, b.v); // a2 b2 a3 b3
+        const __m128 t2 = _mm_unpacklo_ps(c.v, d.v); // c0 d0 c1 d1
+        const __m128 t3 = _mm_unpackhi_ps(c.v, d.v); // c2 d2 c3 d3
+        _mm_storeu_ps(p,      _mm_movelh_ps(t0, t2));
+        _mm_storeu_ps(p + 4,  _mm_movehl_ps(t2, t0));
+        _mm_storeu_ps(p + 8,  _mm_movelh_ps(t1, t3));
+        _mm_storeu_ps(p + 12, _mm_movehl_ps(t3, t1));
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+        const float32x4x4_t t = {{ a.v, b.v, c.v, d.v }};
+        vst4q_f32(p, t);
+#else
+        alignas(ALIGNMENT) float ta[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tb[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float tc[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        alignas(ALIGNMENT) float td[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        a.store_aligned(&ta[0]);
+        b.store_aligned(&tb[0]);
+        c.store_aligned(&tc[0]);
+        d.store_aligned(&td[0]);
+        for (size_t ii = 0; ii < WIDTH; ++ii) {
+            p[4*ii] = ta[ii];
+            p[4*ii + 1] = tb[ii];
+            p[4*ii + 2] = tc[ii];
+            p[4*ii + 3] = td[ii];
+        }
+#endif
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    //! Load the first count lanes, with the remaining lanes set to zero, count must be in range [0, WIDTH]
+    static simd_float_t load_partial(const float* p, size_t count) {
+        if (count == WIDTH) {
+            return load(p);
+        }
+        alignas(ALIGNMENT) float t[WIDTH] {}; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        for (size_t ii = 0; ii < count; ++ii) { t[ii] = p[ii]; } // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return load_aligned(&t[0]);
+    }
+    //! Store the first count lanes, count must be in range [0, WIDTH]
+    void store_partial(float* p, size_t count) const {
+        if (count == WIDTH) {
+            store(p);
+            return;
+        }
+        alignas(ALIGNMENT) float t[WIDTH]; // NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+        store_aligned(&t[0]);
+        for (size_t ii = 0; ii < count; ++ii) { p[ii] = t[ii]; } // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    //! Round size up to a multiple of WIDTH
+    static constexpr size_t padded_size(size_t size) { return (size + WIDTH - 1) / WIDTH * WIDTH; }
+    //! Store each of the N planes, so that lanes[kk][ll] is lane ll of planes[kk], used where the results are written out element by element
+    template <size_t N>
+    static std::array<std::array<float, WIDTH>, N> store_lanes(const std::array<simd_float_t, N>& planes) {
+        std::array<std::array<float, WIDTH>, N> lanes; // NOLINT(cppcoreguidelines-pro-type-member-init,hicpp-member-init) fully written below
+        for (size_t kk = 0; kk < N; ++kk) {
+            planes[kk].store(lanes[kk].data());
+        }
+        return lanes;
+    }
+    /*!
+    Calls block(pin, pout, index) for each block of WIDTH elements of in, where index is the index of the first element of the block,
+    and pin and pout point to the block's elements of in and out. out must have at least in.size() elements.
+    The last partial block is copied to a zero padded buffer, and its results are written to a buffer and then copied to out,
+    so block always processes WIDTH elements and there is no scalar tail loop.
+    */
+    template <typename In, typename Out, typename Block>
+    static void for_each_block(std::span<const In> in, std::span<Out> out, Block block) {
+        const size_t count = in.size();
+        size_t ii = 0;
+        for (; ii + WIDTH <= count; ii += WIDTH) {
+            block(&in[ii], &out[ii], ii);
+        }
+        if (ii < count) {
+            std::array<In, WIDTH> t {};
+            std::array<Out, WIDTH> r {};
+            std::copy(in.begin() + static_cast<std::ptrdiff_t>(ii), in.end(), t.begin());
+            block(t.data(), r.data(), ii);
+            std::copy(r.begin(), r.begin() + static_cast<std::ptrdiff_t>(count - ii), out.begin() + static_cast<std::ptrdiff_t>(ii));
+        }
+    }
+    //! As for_each_block, calling block(pin, index), for when the output is held in storage padded to a multiple of WIDTH
+    template <typename In, typename Block>
+    static void for_each_block_in(std::span<const In> in, Block block) {
+        const size_t count = in.size();
+        size_t ii = 0;
+        for (; ii + WIDTH <= count; ii += WIDTH) {
+            block(&in[ii], ii);
+        }
+        if (ii < count) {
+            std::array<In, WIDTH> t {};
+            std::copy(in.begin() + static_cast<std::ptrdiff_t>(ii), in.end(), t.begin());
+            block(t.data(), ii);
+        }
+    }
+    //! As for_each_block, calling block(pout, index), for when the input is held in storage padded to a multiple of WIDTH
+    template <typename Out, typename Block>
+    static void for_each_block_out(std::span<Out> out, Block block) {
+        const size_t count = out.size();
+        size_t ii = 0;
+        for (; ii + WIDTH <= count; ii += WIDTH) {
+            block(&out[ii], ii);
+        }
+        if (ii < count) {
+            std::array<Out, WIDTH> r {};
+            block(r.data(), ii);
+            std::copy(r.begin(), r.begin() + static_cast<std::ptrdiff_t>(count - ii), out.begin() + static_cast<std::ptrdiff_t>(ii));
+        }
+    }
+};
+
+
+/*!
+Allocator returning memory aligned to simd_float_t::ALIGNMENT, for use with std::vector.
+*/
+template <typename T>
+struct simd_allocator_t {
+    using value_type = T;
+    simd_allocator_t() = default;
+    template <typename U> explicit simd_allocator_t(const simd_allocator_t<U>& other) { (void)other; }
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n*sizeof(T), std::align_val_t{simd_float_t::ALIGNMENT})); }
+    void deallocate(T* p, size_t n) { (void)n; ::operator delete(p, std::align_val_t{simd_float_t::ALIGNMENT}); }
+    template <typename U> bool operator==(const simd_allocator_t<U>& other) const { (void)other; return true; }
+    template <typename U> bool operator!=(const simd_allocator_t<U>& other) const { (void)other; return false; }
+};
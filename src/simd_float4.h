@@ -0,0 +1,117 @@
+#pragma once
+
+#include "simd_float.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+/*!
+Four float lanes in a single 128-bit register: SSE2 on x86 (including when AVX2 is available), NEON on AArch64,
+and four floats otherwise (or when `LIBRARY_VECTOR_QUATERNION_MATRIX_NO_SIMD` is defined).
+
+Unlike simd_float_t, which is used by the batched kernels with one element per lane, this is used by single objects
+whose (up to) four components fit in one register, for example QuaternionSimd.
+
+As with simd_float_t, no fused multiply-add is used, so that results are the same as the equivalent scalar expression.
+*/
+struct alignas(16) simd_float4_t {
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_AVX2) || defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_SSE2)
+    __m128 v;
+
+    static simd_float4_t set(float a0, float a1, float a2, float a3) { return simd_float4_t{_mm_setr_ps(a0, a1, a2, a3)}; }
+    static simd_float4_t broadcast(float a) { return simd_float4_t{_mm_set1_ps(a)}; }
+    static simd_float4_t load_aligned(const float* p) { return simd_float4_t{_mm_load_ps(p)}; } //!< p must be 16-byte aligned
+    void store_aligned(float* p) const { _mm_store_ps(p, v); } //!< p must be 16-byte aligned
+    //! Lane I
+    template <int I>
+    float get() const { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I))); }
+    //! Lane k of the result is lane Ik of this
+    template <int I0, int I1, int I2, int I3>
+    simd_float4_t shuffle() const { return simd_float4_t{_mm_shuffle_ps(v, v, _MM_SHUFFLE(I3, I2, I1, I0))}; }
+
+    friend simd_float4_t operator+(simd_float4_t a, simd_float4_t b) { return simd_float4_t{_mm_add_ps(a.v, b.v)}; }
+    friend simd_float4_t operator-(simd_float4_t a, simd_float4_t b) { return simd_float4_t{_mm_sub_ps(a.v, b.v)}; }
+    friend simd_float4_t operator*(simd_float4_t a, simd_float4_t b) { return simd_float4_t{_mm_mul_ps(a.v, b.v)}; }
+    friend simd_float4_t operator/(simd_float4_t a, simd_float4_t b) { return simd_float4_t{_mm_div_ps(a.v, b.v)}; }
+    //! Flip the sign of each lane for which the corresponding lane of signs is -0.0F (signs lanes must be +0.0F or -0.0F)
+    simd_float4_t flip_signs(simd_float4_t signs) const { return simd_float4_t{_mm_xor_ps(v, signs.v)}; }
+    static simd_float4_t sqrt(simd_float4_t a) { return simd_float4_t{_mm_sqrt_ps(a.v)}; }
+    static simd_float4_t abs(simd_float4_t a) { return simd_float4_t{_mm_andnot_ps(_mm_set1_ps(-0.0F), a.v)}; }
+    static simd_float4_t min(simd_float4_t a, simd_float4_t b) { return simd_float4_t{_mm_min_ps(a.v, b.v)}; }
+    static simd_float4_t max(simd_float4_t a, simd_float4_t b) { return simd_float4_t{_mm_max_ps(a.v, b.v)}; }
+    //! One bit per lane, set where the lanes are equal, lane 0 in the least significant bit
+    uint32_t equal_lanes(simd_float4_t a) const { return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpeq_ps(v, a.v))); }
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+    float32x4_t v;
+
+    static simd_float4_t set(float a0, float a1, float a2, float a3) { const float32x4_t r = { a0, a1, a2, a3 }; return simd_float4_t{r}; }
+    static simd_float4_t broadcast(float a) { return simd_float4_t{vdupq_n_f32(a)}; }
+    static simd_float4_t load_aligned(const float* p) { return simd_float4_t{vld1q_f32(p)}; }
+    void store_aligned(float* p) const { vst1q_f32(p, v); }
+    template <int I>
+    float get() const { return vgetq_lane_f32(v, I); }
+    template <int I0, int I1, int I2, int I3>
+    simd_float4_t shuffle() const {
+#if defined(__clang__)
+        return simd_float4_t{__builtin_shufflevector(v, v, I0, I1, I2, I3)};
+#else
+        return simd_float4_t{__builtin_shuffle(v, uint32x4_t{I0, I1, I2, I3})};
+#endif
+    }
+
+    friend simd_float4_t operator+(simd_float4_t a, simd_float4_t b) { return simd_float4_t{vaddq_f32(a.v, b.v)}; }
+    friend simd_float4_t operator-(simd_float4_t a, simd_float4_t b) { return simd_float4_t{vsubq_f32(a.v, b.v)}; }
+    friend simd_float4_t operator*(simd_float4_t a, simd_float4_t b) { return simd_float4_t{vmulq_f32(a.v, b.v)}; }
+    friend simd_float4_t operator/(simd_float4_t a, simd_float4_t b) { return simd_float4_t{vdivq_f32(a.v, b.v)}; }
+    simd_float4_t flip_signs(simd_float4_t signs) const { return simd_float4_t{vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(v), vreinterpretq_u32_f32(signs.v)))}; }
+    static simd_float4_t sqrt(simd_float4_t a) { return simd_float4_t{vsqrtq_f32(a.v)}; }
+    static simd_float4_t abs(simd_float4_t a) { return simd_float4_t{vabsq_f32(a.v)}; }
+    static simd_float4_t min(simd_float4_t a, simd_float4_t b) { return simd_float4_t{vminq_f32(a.v, b.v)}; }
+    static simd_float4_t max(simd_float4_t a, simd_float4_t b) { return simd_float4_t{vmaxq_f32(a.v, b.v)}; }
+    uint32_t equal_lanes(simd_float4_t a) const {
+        const uint32x4_t lane_bits = { 1, 2, 4, 8 };
+        return vaddvq_u32(vandq_u32(vceqq_f32(v, a.v), lane_bits));
+    }
+#else
+    std::array<float, 4> v;
+
+    static simd_float4_t set(float a0, float a1, float a2, float a3) { return simd_float4_t{{{ a0, a1, a2, a3 }}}; }
+    static simd_float4_t broadcast(float a) { return simd_float4_t{{{ a, a, a, a }}}; }
+    static simd_float4_t load_aligned(const float* p) { return simd_float4_t{{{ p[0], p[1], p[2], p[3] }}}; } // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    void store_aligned(float* p) const { p[0] = v[0]; p[1] = v[1]; p[2] = v[2]; p[3] = v[3]; } // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    template <int I>
+    float get() const { return v[I]; }
+    template <int I0, int I1, int I2, int I3>
+    simd_float4_t shuffle() const { return simd_float4_t{{{ v[I0], v[I1], v[I2], v[I3] }}}; }
+
+    friend simd_float4_t operator+(simd_float4_t a, simd_float4_t b) { return simd_float4_t{{{ a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] }}}; }
+    friend simd_float4_t operator-(simd_float4_t a, simd_float4_t b) { return simd_float4_t{{{ a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] }}}; }
+    friend simd_float4_t operator*(simd_float4_t a, simd_float4_t b) { return simd_float4_t{{{ a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] }}}; }
+    friend simd_float4_t operator/(simd_float4_t a, simd_float4_t b) { return simd_float4_t{{{ a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] }}}; }
+    simd_float4_t flip_signs(simd_float4_t signs) const {
+        return simd_float4_t{{{
+            std::signbit(signs.v[0]) ? -v[0] : v[0], std::signbit(signs.v[1]) ? -v[1] : v[1],
+            std::signbit(signs.v[2]) ? -v[2] : v[2], std::signbit(signs.v[3]) ? -v[3] : v[3]
+        }}};
+    }
+    static simd_float4_t sqrt(simd_float4_t a) { return simd_float4_t{{{ sqrtf(a.v[0]), sqrtf(a.v[1]), sqrtf(a.v[2]), sqrtf(a.v[3]) }}}; }
+    static simd_float4_t abs(simd_float4_t a) { return simd_float4_t{{{ std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3]) }}}; }
+    // min and max follow the SSE convention, returning b if either is NaN
+    static simd_float4_t min(simd_float4_t a, simd_float4_t b) { return simd_float4_t{{{ a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1], a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3] }}}; }
+    static simd_float4_t max(simd_float4_t a, simd_float4_t b) { return simd_float4_t{{{ a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1], a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3] }}}; }
+    uint32_t equal_lanes(simd_float4_t a) const {
+        return (v[0] == a.v[0] ? 1U : 0U) | (v[1] == a.v[1] ? 2U : 0U) | (v[2] == a.v[2] ? 4U : 0U) | (v[3] == a.v[3] ? 8U : 0U);
+    }
+#endif
+    static simd_float4_t zero() { return broadcast(0.0F); }
+    //! Reference to lane i (which must be less than 4), this forces the value into memory, so use get<I>() where possible
+    float& lane(size_t i) { return reinterpret_cast<float*>(&v)[i]; } // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    bool operator==(simd_float4_t a) const { return equal_lanes(a) == 0xFU; }
+    bool operator!=(simd_float4_t a) const { return !operator==(a); }
+    //! Lane I in all lanes
+    template <int I>
+    simd_float4_t broadcast_lane() const { return shuffle<I, I, I, I>(); }
+    //! Sum of the lanes, added in order, ((a0 + a1) + a2) + a3, so is identical to the equivalent scalar expression
+    float sum() const { return get<0>() + get<1>() + get<2>() + get<3>(); }
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "symmetric_matrix3x3.h"
+
+#include <cstdint>
+#include <span>
+
+/*!
+Eigendecomposition S = V*diag(eigenvalues)*V^T of a symmetric 3x3 matrix S, templated on the scalar type T,
+see SymmetricEigen3x3 (float) and SymmetricEigen3x3d (double).
+
+Intended for ellipsoid (eg magnetometer) calibration, principal axis estimation, and shaping of covariance matrices.
+The decomposition uses the cyclic Jacobi method, which is accurate for repeated and nearly repeated eigenvalues
+and gives orthonormal eigenvectors. Where only the eigenvalues are needed, `calculate_eigenvalues` uses the closed-form
+trigonometric solution of the characteristic cubic, which is faster but less accurate for nearly repeated eigenvalues.
+
+The eigenvalues are sorted largest first, and the eigenvectors are the corresponding columns of V.
+V is a rotation matrix (its determinant is +1), so it can be converted to a quaternion giving the principal axes.
+*/
+template <typename T>
+class SymmetricEigen3x3T {
+public:
+    static constexpr uint32_t MAX_SWEEPS = 8; //!< maximum number of Jacobi sweeps, each sweep is three rotations, typically 3 to 5 sweeps are needed
+public:
+    SymmetricEigen3x3T() : _eigenvectors(T(1)), _eigenvalues{} {}
+    explicit SymmetricEigen3x3T(const SymmetricMatrix3x3T<T>& s) : _eigenvectors(T(1)), _eigenvalues{} { decompose(s); }
+    void decompose(const SymmetricMatrix3x3T<T>& s); //!< Eigendecomposition of s using the cyclic Jacobi method
+
+    const xyz_type<T>& eigenvalues() const { return _eigenvalues; } //!< Eigenvalues, largest first
+    const Matrix3x3T<T>& eigenvectors() const { return _eigenvectors; } //!< Matrix V, whose columns are the unit eigenvectors
+    //! Unit eigenvector corresponding to eigenvalue index, where index is 0, 1, or 2
+    xyz_type<T> eigenvector(size_t index) const { return xyz_type<T>{ _eigenvectors[index], _eigenvectors[index + 3], _eigenvectors[index + 6] }; }
+    //! Returns V*diag(eigenvalues)*V^T, eg after the eigenvalues have been clamped using set_eigenvalues
+    SymmetricMatrix3x3T<T> matrix() const;
+    void set_eigenvalues(const xyz_type<T>& eigenvalues) { _eigenvalues = eigenvalues; } //!< Sets the eigenvalues, eg for covariance shaping
+
+    //! Eigenvalues of s, largest first, using the closed-form trigonometric solution, without calculating the eigenvectors
+    static xyz_type<T> calculate_eigenvalues(const SymmetricMatrix3x3T<T>& s);
+
+    // Batched versions, implemented in vector_quaternion_matrix.cpp
+    //! out[i] = calculate_eigenvalues(s[i]), out must have at least s.size() elements
+    static void eigenvalues_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<xyz_type<T>> out);
+    //! Decomposes s[i] into out[i], out must have at least s.size() elements
+    static void decompose_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<SymmetricEigen3x3T> out);
+private:
+    Matrix3x3T<T> _eigenvectors; //!< eigenvectors, stored as columns
+    xyz_type<T> _eigenvalues;
+};
+
+using SymmetricEigen3x3 = SymmetricEigen3x3T<float>;
+using SymmetricEigen3x3d = SymmetricEigen3x3T<double>;
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "matrix3x3.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+/*!
+Symmetric 3x3 matrix, templated on the scalar type T, see SymmetricMatrix3x3 (float) and SymmetricMatrix3x3d (double).
+
+Intended for covariance matrices. Only the six elements on and above the diagonal are stored, in the order
+a00, a01, a02, a11, a12, a22, so it uses two thirds of the memory of Matrix3x3T.
+The arithmetic functions use the symmetry, eg the inverse calculates six cofactors rather than nine.
+*/
+template <typename T>
+class SymmetricMatrix3x3T {
+public:
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T() : _a{} {}
+    [[gnu::always_inline]] constexpr explicit SymmetricMatrix3x3T(T diagonal) : _a{{ diagonal, T(0), T(0), diagonal, T(0), diagonal }} {}
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T(T d0, T d1, T d2) : _a{{ d0, T(0), T(0), d1, T(0), d2 }} {} //<! Set the matrix diagonal
+    [[gnu::always_inline]] constexpr explicit SymmetricMatrix3x3T(const std::array<T, 6>& a) : _a(a) {}
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T(T a00, T a01, T a02, T a11, T a12, T a22) : _a{{ a00, a01, a02, a11, a12, a22 }} {}
+    //! Create from the elements on and above the diagonal of m, the elements below the diagonal are ignored
+    [[gnu::always_inline]] constexpr explicit SymmetricMatrix3x3T(const Matrix3x3T<T>& m) : _a{{ m[0], m[1], m[2], m[4], m[5], m[8] }} {}
+    [[gnu::always_inline]] constexpr Matrix3x3T<T> matrix() const { return Matrix3x3T<T>(_a[0], _a[1], _a[2], _a[1], _a[3], _a[4], _a[2], _a[4], _a[5]); } //<! Convert to a full matrix
+public:
+    // Equality operators
+    constexpr bool operator==(const SymmetricMatrix3x3T& m) const = default;
+
+    // Index operators, these index the six stored elements
+    [[gnu::always_inline]] constexpr T operator[](size_t pos) const { return _a[pos]; } //<! Index operator
+    [[gnu::always_inline]] constexpr T& operator[](size_t pos) { return _a[pos]; } //<! Index operator
+    //! Element at row, column
+    [[gnu::always_inline]] constexpr T operator()(size_t row, size_t column) const { return _a[INDEX[row*3 + column]]; }
+
+    // Unary operations
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator+() const { return *this; } //<! Unary plus
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator-() const { return SymmetricMatrix3x3T(-_a[0], -_a[1], -_a[2], -_a[3], -_a[4], -_a[5]); } //<! Unary negation
+
+    // cppcheck-suppress useStlAlgorithm
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator*=(T k) { for (T& a : _a) { a*=k; } return *this; } //<! Multiplication by a scalar
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator/=(T k) { const T r = T(1)/k; return operator*=(r); } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator+=(const SymmetricMatrix3x3T& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] += m[ii];} return *this; } //<! Unary addition
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator-=(const SymmetricMatrix3x3T& m) { for (size_t ii = 0; ii < _a.size(); ++ii) {_a[ii] -= m[ii];} return *this; } //<! Unary subtraction
+
+    // Binary operations
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator*(T k) const { return SymmetricMatrix3x3T(_a[0]*k, _a[1]*k, _a[2]*k, _a[3]*k, _a[4]*k, _a[5]*k); } //<! Multiplication by a scalar
+    [[gnu::always_inline]] friend constexpr SymmetricMatrix3x3T operator*(T k, const SymmetricMatrix3x3T& m) { return m*k; } //<! Pre-multiplication by a scalar
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator/(T k) const { const T r = T(1)/k; return *this*r; } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator+(const SymmetricMatrix3x3T& m) const { return SymmetricMatrix3x3T(_a[0] + m[0], _a[1] + m[1], _a[2] + m[2], _a[3] + m[3], _a[4] + m[4], _a[5] + m[5]); } //<! Addition
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T operator-(const SymmetricMatrix3x3T& m) const { return SymmetricMatrix3x3T(_a[0] - m[0], _a[1] - m[1], _a[2] - m[2], _a[3] - m[3], _a[4] - m[4], _a[5] - m[5]); } //<! Subtraction
+    //! Multiplication of a vector
+    [[gnu::always_inline]] constexpr xyz_type<T> operator*(const xyz_type<T>& v) const {
+        return xyz_type<T> { _a[0]*v.x + _a[1]*v.y + _a[2]*v.z, _a[1]*v.x + _a[3]*v.y + _a[4]*v.z, _a[2]*v.x + _a[4]*v.y + _a[5]*v.z };
+    }
+    //! Quadratic form v^T*P*v, eg the squared Mahalanobis distance when P is an inverse covariance
+    [[gnu::always_inline]] constexpr T quadratic_form(const xyz_type<T>& v) const {
+        return _a[0]*v.x*v.x + _a[3]*v.y*v.y + _a[5]*v.z*v.z + T(2)*(_a[1]*v.x*v.y + _a[2]*v.x*v.z + _a[4]*v.y*v.z);
+    }
+
+    //! Congruence transform, that is return f*P*f^T, eg for covariance propagation, using 45 multiplications rather than the 54 of the full products.
+    //! Uses the same operation order as Matrix3x3T::congruence, so agrees with it to within a few ulps.
+    SymmetricMatrix3x3T congruence(const Matrix3x3T<T>& f) const;
+    //! Congruence transform plus q, that is return f*P*f^T + q, eg for the EKF covariance prediction
+    SymmetricMatrix3x3T congruence_add(const Matrix3x3T<T>& f, const SymmetricMatrix3x3T& q) const;
+
+    [[gnu::always_inline]] constexpr void set_zero() { _a.fill(T(0)); }
+    [[gnu::always_inline]] constexpr void set_to_identity() { _a = {{ T(1), T(0), T(0), T(1), T(0), T(1) }}; } //<! Sets matrix to identity matrix
+    [[gnu::always_inline]] constexpr void set_to_scaled_identity(T d) { _a = {{ d, T(0), T(0), d, T(0), d }}; } //<! Sets matrix to d times the identity matrix
+    [[gnu::always_inline]] constexpr void add_to_diagonal_in_place(const xyz_type<T>& v) { _a[0]+=v.x; _a[3]+=v.y; _a[5]+=v.z; } //<! Add vector to diagonal of matrix, in-place
+    [[gnu::always_inline]] constexpr SymmetricMatrix3x3T add_to_diagonal(const xyz_type<T>& v) const { return SymmetricMatrix3x3T(_a[0]+v.x, _a[1], _a[2], _a[3]+v.y, _a[4], _a[5]+v.z); } //<! Add vector to diagonal of matrix
+    [[gnu::always_inline]] constexpr xyz_type<T> diagonal() const { return xyz_type<T>{ _a[0], _a[3], _a[5] }; } //<! The diagonal, eg the variances of a covariance matrix
+
+    //! Invert matrix, in-place, the inverse of a symmetric matrix is symmetric, so only six cofactors are calculated
+    bool invert_in_place() {
+        const T A = _a[3]*_a[5] - _a[4]*_a[4];
+        const T B = _a[2]*_a[4] - _a[1]*_a[5];
+        const T C = _a[1]*_a[4] - _a[2]*_a[3];
+        const T det = _a[0]*A + _a[1]*B + _a[2]*C;
+
+        using std::abs;
+        if ((abs(det) <= std::numeric_limits<T>::epsilon())) {
+            return false;
+        }
+
+        const T E = _a[0]*_a[5] - _a[2]*_a[2];
+        const T F = _a[1]*_a[2] - _a[0]*_a[4];
+        const T I = _a[0]*_a[3] - _a[1]*_a[1];
+        // multiply by the reciprocal of det, rather than doing six divisions
+        const T r = T(1) / det;
+        _a = {{ A*r, B*r, C*r, E*r, F*r, I*r }};
+        return true;
+    }
+    SymmetricMatrix3x3T inverse() const { SymmetricMatrix3x3T ret = *this; (void)ret.invert_in_place(); return ret; } //<! Returns inverse of matrix, or the matrix itself if it is singular
+
+    [[gnu::always_inline]] constexpr T determinant() const { return _a[0]*(_a[3]*_a[5] - _a[4]*_a[4]) + _a[1]*(_a[2]*_a[4] - _a[1]*_a[5]) + _a[2]*(_a[1]*_a[4] - _a[2]*_a[3]); } //<! Matrix determinant
+    [[gnu::always_inline]] constexpr T trace() const { return _a[0] + _a[3] + _a[5]; }
+private:
+    std::array<T, 9> premultiply(const Matrix3x3T<T>& f) const; //!< Returns f*P, which is not symmetric, as a full matrix
+    static constexpr std::array<size_t, 9> INDEX {{ 0, 1, 2, 1, 3, 4, 2, 4, 5 }};
+protected:
+    std::array<T, 6> _a;
+};
+
+using SymmetricMatrix3x3 = SymmetricMatrix3x3T<float>;
+using SymmetricMatrix3x3d = SymmetricMatrix3x3T<double>;
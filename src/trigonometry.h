@@ -0,0 +1,48 @@
+#pragma once
+
+#include "fast_trigonometry.h"
+
+#include <cmath>
+
+/*!
+Trigonometric functions for each scalar type, used by the templated vector, quaternion, and matrix classes,
+so that each precision uses its fastest path.
+
+The float specialization uses the FastTrigonometry functions when LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY
+is defined, and the standard library functions otherwise, so gives the same results as the original float only code.
+The double specialization always uses the standard library functions.
+Other scalar types (eg fixed point) provide their own specialization.
+*/
+template <typename T>
+class Trigonometry;
+
+template <>
+class Trigonometry<float> {
+public:
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY)
+    static float sin(float x) { return FastTrigonometry::sin(x); }
+    static float cos(float x) { return FastTrigonometry::cos(x); }
+    static void sin_cos(float x, float& sin, float& cos) { FastTrigonometry::sin_cos(x, sin, cos); }
+    static float atan2(float y, float x) { return FastTrigonometry::atan2(y, x); }
+    static float asin(float x) { return FastTrigonometry::asin(x); }
+    static float acos(float x) { return FastTrigonometry::acos(x); }
+#else
+    static float sin(float x) { return sinf(x); }
+    static float cos(float x) { return cosf(x); }
+    static void sin_cos(float x, float& sin, float& cos) { sin = sinf(x); cos = cosf(x); }
+    static float atan2(float y, float x) { return atan2f(y, x); }
+    static float asin(float x) { return asinf(x); }
+    static float acos(float x) { return acosf(x); }
+#endif
+};
+
+template <>
+class Trigonometry<double> {
+public:
+    static double sin(double x) { return std::sin(x); }
+    static double cos(double x) { return std::cos(x); }
+    static void sin_cos(double x, double& sin, double& cos) { sin = std::sin(x); cos = std::cos(x); }
+    static double atan2(double y, double x) { return std::atan2(y, x); }
+    static double asin(double x) { return std::asin(x); }
+    static double acos(double x) { return std::acos(x); }
+};
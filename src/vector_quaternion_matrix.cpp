@@ -1,91 +1,152 @@
+#include "cholesky3x3.h"
 #include "fast_trigonometry.h"
+#include "fast_trigonometry_simd.h"
 #include "matrix3x3.h"
+#include "q2_30_type.h"
 #include "quaternion.h"
+#include "reciprocal_sqrt.h"
+#include "rotation_matrix3x3.h"
+#include "symmetric_eigen3x3.h"
+#include "symmetric_matrix3x3.h"
+#include "trigonometry.h"
 #include "xy_type.h"
+#include "xyz_soa.h"
 
-#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <limits>
+#include <utility>
 
-/*!
-Reciprocal square root
-Implementation of [fast inverse square root](http://en.wikipedia.org/wiki/Fast_inverse_square_root)
-using [Pizer’s optimisation](https://pizer.wordpress.com/2008/10/12/fast-inverse-square-root/) and
-using `union` rather than `reinterpret_cast` to avoid breaking strict-aliasing rules.
-
-The Xtensa floating point coprocessor (used on the ESP32) has some hardware support for reciprocal square root: it has
-an RSQRT0.S (single-precision reciprocal square root initial step) instruction.
-However benchmarking shows that FAST_RECIPROCAL_SQUARE_ROOT is approximately 3.5 times faster than `1.0F / sqrtf()`
-*/
-inline float reciprocal_sqrtf(float x)
-{
-#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_RECIPROCAL_SQUARE_ROOT) || defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_RECIPROCAL_SQUARE_ROOT_TWO_ITERATIONS)
-    union {
-        float f;
-        int32_t i;
-    } u { .f = x };
-
-// NOLINTBEGIN(cppcoreguidelines-pro-type-union-access)
-    u.i = 0x5f1f1412 - (u.i >> 1); // Initial estimate for Newton–Raphson method
-    // single iteration gives accuracy to 4.5 significant figures
-    u.f *= 1.69000231F - 0.714158168F * x * u.f * u.f; // First iteration
-#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_RECIPROCAL_SQUARE_ROOT_TWO_ITERATIONS)
-    // two iterations gives floating point accuracy to within 2 significant bits, and will pass platformio's Unity TEST_ASSERT_EQUAL_FLOAT
-    u.f *= 1.5F - (0.5F * x * u.f * u.f); // Second iteration
-#endif
-
-    return u.f;
-// NOLINTEND(cppcoreguidelines-pro-type-union-access)
-#else
-    return 1.0F / sqrtf(x);
-#endif
-}
-
-xyz_t Quaternion::rotate(const xyz_t& v) const
-{
-    const float x2 = x*x;
-    const float y2 = y*y;
-    const float z2 = z*z;
+template <typename T>
+xyz_type<T> QuaternionT<T>::rotate(const xyz_type<T>& v) const
+{
+    const T x2 = x*x;
+    const T y2 = y*y;
+    const T z2 = z*z;
     // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
-    return xyz_t {
-        2.0F*(v.x*(0.5F - y2 - z2) + v.y*(x*y - w*z)      + v.z*(w*y + x*z)),
-        2.0F*(v.x*(w*z + x*y)      + v.y*(0.5F - x2 - z2) + v.z*(y*z - w*x)),
-        2.0F*(v.x*(x*z - w*y)      + v.y*(w*x + y*z)      + v.z*(0.5F - x2 - y2))
+    return xyz_type<T> {
+        T(2)*(v.x*(T(0.5F) - y2 - z2) + v.y*(x*y - w*z)         + v.z*(w*y + x*z)),
+        T(2)*(v.x*(w*z + x*y)         + v.y*(T(0.5F) - x2 - z2) + v.z*(y*z - w*x)),
+        T(2)*(v.x*(x*z - w*y)         + v.y*(w*x + y*z)         + v.z*(T(0.5F) - x2 - y2))
     };
     // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 }
 
+/*!
+Rotate an array of vectors.
+
+The rotation matrix coefficients are calculated once, and then applied to simd_float_t::WIDTH vectors at a time.
+The coefficients are doubled, rather than doubling the result as in the single vector `rotate`, which saves three multiplications
+per vector. Since multiplication by 2 is exact the results agree to within a few ulps, see simd_float.h.
+*/
+template <typename T>
+void QuaternionT<T>::rotate(std::span<const xyz_type<T>> v, std::span<xyz_type<T>> out) const requires std::same_as<T, float>
+{
+    static_assert(sizeof(xyz_t) == 3*sizeof(float));
+    using V = simd_float_t;
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const V m0 = V::broadcast(2.0F*(0.5F - y*y - z*z));
+    const V m1 = V::broadcast(2.0F*(x*y - w*z));
+    const V m2 = V::broadcast(2.0F*(w*y + x*z));
+    const V m3 = V::broadcast(2.0F*(w*z + x*y));
+    const V m4 = V::broadcast(2.0F*(0.5F - x*x - z*z));
+    const V m5 = V::broadcast(2.0F*(y*z - w*x));
+    const V m6 = V::broadcast(2.0F*(x*z - w*y));
+    const V m7 = V::broadcast(2.0F*(w*x + y*z));
+    const V m8 = V::broadcast(2.0F*(0.5F - x*x - y*y));
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    const size_t count = v.size();
+    size_t ii = 0;
+    for (; ii + V::WIDTH <= count; ii += V::WIDTH) {
+        V vx {};
+        V vy {};
+        V vz {};
+        V::load_interleaved3(&v[ii].x, vx, vy, vz);
+        V::store_interleaved3(&out[ii].x,
+            vx*m0 + vy*m1 + vz*m2,
+            vx*m3 + vy*m4 + vz*m5,
+            vx*m6 + vy*m7 + vz*m8);
+    }
+    for (; ii < count; ++ii) {
+        out[ii] = rotate(v[ii]);
+    }
+}
+
+template <typename T>
+void QuaternionT<T>::rotate(const xyz_soa_t& v, xyz_soa_t& out) const requires std::same_as<T, float>
+{
+    using V = simd_float_t;
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const V m0 = V::broadcast(2.0F*(0.5F - y*y - z*z));
+    const V m1 = V::broadcast(2.0F*(x*y - w*z));
+    const V m2 = V::broadcast(2.0F*(w*y + x*z));
+    const V m3 = V::broadcast(2.0F*(w*z + x*y));
+    const V m4 = V::broadcast(2.0F*(0.5F - x*x - z*z));
+    const V m5 = V::broadcast(2.0F*(y*z - w*x));
+    const V m6 = V::broadcast(2.0F*(x*z - w*y));
+    const V m7 = V::broadcast(2.0F*(w*x + y*z));
+    const V m8 = V::broadcast(2.0F*(0.5F - x*x - y*y));
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+
+    const size_t count = v.size();
+    out.resize(count);
+    const float* px = v.x().data();
+    const float* py = v.y().data();
+    const float* pz = v.z().data();
+    float* ox = out.x().data();
+    float* oy = out.y().data();
+    float* oz = out.z().data();
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic) arrays are padded to a multiple of WIDTH
+    for (size_t ii = 0; ii < count; ii += V::WIDTH) {
+        const V vx = V::load_aligned(px + ii);
+        const V vy = V::load_aligned(py + ii);
+        const V vz = V::load_aligned(pz + ii);
+        (vx*m0 + vy*m1 + vz*m2).store_aligned(ox + ii);
+        (vx*m3 + vy*m4 + vz*m5).store_aligned(oy + ii);
+        (vx*m6 + vy*m7 + vz*m8).store_aligned(oz + ii);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
 /*!
 Create a quaternion representing the rotation from the source to the destination vector.
 src and dst do not need to be normalized.
 */
-Quaternion::Quaternion(const xyz_t& src, const xyz_t& dst)
+template <typename T>
+QuaternionT<T>::QuaternionT(const xyz_type<T>& src, const xyz_type<T>& dst)
 {
-    static constexpr float epsilon = 1E-5F;
+    static constexpr T epsilon = T(1E-5F);
 
-    xyz_t cross_product = src.cross(dst);
-    const float dot_product = src.dot(dst);
+    xyz_type<T> cross_product = src.cross(dst);
+    const T dot_product = src.dot(dst);
 
-    if (cross_product.magnitude() < epsilon && dot_product < 0.0F) {
+    if (cross_product.magnitude() < epsilon && dot_product < T(0)) {
         // handle corner cases with 180 degree rotations
         // if the two vectors are parallel, cross product is zero
         // if they point opposite, the dot product is negative
-        w = 0.0F;
-        const xyz_t source_absolute = src.absolute();
+        w = T(0);
+        const xyz_type<T> source_absolute = src.absolute();
         if (source_absolute.x < source_absolute.y) {
             if (source_absolute.x < source_absolute.z) {
-                cross_product = src.cross(xyz_t{1.0F, 0.0F, 0.0F});
+                cross_product = src.cross(xyz_type<T>{T(1), T(0), T(0)});
             } else {
-                cross_product = src.cross(xyz_t{0.0F, 0.0F, 1.0F});
+                cross_product = src.cross(xyz_type<T>{T(0), T(0), T(1)});
             }
         } else {
             if (source_absolute.y < source_absolute.z) {
-                cross_product = src.cross(xyz_t{0.0F, 1.0F, 0.0F});
+                cross_product = src.cross(xyz_type<T>{T(0), T(1), T(0)});
             } else {
-                cross_product = src.cross(xyz_t{0.0F, 0.0F, 1.0F});
+                cross_product = src.cross(xyz_type<T>{T(0), T(0), T(1)});
             }
         }
     } else {
         // normal case, do half-way quaternion solution
-        w = dot_product + std::sqrt(src.magnitude_squared() * dst.magnitude_squared());
+        using std::sqrt;
+        w = dot_product + sqrt(src.magnitude_squared() * dst.magnitude_squared());
     }
     x = cross_product.x;
     y = cross_product.y;
@@ -99,32 +160,21 @@ Create a Quaternion from roll, pitch, and yaw Euler angles (in radians).
 See:
 https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles#Euler_angles_(in_3-2-1_sequence)_to_quaternion_conversion
 */
-Quaternion Quaternion::from_euler_angles_radians(float roll_radians, float pitch_radians, float yaw_radians)
+template <typename T>
+QuaternionT<T> QuaternionT<T>::from_euler_angles_radians(T roll_radians, T pitch_radians, T yaw_radians)
 {
-#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY)
     // NOLINTBEGIN(misc-const-correctness)
-    float sin_half_roll {};
-    float cos_half_roll {};
-    FastTrigonometry::sin_cos(0.5F*roll_radians, sin_half_roll, cos_half_roll);
-    float sin_half_pitch {};
-    float cos_half_pitch {};
-    FastTrigonometry::sin_cos(0.5F*pitch_radians, sin_half_pitch, cos_half_pitch);
-    float sin_half_yaw {};
-    float cos_half_yaw {};
-    FastTrigonometry::sin_cos(0.5F*yaw_radians, sin_half_yaw, cos_half_yaw);
+    T sin_half_roll {};
+    T cos_half_roll {};
+    Trigonometry<T>::sin_cos(T(0.5F)*roll_radians, sin_half_roll, cos_half_roll);
+    T sin_half_pitch {};
+    T cos_half_pitch {};
+    Trigonometry<T>::sin_cos(T(0.5F)*pitch_radians, sin_half_pitch, cos_half_pitch);
+    T sin_half_yaw {};
+    T cos_half_yaw {};
+    Trigonometry<T>::sin_cos(T(0.5F)*yaw_radians, sin_half_yaw, cos_half_yaw);
     // NOLINTEND(misc-const-correctness)
-#else
-    const float half_roll = 0.5F * roll_radians;
-    const float half_pitch = 0.5F * pitch_radians;
-    const float half_yaw = 0.5F * yaw_radians;
-
-    const float sin_half_roll = sinf(half_roll);
-    const float cos_half_roll = cosf(half_roll);
-    const float sin_half_pitch = sinf(half_pitch);
-    const float cos_half_pitch = cosf(half_pitch);
-    const float sin_half_yaw = sinf(half_yaw);
-    const float cos_half_yaw = cosf(half_yaw);
-#endif
+
     return {
         cos_half_roll * cos_half_pitch * cos_half_yaw + sin_half_roll * sin_half_pitch * sin_half_yaw,
         sin_half_roll * cos_half_pitch * cos_half_yaw - cos_half_roll * sin_half_pitch * sin_half_yaw,
@@ -136,26 +186,17 @@ Quaternion Quaternion::from_euler_angles_radians(float roll_radians, float pitch
 /*!
 Create a Quaternion from roll and pitch Euler angles (in radians), assumes yaw angle is zero.
 */
-Quaternion Quaternion::from_euler_angles_radians(float roll_radians, float pitch_radians)
+template <typename T>
+QuaternionT<T> QuaternionT<T>::from_euler_angles_radians(T roll_radians, T pitch_radians)
 {
-#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY)
     // NOLINTBEGIN(misc-const-correctness)
-    float sin_half_roll {};
-    float cos_half_roll {};
-    FastTrigonometry::sin_cos(0.5F*roll_radians, sin_half_roll, cos_half_roll);
-    float sin_half_pitch {};
-    float cos_half_pitch {};
-    FastTrigonometry::sin_cos(0.5F*pitch_radians, sin_half_pitch, cos_half_pitch);
+    T sin_half_roll {};
+    T cos_half_roll {};
+    Trigonometry<T>::sin_cos(T(0.5F)*roll_radians, sin_half_roll, cos_half_roll);
+    T sin_half_pitch {};
+    T cos_half_pitch {};
+    Trigonometry<T>::sin_cos(T(0.5F)*pitch_radians, sin_half_pitch, cos_half_pitch);
     // NOLINTEND(misc-const-correctness)
-#else
-    const float half_roll = 0.5F * roll_radians;
-    const float half_pitch = 0.5F * pitch_radians;
-
-    const float sin_half_roll = sinf(half_roll);
-    const float cos_half_roll = cosf(half_roll);
-    const float sin_half_pitch = sinf(half_pitch);
-    const float cos_half_pitch = cosf(half_pitch);
-#endif
 
     return {
         cos_half_roll * cos_half_pitch,
@@ -167,7 +208,8 @@ Quaternion Quaternion::from_euler_angles_radians(float roll_radians, float pitch
 /*!
 Create a Quaternion from roll, pitch, and yaw Euler angles (in degrees).
 */
-Quaternion Quaternion::from_euler_angles_degrees(float roll_degrees, float pitch_degrees, float yaw_degrees)
+template <typename T>
+QuaternionT<T> QuaternionT<T>::from_euler_angles_degrees(T roll_degrees, T pitch_degrees, T yaw_degrees)
 {
     return from_euler_angles_radians(roll_degrees*DEGREES_TO_RADIANS, pitch_degrees*DEGREES_TO_RADIANS, yaw_degrees*DEGREES_TO_RADIANS);
 }
@@ -175,7 +217,8 @@ Quaternion Quaternion::from_euler_angles_degrees(float roll_degrees, float pitch
 /*!
 Create a Quaternion from roll and pitch Euler angles (in degrees), assumes yaw angle is zero.
 */
-Quaternion Quaternion::from_euler_angles_degrees(float roll_degrees, float pitch_degrees)
+template <typename T>
+QuaternionT<T> QuaternionT<T>::from_euler_angles_degrees(T roll_degrees, T pitch_degrees)
 {
     return from_euler_angles_radians(roll_degrees*DEGREES_TO_RADIANS, pitch_degrees*DEGREES_TO_RADIANS);
 }
@@ -187,7 +230,8 @@ Adapted from [Converting a Rotation Matrix to a Quaternion](https://d3cw3dd2w32x
 Note that Day's paper uses the [Shuster multiplication convention](https://en.wikipedia.org/wiki/Quaternions_and_spatial_rotation#Alternative_conventions),
 rather than the Hamilton multiplication convention used by the Quaternion class.
 */
-Quaternion Matrix3x3::quaternion() const // NOLINT(readability-convert-member-functions-to-static) false positive
+template <typename T>
+QuaternionT<T> Matrix3x3T<T>::quaternion() const // NOLINT(readability-convert-member-functions-to-static) false positive
 {
 /*
 _a[0] = 1 - 2(yy + zz);
@@ -214,62 +258,56 @@ _a[7] - _a[5] = 2(wx + yz) - 2(yz - wx) = 4xw
 
 // NOLINTBEGIN(cppcoreguidelines-init-variables,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers) avoid false positives
     // Choose largest scale factor from 4w, 4x, 4y, and 4z, to avoid a scale factor of zero, or numerical instabilities caused by division of a small scale factor.
-    if (_a[8] < 0) {
+    if (_a[8] < T(0)) {
         // |(x,y)| is bigger than |(z,w)|?
         if (_a[0] > _a[4]) {
             // |x| bigger than |y|, so use x-form
-            const float t = 1.0F + (_a[0] - _a[4]) - _a[8]; // 1 + 2(xx - yy) - 1 + 2(xx + yy) = 4xx
-            const Quaternion q = Quaternion(_a[7] - _a[5], t, _a[1] + _a[3], _a[6] + _a[2]);
-            return q * (0.5F * reciprocal_sqrtf(t)); // note brackets because we want perform the scalar multiply first, so it is only done once
+            const T t = T(1) + (_a[0] - _a[4]) - _a[8]; // 1 + 2(xx - yy) - 1 + 2(xx + yy) = 4xx
+            const QuaternionT<T> q = QuaternionT<T>(_a[7] - _a[5], t, _a[1] + _a[3], _a[6] + _a[2]);
+            return q * (T(0.5F) * reciprocal_sqrt(t)); // note brackets because we want perform the scalar multiply first, so it is only done once
         }
         // |y| bigger than |x|, so use y-form
-        const float t = 1 - (_a[0] - _a[4]) - _a[8]; // 1 - 2(xx - yy) - 1 + 2(xx + yy) = 4yy
-        const Quaternion q = Quaternion(_a[2] - _a[6], _a[1] + _a[3], t, _a[5] + _a[7]);
-        return q * (0.5F * reciprocal_sqrtf(t)); // note brackets because we want perform the scalar multiply first, so it is only done once
+        const T t = T(1) - (_a[0] - _a[4]) - _a[8]; // 1 - 2(xx - yy) - 1 + 2(xx + yy) = 4yy
+        const QuaternionT<T> q = QuaternionT<T>(_a[2] - _a[6], _a[1] + _a[3], t, _a[5] + _a[7]);
+        return q * (T(0.5F) * reciprocal_sqrt(t)); // note brackets because we want perform the scalar multiply first, so it is only done once
     }
 
     // |(z,w)| bigger than |(x,y)|
     if (_a[0] < -_a[4]) {
         // |z| bigger than |w|, so use z-form
-        const float t = 1.0F - _a[0] - (_a[4] - _a[8]); // 1 - (1 - 2*(yy + zz)) - (2(yy - zz)) = 4zz
-        const Quaternion q = Quaternion(_a[3] - _a[1], _a[2] + _a[6], _a[5] + _a[7], t);
-        return q * (0.5F * reciprocal_sqrtf(t)); // note brackets because we want perform the scalar multiply first, so it is only done once
+        const T t = T(1) - _a[0] - (_a[4] - _a[8]); // 1 - (1 - 2*(yy + zz)) - (2(yy - zz)) = 4zz
+        const QuaternionT<T> q = QuaternionT<T>(_a[3] - _a[1], _a[2] + _a[6], _a[5] + _a[7], t);
+        return q * (T(0.5F) * reciprocal_sqrt(t)); // note brackets because we want perform the scalar multiply first, so it is only done once
     }
 
     // |w| bigger than |z|, so use w-form
     // ww + xx + yy + zz = 1, since unit quaternion, so xx + yy + zz =  1 - ww
-    const float t = 1.0F + _a[0] + _a[4] + _a[8]; // 1 + 1 - 2*(yy + zz) + 1 - 2(xx + zz) + 1 - 2(xx + yy) =  4 - 4(xx + yy + zz) = 4 - 4(1 - ww) = 4ww
-    const Quaternion q = Quaternion(t, _a[7] - _a[5], _a[2] - _a[6], _a[3] - _a[1]);
-    return q * (0.5F * reciprocal_sqrtf(t)); // note brackets because we want perform the scalar multiply first, so it is only done once
+    const T t = T(1) + _a[0] + _a[4] + _a[8]; // 1 + 1 - 2*(yy + zz) + 1 - 2(xx + zz) + 1 - 2(xx + yy) =  4 - 4(xx + yy + zz) = 4 - 4(1 - ww) = 4ww
+    const QuaternionT<T> q = QuaternionT<T>(t, _a[7] - _a[5], _a[2] - _a[6], _a[3] - _a[1]);
+    return q * (T(0.5F) * reciprocal_sqrt(t)); // note brackets because we want perform the scalar multiply first, so it is only done once
 // NOLINTEND(cppcoreguidelines-init-variables,cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 }
 
+
 /*!
 Create a Rotation Matrix from roll, pitch, and yaw Euler angles (in degrees).
 */
-Matrix3x3 Matrix3x3::from_euler_angles_radians(float roll_radians, float pitch_radians, float yaw_radians)
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::from_euler_angles_radians(T roll_radians, T pitch_radians, T yaw_radians)
 {
-#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY)
     // NOLINTBEGIN(misc-const-correctness)
-    float sin_phi {};
-    float cos_phi {};
-    FastTrigonometry::sin_cos(roll_radians, sin_phi, cos_phi);
-    float sin_theta {};
-    float cos_theta {};
-    FastTrigonometry::sin_cos(pitch_radians, sin_theta, cos_theta);
-    float sin_psi {};
-    float cos_psi {};
-    FastTrigonometry::sin_cos(yaw_radians, sin_psi, cos_psi);
+    T sin_phi {};
+    T cos_phi {};
+    Trigonometry<T>::sin_cos(roll_radians, sin_phi, cos_phi);
+    T sin_theta {};
+    T cos_theta {};
+    Trigonometry<T>::sin_cos(pitch_radians, sin_theta, cos_theta);
+    T sin_psi {};
+    T cos_psi {};
+    Trigonometry<T>::sin_cos(yaw_radians, sin_psi, cos_psi);
     // NOLINTEND(misc-const-correctness)
-#else
-    const float sin_phi = sinf(roll_radians);
-    const float cos_phi = cosf(roll_radians);
-    const float sin_theta = sinf(pitch_radians);
-    const float cos_theta = cosf(pitch_radians);
-    const float sin_psi = sinf(yaw_radians);
-    const float cos_psi = cosf(yaw_radians);
-#endif
-    return Matrix3x3 {
+
+    return Matrix3x3T {
          cos_theta*cos_psi,
         -cos_phi*sin_psi + sin_phi*sin_theta*cos_psi,
          sin_phi*sin_psi + cos_phi*sin_theta*cos_psi,
@@ -285,105 +323,727 @@ Matrix3x3 Matrix3x3::from_euler_angles_radians(float roll_radians, float pitch_r
 /*!
 Create a Rotation Matrix from roll, pitch, and yaw Euler angles (in degrees).
 */
-Matrix3x3 Matrix3x3::from_euler_angles_degrees(float roll_degrees, float pitch_degrees, float yaw_degrees)
+template <typename T>
+Matrix3x3T<T> Matrix3x3T<T>::from_euler_angles_degrees(T roll_degrees, T pitch_degrees, T yaw_degrees)
 {
-    return from_euler_angles_radians(roll_degrees*Quaternion::DEGREES_TO_RADIANS, pitch_degrees*Quaternion::DEGREES_TO_RADIANS, yaw_degrees*Quaternion::DEGREES_TO_RADIANS);
+    return from_euler_angles_radians(roll_degrees*QuaternionT<T>::DEGREES_TO_RADIANS, pitch_degrees*QuaternionT<T>::DEGREES_TO_RADIANS, yaw_degrees*QuaternionT<T>::DEGREES_TO_RADIANS);
 }
 
 /*!
 Return the normalized vector
 */
-xy_t xy_t::normalized() const
+template <typename T>
+xy_type<T> xy_type<T>::normalized() const
 {
-    const float r = reciprocal_sqrtf(magnitude_squared());
+    const T r = reciprocal_sqrt(magnitude_squared());
     return *this*r;
 }
 
 /*!
 Return the normalized vector
 */
-xyz_t xyz_t::normalized() const
+template <typename T>
+xyz_type<T> xyz_type<T>::normalized() const
 {
-    const float r = reciprocal_sqrtf(magnitude_squared());
+    const T r = reciprocal_sqrt(magnitude_squared());
     return *this*r;
 }
 
 /*!
 Return the normalized quaternion
 */
-Quaternion Quaternion::normalized() const
+template <typename T>
+QuaternionT<T> QuaternionT<T>::normalized() const
 {
-    const float r = reciprocal_sqrtf(magnitude_squared());
+    const T r = reciprocal_sqrt(magnitude_squared());
     return *this*r;
 }
 
+/*!
+exp(w + v) = e^w * (cos(θ) + v sin(θ)/θ), where θ = |v|.
+For small θ, cos(θ) = 1 - θ²/2 and sin(θ)/θ = 1 - θ²/6, with errors of at most θ⁴/24 and θ⁴/120, see SMALL_ANGLE_SQUARED.
+*/
+template <typename T>
+QuaternionT<T> QuaternionT<T>::exp() const
+{
+    using std::exp;
+    using std::sqrt;
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const T theta_squared = x*x + y*y + z*z;
+    const T e = exp(w);
+    if (theta_squared < SMALL_ANGLE_SQUARED) {
+        const T k = e*(T(1) - theta_squared/T(6));
+        return QuaternionT(e*(T(1) - T(0.5F)*theta_squared), x*k, y*k, z*k);
+    }
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const T theta = sqrt(theta_squared);
+    T sin_theta {}; // NOLINT(misc-const-correctness)
+    T cos_theta {}; // NOLINT(misc-const-correctness)
+    Trigonometry<T>::sin_cos(theta, sin_theta, cos_theta);
+    const T k = e*sin_theta/theta;
+    return QuaternionT(e*cos_theta, x*k, y*k, z*k);
+}
+
+/*!
+log(q) = ln|q| + v θ/|v|, where θ = atan2(|v|, w) is the angle between q and the real axis.
+For small θ (and positive w), θ/|v| = (1/w)(1 - r²/3), where r = |v|/w, with relative error of at most r⁴/5, see SMALL_ANGLE_SQUARED.
+The log of a negative real quaternion is not unique, in this case the vector part is chosen to be along the x-axis.
+*/
+template <typename T>
+QuaternionT<T> QuaternionT<T>::log() const
+{
+    using std::log;
+    using std::sqrt;
+    const T v_squared = x*x + y*y + z*z;
+    const T ln_norm = T(0.5F)*log(w*w + v_squared); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    if (w > T(0) && v_squared < SMALL_ANGLE_SQUARED*w*w) {
+        const T r = T(1)/w;
+        const T k = r*(T(1) - v_squared*r*r/T(3)); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        return QuaternionT(ln_norm, x*k, y*k, z*k);
+    }
+    if (v_squared == T(0)) {
+        return QuaternionT(ln_norm, M_PI_F, T(0), T(0));
+    }
+    const T v = sqrt(v_squared);
+    const T k = Trigonometry<T>::atan2(v, w)/v;
+    return QuaternionT(ln_norm, x*k, y*k, z*k);
+}
+
+template <typename T>
+QuaternionT<T> QuaternionT<T>::nlerp(const QuaternionT& q0, const QuaternionT& q1, T t)
+{
+    // negate q1 if required, so interpolation is along the shortest path
+    const T t1 = q0.dot(q1) < T(0) ? -t : t;
+    return (q0*(T(1) - t) + q1*t1).normalized();
+}
+
+template <typename T>
+QuaternionT<T> QuaternionT<T>::slerp(const QuaternionT& q0, const QuaternionT& q1, T t)
+{
+    using std::abs;
+    const T d = q0.dot(q1);
+    if (abs(d) > SLERP_NLERP_THRESHOLD) {
+        return nlerp(q0, q1, t);
+    }
+    // negate q1 if required, so interpolation is along the shortest path
+    const QuaternionT q = d < T(0) ? -q1 : q1;
+    const T theta = Trigonometry<T>::acos(abs(d));
+    const T r = T(1)/Trigonometry<T>::sin(theta);
+    return q0*(Trigonometry<T>::sin((T(1) - t)*theta)*r) + q*(Trigonometry<T>::sin(t*theta)*r);
+}
+
+namespace {
+
+using V = simd_float_t;
+
+/*!
+Normalize WIDTH elements, each of N floats, from p into out (which may be the same as p).
+The magnitude squared is summed in the same order as the single element magnitude_squared() functions, so with rsqrt_precision_e::FULL
+the results match those of the single element normalized() functions, to within RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR
+(and a few ulps, see simd_float.h).
+*/
+template <size_t N, rsqrt_precision_e P>
+void normalize_block(const float* p, float* out)
+{
+    static_assert(N >= 2 && N <= 4);
+    V a {};
+    V b {};
+    V c {};
+    V d {};
+    if constexpr (N == 2) {
+        V::load_interleaved2(p, a, b);
+    } else if constexpr (N == 3) {
+        V::load_interleaved3(p, a, b, c);
+    } else {
+        V::load_interleaved4(p, a, b, c, d);
+    }
+    V m2 = a*a + b*b;
+    if constexpr (N >= 3) { m2 = m2 + c*c; }
+    if constexpr (N == 4) { m2 = m2 + d*d; }
+    const V r = V::reciprocal_sqrt<P>(m2);
+    if constexpr (N == 2) {
+        V::store_interleaved2(out, a*r, b*r);
+    } else if constexpr (N == 3) {
+        V::store_interleaved3(out, a*r, b*r, c*r);
+    } else {
+        V::store_interleaved4(out, a*r, b*r, c*r, d*r);
+    }
+}
+
+/*!
+Normalize the elements of v, each of N floats, into out.
+*/
+template <typename E, rsqrt_precision_e P>
+void normalize_batch(std::span<const E> v, std::span<E> out)
+{
+    constexpr size_t N = sizeof(E)/sizeof(float);
+    V::for_each_block(v, out, [](const E* pv, E* pout, size_t ii) {
+        (void)ii;
+        normalize_block<N, P>(reinterpret_cast<const float*>(pv), reinterpret_cast<float*>(pout)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    });
+}
+
+template <typename E>
+void normalize_batch(std::span<const E> v, std::span<E> out, rsqrt_precision_e precision)
+{
+    switch (precision) {
+    case rsqrt_precision_e::ESTIMATE:
+        normalize_batch<E, rsqrt_precision_e::ESTIMATE>(v, out);
+        break;
+    case rsqrt_precision_e::ONE_ITERATION:
+        normalize_batch<E, rsqrt_precision_e::ONE_ITERATION>(v, out);
+        break;
+    case rsqrt_precision_e::FULL:
+    default:
+        normalize_batch<E, rsqrt_precision_e::FULL>(v, out);
+        break;
+    }
+}
+
+} // end namespace
+
+/*!
+Normalize an array of vectors, simd_float_t::WIDTH vectors at a time.
+*/
+template <typename T>
+void xy_type<T>::normalize_batch(std::span<const xy_type> v, std::span<xy_type> out, rsqrt_precision_e precision) requires std::same_as<T, float>
+{
+    static_assert(sizeof(xy_t) == 2*sizeof(float));
+    ::normalize_batch(v, out, precision);
+}
+
+/*!
+Normalize an array of vectors, simd_float_t::WIDTH vectors at a time.
+*/
+template <typename T>
+void xyz_type<T>::normalize_batch(std::span<const xyz_type> v, std::span<xyz_type> out, rsqrt_precision_e precision) requires std::same_as<T, float>
+{
+    static_assert(sizeof(xyz_t) == 3*sizeof(float));
+    ::normalize_batch(v, out, precision);
+}
+
+/*!
+Normalize an array of quaternions, simd_float_t::WIDTH quaternions at a time.
+*/
+template <typename T>
+void QuaternionT<T>::normalize_batch(std::span<const QuaternionT> q, std::span<QuaternionT> out, rsqrt_precision_e precision) requires std::same_as<T, float>
+{
+    static_assert(sizeof(Quaternion) == 4*sizeof(float));
+    ::normalize_batch(q, out, precision);
+}
+
 /*
 See
 https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles#Quaternion_to_Euler_angles_(in_3-2-1_sequence)_conversion
 for Quaternion to Euler angles conversion.
 */
-float Quaternion::calculate_roll_radians() const
+template <typename T>
+T QuaternionT<T>::calculate_roll_radians() const
 {
-    return atan2f(w*x + y*z, 0.5F - x*x - y*y); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    return Trigonometry<T>::atan2(w*x + y*z, T(0.5F) - x*x - y*y); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 }
 
-float Quaternion::calculate_pitch_radians() const
+template <typename T>
+T QuaternionT<T>::calculate_pitch_radians() const
 {
-    return asinf(2.0F*(w*y - x*z)); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    return Trigonometry<T>::asin(T(2)*(w*y - x*z)); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
 }
 
-float Quaternion::calculate_yaw_radians() const
+template <typename T>
+T QuaternionT<T>::calculate_yaw_radians() const
 {
-    return atan2f(w*z + x*y, 0.5F - y*y - z*z); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    return Trigonometry<T>::atan2(w*z + x*y, T(0.5F) - y*y - z*z); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     // alternatively
-    // return atan2f(2*(w*z + x*y), w*w + x*x - y*y - z*z);
+    // return atan2(2*(w*z + x*y), w*w + x*x - y*y - z*z);
+}
+
+template <typename T>
+attitude_type<T> QuaternionT<T>::attitude() const
+{
+    using std::sqrt;
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const T a_roll = w*x + y*z;
+    const T b_roll = T(0.5F) - x*x - y*y;
+    const T a_yaw = w*z + x*y;
+    const T b_yaw = T(0.5F) - y*y - z*z;
+    const T sin_pitch = T(2)*(w*y - x*z);
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const T r_roll = reciprocal_sqrt(a_roll*a_roll + b_roll*b_roll);
+    const T r_yaw = reciprocal_sqrt(a_yaw*a_yaw + b_yaw*b_yaw);
+    const T cos_pitch = sqrt(T(1) - sin_pitch*sin_pitch);
+
+    return attitude_type<T> {
+        .roll = Trigonometry<T>::atan2(a_roll, b_roll),
+        .pitch = Trigonometry<T>::asin(sin_pitch),
+        .yaw = Trigonometry<T>::atan2(a_yaw, b_yaw),
+        .sin_roll = a_roll*r_roll,
+        .cos_roll = b_roll*r_roll,
+        .tan_roll = a_roll/b_roll,
+        .sin_pitch = sin_pitch,
+        .cos_pitch = cos_pitch,
+        .tan_pitch = sin_pitch/cos_pitch,
+        .sin_yaw = a_yaw*r_yaw,
+        .cos_yaw = b_yaw*r_yaw,
+        .tan_yaw = a_yaw/b_yaw
+    };
 }
 
-float Quaternion::sin_roll() const
+/*!
+simd_float_t::WIDTH quaternions are processed at a time, the results are then written out lane by lane, since attitude_t is an array of structures.
+*/
+template <typename T>
+void QuaternionT<T>::attitude_batch(std::span<const QuaternionT> q, std::span<attitude_type<T>> out) requires std::same_as<T, float>
 {
-    const float a = w*x + y*z;
-    const float b = 0.5F - x*x - y*y;
-    return a * reciprocal_sqrtf(a*a + b*b);
+    static_assert(sizeof(Quaternion) == 4*sizeof(float));
+    static_assert(sizeof(attitude_t) == 12*sizeof(float));
+    using V = simd_float_t;
+
+    V::for_each_block(q, out, [](const Quaternion* pq, attitude_t* pout, size_t ii) {
+        (void)ii;
+        V qw {};
+        V qx {};
+        V qy {};
+        V qz {};
+        V::load_interleaved4(reinterpret_cast<const float*>(pq), qw, qx, qy, qz); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+
+        const V half = V::broadcast(0.5F); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+        const V a_roll = qw*qx + qy*qz;
+        const V b_roll = half - qx*qx - qy*qy;
+        const V a_yaw = qw*qz + qx*qy;
+        const V b_yaw = half - qy*qy - qz*qz;
+        const V sin_pitch = V::broadcast(2.0F)*(qw*qy - qx*qz);
+        const V r_roll = V::reciprocal_sqrt<rsqrt_precision_e::FULL>(a_roll*a_roll + b_roll*b_roll);
+        const V r_yaw = V::reciprocal_sqrt<rsqrt_precision_e::FULL>(a_yaw*a_yaw + b_yaw*b_yaw);
+        const V cos_pitch = V::sqrt(V::broadcast(1.0F) - sin_pitch*sin_pitch);
+
+        // same order as the members of attitude_t
+        const std::array<std::array<float, V::WIDTH>, 12> lanes = V::store_lanes<12>({{
+            FastTrigonometrySimd::atan2(a_roll, b_roll), FastTrigonometrySimd::asin(sin_pitch), FastTrigonometrySimd::atan2(a_yaw, b_yaw),
+            a_roll*r_roll, b_roll*r_roll, a_roll/b_roll,
+            sin_pitch, cos_pitch, sin_pitch/cos_pitch,
+            a_yaw*r_yaw, b_yaw*r_yaw, a_yaw/b_yaw
+        }});
+        for (size_t ll = 0; ll < V::WIDTH; ++ll) {
+            pout[ll] = attitude_t { // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                lanes[0][ll], lanes[1][ll], lanes[2][ll],
+                lanes[3][ll], lanes[4][ll], lanes[5][ll],
+                lanes[6][ll], lanes[7][ll], lanes[8][ll],
+                lanes[9][ll], lanes[10][ll], lanes[11][ll]
+            };
+        }
+    });
+}
+
+template <typename T>
+T QuaternionT<T>::sin_roll() const
+{
+    const T a = w*x + y*z;
+    const T b = T(0.5F) - x*x - y*y;
+    return a * reciprocal_sqrt(a*a + b*b);
 }
 /*!
-clip sin(rollAngle) to +/-1.0F when roll angle outside range [-90 degrees, 90 degrees]
+clip sin(rollAngle) to +/-1 when roll angle outside range [-90 degrees, 90 degrees]
 */
-float Quaternion::sin_roll_clipped() const
+template <typename T>
+T QuaternionT<T>::sin_roll_clipped() const
+{
+    const T a = w*x + y*z;
+    const T b = T(0.5F) - x*x - y*y;
+    return std::signbit(b) ? std::copysign(T(1), a) : a * reciprocal_sqrt(a*a + b*b);
+}
+
+template <typename T>
+T QuaternionT<T>::cos_roll() const
 {
-    const float a = w*x + y*z;
-    const float b = 0.5F - x*x - y*y;
-    return std::signbit(b) ? std::copysignf(1.0F, a) : a * reciprocal_sqrtf(a*a + b*b);
+    const T a = w*x + y*z;
+    const T b = T(0.5F) - x*x - y*y;
+    return b * reciprocal_sqrt(a*a + b*b);
 }
 
-float Quaternion::cos_roll() const
+template <typename T>
+T QuaternionT<T>::cos_pitch() const
 {
-    const float a = w*x + y*z;
-    const float b = 0.5F - x*x - y*y;
-    return b * reciprocal_sqrtf(a*a + b*b);
+    using std::sqrt;
+    const T s = sin_pitch();
+    return sqrt(T(1) - s*s);
 }
 
-float Quaternion::cos_pitch() const
+template <typename T>
+T QuaternionT<T>::tan_pitch() const
 {
-    const float s = sin_pitch();
-    return sqrtf(1.0F - s*s);
+    const T s = sin_pitch();
+    return s * reciprocal_sqrt(T(1) - s*s);
 }
 
-float Quaternion::tan_pitch() const
+template <typename T>
+T QuaternionT<T>::cos_yaw() const
 {
-    const float s = sin_pitch();
-    return s * reciprocal_sqrtf(1.0F - s*s);
+    const T a = w*z + x*y;
+    const T b = T(0.5F) - y*y - z*z;
+    return b * reciprocal_sqrt(a*a + b*b);
 }
 
-float Quaternion::cos_yaw() const
+template <typename T>
+T QuaternionT<T>::sin_yaw() const
 {
-    const float a = w*z + x*y;
-    const float b = 0.5F - y*y - z*z;
-    return b * reciprocal_sqrtf(a*a + b*b);
+    const T a = w*z + x*y;
+    const T b = T(0.5F) - y*y - z*z;
+    return a * reciprocal_sqrt(a*a + b*b);
 }
 
-float Quaternion::sin_yaw() const
+template <typename T>
+std::array<T, 9> SymmetricMatrix3x3T<T>::premultiply(const Matrix3x3T<T>& f) const
 {
-    const float a = w*z + x*y;
-    const float b = 0.5F - y*y - z*z;
-    return a * reciprocal_sqrtf(a*a + b*b);
+    return std::array<T, 9> {{
+        f[0]*_a[0] + f[1]*_a[1] + f[2]*_a[2],   f[0]*_a[1] + f[1]*_a[3] + f[2]*_a[4],   f[0]*_a[2] + f[1]*_a[4] + f[2]*_a[5],
+        f[3]*_a[0] + f[4]*_a[1] + f[5]*_a[2],   f[3]*_a[1] + f[4]*_a[3] + f[5]*_a[4],   f[3]*_a[2] + f[4]*_a[4] + f[5]*_a[5],
+        f[6]*_a[0] + f[7]*_a[1] + f[8]*_a[2],   f[6]*_a[1] + f[7]*_a[3] + f[8]*_a[4],   f[6]*_a[2] + f[7]*_a[4] + f[8]*_a[5]
+    }};
 }
+
+/*!
+Only the six elements on and above the diagonal of f*P*f^T are calculated, since it is symmetric.
+*/
+template <typename T>
+SymmetricMatrix3x3T<T> SymmetricMatrix3x3T<T>::congruence(const Matrix3x3T<T>& f) const
+{
+    const std::array<T, 9> fp = premultiply(f);
+    return SymmetricMatrix3x3T(
+        fp[0]*f[0] + fp[1]*f[1] + fp[2]*f[2],
+        fp[0]*f[3] + fp[1]*f[4] + fp[2]*f[5],
+        fp[0]*f[6] + fp[1]*f[7] + fp[2]*f[8],
+        fp[3]*f[3] + fp[4]*f[4] + fp[5]*f[5],
+        fp[3]*f[6] + fp[4]*f[7] + fp[5]*f[8],
+        fp[6]*f[6] + fp[7]*f[7] + fp[8]*f[8]
+    );
+}
+
+template <typename T>
+SymmetricMatrix3x3T<T> SymmetricMatrix3x3T<T>::congruence_add(const Matrix3x3T<T>& f, const SymmetricMatrix3x3T& q) const
+{
+    const std::array<T, 9> fp = premultiply(f);
+    return SymmetricMatrix3x3T(
+        fp[0]*f[0] + fp[1]*f[1] + fp[2]*f[2] + q[0],
+        fp[0]*f[3] + fp[1]*f[4] + fp[2]*f[5] + q[1],
+        fp[0]*f[6] + fp[1]*f[7] + fp[2]*f[8] + q[2],
+        fp[3]*f[3] + fp[4]*f[4] + fp[5]*f[5] + q[3],
+        fp[3]*f[6] + fp[4]*f[7] + fp[5]*f[8] + q[4],
+        fp[6]*f[6] + fp[7]*f[7] + fp[8]*f[8] + q[5]
+    );
+}
+
+/*!
+Gram-Schmidt orthonormalization: the first row is normalized, the component along the first row is removed from the second row
+and it is normalized, and the third row is the cross product of the first two, which also ensures the determinant is +1.
+Uses 1/sqrt rather than reciprocal_sqrt, so the result is orthonormal to within rounding even when the FAST_RECIPROCAL_SQUARE_ROOT macros are defined.
+*/
+template <typename T>
+void RotationMatrix3x3T<T>::orthonormalize_in_place()
+{
+    using std::sqrt;
+    xyz_type<T> x { _m[0], _m[1], _m[2] };
+    xyz_type<T> y { _m[3], _m[4], _m[5] };
+    x *= T(1)/sqrt(x.dot(x));
+    y -= x*x.dot(y);
+    y *= T(1)/sqrt(y.dot(y));
+    _m = Matrix3x3T<T>(x, y, x.cross(y));
+}
+
+/*!
+See Premerlani and Bizard, "Direction Cosine Matrix IMU: Theory", equations 18 to 21.
+The orthogonality error x.y is shared equally between the first two rows, the third row is their cross product,
+and each row is normalized using the first-order Taylor expansion of 1/sqrt(v.v) about 1, which needs no square root.
+*/
+template <typename T>
+void RotationMatrix3x3T<T>::renormalize_in_place()
+{
+    const xyz_type<T> x0 { _m[0], _m[1], _m[2] };
+    const xyz_type<T> y0 { _m[3], _m[4], _m[5] };
+    const T half_error = T(0.5F)*x0.dot(y0); // NOLINT(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    const xyz_type<T> x = x0 - y0*half_error;
+    const xyz_type<T> y = y0 - x0*half_error;
+    const xyz_type<T> z = x.cross(y);
+    // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+    _m = Matrix3x3T<T>(x*(T(1.5F) - T(0.5F)*x.dot(x)), y*(T(1.5F) - T(0.5F)*y.dot(y)), z*(T(1.5F) - T(0.5F)*z.dot(z)));
+    // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+}
+
+/*!
+First-order integration of R_dot = R*[omega]x, each row r of R is updated to r + r x (omega*dt).
+*/
+template <typename T>
+void RotationMatrix3x3T<T>::integrate(const xyz_type<T>& angular_velocity, T dt)
+{
+    const xyz_type<T> theta = angular_velocity*dt;
+    const xyz_type<T> x { _m[0], _m[1], _m[2] };
+    const xyz_type<T> y { _m[3], _m[4], _m[5] };
+    const xyz_type<T> z { _m[6], _m[7], _m[8] };
+    _m = Matrix3x3T<T>(x + x.cross(theta), y + y.cross(theta), z + z.cross(theta));
+    renormalize_in_place();
+}
+
+template <typename T>
+void RotationMatrix3x3T<T>::orthonormalize_batch(std::span<RotationMatrix3x3T> r)
+{
+    for (RotationMatrix3x3T& m : r) {
+        m.orthonormalize_in_place();
+    }
+}
+
+template <typename T>
+void RotationMatrix3x3T<T>::renormalize_batch(std::span<RotationMatrix3x3T> r)
+{
+    for (RotationMatrix3x3T& m : r) {
+        m.renormalize_in_place();
+    }
+}
+
+template <typename T>
+void RotationMatrix3x3T<T>::integrate_batch(std::span<RotationMatrix3x3T> r, std::span<const xyz_type<T>> angular_velocity, T dt)
+{
+    for (size_t ii = 0; ii < r.size(); ++ii) {
+        r[ii].integrate(angular_velocity[ii], dt);
+    }
+}
+
+template <typename T>
+Matrix3x3T<T> Cholesky3x3T<T>::solve(const Matrix3x3T<T>& b) const
+{
+    const xyz_type<T> x0 = solve(xyz_type<T>{ b[0], b[3], b[6] });
+    const xyz_type<T> x1 = solve(xyz_type<T>{ b[1], b[4], b[7] });
+    const xyz_type<T> x2 = solve(xyz_type<T>{ b[2], b[5], b[8] });
+    return Matrix3x3T<T>(x0.x, x1.x, x2.x, x0.y, x1.y, x2.y, x0.z, x1.z, x2.z);
+}
+
+/*!
+X*S = B is equivalent to S*X^T = B^T, since S is symmetric, so each row of X is the solution for the corresponding row of B.
+*/
+template <typename T>
+Matrix3x3T<T> Cholesky3x3T<T>::solve_right(const Matrix3x3T<T>& b) const
+{
+    return Matrix3x3T<T>(solve(xyz_type<T>{ b[0], b[1], b[2] }), solve(xyz_type<T>{ b[3], b[4], b[5] }), solve(xyz_type<T>{ b[6], b[7], b[8] }));
+}
+
+/*!
+The inverse is symmetric, so only the elements on and above its diagonal are needed.
+*/
+template <typename T>
+SymmetricMatrix3x3T<T> Cholesky3x3T<T>::inverse() const
+{
+    const xyz_type<T> c0 = solve(xyz_type<T>{ T(1), T(0), T(0) });
+    const xyz_type<T> c1 = solve(xyz_type<T>{ T(0), T(1), T(0) });
+    const T c22 = _r[2]*_r[2]; // the bottom right element of the inverse is 1/l22^2
+    return SymmetricMatrix3x3T<T>(c0.x, c0.y, c0.z, c1.y, c1.z, c22);
+}
+
+template <typename T>
+bool Cholesky3x3T<T>::factorize_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<Cholesky3x3T> out)
+{
+    bool ret = true;
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        ret = out[ii].factorize(s[ii]) && ret;
+    }
+    return ret;
+}
+
+template <typename T>
+bool Cholesky3x3T<T>::solve_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<const xyz_type<T>> b, std::span<xyz_type<T>> out)
+{
+    bool ret = true;
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        Cholesky3x3T cholesky;
+        ret = cholesky.factorize(s[ii]) && ret;
+        // the factor is zero if s[ii] is not positive definite, so the solution is also zero
+        out[ii] = cholesky.solve(b[ii]);
+    }
+    return ret;
+}
+
+template <typename T>
+bool LDLT3x3T<T>::factorize_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<LDLT3x3T> out)
+{
+    bool ret = true;
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        ret = out[ii].factorize(s[ii]) && ret;
+    }
+    return ret;
+}
+
+template <typename T>
+bool LDLT3x3T<T>::solve_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<const xyz_type<T>> b, std::span<xyz_type<T>> out)
+{
+    bool ret = true;
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        LDLT3x3T ldlt;
+        ret = ldlt.factorize(s[ii]) && ret;
+        // the factor is zero if s[ii] is singular, so the solution is also zero
+        out[ii] = ldlt.solve(b[ii]);
+    }
+    return ret;
+}
+
+namespace {
+/*!
+Jacobi rotation in the (p, q) plane, chosen to zero apq, r is the third index.
+Uses the formulation of Rutishauser (see Numerical Recipes, section 11.1), which minimizes rounding error.
+The rotation is accumulated into columns p and q of the eigenvector matrix v.
+*/
+template <typename T>
+void jacobi_rotate(T& app, T& aqq, T& apq, T& arp, T& arq, Matrix3x3T<T>& v, size_t p, size_t q)
+{
+    if (apq == T(0)) {
+        return;
+    }
+    using std::abs;
+    using std::sqrt;
+    const T theta = (aqq - app)/(T(2)*apq);
+    // t is the tangent of the rotation angle, the smaller root of t^2 + 2*t*theta - 1 = 0, so the rotation angle is at most 45 degrees
+    T t = T(1)/(abs(theta) + sqrt(theta*theta + T(1)));
+    if (theta < T(0)) {
+        t = -t;
+    }
+    const T c = T(1)/sqrt(t*t + T(1));
+    const T s = t*c;
+    const T tau = s/(T(1) + c);
+    app -= t*apq;
+    aqq += t*apq;
+    apq = T(0);
+    const T rp = arp;
+    arp -= s*(arq + tau*rp);
+    arq += s*(rp - tau*arq);
+    for (size_t ii = 0; ii < 9; ii += 3) {
+        const T vp = v[ii + p];
+        const T vq = v[ii + q];
+        v[ii + p] = vp - s*(vq + tau*vp);
+        v[ii + q] = vq + s*(vp - tau*vq);
+    }
+}
+} // end namespace
+
+/*!
+Cyclic Jacobi: each sweep zeros a01, a02, and a12 in turn, until the off-diagonal elements are negligible compared with the diagonal.
+Convergence is quadratic, so few sweeps are needed.
+*/
+template <typename T>
+void SymmetricEigen3x3T<T>::decompose(const SymmetricMatrix3x3T<T>& s)
+{
+    T a00 = s[0];
+    T a01 = s[1];
+    T a02 = s[2];
+    T a11 = s[3];
+    T a12 = s[4];
+    T a22 = s[5];
+    Matrix3x3T<T> v(T(1));
+    constexpr T epsilon_squared = std::numeric_limits<T>::epsilon()*std::numeric_limits<T>::epsilon();
+    for (uint32_t sweep = 0; sweep < MAX_SWEEPS; ++sweep) {
+        const T off = a01*a01 + a02*a02 + a12*a12;
+        if (off <= epsilon_squared*(a00*a00 + a11*a11 + a22*a22)) {
+            break;
+        }
+        jacobi_rotate(a00, a11, a01, a02, a12, v, 0, 1);
+        jacobi_rotate(a00, a22, a02, a01, a12, v, 0, 2);
+        jacobi_rotate(a11, a22, a12, a01, a02, v, 1, 2);
+    }
+    // sort the eigenvalues, largest first, swapping the eigenvector columns to match
+    xyz_type<T> e { a00, a11, a22 };
+    const auto swap = [&e, &v](size_t p, size_t q) {
+        if (e[p] < e[q]) {
+            std::swap(e[p], e[q]);
+            for (size_t ii = 0; ii < 9; ii += 3) {
+                std::swap(v[ii + p], v[ii + q]);
+            }
+        }
+    };
+    swap(0, 1);
+    swap(1, 2);
+    swap(0, 1);
+    // the Jacobi rotations have determinant +1, but swapping columns changes the sign of the determinant
+    if (v.determinant() < T(0)) {
+        v[2] = -v[2];
+        v[5] = -v[5];
+        v[8] = -v[8];
+    }
+    _eigenvectors = v;
+    _eigenvalues = e;
+}
+
+template <typename T>
+SymmetricMatrix3x3T<T> SymmetricEigen3x3T<T>::matrix() const
+{
+    const Matrix3x3T<T>& v = _eigenvectors;
+    const xyz_type<T>& e = _eigenvalues;
+    // element (i, j) is the sum over k of e[k]*v(i, k)*v(j, k)
+    const xyz_type<T> r0 { e.x*v[0], e.y*v[1], e.z*v[2] };
+    const xyz_type<T> r1 { e.x*v[3], e.y*v[4], e.z*v[5] };
+    const xyz_type<T> r2 { e.x*v[6], e.y*v[7], e.z*v[8] };
+    return SymmetricMatrix3x3T<T>(
+        r0.dot(xyz_type<T>{ v[0], v[1], v[2] }), r0.dot(xyz_type<T>{ v[3], v[4], v[5] }), r0.dot(xyz_type<T>{ v[6], v[7], v[8] }),
+        r1.dot(xyz_type<T>{ v[3], v[4], v[5] }), r1.dot(xyz_type<T>{ v[6], v[7], v[8] }),
+        r2.dot(xyz_type<T>{ v[6], v[7], v[8] })
+    );
+}
+
+/*!
+See Smith, "Eigenvalues of a symmetric 3x3 matrix", Communications of the ACM, 1961.
+With q the mean of the eigenvalues and S = q*I + p*B, the eigenvalues of B are 2*cos(phi + 2*k*PI/3), where cos(3*phi) = det(B)/2.
+*/
+template <typename T>
+xyz_type<T> SymmetricEigen3x3T<T>::calculate_eigenvalues(const SymmetricMatrix3x3T<T>& s)
+{
+    const T q = (s[0] + s[3] + s[5])/T(3);
+    const T b00 = s[0] - q;
+    const T b11 = s[3] - q;
+    const T b22 = s[5] - q;
+    const T p2 = (b00*b00 + b11*b11 + b22*b22 + T(2)*(s[1]*s[1] + s[2]*s[2] + s[4]*s[4]))/T(6);
+    if (p2 <= std::numeric_limits<T>::min()) {
+        // s is a multiple of the identity
+        return xyz_type<T>{ q, q, q };
+    }
+    using std::sqrt;
+    const T p = sqrt(p2);
+    const T det = b00*(b11*b22 - s[4]*s[4]) - s[1]*(s[1]*b22 - s[4]*s[2]) + s[2]*(s[1]*s[4] - b11*s[2]);
+    // clamp to [-1, 1], since rounding can take det(B)/2 slightly outside this range
+    const T r = std::clamp(det/(T(2)*p2*p), T(-1), T(1));
+    const T phi = Trigonometry<T>::acos(r)/T(3);
+    const T e0 = q + T(2)*p*Trigonometry<T>::cos(phi);
+    const T e2 = q + T(2)*p*Trigonometry<T>::cos(phi + T(2)*QuaternionT<T>::M_PI_F/T(3));
+    return xyz_type<T>{ e0, T(3)*q - e0 - e2, e2 };
+}
+
+template <typename T>
+void SymmetricEigen3x3T<T>::eigenvalues_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<xyz_type<T>> out)
+{
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        out[ii] = calculate_eigenvalues(s[ii]);
+    }
+}
+
+template <typename T>
+void SymmetricEigen3x3T<T>::decompose_batch(std::span<const SymmetricMatrix3x3T<T>> s, std::span<SymmetricEigen3x3T> out)
+{
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        out[ii].decompose(s[ii]);
+    }
+}
+
+template struct xy_type<float>;
+template struct xy_type<double>;
+template struct xyz_type<float>;
+template struct xyz_type<double>;
+template class QuaternionT<float>;
+template class QuaternionT<double>;
+template class Matrix3x3T<float>;
+template class Matrix3x3T<double>;
+template class SymmetricMatrix3x3T<float>;
+template class SymmetricMatrix3x3T<double>;
+template class RotationMatrix3x3T<float>;
+template class RotationMatrix3x3T<double>;
+template class Cholesky3x3T<float>;
+template class Cholesky3x3T<double>;
+template class LDLT3x3T<float>;
+template class LDLT3x3T<double>;
+template class SymmetricEigen3x3T<float>;
+template class SymmetricEigen3x3T<double>;
+
+// no non-inline functions are instantiated for q2_30_t: rotate and normalized are specialized in q2_30_type.cpp,
+// and the remaining functions use angles or constants outside the range [-2, 2)
@@ -1,60 +1,73 @@
 #pragma once
 
+#include "reciprocal_sqrt.h"
+
 #include <cmath>
+#include <concepts>
+#include <span>
 
-struct xy_t {
+/*!
+2D vector, templated on the scalar type T, see xy_t (float) and xyd_t (double).
+*/
+template <typename T>
+struct xy_type {
 public:
     // Assignment
-    xy_t& operator=(float k) { *this = {k, k }; return *this; }
+    [[gnu::always_inline]] constexpr xy_type& operator=(T k) { *this = {k, k }; return *this; }
 
     // Equality operators
-    bool operator==(const xy_t& v) const { return x == v.x &&  y == v.y; }
-    bool operator!=(const xy_t& v) const { return x != v.x ||  y != v.y; }
+    [[gnu::always_inline]] constexpr bool operator==(const xy_type& v) const { return x == v.x &&  y == v.y; }
+    [[gnu::always_inline]] constexpr bool operator!=(const xy_type& v) const { return x != v.x ||  y != v.y; }
 
     // Index operators
-    float operator[](size_t pos) const { return (pos == 0) ? x : y; } //<! Index operator
-    float& operator[](size_t pos) { return (pos == 0) ? x : y; } //<! Index operator
+    [[gnu::always_inline]] constexpr T operator[](size_t pos) const { return (pos == 0) ? x : y; } //<! Index operator
+    [[gnu::always_inline]] constexpr T& operator[](size_t pos) { return (pos == 0) ? x : y; } //<! Index operator
 
     // Unary operators
-    xy_t operator+() const { return *this; } //<! Unary plus
-    xy_t operator-() const { return xy_t{-x, -y }; } //<! Unary negation
+    [[gnu::always_inline]] constexpr xy_type operator+() const { return *this; } //<! Unary plus
+    [[gnu::always_inline]] constexpr xy_type operator-() const { return xy_type{-x, -y }; } //<! Unary negation
 
-    xy_t operator+=(const xy_t& v) { x += v.x; y += v.y; return *this; } //<! Addition
-    xy_t operator-=(const xy_t& v) { x -= v.x; y -= v.y; return *this; } //<! Subtraction
-    xy_t operator*=(float k) { x*=k; y*=k; return *this; } //<! Multiplication by a scalar
-    xy_t operator/=(float k) { const float r = 1.0F/k; x*=r; y*=r; return *this; } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr xy_type operator+=(const xy_type& v) { x += v.x; y += v.y; return *this; } //<! Addition
+    [[gnu::always_inline]] constexpr xy_type operator-=(const xy_type& v) { x -= v.x; y -= v.y; return *this; } //<! Subtraction
+    [[gnu::always_inline]] constexpr xy_type operator*=(T k) { x*=k; y*=k; return *this; } //<! Multiplication by a scalar
+    [[gnu::always_inline]] constexpr xy_type operator/=(T k) { const T r = T(1)/k; x*=r; y*=r; return *this; } //<! Division by a scalar
 
     // Binary operators
-    xy_t operator+(const xy_t& v) const { return xy_t{x + v.x, y + v.y}; } //<! Addition
-    xy_t operator-(const xy_t& v) const { return xy_t{x - v.x, y - v.y}; } //<! Subtraction
-    xy_t operator*(float k) const { return xy_t{x*k, y*k}; } //<! Multiplication by a scalar
-    friend xy_t operator*(float k, const xy_t& v) { return v*k; } //<! Pre-multiplication by a scalar
-    xy_t operator/(float k) const { const float r = 1.0F/k; return *this*r; } //<! Division by a scalar
-    float dot(const xy_t& v) const { return  x*v.x + y*v.y; } //!< Vector dot product
-    float cross(const xy_t& v) const { return x*v.y - y*v.x; } //!< Z component of vector cross product of this and v extended to 3D
-    float distance_squared(const xy_t& v) const { return (x-v.x)*(x-v.x) + (y-v.y)*(y-v.y); } //!< Distance between two points squared
-    float distance(const xy_t& v) const { return sqrtf(distance_squared(v)); } //!< Distance between two points
+    [[gnu::always_inline]] constexpr xy_type operator+(const xy_type& v) const { return xy_type{x + v.x, y + v.y}; } //<! Addition
+    [[gnu::always_inline]] constexpr xy_type operator-(const xy_type& v) const { return xy_type{x - v.x, y - v.y}; } //<! Subtraction
+    [[gnu::always_inline]] constexpr xy_type operator*(T k) const { return xy_type{x*k, y*k}; } //<! Multiplication by a scalar
+    [[gnu::always_inline]] friend constexpr xy_type operator*(T k, const xy_type& v) { return v*k; } //<! Pre-multiplication by a scalar
+    [[gnu::always_inline]] constexpr xy_type operator/(T k) const { const T r = T(1)/k; return *this*r; } //<! Division by a scalar
+    [[gnu::always_inline]] constexpr T dot(const xy_type& v) const { return  x*v.x + y*v.y; } //!< Vector dot product
+    [[gnu::always_inline]] constexpr T cross(const xy_type& v) const { return x*v.y - y*v.x; } //!< Z component of vector cross product of this and v extended to 3D
+    [[gnu::always_inline]] constexpr T distance_squared(const xy_type& v) const { return (x-v.x)*(x-v.x) + (y-v.y)*(y-v.y); } //!< Distance between two points squared
+    T distance(const xy_type& v) const { using std::sqrt; return sqrt(distance_squared(v)); } //!< Distance between two points
 
     // Other functions
-    float magnitude_squared() const { return x*x + y*y; } //<! The square of the magnitude
-    float magnitude() const { return sqrtf(magnitude_squared()); } //<! The  magnitude
-    float squared_norm() const { return magnitude_squared(); } //<! The square of the magnitude (using Eigen library naming)
-    float norm() const { return magnitude(); } //<! The  magnitude (using Eigen library naming)
-    xy_t normalized() const; //<! Return the normalized vector
-    xy_t normalize() { *this=normalized(); return *this; } //<! Normalize, in-place (using Eigen library naming)
-    xy_t absolute() const { return{std::fabs(x), std::fabs(y) };  }//<! Return the vector consisting of the absolute value of all components
-    xy_t absolute_in_place() { *this=absolute(); return *this; } //<! Absolute value of all components, in-place
-    static float clamp(float value, float min, float max) { return value < min ? min : value > max ? max : value; } //<! Clamp helper function
-    static xy_t clamp(const xy_t& v, float min, float max) { return xy_t{clamp(v.x, min, max), clamp(v.y, min, max)}; } //<! Return clamped value
-    xy_t clamp_in_place(float min, float max) { x = clamp(x, min, max); y = clamp(y, min, max); return *this; } //<! Clamp, in-place
-
-    void set_zero() { x = 0.0F; y = 0.0F; }
-    void set_ones() { x = 1.0F; y = 1.0F; }
-    void set_constant(float value) { x = value; y = value; }
-    float sum() const { return x + y; }
-    float mean() const { return sum()*0.5F; }
-    float prod() const { return x*y; }
+    [[gnu::always_inline]] constexpr T magnitude_squared() const { return x*x + y*y; } //<! The square of the magnitude
+    T magnitude() const { using std::sqrt; return sqrt(magnitude_squared()); } //<! The  magnitude
+    [[gnu::always_inline]] constexpr T squared_norm() const { return magnitude_squared(); } //<! The square of the magnitude (using Eigen library naming)
+    T norm() const { return magnitude(); } //<! The  magnitude (using Eigen library naming)
+    xy_type normalized() const; //<! Return the normalized vector
+    xy_type normalize() { *this=normalized(); return *this; } //<! Normalize, in-place (using Eigen library naming)
+    //! Normalize an array of vectors, out may be the same array as v
+    static void normalize_batch(std::span<const xy_type> v, std::span<xy_type> out, rsqrt_precision_e precision = rsqrt_precision_e::FULL) requires std::same_as<T, float>;
+    xy_type absolute() const { using std::abs; return{abs(x), abs(y) };  }//<! Return the vector consisting of the absolute value of all components
+    xy_type absolute_in_place() { *this=absolute(); return *this; } //<! Absolute value of all components, in-place
+    [[gnu::always_inline]] static constexpr T clamp(T value, T min, T max) { return value < min ? min : value > max ? max : value; } //<! Clamp helper function
+    [[gnu::always_inline]] static constexpr xy_type clamp(const xy_type& v, T min, T max) { return xy_type{clamp(v.x, min, max), clamp(v.y, min, max)}; } //<! Return clamped value
+    [[gnu::always_inline]] constexpr xy_type clamp_in_place(T min, T max) { x = clamp(x, min, max); y = clamp(y, min, max); return *this; } //<! Clamp, in-place
+
+    [[gnu::always_inline]] constexpr void set_zero() { x = T(0); y = T(0); }
+    [[gnu::always_inline]] constexpr void set_ones() { x = T(1); y = T(1); }
+    [[gnu::always_inline]] constexpr void set_constant(T value) { x = value; y = value; }
+    [[gnu::always_inline]] constexpr T sum() const { return x + y; }
+    [[gnu::always_inline]] constexpr T mean() const { return sum()*T(0.5F); }
+    [[gnu::always_inline]] constexpr T prod() const { return x*y; }
 public:
-    float x;
-    float y;
+    T x;
+    T y;
 };
+
+using xy_t = xy_type<float>;
+using xyd_t = xy_type<double>;
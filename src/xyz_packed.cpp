@@ -0,0 +1,270 @@
+#include "simd_float.h"
+#include "xyz_packed.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+#if !defined(LIBRARY_VECTOR_QUATERNION_MATRIX_NO_SIMD)
+#if defined(__F16C__)
+#define LIBRARY_VECTOR_QUATERNION_MATRIX_HALF_F16C
+#include <immintrin.h>
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_SIMD_NEON)
+#define LIBRARY_VECTOR_QUATERNION_MATRIX_HALF_NEON
+#endif
+#endif
+
+namespace {
+
+using V = simd_float_t;
+
+/*!
+Quantization constants for BITS bits per coordinate.
+Coordinates in the range [-1, 1] are mapped to the integers [0, 2*HALF], with zero mapped to HALF.
+*/
+template <uint32_t BITS>
+struct octahedral {
+    static constexpr float HALF = static_cast<float>((1U << (BITS - 1)) - 1);
+    static constexpr float DECODE_SCALE = 1.0F / HALF;
+
+    static uint32_t quantize(float u) { return static_cast<uint32_t>(std::clamp(roundf(u*HALF), -HALF, HALF) + HALF); }
+    static float dequantize(uint32_t k) { return (static_cast<float>(k) - HALF)*DECODE_SCALE; }
+};
+
+template <typename P>
+P encode(const xyz_t& v)
+{
+    using O = octahedral<P::BITS>;
+    // project onto the octahedron, a zero vector is left as zero, and so encoded as {0, 0, 1}
+    const float r = 1.0F / std::max(std::fabs(v.x) + std::fabs(v.y) + std::fabs(v.z), std::numeric_limits<float>::min());
+    float u = v.x*r;
+    float w = v.y*r;
+    if (v.z < 0.0F) {
+        // fold the lower half of the octahedron over onto the upper half
+        const float fu = 1.0F - std::fabs(w);
+        const float fw = 1.0F - std::fabs(u);
+        u = u < 0.0F ? -fu : fu;
+        w = w < 0.0F ? -fw : fw;
+    }
+    return P::pack(O::quantize(u), O::quantize(w));
+}
+
+template <typename P>
+xyz_t decode(const P& p)
+{
+    using O = octahedral<P::BITS>;
+    const std::array<uint32_t, 2> k = p.coordinates();
+    const float u = O::dequantize(k[0]);
+    const float w = O::dequantize(k[1]);
+    const float z = 1.0F - std::fabs(u) - std::fabs(w);
+    // unfold the lower half of the octahedron
+    const float t = std::max(-z, 0.0F);
+    const float x = u - (u < 0.0F ? -t : t);
+    const float y = w - (w < 0.0F ? -t : t);
+    // use 1/sqrt rather than reciprocal_sqrtf, so the results do not depend on the FAST_RECIPROCAL_SQUARE_ROOT macros
+    const float r = 1.0F / sqrtf(x*x + y*y + z*z);
+    return xyz_t { x*r, y*r, z*r };
+}
+
+/*!
+Encode V::WIDTH vectors, the projection, folding, and quantization are calculated in SIMD registers, the bit packing is then done lane by lane.
+*/
+template <typename P>
+void encode_block(const xyz_t* pv, P* pout)
+{
+    using O = octahedral<P::BITS>;
+    V x {};
+    V y {};
+    V z {};
+    V::load_interleaved3(reinterpret_cast<const float*>(pv), x, y, z); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+
+    const V zero = V::broadcast(0.0F);
+    const V one = V::broadcast(1.0F);
+    const V r = one / V::max(V::abs(x) + V::abs(y) + V::abs(z), V::broadcast(std::numeric_limits<float>::min()));
+    V u = x*r;
+    V w = y*r;
+    const simd_mask_t lower = z < zero;
+    const V fu = one - V::abs(w);
+    const V fw = one - V::abs(u);
+    u = V::select(lower, V::negate_if(u < zero, fu), u);
+    w = V::select(lower, V::negate_if(w < zero, fw), w);
+
+    const V half = V::broadcast(O::HALF);
+    const auto quantize = [&half](V a) { return V::max(V::min(V::round(a*half), half), -half) + half; };
+    const std::array<std::array<float, V::WIDTH>, 2> lanes = V::store_lanes<2>({{ quantize(u), quantize(w) }});
+    for (size_t ll = 0; ll < V::WIDTH; ++ll) {
+        pout[ll] = P::pack(static_cast<uint32_t>(lanes[0][ll]), static_cast<uint32_t>(lanes[1][ll])); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+}
+
+/*!
+Decode V::WIDTH vectors, the bit unpacking is done lane by lane, the unfolding and normalization are then calculated in SIMD registers.
+*/
+template <typename P>
+void decode_block(const P* pp, xyz_t* pout)
+{
+    using O = octahedral<P::BITS>;
+    std::array<std::array<float, V::WIDTH>, 2> lanes {};
+    for (size_t ll = 0; ll < V::WIDTH; ++ll) {
+        const std::array<uint32_t, 2> k = pp[ll].coordinates(); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        lanes[0][ll] = static_cast<float>(k[0]);
+        lanes[1][ll] = static_cast<float>(k[1]);
+    }
+    const V zero = V::broadcast(0.0F);
+    const V half = V::broadcast(O::HALF);
+    const V scale = V::broadcast(O::DECODE_SCALE);
+    const V u = (V::load(lanes[0].data()) - half)*scale;
+    const V w = (V::load(lanes[1].data()) - half)*scale;
+    const V z = V::broadcast(1.0F) - V::abs(u) - V::abs(w);
+    const V t = V::max(-z, zero);
+    const V x = u - V::negate_if(u < zero, t);
+    const V y = w - V::negate_if(w < zero, t);
+    const V r = V::reciprocal_sqrt<rsqrt_precision_e::FULL>(x*x + y*y + z*z);
+    V::store_interleaved3(reinterpret_cast<float*>(pout), x*r, y*r, z*r); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+template <typename P>
+void encode_batch(std::span<const xyz_t> v, std::span<P> out)
+{
+    static_assert(sizeof(xyz_t) == 3*sizeof(float));
+    V::for_each_block(v, out, [](const xyz_t* pv, P* pout, size_t ii) { (void)ii; encode_block(pv, pout); });
+}
+
+template <typename P>
+void decode_batch(std::span<const P> p, std::span<xyz_t> out)
+{
+    V::for_each_block(p, out, [](const P* pp, xyz_t* pout, size_t ii) { (void)ii; decode_block(pp, pout); });
+}
+
+} // end namespace
+
+xyz_octahedral16_t xyz_octahedral16_t::encode(const xyz_t& v)
+{
+    return ::encode<xyz_octahedral16_t>(v);
+}
+
+xyz_t xyz_octahedral16_t::decode() const
+{
+    return ::decode(*this);
+}
+
+void xyz_octahedral16_t::encode_batch(std::span<const xyz_t> v, std::span<xyz_octahedral16_t> out)
+{
+    ::encode_batch(v, out);
+}
+
+void xyz_octahedral16_t::decode_batch(std::span<const xyz_octahedral16_t> p, std::span<xyz_t> out)
+{
+    ::decode_batch(p, out);
+}
+
+xyz_octahedral32_t xyz_octahedral32_t::encode(const xyz_t& v)
+{
+    return ::encode<xyz_octahedral32_t>(v);
+}
+
+xyz_t xyz_octahedral32_t::decode() const
+{
+    return ::decode(*this);
+}
+
+void xyz_octahedral32_t::encode_batch(std::span<const xyz_t> v, std::span<xyz_octahedral32_t> out)
+{
+    ::encode_batch(v, out);
+}
+
+void xyz_octahedral32_t::decode_batch(std::span<const xyz_octahedral32_t> p, std::span<xyz_t> out)
+{
+    ::decode_batch(p, out);
+}
+
+/*!
+Normal values are rebiased and rounded in integer arithmetic, adding 0xFFF plus the lowest retained bit rounds to nearest even.
+Subnormal values are rounded by the floating point unit, by adding 0.5, whose unit in the last place is the half precision subnormal unit 2^-24.
+*/
+uint16_t xyz_half_t::float_to_half(float f)
+{
+    const auto x = std::bit_cast<uint32_t>(f);
+    const uint32_t sign = (x >> 16U) & 0x8000U;
+    const uint32_t a = x & 0x7FFFFFFFU;
+    if (a >= 0x7F800000U) {
+        // infinity, or NaN (which is kept quiet)
+        return static_cast<uint16_t>(sign | 0x7C00U | (a > 0x7F800000U ? 0x200U : 0U));
+    }
+    if (a >= 0x477FF000U) {
+        // 65520 and above round to infinity
+        return static_cast<uint16_t>(sign | 0x7C00U);
+    }
+    if (a < 0x38800000U) {
+        // below 2^-14, so subnormal or zero
+        const float t = std::bit_cast<float>(a) + 0.5F;
+        return static_cast<uint16_t>(sign | (std::bit_cast<uint32_t>(t) - 0x3F000000U));
+    }
+    const uint32_t odd = (a >> 13U) & 1U;
+    return static_cast<uint16_t>(sign | ((a - 0x38000000U + 0xFFFU + odd) >> 13U)); // rebias the exponent from 127 to 15
+}
+
+float xyz_half_t::half_to_float(uint16_t h)
+{
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000U) << 16U;
+    const uint32_t a = h & 0x7FFFU;
+    if (a >= 0x7C00U) {
+        // infinity or NaN
+        return std::bit_cast<float>(sign | 0x7F800000U | ((a & 0x3FFU) << 13U));
+    }
+    if (a < 0x400U) {
+        // subnormal or zero
+        return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(static_cast<float>(a) * 0x1p-24F));
+    }
+    return std::bit_cast<float>(sign | ((a << 13U) + 0x38000000U)); // rebias the exponent from 15 to 127
+}
+
+/*!
+The vectors are converted as a flat array of floats, four at a time when hardware conversion is available.
+*/
+void xyz_half_t::encode_batch(std::span<const xyz_t> v, std::span<xyz_half_t> out)
+{
+    static_assert(sizeof(xyz_t) == 3*sizeof(float));
+    static_assert(sizeof(xyz_half_t) == 3*sizeof(uint16_t));
+    const size_t count = 3*v.size();
+    const auto* pv = reinterpret_cast<const float*>(v.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto* pout = reinterpret_cast<uint16_t*>(out.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    size_t ii = 0;
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_HALF_F16C)
+    for (; ii + 4 <= count; ii += 4) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pout + ii), _mm_cvtps_ph(_mm_loadu_ps(pv + ii), _MM_FROUND_TO_NEAREST_INT)); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_HALF_NEON)
+    for (; ii + 4 <= count; ii += 4) {
+        vst1_u16(pout + ii, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(pv + ii))));
+    }
+#endif
+    for (; ii < count; ++ii) {
+        pout[ii] = float_to_half(pv[ii]);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+void xyz_half_t::decode_batch(std::span<const xyz_half_t> p, std::span<xyz_t> out)
+{
+    const size_t count = 3*p.size();
+    const auto* pp = reinterpret_cast<const uint16_t*>(p.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto* pout = reinterpret_cast<float*>(out.data()); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    size_t ii = 0;
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_HALF_F16C)
+    for (; ii + 4 <= count; ii += 4) {
+        _mm_storeu_ps(pout + ii, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pp + ii)))); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+#elif defined(LIBRARY_VECTOR_QUATERNION_MATRIX_HALF_NEON)
+    for (; ii + 4 <= count; ii += 4) {
+        vst1q_f32(pout + ii, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(pp + ii))));
+    }
+#endif
+    for (; ii < count; ++ii) {
+        pout[ii] = half_to_float(pp[ii]);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
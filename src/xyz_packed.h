@@ -0,0 +1,85 @@
+#pragma once
+
+#include "xyz_type.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+/*!
+Compressed unit vectors (eg gravity directions, normals, and magnetometer directions), using the octahedral encoding.
+
+The vector is projected onto the octahedron |x| + |y| + |z| = 1, and the lower half of the octahedron is folded over
+onto the upper half, so that the direction is mapped to the square [-1, 1] x [-1, 1]. The two coordinates of the square
+are then quantized to BITS bits each. The quantization is symmetric about zero, so the coordinate axes are encoded exactly.
+Decoded vectors are normalized. The zero vector is encoded as {0, 0, 1}.
+The quantization error is largest near the folded edges of the octahedron, MAX_ANGULAR_ERROR_DEGREES is a bound on the
+measured error over several million random unit vectors (0.95 degrees for 16 bits and 0.0037 degrees for 32 bits).
+
+The batch functions process simd_float_t::WIDTH vectors at a time. They give the same encodings as the single vector functions,
+and decoded vectors that agree with them to within a few ulps, see simd_float.h.
+
+See [A Survey of Efficient Representations for Independent Unit Vectors](https://jcgt.org/published/0003/02/01/).
+*/
+struct xyz_octahedral16_t {
+public:
+    static constexpr uint32_t BITS = 8; //!< bits per coordinate
+    static constexpr float MAX_ANGULAR_ERROR_DEGREES = 1.0F; //!< Maximum angle between a unit vector and its decoded value
+    static constexpr xyz_octahedral16_t pack(uint32_t u, uint32_t v) { return xyz_octahedral16_t { static_cast<uint16_t>((u << BITS) | v) }; }
+    constexpr std::array<uint32_t, 2> coordinates() const { return {{ static_cast<uint32_t>(bits >> BITS), bits & MASK }}; }
+    constexpr bool operator==(const xyz_octahedral16_t& p) const = default;
+public:
+    static xyz_octahedral16_t encode(const xyz_t& v);
+    xyz_t decode() const;
+    static void encode_batch(std::span<const xyz_t> v, std::span<xyz_octahedral16_t> out); //!< out must have at least v.size() elements
+    static void decode_batch(std::span<const xyz_octahedral16_t> p, std::span<xyz_t> out); //!< out must have at least p.size() elements
+private:
+    static constexpr uint32_t MASK = (1U << BITS) - 1;
+public:
+    uint16_t bits;
+};
+
+/*!
+32-bit version of xyz_octahedral16_t, with 16 bits per coordinate.
+*/
+struct xyz_octahedral32_t {
+public:
+    static constexpr uint32_t BITS = 16; //!< bits per coordinate
+    static constexpr float MAX_ANGULAR_ERROR_DEGREES = 0.004F; //!< Maximum angle between a unit vector and its decoded value
+    static constexpr xyz_octahedral32_t pack(uint32_t u, uint32_t v) { return xyz_octahedral32_t { (u << BITS) | v }; }
+    constexpr std::array<uint32_t, 2> coordinates() const { return {{ bits >> BITS, bits & MASK }}; }
+    constexpr bool operator==(const xyz_octahedral32_t& p) const = default;
+public:
+    static xyz_octahedral32_t encode(const xyz_t& v);
+    xyz_t decode() const;
+    static void encode_batch(std::span<const xyz_t> v, std::span<xyz_octahedral32_t> out); //!< out must have at least v.size() elements
+    static void decode_batch(std::span<const xyz_octahedral32_t> p, std::span<xyz_t> out); //!< out must have at least p.size() elements
+private:
+    static constexpr uint32_t MASK = (1U << BITS) - 1;
+public:
+    uint32_t bits;
+};
+
+/*!
+3D vector stored as IEEE 754 half precision (binary16) values, for vectors that are not unit length.
+
+The relative error of each component is at most 2^-11 (about 4.9E-4), for magnitudes in the range [6.1E-5, 65504].
+Larger magnitudes are encoded as infinity, smaller ones as half precision subnormals or zero.
+Conversion uses round to nearest even, as the hardware conversion instructions do.
+
+The batch functions use the F16C instructions on x86 (when compiled with `-mf16c`) and the NEON conversion instructions on AArch64,
+and give identical results to the single vector functions (other than the payloads of NaNs).
+*/
+struct xyz_half_t {
+public:
+    static uint16_t float_to_half(float f); //!< Convert to half precision, rounding to nearest even
+    static float half_to_float(uint16_t h); //!< Convert from half precision, this is exact
+    constexpr bool operator==(const xyz_half_t& p) const = default;
+public:
+    static xyz_half_t encode(const xyz_t& v) { return xyz_half_t {{{ float_to_half(v.x), float_to_half(v.y), float_to_half(v.z) }}}; }
+    xyz_t decode() const { return xyz_t { half_to_float(bits[0]), half_to_float(bits[1]), half_to_float(bits[2]) }; }
+    static void encode_batch(std::span<const xyz_t> v, std::span<xyz_half_t> out); //!< out must have at least v.size() elements
+    static void decode_batch(std::span<const xyz_half_t> p, std::span<xyz_t> out); //!< out must have at least p.size() elements
+public:
+    std::array<uint16_t, 3> bits;
+};
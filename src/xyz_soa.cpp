@@ -0,0 +1,194 @@
+#include "xyz_soa.h"
+
+#include <algorithm>
+#include <cstddef>
+
+using V = simd_float_t;
+
+xyz_soa_t::xyz_soa_t(const xyz_soa_t& other) = default;
+xyz_soa_t::xyz_soa_t(xyz_soa_t&& other) noexcept = default;
+xyz_soa_t& xyz_soa_t::operator=(const xyz_soa_t& other) = default;
+xyz_soa_t& xyz_soa_t::operator=(xyz_soa_t&& other) noexcept = default;
+xyz_soa_t::~xyz_soa_t() = default;
+
+void xyz_soa_t::resize(size_t size)
+{
+    // elements beyond the old size may hold stale values, or NaNs written to the padding by normalize_in_place,
+    // so all elements from the old size onwards, including the padding, are zeroed
+    const size_t keep = std::min(_size, size);
+    _size = size;
+    const size_t padded = V::padded_size(size);
+    _x.resize(padded);
+    _y.resize(padded);
+    _z.resize(padded);
+    std::fill(_x.begin() + static_cast<std::ptrdiff_t>(keep), _x.end(), 0.0F);
+    std::fill(_y.begin() + static_cast<std::ptrdiff_t>(keep), _y.end(), 0.0F);
+    std::fill(_z.begin() + static_cast<std::ptrdiff_t>(keep), _z.end(), 0.0F);
+}
+
+void xyz_soa_t::from_xyz(std::span<const xyz_t> v)
+{
+    resize(v.size());
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        _x[ii] = v[ii].x;
+        _y[ii] = v[ii].y;
+        _z[ii] = v[ii].z;
+    }
+}
+
+void xyz_soa_t::to_xyz(std::span<xyz_t> v) const
+{
+    for (size_t ii = 0; ii < _size; ++ii) {
+        v[ii] = xyz_t{_x[ii], _y[ii], _z[ii]};
+    }
+}
+
+xyz_soa_t& xyz_soa_t::operator+=(const xyz_soa_t& v)
+{
+    for (size_t ii = 0; ii < _x.size(); ii += V::WIDTH) {
+        (V::load_aligned(&_x[ii]) + V::load_aligned(&v._x[ii])).store_aligned(&_x[ii]);
+        (V::load_aligned(&_y[ii]) + V::load_aligned(&v._y[ii])).store_aligned(&_y[ii]);
+        (V::load_aligned(&_z[ii]) + V::load_aligned(&v._z[ii])).store_aligned(&_z[ii]);
+    }
+    return *this;
+}
+
+xyz_soa_t& xyz_soa_t::operator-=(const xyz_soa_t& v)
+{
+    for (size_t ii = 0; ii < _x.size(); ii += V::WIDTH) {
+        (V::load_aligned(&_x[ii]) - V::load_aligned(&v._x[ii])).store_aligned(&_x[ii]);
+        (V::load_aligned(&_y[ii]) - V::load_aligned(&v._y[ii])).store_aligned(&_y[ii]);
+        (V::load_aligned(&_z[ii]) - V::load_aligned(&v._z[ii])).store_aligned(&_z[ii]);
+    }
+    return *this;
+}
+
+xyz_soa_t& xyz_soa_t::operator*=(float k)
+{
+    const V kv = V::broadcast(k);
+    for (size_t ii = 0; ii < _x.size(); ii += V::WIDTH) {
+        (V::load_aligned(&_x[ii]) * kv).store_aligned(&_x[ii]);
+        (V::load_aligned(&_y[ii]) * kv).store_aligned(&_y[ii]);
+        (V::load_aligned(&_z[ii]) * kv).store_aligned(&_z[ii]);
+    }
+    return *this;
+}
+
+xyz_soa_t& xyz_soa_t::add_scaled(float k, const xyz_soa_t& v)
+{
+    const V kv = V::broadcast(k);
+    for (size_t ii = 0; ii < _x.size(); ii += V::WIDTH) {
+        (V::load_aligned(&_x[ii]) + kv*V::load_aligned(&v._x[ii])).store_aligned(&_x[ii]);
+        (V::load_aligned(&_y[ii]) + kv*V::load_aligned(&v._y[ii])).store_aligned(&_y[ii]);
+        (V::load_aligned(&_z[ii]) + kv*V::load_aligned(&v._z[ii])).store_aligned(&_z[ii]);
+    }
+    return *this;
+}
+
+void xyz_soa_t::dot(const xyz_soa_t& v, std::span<float> out) const
+{
+    for (size_t ii = 0; ii < _size; ii += V::WIDTH) {
+        const V d = V::load_aligned(&_x[ii])*V::load_aligned(&v._x[ii])
+                  + V::load_aligned(&_y[ii])*V::load_aligned(&v._y[ii])
+                  + V::load_aligned(&_z[ii])*V::load_aligned(&v._z[ii]);
+        d.store_partial(&out[ii], std::min(V::WIDTH, _size - ii));
+    }
+}
+
+void xyz_soa_t::cross(const xyz_soa_t& v, xyz_soa_t& out) const
+{
+    out.resize(_size);
+    for (size_t ii = 0; ii < _x.size(); ii += V::WIDTH) {
+        const V x = V::load_aligned(&_x[ii]);
+        const V y = V::load_aligned(&_y[ii]);
+        const V z = V::load_aligned(&_z[ii]);
+        const V vx = V::load_aligned(&v._x[ii]);
+        const V vy = V::load_aligned(&v._y[ii]);
+        const V vz = V::load_aligned(&v._z[ii]);
+        (y*vz - z*vy).store_aligned(&out._x[ii]);
+        (z*vx - x*vz).store_aligned(&out._y[ii]);
+        (x*vy - y*vx).store_aligned(&out._z[ii]);
+    }
+}
+
+void xyz_soa_t::distance_squared(const xyz_soa_t& v, std::span<float> out) const
+{
+    for (size_t ii = 0; ii < _size; ii += V::WIDTH) {
+        const V dx = V::load_aligned(&_x[ii]) - V::load_aligned(&v._x[ii]);
+        const V dy = V::load_aligned(&_y[ii]) - V::load_aligned(&v._y[ii]);
+        const V dz = V::load_aligned(&_z[ii]) - V::load_aligned(&v._z[ii]);
+        (dx*dx + dy*dy + dz*dz).store_partial(&out[ii], std::min(V::WIDTH, _size - ii));
+    }
+}
+
+void xyz_soa_t::distance(const xyz_soa_t& v, std::span<float> out) const
+{
+    for (size_t ii = 0; ii < _size; ii += V::WIDTH) {
+        const V dx = V::load_aligned(&_x[ii]) - V::load_aligned(&v._x[ii]);
+        const V dy = V::load_aligned(&_y[ii]) - V::load_aligned(&v._y[ii]);
+        const V dz = V::load_aligned(&_z[ii]) - V::load_aligned(&v._z[ii]);
+        V::sqrt(dx*dx + dy*dy + dz*dz).store_partial(&out[ii], std::min(V::WIDTH, _size - ii));
+    }
+}
+
+void xyz_soa_t::magnitude_squared(std::span<float> out) const
+{
+    for (size_t ii = 0; ii < _size; ii += V::WIDTH) {
+        const V x = V::load_aligned(&_x[ii]);
+        const V y = V::load_aligned(&_y[ii]);
+        const V z = V::load_aligned(&_z[ii]);
+        (x*x + y*y + z*z).store_partial(&out[ii], std::min(V::WIDTH, _size - ii));
+    }
+}
+
+void xyz_soa_t::magnitude(std::span<float> out) const
+{
+    for (size_t ii = 0; ii < _size; ii += V::WIDTH) {
+        const V x = V::load_aligned(&_x[ii]);
+        const V y = V::load_aligned(&_y[ii]);
+        const V z = V::load_aligned(&_z[ii]);
+        V::sqrt(x*x + y*y + z*z).store_partial(&out[ii], std::min(V::WIDTH, _size - ii));
+    }
+}
+
+template <rsqrt_precision_e P>
+void xyz_soa_t::normalize_in_place()
+{
+    for (size_t ii = 0; ii < _x.size(); ii += V::WIDTH) {
+        const V x = V::load_aligned(&_x[ii]);
+        const V y = V::load_aligned(&_y[ii]);
+        const V z = V::load_aligned(&_z[ii]);
+        const V r = V::reciprocal_sqrt<P>(x*x + y*y + z*z);
+        (x*r).store_aligned(&_x[ii]);
+        (y*r).store_aligned(&_y[ii]);
+        (z*r).store_aligned(&_z[ii]);
+    }
+}
+
+void xyz_soa_t::normalize_in_place(rsqrt_precision_e precision)
+{
+    switch (precision) {
+    case rsqrt_precision_e::ESTIMATE:
+        normalize_in_place<rsqrt_precision_e::ESTIMATE>();
+        break;
+    case rsqrt_precision_e::ONE_ITERATION:
+        normalize_in_place<rsqrt_precision_e::ONE_ITERATION>();
+        break;
+    case rsqrt_precision_e::FULL:
+    default:
+        normalize_in_place<rsqrt_precision_e::FULL>();
+        break;
+    }
+}
+
+void xyz_soa_t::clamp_in_place(float min, float max)
+{
+    // argument order chosen so that, like xyz_t::clamp, a NaN component is passed through unchanged
+    const V minv = V::broadcast(min);
+    const V maxv = V::broadcast(max);
+    for (size_t ii = 0; ii < _x.size(); ii += V::WIDTH) {
+        V::min(maxv, V::max(minv, V::load_aligned(&_x[ii]))).store_aligned(&_x[ii]);
+        V::min(maxv, V::max(minv, V::load_aligned(&_y[ii]))).store_aligned(&_y[ii]);
+        V::min(maxv, V::max(minv, V::load_aligned(&_z[ii]))).store_aligned(&_z[ii]);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "simd_float.h"
+#include "xyz_type.h"
+
+#include <span>
+#include <vector>
+
+/*!
+Structure of arrays (SoA) container of 3D vectors.
+
+The x, y, and z components are stored in three separate SIMD-aligned arrays, so the batched functions below
+process simd_float_t::WIDTH vectors per instruction, rather than one `xyz_t` at a time.
+
+The arrays are padded to a multiple of simd_float_t::WIDTH, so the kernels have no scalar tail loop.
+Where a function takes a second xyz_soa_t, it must be the same size as this one.
+Where a function writes to a `std::span<float>`, the span must have at least size() elements.
+*/
+class xyz_soa_t {
+public:
+    using array_t = std::vector<float, simd_allocator_t<float>>;
+public:
+    xyz_soa_t() = default;
+    explicit xyz_soa_t(size_t size) { resize(size); }
+    explicit xyz_soa_t(std::span<const xyz_t> v) { from_xyz(v); }
+    // special member functions are defined out of line, since they are too large to inline
+    xyz_soa_t(const xyz_soa_t& other);
+    xyz_soa_t(xyz_soa_t&& other) noexcept;
+    xyz_soa_t& operator=(const xyz_soa_t& other);
+    xyz_soa_t& operator=(xyz_soa_t&& other) noexcept;
+    ~xyz_soa_t();
+    void from_xyz(std::span<const xyz_t> v); //!< Convert from array of structures
+    void to_xyz(std::span<xyz_t> v) const; //!< Convert to array of structures, v must have at least size() elements
+    std::vector<xyz_t> to_vector() const { std::vector<xyz_t> v(_size); to_xyz(v); return v; } //!< Convert to vector of xyz_t
+public:
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    void resize(size_t size);
+    void clear() { resize(0); }
+
+    xyz_t operator[](size_t pos) const { return xyz_t{_x[pos], _y[pos], _z[pos]}; } //<! Index operator
+    void set(size_t pos, const xyz_t& v) { _x[pos] = v.x; _y[pos] = v.y; _z[pos] = v.z; }
+
+    std::span<float> x() { return {_x.data(), _size}; }
+    std::span<float> y() { return {_y.data(), _size}; }
+    std::span<float> z() { return {_z.data(), _size}; }
+    std::span<const float> x() const { return {_x.data(), _size}; }
+    std::span<const float> y() const { return {_y.data(), _size}; }
+    std::span<const float> z() const { return {_z.data(), _size}; }
+public:
+    // Batched arithmetic, the equivalent of applying the xyz_t operator to each element
+    xyz_soa_t& operator+=(const xyz_soa_t& v); //<! Addition
+    xyz_soa_t& operator-=(const xyz_soa_t& v); //<! Subtraction
+    xyz_soa_t& operator*=(float k); //<! Multiplication by a scalar
+    xyz_soa_t& operator/=(float k) { return operator*=(1.0F/k); } //<! Division by a scalar
+    xyz_soa_t& add_scaled(float k, const xyz_soa_t& v); //<! this += k*v
+
+    void dot(const xyz_soa_t& v, std::span<float> out) const; //!< Vector dot products
+    void cross(const xyz_soa_t& v, xyz_soa_t& out) const; //!< Vector cross products
+    void distance_squared(const xyz_soa_t& v, std::span<float> out) const; //!< Distances between points squared
+    void distance(const xyz_soa_t& v, std::span<float> out) const; //!< Distances between points
+    void magnitude_squared(std::span<float> out) const; //<! The squares of the magnitudes
+    void magnitude(std::span<float> out) const; //<! The magnitudes
+    //! Return the normalized vectors
+    xyz_soa_t normalized(rsqrt_precision_e precision = rsqrt_precision_e::FULL) const { xyz_soa_t ret = *this; ret.normalize_in_place(precision); return ret; }
+    void normalize_in_place(rsqrt_precision_e precision = rsqrt_precision_e::FULL); //<! Normalize, in-place
+    void clamp_in_place(float min, float max); //<! Clamp all components, in-place
+private:
+    template <rsqrt_precision_e P> void normalize_in_place();
+private:
+    array_t _x {};
+    array_t _y {};
+    array_t _z {};
+    size_t _size {0};
+};
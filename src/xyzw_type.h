@@ -0,0 +1,89 @@
+#pragma once
+
+#include "simd_float4.h"
+#include "xyz_type.h"
+
+
+/*!
+Vector of 3 floats, padded to 16 bytes, {x, y, z, 0}, held in a single 128-bit register, see simd_float4_t.
+
+Arrays of xyzw_t are 16-byte aligned, so vectors are loaded and stored with single aligned SIMD instructions,
+rather than the unaligned loads (or gathers) needed for the 12-byte xyz_t.
+The element-wise operations are each a single SIMD instruction, and the reductions (dot, magnitude etc) add the
+products in the same order as xyz_t, so all results agree with those of xyz_t to within a few ulps, see simd_float.h.
+The w (padding) lane is ignored by comparisons and reductions.
+*/
+struct xyzw_t {
+public:
+    xyzw_t() : _v(simd_float4_t::zero()) {}
+    xyzw_t(float x, float y, float z) : _v(simd_float4_t::set(x, y, z, 0.0F)) {}
+    explicit xyzw_t(const xyz_t& v) : _v(simd_float4_t::set(v.x, v.y, v.z, 0.0F)) {}
+    explicit xyzw_t(simd_float4_t v) : _v(v) {}
+    xyz_t xyz() const { return xyz_t{get_x(), get_y(), get_z()}; } //!< Conversion to xyz_t
+    static void from_xyz(std::span<const xyz_t> v, std::span<xyzw_t> out) { for (size_t ii = 0; ii < v.size(); ++ii) { out[ii] = xyzw_t(v[ii]); } } //!< out must have at least as many elements as v
+    static void to_xyz(std::span<const xyzw_t> v, std::span<xyz_t> out) { for (size_t ii = 0; ii < v.size(); ++ii) { out[ii] = v[ii].xyz(); } } //!< out must have at least as many elements as v
+
+    float get_x() const { return _v.get<0>(); }
+    float get_y() const { return _v.get<1>(); }
+    float get_z() const { return _v.get<2>(); }
+    simd_float4_t get_xyzw() const { return _v; }
+
+    // Assignment
+    xyzw_t& operator=(float k) { _v = simd_float4_t::set(k, k, k, 0.0F); return *this; }
+
+    // Equality operators
+    bool operator==(const xyzw_t& v) const { return (_v.equal_lanes(v._v) & XYZ_LANES) == XYZ_LANES; }
+    bool operator!=(const xyzw_t& v) const { return !operator==(v); }
+
+    // Index operators, the non-const version forces the vector into memory, so prefer get_x() etc in arithmetic
+    float operator[](size_t pos) const { return (pos == 0) ? get_x() : (pos == 1) ? get_y() : get_z(); } //<! Index operator
+    float& operator[](size_t pos) { return _v.lane((pos < 2) ? pos : 2); } //<! Index operator, positions beyond 2 give z, so the padding lane stays zero
+
+    // Unary operators
+    xyzw_t operator+() const { return *this; } //<! Unary plus
+    xyzw_t operator-() const { return xyzw_t(_v.flip_signs(simd_float4_t::broadcast(-0.0F))); } //<! Unary negation
+
+    xyzw_t operator+=(const xyzw_t& v) { _v = _v + v._v; return *this; } //<! Addition
+    xyzw_t operator-=(const xyzw_t& v) { _v = _v - v._v; return *this; } //<! Subtraction
+    xyzw_t operator*=(float k) { _v = _v*simd_float4_t::broadcast(k); return *this; } //<! Multiplication by a scalar
+    xyzw_t operator/=(float k) { const float r = 1.0F/k; return operator*=(r); } //<! Division by a scalar
+
+    // Binary operators
+    xyzw_t operator+(const xyzw_t& v) const { return xyzw_t(_v + v._v); } //<! Addition
+    xyzw_t operator-(const xyzw_t& v) const { return xyzw_t(_v - v._v); } //<! Subtraction
+    xyzw_t operator*(float k) const { return xyzw_t(_v*simd_float4_t::broadcast(k)); } //<! Multiplication by a scalar
+    friend xyzw_t operator*(float k, const xyzw_t& v) { return v*k; } //<! Pre-multiplication by a scalar
+    xyzw_t operator/(float k) const { const float r = 1.0F/k; return *this*r; } //<! Division by a scalar
+    float dot(const xyzw_t& v) const { return sum_xyz(_v*v._v); } //!< Vector dot product
+    //! Vector cross product, {y, z, x, w}*{z, x, y, w} - {z, x, y, w}*{y, z, x, w}, so the w lane is zero
+    xyzw_t cross(const xyzw_t& v) const {
+        return xyzw_t(_v.shuffle<1, 2, 0, 3>()*v._v.shuffle<2, 0, 1, 3>() - _v.shuffle<2, 0, 1, 3>()*v._v.shuffle<1, 2, 0, 3>());
+    }
+    float distance_squared(const xyzw_t& v) const { const simd_float4_t d = _v - v._v; return sum_xyz(d*d); } //!< Distance between two points squared
+    float distance(const xyzw_t& v) const { return sqrtf(distance_squared(v)); } //!< Distance between two points
+
+    // Other functions
+    float magnitude_squared() const { return sum_xyz(_v*_v); } //<! The square of the magnitude
+    float magnitude() const { return sqrtf(magnitude_squared()); } //<! The  magnitude
+    float squared_norm() const { return magnitude_squared(); } //<! The square of the magnitude (using Eigen library naming)
+    float norm() const { return magnitude(); } //<! The  magnitude (using Eigen library naming)
+    xyzw_t normalized() const { return *this*reciprocal_sqrtf(magnitude_squared()); } //<! Return the normalized vector
+    xyzw_t normalize() { *this=normalized(); return *this; } //<! Normalize, in-place
+    xyzw_t absolute() const { return xyzw_t(simd_float4_t::abs(_v)); } //<! Return the vector consisting of the absolute value of all components
+    xyzw_t absolute_in_place() { *this=absolute(); return *this; } //<! Absolute value of all components, in-place
+    //! Return clampped value, the argument order is chosen so that, like xyz_t::clamp, a NaN component is passed through unchanged
+    static xyzw_t clamp(const xyzw_t& v, float min, float max) { return xyzw_t(simd_float4_t::min(simd_float4_t::set(max, max, max, 0.0F), simd_float4_t::max(simd_float4_t::set(min, min, min, 0.0F), v._v))); }
+    xyzw_t clamp_in_place(float min, float max) { *this = clamp(*this, min, max); return *this; } //<! clamp, in-place
+
+    void set_zero() { _v = simd_float4_t::zero(); }
+    void set_ones() { _v = simd_float4_t::set(1.0F, 1.0F, 1.0F, 0.0F); }
+    void set_constant(float value) { _v = simd_float4_t::set(value, value, value, 0.0F); }
+    float sum() const { return sum_xyz(_v); }
+    float mean() const { return sum()*(1.0F/3.0F); }
+    float prod() const { return get_x()*get_y()*get_z(); }
+private:
+    static float sum_xyz(simd_float4_t v) { return v.get<0>() + v.get<1>() + v.get<2>(); }
+    static constexpr uint32_t XYZ_LANES = 0x7U;
+private:
+    simd_float4_t _v;
+};
@@ -0,0 +1,851 @@
+#include "cholesky3x3.h"
+#include "diagonal_matrix3x3.h"
+#include "lazy_expression.h"
+#include "matrix3x3_simd.h"
+#include "matrix_nxm.h"
+#include "matrix3x3_soa.h"
+#include "quaternion.h"
+#include "quaternion_interpolator.h"
+#include "quaternion_packed.h"
+#include "quaternion_simd.h"
+#include "rotation_matrix3x3.h"
+#include "symmetric_eigen3x3.h"
+#include "symmetric_matrix3x3.h"
+#include "xyz_packed.h"
+#include "xyz_soa.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+#include <unity.h>
+
+// Eigen is not a dependency of this library, the Matrix<N, M> benchmarks also compare against it when it is on the include path,
+// eg by adding `-I/usr/include/eigen3` to the build_flags of the unit-test environment
+#if __has_include(<Eigen/Dense>)
+#define BENCHMARK_EIGEN
+#include <Eigen/Dense>
+#endif
+
+/*
+Benchmarks of the batched functions against a loop of the equivalent single element function.
+Timings are reported using TEST_MESSAGE (run with `pio test -e unit-test -f test_native/test_benchmark -v` to see them),
+the tests themselves only check that the batched and single element results agree.
+*/
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+static constexpr size_t BENCHMARK_COUNT = 4096;
+static constexpr int BENCHMARK_REPETITIONS = 200;
+
+//! Return the average time in nanoseconds per element of BENCHMARK_REPETITIONS calls of f()
+template <typename F>
+static double benchmark_ns(F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int ii = 0; ii < BENCHMARK_REPETITIONS; ++ii) {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count())
+        / (static_cast<double>(BENCHMARK_REPETITIONS) * static_cast<double>(BENCHMARK_COUNT));
+}
+
+static void report(const char* name, double scalar_ns, double batch_ns)
+{
+    std::array<char, 160> buf {};
+    (void)snprintf(buf.data(), buf.size(), "%-32s scalar %7.3f ns, batch %7.3f ns, speedup %5.2fx", name, scalar_ns, batch_ns, scalar_ns/batch_ns);
+    TEST_MESSAGE(buf.data());
+}
+
+/*!
+The batched functions use the same operation order as the scalar functions, but the compiler may contract multiply-adds into
+fused multiply-adds (eg with -mfma, and on AArch64) differently in each, so the results are compared to within a few ulps,
+relative to the larger of 1 and the largest element of the expected vector or matrix (since the elements may be the result of cancellation).
+*/
+static constexpr float ULP_TOLERANCE = 8.0F*std::numeric_limits<float>::epsilon();
+
+static void assert_close(float expected, float actual, float tolerance = ULP_TOLERANCE, float scale = 1.0F)
+{
+    TEST_ASSERT_FLOAT_WITHIN(tolerance*std::max({ 1.0F, scale, std::fabs(expected) }), expected, actual);
+}
+
+static void assert_close(const xyz_t& expected, const xyz_t& actual, float tolerance = ULP_TOLERANCE)
+{
+    const float scale = std::max({ std::fabs(expected.x), std::fabs(expected.y), std::fabs(expected.z) });
+    assert_close(expected.x, actual.x, tolerance, scale);
+    assert_close(expected.y, actual.y, tolerance, scale);
+    assert_close(expected.z, actual.z, tolerance, scale);
+}
+
+static float largest_element(const Matrix3x3& m)
+{
+    float ret = 0.0F;
+    for (size_t ii = 0; ii < 9; ++ii) {
+        ret = std::max(ret, std::fabs(m[ii]));
+    }
+    return ret;
+}
+
+static void assert_close(const Matrix3x3& expected, const Matrix3x3& actual, float tolerance = ULP_TOLERANCE)
+{
+    const float scale = largest_element(expected);
+    for (size_t ii = 0; ii < 9; ++ii) {
+        assert_close(expected[ii], actual[ii], tolerance, scale);
+    }
+}
+
+static void assert_close(const Quaternion& expected, const Quaternion& actual, float tolerance = ULP_TOLERANCE)
+{
+    const float scale = std::max({ std::fabs(expected.w), std::fabs(expected.x), std::fabs(expected.y), std::fabs(expected.z) });
+    assert_close(expected.w, actual.w, tolerance, scale);
+    assert_close(expected.x, actual.x, tolerance, scale);
+    assert_close(expected.y, actual.y, tolerance, scale);
+    assert_close(expected.z, actual.z, tolerance, scale);
+}
+
+static void assert_close(const std::vector<xyz_t>& expected, const std::vector<xyz_t>& actual, float tolerance = ULP_TOLERANCE)
+{
+    TEST_ASSERT_EQUAL(expected.size(), actual.size());
+    for (size_t ii = 0; ii < expected.size(); ++ii) { assert_close(expected[ii], actual[ii], tolerance); }
+}
+
+static void assert_close(const std::vector<Matrix3x3>& expected, const std::vector<Matrix3x3>& actual, float tolerance = ULP_TOLERANCE)
+{
+    TEST_ASSERT_EQUAL(expected.size(), actual.size());
+    for (size_t ii = 0; ii < expected.size(); ++ii) { assert_close(expected[ii], actual[ii], tolerance); }
+}
+
+static std::vector<xyz_t> benchmark_vectors()
+{
+    std::vector<xyz_t> v(BENCHMARK_COUNT);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        v[ii] = xyz_t{f*0.01F - 3.0F, 0.5F - f*0.002F, 1.0F + f*0.003F};
+    }
+    return v;
+}
+
+void test_benchmark_quaternion_rotate()
+{
+    const Quaternion q = Quaternion::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    const std::vector<xyz_t> v = benchmark_vectors();
+    std::vector<xyz_t> scalar(v.size());
+    std::vector<xyz_t> batch(v.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar[ii] = q.rotate(v[ii]); }
+    });
+    const double batch_ns = benchmark_ns([&]() { q.rotate(v, batch); });
+    report("Quaternion::rotate(xyz_t)", scalar_ns, batch_ns);
+    assert_close(scalar, batch);
+
+    const xyz_soa_t s(v);
+    xyz_soa_t sOut(v.size());
+    const double soa_ns = benchmark_ns([&]() { q.rotate(s, sOut); });
+    report("Quaternion::rotate(xyz_soa_t)", scalar_ns, soa_ns);
+    assert_close(scalar, sOut.to_vector());
+}
+
+void test_benchmark_normalize()
+{
+    const std::vector<xyz_t> v = benchmark_vectors();
+    std::vector<xyz_t> scalar(v.size());
+    std::vector<xyz_t> batch(v.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar[ii] = v[ii].normalized(); }
+    });
+    const double full_ns = benchmark_ns([&]() { xyz_t::normalize_batch(v, batch, rsqrt_precision_e::FULL); });
+    report("xyz_t::normalized (full)", scalar_ns, full_ns);
+    // xyz_t::normalized uses reciprocal_sqrtf, which is approximate if a FAST_RECIPROCAL_SQUARE_ROOT macro is defined
+    assert_close(scalar, batch, ULP_TOLERANCE + RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR);
+
+    const double one_iteration_ns = benchmark_ns([&]() { xyz_t::normalize_batch(v, batch, rsqrt_precision_e::ONE_ITERATION); });
+    report("xyz_t::normalized (1 iteration)", scalar_ns, one_iteration_ns);
+    const double estimate_ns = benchmark_ns([&]() { xyz_t::normalize_batch(v, batch, rsqrt_precision_e::ESTIMATE); });
+    report("xyz_t::normalized (estimate)", scalar_ns, estimate_ns);
+}
+
+static std::vector<Matrix3x3> benchmark_matrices(float offset)
+{
+    std::vector<Matrix3x3> m(BENCHMARK_COUNT);
+    for (size_t ii = 0; ii < m.size(); ++ii) {
+        const auto f = static_cast<float>(ii)*0.001F;
+        m[ii] = Matrix3x3(f + offset, 2.0F - f, 0.5F*f, 3.0F, f*offset, -1.0F - f, 0.25F*f + 1.0F, 7.0F - f, offset - f);
+    }
+    return m;
+}
+
+void test_benchmark_matrix3x3_multiply()
+{
+    const std::vector<Matrix3x3> a = benchmark_matrices(0.5F);
+    const std::vector<Matrix3x3> b = benchmark_matrices(-1.25F);
+    std::vector<Matrix3x3> scalar(a.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < a.size(); ++ii) { scalar[ii] = a[ii]*b[ii]; }
+    });
+
+    const matrix3x3_soa_t sa(a);
+    const matrix3x3_soa_t sb(b);
+    matrix3x3_soa_t sOut(a.size());
+    const double batch_ns = benchmark_ns([&]() { sa.multiply(sb, sOut); });
+    report("Matrix3x3[i]*Matrix3x3[i]", scalar_ns, batch_ns);
+    assert_close(scalar, sOut.to_vector());
+}
+
+void test_benchmark_matrix3x3_congruence()
+{
+    const std::vector<Matrix3x3> F = benchmark_matrices(0.5F);
+    const std::vector<Matrix3x3> P = benchmark_matrices(-1.25F);
+    const Matrix3x3 Q(0.01F, 0.02F, 0.03F);
+    std::vector<Matrix3x3> scalar(F.size());
+    std::vector<Matrix3x3> fused(F.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { scalar[ii] = F[ii]*P[ii]*F[ii].transpose() + Q; }
+    });
+    const double fused_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { fused[ii] = F[ii].congruence_add(P[ii], Q); }
+    });
+    report("Matrix3x3::congruence_add", scalar_ns, fused_ns);
+    // P is not symmetric, so only the elements on and above the diagonal agree
+    for (size_t ii = 0; ii < F.size(); ++ii) {
+        for (const size_t kk : { 0, 1, 2, 4, 5, 8 }) { assert_close(scalar[ii][kk], fused[ii][kk], ULP_TOLERANCE, largest_element(scalar[ii])); }
+    }
+
+    const double scalar_transpose_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { scalar[ii] = F[ii]*P[ii].transpose(); }
+    });
+    const double fused_transpose_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { fused[ii] = F[ii].multiply_transpose(P[ii]); }
+    });
+    report("Matrix3x3::multiply_transpose", scalar_transpose_ns, fused_transpose_ns);
+    assert_close(scalar, fused);
+}
+
+void test_benchmark_symmetric_matrix3x3()
+{
+    const std::vector<Matrix3x3> F = benchmark_matrices(0.5F);
+    std::vector<Matrix3x3> P(F.size());
+    std::vector<SymmetricMatrix3x3> Ps(F.size());
+    for (size_t ii = 0; ii < F.size(); ++ii) {
+        const auto f = static_cast<float>(ii)*0.001F;
+        Ps[ii] = SymmetricMatrix3x3(2.0F + f, 0.1F, -0.3F*f, 3.0F, 0.2F + f, 4.0F - f);
+        P[ii] = Ps[ii].matrix();
+    }
+    const Matrix3x3 Q(0.01F, 0.02F, 0.03F);
+    const SymmetricMatrix3x3 Qs(0.01F, 0.02F, 0.03F);
+    std::vector<Matrix3x3> scalar(F.size());
+    std::vector<SymmetricMatrix3x3> symmetric(F.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { scalar[ii] = F[ii].congruence_add(P[ii], Q); }
+    });
+    const double symmetric_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { symmetric[ii] = Ps[ii].congruence_add(F[ii], Qs); }
+    });
+    report("SymmetricMatrix3x3::congruence_add", scalar_ns, symmetric_ns);
+    for (size_t ii = 0; ii < F.size(); ++ii) { assert_close(scalar[ii], symmetric[ii].matrix()); }
+
+    const double scalar_inverse_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { scalar[ii] = P[ii].inverse(); }
+    });
+    const double symmetric_inverse_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { symmetric[ii] = Ps[ii].inverse(); }
+    });
+    report("SymmetricMatrix3x3::inverse", scalar_inverse_ns, symmetric_inverse_ns);
+    for (size_t ii = 0; ii < F.size(); ++ii) { TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, scalar[ii][1], symmetric[ii][1]); }
+}
+
+void test_benchmark_diagonal_matrix3x3()
+{
+    const std::vector<Matrix3x3> M = benchmark_matrices(0.5F);
+    std::vector<Matrix3x3> D(M.size());
+    std::vector<DiagonalMatrix3x3> Ds(M.size());
+    for (size_t ii = 0; ii < M.size(); ++ii) {
+        const auto f = static_cast<float>(ii)*0.001F;
+        Ds[ii] = DiagonalMatrix3x3(1.0F + f, 2.0F - f, 0.5F + f);
+        D[ii] = Ds[ii].matrix();
+    }
+    std::vector<Matrix3x3> scalar(M.size());
+    std::vector<Matrix3x3> diagonal(M.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < M.size(); ++ii) { scalar[ii] = D[ii]*M[ii]*D[ii]; }
+    });
+    const double diagonal_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < M.size(); ++ii) { diagonal[ii] = Ds[ii]*M[ii]*Ds[ii]; }
+    });
+    report("DiagonalMatrix3x3 D*M*D", scalar_ns, diagonal_ns);
+    TEST_ASSERT_TRUE(scalar == diagonal);
+}
+
+void test_benchmark_rotation_matrix3x3()
+{
+    std::vector<Matrix3x3> M(BENCHMARK_COUNT);
+    std::vector<RotationMatrix3x3> R(BENCHMARK_COUNT);
+    for (size_t ii = 0; ii < R.size(); ++ii) {
+        const auto f = static_cast<float>(ii)*0.01F;
+        R[ii] = RotationMatrix3x3::from_euler_angles_radians(f, 0.5F - f, 2.0F*f);
+        M[ii] = R[ii].matrix();
+    }
+    std::vector<Matrix3x3> scalar(R.size());
+    std::vector<RotationMatrix3x3> rotation(R.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < M.size(); ++ii) { scalar[ii] = M[ii].inverse(); }
+    });
+    const double rotation_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < R.size(); ++ii) { rotation[ii] = R[ii].inverse(); }
+    });
+    report("RotationMatrix3x3::inverse", scalar_ns, rotation_ns);
+    for (size_t ii = 0; ii < R.size(); ++ii) { TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, scalar[ii][1], rotation[ii][1]); }
+
+    const double orthonormalize_ns = benchmark_ns([&]() {
+        rotation = R;
+        RotationMatrix3x3::orthonormalize_batch(rotation);
+    });
+    const double renormalize_ns = benchmark_ns([&]() {
+        rotation = R;
+        RotationMatrix3x3::renormalize_batch(rotation);
+    });
+    report("RotationMatrix3x3::renormalize", orthonormalize_ns, renormalize_ns);
+}
+
+//! Reference matrix multiplication, using the textbook dot product loop
+template <size_t N>
+static Matrix<N, N> reference_multiply(const Matrix<N, N>& a, const Matrix<N, N>& b)
+{
+    Matrix<N, N> ret;
+    for (size_t row = 0; row < N; ++row) {
+        for (size_t column = 0; column < N; ++column) {
+            float sum = 0.0F;
+            for (size_t kk = 0; kk < N; ++kk) {
+                sum += a(row, kk)*b(kk, column);
+            }
+            ret(row, column) = sum;
+        }
+    }
+    return ret;
+}
+
+template <size_t N>
+static void benchmark_matrix_nxm(const char* multiply_name, const char* congruence_name)
+{
+    // a small number of distinct matrices, so the benchmark measures the arithmetic rather than the memory bandwidth
+    static constexpr size_t MATRIX_COUNT = 8;
+    std::vector<Matrix<N, N>> F(MATRIX_COUNT);
+    std::vector<Matrix<N, N>> P(MATRIX_COUNT);
+    for (size_t ii = 0; ii < MATRIX_COUNT; ++ii) {
+        for (size_t jj = 0; jj < N*N; ++jj) {
+            F[ii][jj] = static_cast<float>((ii + jj*7) % 11)*0.1F;
+            P[ii][jj] = static_cast<float>((ii*3 + jj) % 5)*0.1F;
+        }
+    }
+    const Matrix<N, N> Q(0.01F);
+    std::vector<Matrix<N, N>> reference(MATRIX_COUNT);
+    std::vector<Matrix<N, N>> result(MATRIX_COUNT);
+
+    const double reference_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < BENCHMARK_COUNT; ++ii) { reference[ii % MATRIX_COUNT] = reference_multiply(F[ii % MATRIX_COUNT], P[ii % MATRIX_COUNT]); }
+    });
+    const double multiply_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < BENCHMARK_COUNT; ++ii) { result[ii % MATRIX_COUNT] = F[ii % MATRIX_COUNT]*P[ii % MATRIX_COUNT]; }
+    });
+    report(multiply_name, reference_ns, multiply_ns);
+    for (size_t ii = 0; ii < MATRIX_COUNT; ++ii) {
+        for (size_t jj = 0; jj < N*N; ++jj) { TEST_ASSERT_FLOAT_WITHIN(1.0E-4F, reference[ii][jj], result[ii][jj]); }
+    }
+
+    const double reference_congruence_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < BENCHMARK_COUNT; ++ii) { reference[ii % MATRIX_COUNT] = reference_multiply(reference_multiply(F[ii % MATRIX_COUNT], P[ii % MATRIX_COUNT]), F[ii % MATRIX_COUNT].transpose()) + Q; }
+    });
+    const double congruence_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < BENCHMARK_COUNT; ++ii) { result[ii % MATRIX_COUNT] = F[ii % MATRIX_COUNT].congruence_add(P[ii % MATRIX_COUNT], Q); }
+    });
+    report(congruence_name, reference_congruence_ns, congruence_ns);
+
+#if defined(BENCHMARK_EIGEN)
+    // Eigen's fixed size matrices, reported as scalar, against Matrix<N, N>, reported as batch
+    using EigenMatrix = Eigen::Matrix<float, static_cast<int>(N), static_cast<int>(N), Eigen::RowMajor>;
+    std::vector<EigenMatrix> eigen_F(MATRIX_COUNT);
+    std::vector<EigenMatrix> eigen_P(MATRIX_COUNT);
+    std::vector<EigenMatrix> eigen_result(MATRIX_COUNT);
+    for (size_t ii = 0; ii < MATRIX_COUNT; ++ii) {
+        for (size_t row = 0; row < N; ++row) {
+            for (size_t column = 0; column < N; ++column) {
+                eigen_F[ii](static_cast<Eigen::Index>(row), static_cast<Eigen::Index>(column)) = F[ii](row, column);
+                eigen_P[ii](static_cast<Eigen::Index>(row), static_cast<Eigen::Index>(column)) = P[ii](row, column);
+            }
+        }
+    }
+    const EigenMatrix eigen_Q = EigenMatrix::Identity()*0.01F;
+    // congruence_add assumes P is symmetric, which these P are not, so only the elements on and above the diagonal agree
+    const auto assert_close_to_eigen = [&](bool upper) {
+        for (size_t ii = 0; ii < MATRIX_COUNT; ++ii) {
+            for (size_t row = 0; row < N; ++row) {
+                for (size_t column = upper ? row : 0; column < N; ++column) {
+                    TEST_ASSERT_FLOAT_WITHIN(1.0E-4F, eigen_result[ii](static_cast<Eigen::Index>(row), static_cast<Eigen::Index>(column)), result[ii](row, column));
+                }
+            }
+        }
+    };
+    std::array<char, 40> name {};
+
+    const double eigen_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < BENCHMARK_COUNT; ++ii) { eigen_result[ii % MATRIX_COUNT].noalias() = eigen_F[ii % MATRIX_COUNT]*eigen_P[ii % MATRIX_COUNT]; }
+    });
+    (void)snprintf(name.data(), name.size(), "Eigen<%zu,%zu> multiply", N, N);
+    report(name.data(), eigen_ns, multiply_ns);
+    for (size_t ii = 0; ii < MATRIX_COUNT; ++ii) { result[ii] = F[ii]*P[ii]; }
+    assert_close_to_eigen(false);
+
+    const double eigen_congruence_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < BENCHMARK_COUNT; ++ii) {
+            const EigenMatrix& f = eigen_F[ii % MATRIX_COUNT];
+            eigen_result[ii % MATRIX_COUNT].noalias() = f*eigen_P[ii % MATRIX_COUNT]*f.transpose() + eigen_Q;
+        }
+    });
+    (void)snprintf(name.data(), name.size(), "Eigen<%zu,%zu> congruence_add", N, N);
+    report(name.data(), eigen_congruence_ns, congruence_ns);
+    for (size_t ii = 0; ii < MATRIX_COUNT; ++ii) { result[ii] = F[ii].congruence_add(P[ii], Q); }
+    assert_close_to_eigen(true);
+#endif
+}
+
+void test_benchmark_matrix_nxm()
+{
+    benchmark_matrix_nxm<6>("Matrix<6,6> multiply", "Matrix<6,6> congruence_add");
+    benchmark_matrix_nxm<9>("Matrix<9,9> multiply", "Matrix<9,9> congruence_add");
+    benchmark_matrix_nxm<12>("Matrix<12,12> multiply", "Matrix<12,12> congruence_add");
+    benchmark_matrix_nxm<15>("Matrix<15,15> multiply", "Matrix<15,15> congruence_add");
+}
+
+void test_benchmark_cholesky3x3()
+{
+    const std::vector<Matrix3x3> B = benchmark_matrices(0.5F);
+    std::vector<SymmetricMatrix3x3> S(B.size());
+    std::vector<Matrix3x3> M(B.size());
+    for (size_t ii = 0; ii < B.size(); ++ii) {
+        const auto f = static_cast<float>(ii)*0.0001F;
+        S[ii] = SymmetricMatrix3x3(2.0F + f, 0.1F, -0.3F*f, 3.0F, 0.2F + f, 4.0F - f);
+        M[ii] = S[ii].matrix();
+    }
+    std::vector<Matrix3x3> scalar(B.size());
+    std::vector<Matrix3x3> cholesky(B.size());
+    std::vector<Matrix3x3> ldlt(B.size());
+
+    // Kalman gain K = B*S^-1
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < B.size(); ++ii) { scalar[ii] = B[ii]*M[ii].inverse(); }
+    });
+    const double cholesky_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < B.size(); ++ii) { cholesky[ii] = Cholesky3x3(S[ii]).solve_right(B[ii]); }
+    });
+    report("Cholesky3x3::solve_right", scalar_ns, cholesky_ns);
+    const double ldlt_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < B.size(); ++ii) { ldlt[ii] = LDLT3x3(S[ii]).solve_right(B[ii]); }
+    });
+    report("LDLT3x3::solve_right", scalar_ns, ldlt_ns);
+    for (size_t ii = 0; ii < B.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, scalar[ii][1], cholesky[ii][1]);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, scalar[ii][1], ldlt[ii][1]);
+    }
+}
+
+void test_benchmark_symmetric_eigen3x3()
+{
+    std::vector<SymmetricMatrix3x3> S(BENCHMARK_COUNT);
+    for (size_t ii = 0; ii < S.size(); ++ii) {
+        const auto f = static_cast<float>(ii)*0.001F;
+        S[ii] = SymmetricMatrix3x3(2.0F + f, 0.5F, -0.3F*f, 3.0F, 0.2F + f, 4.0F - f);
+    }
+    std::vector<SymmetricEigen3x3> jacobi(S.size());
+    std::vector<xyz_t> analytic(S.size());
+
+    // Jacobi eigendecomposition, compared with the closed-form eigenvalues
+    const double jacobi_ns = benchmark_ns([&]() { SymmetricEigen3x3::decompose_batch(S, jacobi); });
+    const double analytic_ns = benchmark_ns([&]() { SymmetricEigen3x3::eigenvalues_batch(S, analytic); });
+    report("SymmetricEigen3x3 eigenvalues", jacobi_ns, analytic_ns);
+    for (size_t ii = 0; ii < S.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-4F, jacobi[ii].eigenvalues().x, analytic[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-4F, jacobi[ii].eigenvalues().z, analytic[ii].z);
+    }
+}
+
+void test_benchmark_matrix3x3_multiply_vector()
+{
+    const std::vector<Matrix3x3> a = benchmark_matrices(0.5F);
+    const std::vector<xyz_t> v = benchmark_vectors();
+    std::vector<xyz_t> scalar(v.size());
+    std::vector<xyz_t> batch(v.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar[ii] = a[ii]*v[ii]; }
+    });
+
+    const matrix3x3_soa_t sa(a);
+    const double batch_ns = benchmark_ns([&]() { sa.multiply(v, batch); });
+    report("Matrix3x3[i]*xyz_t[i]", scalar_ns, batch_ns);
+    assert_close(scalar, batch);
+
+    const xyz_soa_t sv(v);
+    xyz_soa_t sOut(v.size());
+    const double soa_ns = benchmark_ns([&]() { sa.multiply(sv, sOut); });
+    report("Matrix3x3[i]*xyz_t[i] (soa)", scalar_ns, soa_ns);
+    assert_close(scalar, sOut.to_vector());
+
+    const Matrix3x3& m = a[7];
+    const double scalar_one_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar[ii] = m*v[ii]; }
+    });
+    const double batch_one_ns = benchmark_ns([&]() { m.multiply(v, batch); });
+    report("Matrix3x3*xyz_t[i]", scalar_one_ns, batch_one_ns);
+    assert_close(scalar, batch);
+    const double soa_one_ns = benchmark_ns([&]() { m.multiply(sv, sOut); });
+    report("Matrix3x3*xyz_t[i] (soa)", scalar_one_ns, soa_one_ns);
+    assert_close(scalar, sOut.to_vector());
+}
+void test_benchmark_matrix3x3_inverse()
+{
+    const std::vector<Matrix3x3> a = benchmark_matrices(0.5F);
+    std::vector<Matrix3x3> scalar(a.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < a.size(); ++ii) { scalar[ii] = a[ii].inverse(); }
+    });
+
+    const matrix3x3_soa_t sa(a);
+    matrix3x3_soa_t sOut(a.size());
+    std::vector<uint32_t> singular(sa.singular_mask_size());
+    const double batch_ns = benchmark_ns([&]() { (void)sa.inverse(sOut, singular); });
+    report("Matrix3x3[i].inverse()", scalar_ns, batch_ns);
+    // the inverse amplifies differences in rounding by the condition number of the matrix,
+    // and some of the benchmark matrices are nearly singular (with determinants down to 0.0045)
+    assert_close(scalar, sOut.to_vector(), 1.0E-4F);
+}
+void test_benchmark_matrix3x3_quaternion()
+{
+    // mixed attitudes, so the branches in Matrix3x3::quaternion are unpredictable
+    std::vector<Quaternion> q(BENCHMARK_COUNT);
+    for (size_t ii = 0; ii < q.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        q[ii] = Quaternion::from_euler_angles_radians(0.7F*f, 0.37F*f, 1.3F*f);
+    }
+    std::vector<Matrix3x3> m(q.size());
+    const double scalar_from_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < q.size(); ++ii) { m[ii] = Matrix3x3(q[ii]); }
+    });
+    matrix3x3_soa_t sm(q.size());
+    const double batch_from_ns = benchmark_ns([&]() { sm.from_quaternion(q); });
+    report("Matrix3x3(Quaternion)", scalar_from_ns, batch_from_ns);
+    assert_close(m, sm.to_vector());
+
+    std::vector<Quaternion> scalar(q.size());
+    std::vector<Quaternion> batch(q.size());
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < m.size(); ++ii) { scalar[ii] = m[ii].quaternion(); }
+    });
+    const double batch_ns = benchmark_ns([&]() { sm.to_quaternion(batch); });
+    report("Matrix3x3::quaternion", scalar_ns, batch_ns);
+    // the scalar and batch square root estimates may each be out by RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR
+    for (size_t ii = 0; ii < q.size(); ++ii) { assert_close(scalar[ii].get_w(), batch[ii].get_w(), ULP_TOLERANCE + 2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR); }
+}
+void test_benchmark_quaternion_attitude()
+{
+    std::vector<Quaternion> q(BENCHMARK_COUNT);
+    for (size_t ii = 0; ii < q.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        q[ii] = Quaternion::from_euler_angles_radians(0.7F*f, 0.37F*f, 1.3F*f);
+    }
+    std::vector<attitude_t> separate(q.size());
+    std::vector<attitude_t> fused(q.size());
+    std::vector<attitude_t> batch(q.size());
+
+    const double separate_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < q.size(); ++ii) {
+            const Quaternion& p = q[ii];
+            separate[ii] = attitude_t {
+                p.calculate_roll_radians(), p.calculate_pitch_radians(), p.calculate_yaw_radians(),
+                p.sin_roll(), p.cos_roll(), p.tan_roll(),
+                p.sin_pitch(), p.cos_pitch(), p.tan_pitch(),
+                p.sin_yaw(), p.cos_yaw(), p.tan_yaw()
+            };
+        }
+    });
+    const double fused_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < q.size(); ++ii) { fused[ii] = q[ii].attitude(); }
+    });
+    report("Quaternion::attitude", separate_ns, fused_ns);
+    const double batch_ns = benchmark_ns([&]() { Quaternion::attitude_batch(q, batch); });
+    report("Quaternion::attitude_batch", separate_ns, batch_ns);
+    for (size_t ii = 0; ii < q.size(); ++ii) {
+        TEST_ASSERT_EQUAL_FLOAT(separate[ii].roll, fused[ii].roll);
+        // cos_yaw is b_yaw/sqrt(a_yaw*a_yaw + b_yaw*b_yaw), where the denominator is cos_pitch/2, so rounding differences are
+        // magnified by 1/cos_pitch near gimbal lock. attitude_batch always uses the full precision reciprocal square root.
+        assert_close(fused[ii].cos_yaw, batch[ii].cos_yaw, ULP_TOLERANCE + RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, 1.0F/fused[ii].cos_pitch);
+    }
+}
+void test_benchmark_quaternion_interpolator()
+{
+    // resample keyframes at 8 times the keyframe rate
+    std::vector<float> times(BENCHMARK_COUNT/8);
+    std::vector<Quaternion> keyframes(times.size());
+    for (size_t ii = 0; ii < times.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        times[ii] = f*0.01F;
+        keyframes[ii] = Quaternion::from_euler_angles_radians(0.7F*f, 0.37F*f, 1.3F*f);
+    }
+    std::vector<float> query(BENCHMARK_COUNT);
+    for (size_t ii = 0; ii < query.size(); ++ii) { query[ii] = static_cast<float>(ii)*0.00125F; }
+    std::vector<Quaternion> scalar(query.size());
+    std::vector<Quaternion> batch(query.size());
+
+    // binary search for the segment, then slerp, for each query
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < query.size(); ++ii) {
+            const float time = query[ii];
+            const auto it = std::upper_bound(times.begin(), times.end(), time);
+            if (it == times.end()) {
+                scalar[ii] = keyframes.back();
+                continue;
+            }
+            const auto segment = static_cast<size_t>(it - times.begin()) - 1;
+            const float t = (time - times[segment])*(1.0F/(times[segment + 1] - times[segment]));
+            scalar[ii] = Quaternion::slerp(keyframes[segment], keyframes[segment + 1], t);
+        }
+    });
+    const double batch_ns = benchmark_ns([&]() {
+        QuaternionInterpolator interpolator(times, keyframes);
+        interpolator.interpolate(query, batch);
+    });
+    report("QuaternionInterpolator (slerp)", scalar_ns, batch_ns);
+    for (size_t ii = 0; ii < query.size(); ++ii) { assert_close(scalar[ii].w, batch[ii].w); }
+}
+void test_benchmark_quaternion_simd()
+{
+    // chained attitude updates, q = (q*dq).normalized(), where dq is a gyro increment
+    std::vector<Quaternion> dq(BENCHMARK_COUNT);
+    std::vector<QuaternionSimd> dqSimd(dq.size());
+    for (size_t ii = 0; ii < dq.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        dq[ii] = Quaternion(1.0F, 0.001F*f, -0.0005F*f, 0.002F).normalized();
+        dqSimd[ii] = QuaternionSimd(dq[ii]);
+    }
+    Quaternion scalar;
+    QuaternionSimd simd;
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (const auto& d : dq) { scalar = (scalar*d).normalized(); }
+    });
+    const double simd_ns = benchmark_ns([&]() {
+        for (const auto& d : dqSimd) { simd = (simd*d).normalized(); }
+    });
+    report("QuaternionSimd attitude update", scalar_ns, simd_ns);
+    // rounding differences (eg from fused multiply-add contraction) accumulate over the chain of updates
+    assert_close(scalar.w, simd.get_w(), 1.0E-4F);
+    assert_close(scalar.z, simd.get_z(), 1.0E-4F);
+
+    // rotate by the same quaternion, so the comparison does not include the differences accumulated above
+    scalar = simd.quaternion();
+    const std::vector<xyz_t> v = benchmark_vectors();
+    std::vector<xyz_t> scalarRotated(v.size());
+    std::vector<xyz_t> simdRotated(v.size());
+    const double scalar_rotate_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalarRotated[ii] = scalar.rotate(v[ii]); }
+    });
+    const double simd_rotate_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { simdRotated[ii] = simd.rotate(v[ii]); }
+    });
+    report("QuaternionSimd::rotate", scalar_rotate_ns, simd_rotate_ns);
+    for (size_t ii = 0; ii < v.size(); ++ii) { TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, scalarRotated[ii].x, simdRotated[ii].x); }
+}
+void test_benchmark_xyzw_t()
+{
+    // 16-byte padded vectors, so each vector is a single aligned load and store
+    const std::vector<xyz_t> v = benchmark_vectors();
+    std::vector<xyzw_t> w(v.size());
+    xyzw_t::from_xyz(v, w);
+    const Matrix3x3 m = Matrix3x3::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    const Matrix3x3Simd mSimd(m);
+    std::vector<xyz_t> scalar(v.size());
+    std::vector<xyzw_t> simd(v.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar[ii] = m*v[ii]; }
+    });
+    const double simd_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < w.size(); ++ii) { simd[ii] = mSimd*w[ii]; }
+    });
+    report("Matrix3x3Simd*xyzw_t[i]", scalar_ns, simd_ns);
+    for (size_t ii = 0; ii < v.size(); ++ii) { assert_close(scalar[ii], simd[ii].xyz()); }
+
+    const double scalar_normalized_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar[ii] = (v[ii] + scalar[ii]).normalized(); }
+    });
+    const double simd_normalized_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < w.size(); ++ii) { simd[ii] = (w[ii] + simd[ii]).normalized(); }
+    });
+    report("xyzw_t::normalized", scalar_normalized_ns, simd_normalized_ns);
+    for (size_t ii = 0; ii < v.size(); ++ii) { assert_close(scalar[ii].x, simd[ii].get_x()); }
+
+    const std::vector<Matrix3x3> a = benchmark_matrices(0.5F);
+    std::vector<Matrix3x3Simd> aSimd(a.size());
+    for (size_t ii = 0; ii < a.size(); ++ii) { aSimd[ii] = Matrix3x3Simd(a[ii]); }
+    std::vector<Matrix3x3> scalarProduct(a.size());
+    std::vector<Matrix3x3Simd> simdProduct(a.size());
+    const double scalar_multiply_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < a.size(); ++ii) { scalarProduct[ii] = m*a[ii]; }
+    });
+    const double simd_multiply_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < a.size(); ++ii) { simdProduct[ii] = mSimd*aSimd[ii]; }
+    });
+    report("Matrix3x3Simd*Matrix3x3Simd[i]", scalar_multiply_ns, simd_multiply_ns);
+    for (size_t ii = 0; ii < a.size(); ++ii) { assert_close(scalarProduct[ii], simdProduct[ii].matrix()); }
+}
+
+void test_benchmark_quaternion_packed()
+{
+    std::vector<Quaternion> q(BENCHMARK_COUNT);
+    for (size_t ii = 0; ii < q.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        q[ii] = Quaternion::from_euler_angles_radians(0.7F*f, 0.37F*f, 1.3F*f);
+    }
+    std::vector<quaternion_packed32_t> scalar(q.size());
+    std::vector<quaternion_packed32_t> batch(q.size());
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < q.size(); ++ii) { scalar[ii] = quaternion_packed32_t::encode(q[ii]); }
+    });
+    const double batch_ns = benchmark_ns([&]() { quaternion_packed32_t::encode_batch(q, batch); });
+    report("quaternion_packed32_t::encode", scalar_ns, batch_ns);
+    TEST_ASSERT_TRUE(scalar == batch);
+
+    std::vector<Quaternion> scalar_q(q.size());
+    std::vector<Quaternion> batch_q(q.size());
+    const double scalar_decode_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < q.size(); ++ii) { scalar_q[ii] = scalar[ii].decode(); }
+    });
+    const double batch_decode_ns = benchmark_ns([&]() { quaternion_packed32_t::decode_batch(batch, batch_q); });
+    report("quaternion_packed32_t::decode", scalar_decode_ns, batch_decode_ns);
+    for (size_t ii = 0; ii < q.size(); ++ii) { assert_close(scalar_q[ii], batch_q[ii]); }
+}
+
+void test_benchmark_xyz_packed()
+{
+    std::vector<xyz_t> v = benchmark_vectors();
+    std::vector<xyz_octahedral32_t> scalar(v.size());
+    std::vector<xyz_octahedral32_t> batch(v.size());
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar[ii] = xyz_octahedral32_t::encode(v[ii]); }
+    });
+    const double batch_ns = benchmark_ns([&]() { xyz_octahedral32_t::encode_batch(v, batch); });
+    report("xyz_octahedral32_t::encode", scalar_ns, batch_ns);
+    TEST_ASSERT_TRUE(scalar == batch);
+
+    std::vector<xyz_t> scalar_v(v.size());
+    std::vector<xyz_t> batch_v(v.size());
+    const double scalar_decode_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar_v[ii] = scalar[ii].decode(); }
+    });
+    const double batch_decode_ns = benchmark_ns([&]() { xyz_octahedral32_t::decode_batch(batch, batch_v); });
+    report("xyz_octahedral32_t::decode", scalar_decode_ns, batch_decode_ns);
+    assert_close(scalar_v, batch_v);
+
+    std::vector<xyz_half_t> scalar_h(v.size());
+    std::vector<xyz_half_t> batch_h(v.size());
+    const double scalar_half_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar_h[ii] = xyz_half_t::encode(v[ii]); }
+    });
+    const double batch_half_ns = benchmark_ns([&]() { xyz_half_t::encode_batch(v, batch_h); });
+    report("xyz_half_t::encode", scalar_half_ns, batch_half_ns);
+    TEST_ASSERT_TRUE(scalar_h == batch_h);
+}
+
+/*!
+The ordinary operators against the lazy expressions of lazy_expression.h, reported as scalar and batch respectively.
+With GCC at -O2 the timings are the same, since the temporaries of the ordinary operators are already eliminated.
+*/
+void test_benchmark_lazy_expression()
+{
+    const std::vector<xyz_t> v = benchmark_vectors();
+    const xyz_t ex{0.6F, 0.8F, 0.0F};
+    const xyz_t ey{-0.8F, 0.6F, 0.0F};
+    const xyz_t ez{0.0F, 0.0F, 1.0F};
+    std::vector<xyz_t> scalar(v.size());
+    std::vector<xyz_t> batch(v.size());
+
+    const double scalar_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { scalar[ii] = v[ii] + v[ii].x*ex + v[ii].y*ey + v[ii].z*ez; }
+    });
+    const double batch_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < v.size(); ++ii) { batch[ii] = lazy(v[ii]) + v[ii].x*lazy(ex) + v[ii].y*lazy(ey) + v[ii].z*lazy(ez); }
+    });
+    report("lazy p1 + x*ex + y*ey + z*ez", scalar_ns, batch_ns);
+    assert_close(scalar, batch);
+
+    const std::vector<Matrix3x3> F = benchmark_matrices(0.5F);
+    const std::vector<Matrix3x3> P = benchmark_matrices(-1.25F);
+    const Matrix3x3 Q(0.01F, 0.02F, 0.03F);
+    std::vector<Matrix3x3> scalar_m(F.size());
+    std::vector<Matrix3x3> batch_m(F.size());
+
+    const double scalar_covariance_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { scalar_m[ii] = F[ii]*P[ii]*F[ii].transpose() + Q; }
+    });
+    const double batch_covariance_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { batch_m[ii] = lazy(F[ii])*P[ii]*lazy(F[ii]).transpose() + Q; }
+    });
+    report("lazy F*P*F.transpose() + Q", scalar_covariance_ns, batch_covariance_ns);
+    assert_close(scalar_m, batch_m);
+
+    const double scalar_sum_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { scalar_m[ii] = F[ii] + P[ii]*2.0F - Q; }
+    });
+    const double batch_sum_ns = benchmark_ns([&]() {
+        for (size_t ii = 0; ii < F.size(); ++ii) { batch_m[ii] = lazy(F[ii]) + P[ii]*2.0F - Q; }
+    });
+    report("lazy F + P*2 - Q", scalar_sum_ns, batch_sum_ns);
+    assert_close(scalar_m, batch_m);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_benchmark_quaternion_rotate);
+    RUN_TEST(test_benchmark_normalize);
+    RUN_TEST(test_benchmark_matrix3x3_multiply);
+    RUN_TEST(test_benchmark_matrix3x3_multiply_vector);
+    RUN_TEST(test_benchmark_matrix3x3_congruence);
+    RUN_TEST(test_benchmark_symmetric_matrix3x3);
+    RUN_TEST(test_benchmark_diagonal_matrix3x3);
+    RUN_TEST(test_benchmark_rotation_matrix3x3);
+    RUN_TEST(test_benchmark_matrix_nxm);
+    RUN_TEST(test_benchmark_cholesky3x3);
+    RUN_TEST(test_benchmark_symmetric_eigen3x3);
+    RUN_TEST(test_benchmark_matrix3x3_inverse);
+    RUN_TEST(test_benchmark_matrix3x3_quaternion);
+    RUN_TEST(test_benchmark_quaternion_attitude);
+    RUN_TEST(test_benchmark_quaternion_interpolator);
+    RUN_TEST(test_benchmark_quaternion_simd);
+    RUN_TEST(test_benchmark_xyzw_t);
+    RUN_TEST(test_benchmark_quaternion_packed);
+    RUN_TEST(test_benchmark_xyz_packed);
+    RUN_TEST(test_benchmark_lazy_expression);
+
+    UNITY_END();
+}
@@ -0,0 +1,185 @@
+#include "cholesky3x3.h"
+#include <array>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+static void assert_xyz_within(float delta, const xyz_t& expected, const xyz_t& actual)
+{
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.x, actual.x);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.y, actual.y);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.z, actual.z);
+}
+
+static void assert_matrix_within(float delta, const Matrix3x3& expected, const Matrix3x3& actual)
+{
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(delta, expected[ii], actual[ii]);
+    }
+}
+
+void test_cholesky3x3_factorize()
+{
+    const SymmetricMatrix3x3 s(4.0F, 2.0F, -2.0F, 10.0F, 4.0F, 9.0F);
+    const Cholesky3x3 cholesky(s);
+    TEST_ASSERT_TRUE(cholesky.is_positive_definite());
+    const Matrix3x3 l = cholesky.lower();
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, l[0]);
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, l[3]);
+    TEST_ASSERT_EQUAL_FLOAT(-1.0F, l[6]);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F/3.0F, l[7]);
+    TEST_ASSERT_EQUAL_FLOAT(std::sqrt(47.0F/9.0F), l[8]);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, l[1]);
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, l[4]);
+    assert_matrix_within(1.0E-6F, s.matrix(), l.multiply_transpose(l));
+
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-3F, s.determinant(), cholesky.determinant());
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, std::log(s.determinant()), cholesky.log_determinant());
+
+    // not positive definite
+    Cholesky3x3 c;
+    TEST_ASSERT_FALSE(c.factorize(SymmetricMatrix3x3(1.0F, 2.0F, 0.0F, 1.0F, 0.0F, 1.0F)));
+    TEST_ASSERT_FALSE(c.is_positive_definite());
+    TEST_ASSERT_TRUE(c.solve(xyz_t{1.0F, 2.0F, 3.0F}) == (xyz_t{0.0F, 0.0F, 0.0F}));
+    TEST_ASSERT_FALSE(Cholesky3x3(SymmetricMatrix3x3(-1.0F)).is_positive_definite());
+    TEST_ASSERT_FALSE(Cholesky3x3(SymmetricMatrix3x3(1.0F, 1.0F, 0.0F)).is_positive_definite());
+}
+
+void test_cholesky3x3_solve()
+{
+    const SymmetricMatrix3x3 s(4.0F, 2.0F, -2.0F, 10.0F, 4.0F, 9.0F);
+    const Cholesky3x3 cholesky(s);
+    const xyz_t b{1.0F, -2.0F, 3.0F};
+    const xyz_t x = cholesky.solve(b);
+    assert_xyz_within(1.0E-6F, b, s*x);
+    assert_xyz_within(1.0E-6F, s.inverse()*b, x);
+    xyz_t y = b;
+    cholesky.solve_in_place(y);
+    assert_xyz_within(1.0E-6F, x, y);
+
+    const Matrix3x3 B(1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F, 8.0F, 10.0F);
+    const Matrix3x3 X = cholesky.solve(B);
+    assert_matrix_within(1.0E-5F, B, s.matrix()*X);
+    Matrix3x3 Y = B;
+    cholesky.solve_in_place(Y);
+    assert_matrix_within(1.0E-6F, X, Y);
+    // Kalman gain, K*S = P*H^T
+    const Matrix3x3 K = cholesky.solve_right(B);
+    assert_matrix_within(1.0E-5F, B, K*s.matrix());
+    assert_matrix_within(1.0E-5F, B*s.matrix().inverse(), K);
+
+    const SymmetricMatrix3x3 inverse = cholesky.inverse();
+    assert_matrix_within(1.0E-6F, s.inverse().matrix(), inverse.matrix());
+}
+
+void test_ldlt3x3()
+{
+    const SymmetricMatrix3x3 s(4.0F, 2.0F, -2.0F, 10.0F, 4.0F, 9.0F);
+    const LDLT3x3 ldlt(s);
+    TEST_ASSERT_TRUE(ldlt.is_positive_definite());
+    TEST_ASSERT_FALSE(ldlt.is_singular());
+    const Matrix3x3 l = ldlt.lower();
+    const xyz_t d = ldlt.diagonal();
+    assert_matrix_within(1.0E-5F, s.matrix(), l*Matrix3x3(d.x, d.y, d.z)*l.transpose());
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-3F, s.determinant(), ldlt.determinant());
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, Cholesky3x3(s).log_determinant(), ldlt.log_determinant());
+
+    const Cholesky3x3 cholesky(s);
+    const xyz_t b{1.0F, -2.0F, 3.0F};
+    assert_xyz_within(1.0E-6F, cholesky.solve(b), ldlt.solve(b));
+    const Matrix3x3 B(1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F, 8.0F, 10.0F);
+    assert_matrix_within(1.0E-5F, cholesky.solve(B), ldlt.solve(B));
+    assert_matrix_within(1.0E-5F, cholesky.solve_right(B), ldlt.solve_right(B));
+
+    // indefinite, but non-singular
+    const SymmetricMatrix3x3 indefinite(1.0F, 2.0F, 0.0F, 1.0F, 0.0F, 1.0F);
+    const LDLT3x3 i(indefinite);
+    TEST_ASSERT_FALSE(i.is_singular());
+    TEST_ASSERT_FALSE(i.is_positive_definite());
+    assert_xyz_within(1.0E-6F, b, indefinite*i.solve(b));
+
+    // singular
+    LDLT3x3 singular;
+    TEST_ASSERT_FALSE(singular.factorize(SymmetricMatrix3x3(1.0F, 1.0F, 0.0F, 1.0F, 0.0F, 1.0F)));
+    TEST_ASSERT_TRUE(singular.is_singular());
+    TEST_ASSERT_FALSE(singular.is_positive_definite());
+}
+
+void test_cholesky3x3_batch()
+{
+    const std::array<SymmetricMatrix3x3, 4> s {{
+        SymmetricMatrix3x3(4.0F, 2.0F, -2.0F, 10.0F, 4.0F, 9.0F),
+        SymmetricMatrix3x3(2.0F, 0.1F, -0.3F, 3.0F, 0.2F, 4.0F),
+        SymmetricMatrix3x3(1.0F, 2.0F, 0.0F, 1.0F, 0.0F, 1.0F), // indefinite
+        SymmetricMatrix3x3(5.0F)
+    }};
+    const std::array<xyz_t, 4> b {{ {1.0F, -2.0F, 3.0F}, {0.5F, 0.5F, 0.5F}, {1.0F, 1.0F, 1.0F}, {5.0F, 10.0F, 15.0F} }};
+    std::array<xyz_t, 4> out {};
+
+    TEST_ASSERT_FALSE(Cholesky3x3::solve_batch(s, b, out));
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        TEST_ASSERT_TRUE(out[ii] == Cholesky3x3(s[ii]).solve(b[ii]));
+    }
+    TEST_ASSERT_TRUE(out[2] == (xyz_t{0.0F, 0.0F, 0.0F}));
+    TEST_ASSERT_TRUE(out[3] == (xyz_t{1.0F, 2.0F, 3.0F}));
+
+    std::array<Cholesky3x3, 4> cholesky {};
+    TEST_ASSERT_FALSE(Cholesky3x3::factorize_batch(s, cholesky));
+    TEST_ASSERT_TRUE(cholesky[0].is_positive_definite());
+    TEST_ASSERT_FALSE(cholesky[2].is_positive_definite());
+    TEST_ASSERT_TRUE(Cholesky3x3::factorize_batch(std::span<const SymmetricMatrix3x3>(s.data(), 2), cholesky));
+
+    // LDLT factorizes the indefinite matrix
+    TEST_ASSERT_TRUE(LDLT3x3::solve_batch(s, b, out));
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        TEST_ASSERT_TRUE(out[ii] == LDLT3x3(s[ii]).solve(b[ii]));
+    }
+    std::array<LDLT3x3, 4> ldlt {};
+    TEST_ASSERT_TRUE(LDLT3x3::factorize_batch(s, ldlt));
+    TEST_ASSERT_FALSE(ldlt[2].is_positive_definite());
+}
+
+void test_cholesky3x3_double()
+{
+    const SymmetricMatrix3x3d s(2.0, 0.1, -0.3, 3.0, 0.2, 4.0);
+    const Cholesky3x3d cholesky(s);
+    const xyzd_t b{1.0, -2.0, 3.0};
+    const xyzd_t r = s*cholesky.solve(b) - b;
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-7F, 0.0F, static_cast<float>(r.x*r.x + r.y*r.y + r.z*r.z));
+    const xyzd_t l = s*LDLT3x3d(s).solve(b) - b;
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-7F, 0.0F, static_cast<float>(l.x*l.x + l.y*l.y + l.z*l.z));
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-7F, 0.0F, static_cast<float>(cholesky.log_determinant() - std::log(s.determinant())));
+}
+
+void test_ldlt3x3_constexpr()
+{
+    constexpr LDLT3x3 ldlt(SymmetricMatrix3x3(4.0F, 2.0F, 0.0F, 2.0F, 0.0F, 1.0F));
+    static_assert(ldlt.is_positive_definite());
+    static_assert(ldlt.diagonal() == (xyz_t{4.0F, 1.0F, 1.0F}));
+    static_assert(ldlt.determinant() == 4.0F);
+    static_assert(ldlt.solve(xyz_t{4.0F, 2.0F, 1.0F}) == (xyz_t{1.0F, 0.0F, 1.0F}));
+    TEST_ASSERT_TRUE(ldlt.lower() == Matrix3x3(1.0F, 0.0F, 0.0F, 0.5F, 1.0F, 0.0F, 0.0F, 0.0F, 1.0F));
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_cholesky3x3_factorize);
+    RUN_TEST(test_cholesky3x3_solve);
+    RUN_TEST(test_ldlt3x3);
+    RUN_TEST(test_cholesky3x3_batch);
+    RUN_TEST(test_cholesky3x3_double);
+    RUN_TEST(test_ldlt3x3_constexpr);
+
+    UNITY_END();
+}
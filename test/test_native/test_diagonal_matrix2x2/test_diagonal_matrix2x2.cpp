@@ -0,0 +1,88 @@
+#include "diagonal_matrix2x2.h"
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+void test_diagonal_matrix2x2_constructors()
+{
+    static_assert(sizeof(DiagonalMatrix2x2) == 2*sizeof(float));
+
+    const DiagonalMatrix2x2 d(2.0F, 3.0F);
+    TEST_ASSERT_TRUE(d.matrix() == Matrix2x2(2.0F, 3.0F));
+    TEST_ASSERT_TRUE(DiagonalMatrix2x2(d.matrix()) == d);
+    TEST_ASSERT_TRUE(DiagonalMatrix2x2(xy_t{2.0F, 3.0F}) == d);
+    TEST_ASSERT_TRUE(d.diagonal() == (xy_t{2.0F, 3.0F}));
+    TEST_ASSERT_TRUE(DiagonalMatrix2x2(Matrix2x2(1.0F, 2.0F, 3.0F, 4.0F)) == DiagonalMatrix2x2(1.0F, 4.0F));
+    TEST_ASSERT_TRUE(DiagonalMatrix2x2(2.0F).matrix() == Matrix2x2(2.0F));
+
+    DiagonalMatrix2x2 s = d;
+    s.set_to_identity();
+    TEST_ASSERT_TRUE(s == DiagonalMatrix2x2(1.0F));
+    s.set_zero();
+    TEST_ASSERT_TRUE(s == DiagonalMatrix2x2());
+}
+
+void test_diagonal_matrix2x2_arithmetic()
+{
+    const DiagonalMatrix2x2 d(2.0F, 3.0F);
+    const DiagonalMatrix2x2 e(0.5F, -1.0F);
+    const Matrix2x2 D = d.matrix();
+    const Matrix2x2 E = e.matrix();
+
+    TEST_ASSERT_TRUE((d + e).matrix() == D + E);
+    TEST_ASSERT_TRUE((d - e).matrix() == D - E);
+    TEST_ASSERT_TRUE((d*e).matrix() == D.multiply_assuming_diagonal(E));
+    TEST_ASSERT_TRUE((-d).matrix() == -D);
+    TEST_ASSERT_TRUE((d*3.0F).matrix() == D*3.0F);
+    TEST_ASSERT_TRUE((d/4.0F).matrix() == D/4.0F);
+
+    const xy_t v{1.0F, -2.0F};
+    TEST_ASSERT_TRUE(d*v == D*v);
+    TEST_ASSERT_EQUAL_FLOAT(D.determinant(), d.determinant());
+    TEST_ASSERT_EQUAL_FLOAT(D.trace(), d.trace());
+}
+
+void test_diagonal_matrix2x2_full_matrix()
+{
+    const DiagonalMatrix2x2 d(2.0F, 3.0F);
+    const Matrix2x2 D = d.matrix();
+    const Matrix2x2 m(1.0F, 2.0F, 3.0F, 5.0F);
+
+    TEST_ASSERT_TRUE(d*m == D*m);
+    TEST_ASSERT_TRUE(m*d == m*D);
+    TEST_ASSERT_TRUE(d + m == D + m);
+    TEST_ASSERT_TRUE(m + d == m + D);
+    TEST_ASSERT_TRUE(d - m == D - m);
+    TEST_ASSERT_TRUE(m - d == m - D);
+}
+
+void test_diagonal_matrix2x2_inverse()
+{
+    constexpr DiagonalMatrix2x2 d(2.0F, -4.0F);
+    static_assert(d.inverse() == DiagonalMatrix2x2(0.5F, -0.25F));
+    TEST_ASSERT_TRUE(d.inverse().matrix() == d.matrix().inverse_assuming_diagonal());
+    DiagonalMatrix2x2 s = d;
+    s.invert_in_place();
+    TEST_ASSERT_TRUE(s == d.inverse());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_diagonal_matrix2x2_constructors);
+    RUN_TEST(test_diagonal_matrix2x2_arithmetic);
+    RUN_TEST(test_diagonal_matrix2x2_full_matrix);
+    RUN_TEST(test_diagonal_matrix2x2_inverse);
+
+    UNITY_END();
+}
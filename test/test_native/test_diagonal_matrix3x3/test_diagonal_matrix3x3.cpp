@@ -0,0 +1,126 @@
+#include "diagonal_matrix3x3.h"
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+void test_diagonal_matrix3x3_constructors()
+{
+    static_assert(sizeof(DiagonalMatrix3x3) == 3*sizeof(float));
+
+    const DiagonalMatrix3x3 d(2.0F, 3.0F, 4.0F);
+    TEST_ASSERT_TRUE(d.matrix() == Matrix3x3(2.0F, 3.0F, 4.0F));
+    TEST_ASSERT_TRUE(DiagonalMatrix3x3(d.matrix()) == d);
+    TEST_ASSERT_TRUE(DiagonalMatrix3x3(xyz_t{2.0F, 3.0F, 4.0F}) == d);
+    TEST_ASSERT_TRUE(d.diagonal() == (xyz_t{2.0F, 3.0F, 4.0F}));
+    // elements off the diagonal are ignored
+    TEST_ASSERT_TRUE(DiagonalMatrix3x3(Matrix3x3(1, 2, 3, 4, 5, 6, 7, 8, 9)) == DiagonalMatrix3x3(1, 5, 9));
+    TEST_ASSERT_TRUE(DiagonalMatrix3x3(2.0F).matrix() == Matrix3x3(2.0F));
+    TEST_ASSERT_TRUE(DiagonalMatrix3x3().matrix() == Matrix3x3());
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, d[1]);
+
+    DiagonalMatrix3x3 s = d;
+    s.set_to_identity();
+    TEST_ASSERT_TRUE(s == DiagonalMatrix3x3(1.0F));
+    s.set_to_scaled_identity(5.0F);
+    TEST_ASSERT_TRUE(s == DiagonalMatrix3x3(5.0F));
+    s.set_zero();
+    TEST_ASSERT_TRUE(s == DiagonalMatrix3x3());
+}
+
+void test_diagonal_matrix3x3_arithmetic()
+{
+    const DiagonalMatrix3x3 d(2.0F, 3.0F, 4.0F);
+    const DiagonalMatrix3x3 e(0.5F, -1.0F, 7.0F);
+    const Matrix3x3 D = d.matrix();
+    const Matrix3x3 E = e.matrix();
+
+    TEST_ASSERT_TRUE((d + e).matrix() == D + E);
+    TEST_ASSERT_TRUE((d - e).matrix() == D - E);
+    TEST_ASSERT_TRUE((d*e).matrix() == D*E);
+    TEST_ASSERT_TRUE((d*e).matrix() == D.multiply_assuming_diagonal(E));
+    TEST_ASSERT_TRUE((-d).matrix() == -D);
+    TEST_ASSERT_TRUE((d*3.0F).matrix() == D*3.0F);
+    TEST_ASSERT_TRUE((3.0F*d).matrix() == 3.0F*D);
+    TEST_ASSERT_TRUE((d/4.0F).matrix() == D/4.0F);
+
+    DiagonalMatrix3x3 s = d;
+    s += e;
+    TEST_ASSERT_TRUE(s == d + e);
+    s -= e;
+    TEST_ASSERT_TRUE(s == d);
+    s *= e;
+    TEST_ASSERT_TRUE(s == d*e);
+    s = d;
+    s *= 2.0F;
+    TEST_ASSERT_TRUE(s == d*2.0F);
+    s /= 2.0F;
+    TEST_ASSERT_TRUE(s == d);
+
+    const xyz_t v{1.0F, -2.0F, 3.0F};
+    TEST_ASSERT_TRUE(d*v == D*v);
+    TEST_ASSERT_EQUAL_FLOAT(D.determinant(), d.determinant());
+    TEST_ASSERT_EQUAL_FLOAT(D.trace(), d.trace());
+}
+
+void test_diagonal_matrix3x3_full_matrix()
+{
+    const DiagonalMatrix3x3 d(2.0F, 3.0F, 4.0F);
+    const Matrix3x3 D = d.matrix();
+    const Matrix3x3 m(1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F, 8.0F, 10.0F);
+
+    TEST_ASSERT_TRUE(d*m == D*m);
+    TEST_ASSERT_TRUE(m*d == m*D);
+    TEST_ASSERT_TRUE(d + m == D + m);
+    TEST_ASSERT_TRUE(m + d == m + D);
+    TEST_ASSERT_TRUE(d - m == D - m);
+    TEST_ASSERT_TRUE(m - d == m - D);
+}
+
+void test_diagonal_matrix3x3_inverse()
+{
+    const DiagonalMatrix3x3 d(2.0F, 4.0F, -8.0F);
+    TEST_ASSERT_TRUE(d.inverse() == DiagonalMatrix3x3(0.5F, 0.25F, -0.125F));
+    TEST_ASSERT_TRUE(d.inverse().matrix() == d.matrix().inverse_assuming_diagonal());
+    TEST_ASSERT_TRUE(d*d.inverse() == DiagonalMatrix3x3(1.0F));
+    DiagonalMatrix3x3 s = d;
+    s.invert_in_place();
+    TEST_ASSERT_TRUE(s == d.inverse());
+
+    const DiagonalMatrix3x3d dd(3.0, 7.0, 11.0);
+    const DiagonalMatrix3x3d identity = dd*dd.inverse();
+    for (size_t ii = 0; ii < 3; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-7F, 0.0F, static_cast<float>(identity[ii] - 1.0));
+    }
+}
+
+void test_diagonal_matrix3x3_constexpr()
+{
+    constexpr DiagonalMatrix3x3 d(2.0F, 4.0F, 8.0F);
+    static_assert(d.determinant() == 64.0F);
+    static_assert(d.inverse() == DiagonalMatrix3x3(0.5F, 0.25F, 0.125F));
+    static_assert(d*(xyz_t{1.0F, 1.0F, 1.0F}) == (xyz_t{2.0F, 4.0F, 8.0F}));
+    static_assert(d*Matrix3x3(1.0F) == d.matrix());
+    TEST_ASSERT_TRUE(d.matrix() == Matrix3x3(2.0F, 4.0F, 8.0F));
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_diagonal_matrix3x3_constructors);
+    RUN_TEST(test_diagonal_matrix3x3_arithmetic);
+    RUN_TEST(test_diagonal_matrix3x3_full_matrix);
+    RUN_TEST(test_diagonal_matrix3x3_inverse);
+    RUN_TEST(test_diagonal_matrix3x3_constexpr);
+
+    UNITY_END();
+}
@@ -1,5 +1,8 @@
+#include <array>
 #include <cmath>
 #include <fast_trigonometry.h>
+#include <limits>
+#include <vector>
 
 #include <unity.h>
 
@@ -231,6 +234,141 @@ void test_sin_cos()
     TEST_ASSERT_EQUAL_FLOAT(0.0F, sin);
     TEST_ASSERT_EQUAL_FLOAT(-1.0F, cos);
 }
+
+void test_sin_cos_batch()
+{
+    std::vector<float> x;
+    // dense range of angles
+    for (int ii = -4000; ii <= 4000; ++ii) {
+        x.push_back(static_cast<float>(ii) * 0.00397F);
+    }
+    // quadrant boundaries, where the remainder is +/-0.5 and rounding is on a halfway case
+    for (int ii = -16; ii <= 16; ++ii) {
+        x.push_back(static_cast<float>(ii) * 0.25F / FastTrigonometry::TWO_OVER_PI);
+    }
+    x.push_back(-0.0F);
+    x.push_back(0.0F);
+    x.push_back(1.0E-30F); // count is odd so the partial last block is also exercised
+
+    std::vector<float> sin(x.size());
+    std::vector<float> cos(x.size());
+    std::vector<float> sin2(x.size());
+    std::vector<float> cos2(x.size());
+    FastTrigonometry::sin_batch(x, sin);
+    FastTrigonometry::cos_batch(x, cos);
+    FastTrigonometry::sin_cos_batch(x, sin2, cos2);
+
+    const float delta = 4.0F*std::numeric_limits<float>::epsilon();
+    for (size_t ii = 0; ii < x.size(); ++ii) {
+        float s {};
+        float c {};
+        FastTrigonometry::sin_cos(x[ii], s, c);
+        // same operation order, but the compiler may contract multiply-adds into fused multiply-adds differently in each
+        TEST_ASSERT_FLOAT_WITHIN(delta, FastTrigonometry::sin(x[ii]), sin[ii]);
+        TEST_ASSERT_FLOAT_WITHIN(delta, FastTrigonometry::cos(x[ii]), cos[ii]);
+        TEST_ASSERT_FLOAT_WITHIN(delta, s, sin2[ii]);
+        TEST_ASSERT_FLOAT_WITHIN(delta, c, cos2[ii]);
+    }
+}
+void test_atan()
+{
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, FastTrigonometry::atan(0.0F));
+    for (int ii = -400; ii <= 400; ++ii) {
+        const float x = static_cast<float>(ii)*0.01F;
+        TEST_ASSERT_FLOAT_WITHIN(FastTrigonometry::ATAN_MAX_ERROR, atanf(x), FastTrigonometry::atan(x));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(FastTrigonometry::ATAN_MAX_ERROR, FastTrigonometry::HALF_PI, FastTrigonometry::atan(1.0E10F));
+    TEST_ASSERT_FLOAT_WITHIN(FastTrigonometry::ATAN_MAX_ERROR, -FastTrigonometry::HALF_PI, FastTrigonometry::atan(-1.0E10F));
+}
+
+void test_atan2()
+{
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, FastTrigonometry::atan2(0.0F, 0.0F));
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, FastTrigonometry::atan2(0.0F, 1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(FastTrigonometry::HALF_PI, FastTrigonometry::atan2(1.0F, 0.0F));
+    TEST_ASSERT_EQUAL_FLOAT(FastTrigonometry::M_PI_F, FastTrigonometry::atan2(0.0F, -1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(-FastTrigonometry::HALF_PI, FastTrigonometry::atan2(-1.0F, 0.0F));
+    // all four quadrants, and a range of magnitudes
+    for (int ii = -180; ii < 180; ++ii) {
+        const float angle = static_cast<float>(ii)*static_cast<float>(M_PI)/180.0F;
+        for (float scale : { 0.001F, 1.0F, 250.0F }) {
+            const float y = scale*sinf(angle);
+            const float x = scale*cosf(angle);
+            TEST_ASSERT_FLOAT_WITHIN(FastTrigonometry::ATAN_MAX_ERROR, atan2f(y, x), FastTrigonometry::atan2(y, x));
+        }
+    }
+}
+
+void test_asin_acos()
+{
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, FastTrigonometry::asin(0.0F));
+    TEST_ASSERT_EQUAL_FLOAT(FastTrigonometry::HALF_PI, FastTrigonometry::asin(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(-FastTrigonometry::HALF_PI, FastTrigonometry::asin(-1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, FastTrigonometry::acos(1.0F));
+    TEST_ASSERT_EQUAL_FLOAT(FastTrigonometry::M_PI_F, FastTrigonometry::acos(-1.0F));
+    for (int ii = -1000; ii <= 1000; ++ii) {
+        const float x = static_cast<float>(ii)*0.001F;
+        TEST_ASSERT_FLOAT_WITHIN(FastTrigonometry::ASIN_MAX_ERROR, asinf(x), FastTrigonometry::asin(x));
+        TEST_ASSERT_FLOAT_WITHIN(FastTrigonometry::ASIN_MAX_ERROR, acosf(x), FastTrigonometry::acos(x));
+    }
+    // arguments slightly out of range, because of rounding errors, are clamped
+    TEST_ASSERT_EQUAL_FLOAT(FastTrigonometry::HALF_PI, FastTrigonometry::asin(1.0000001F));
+    TEST_ASSERT_EQUAL_FLOAT(FastTrigonometry::M_PI_F, FastTrigonometry::acos(-1.0000001F));
+}
+void test_atan2_asin_batch()
+{
+    // 19 values, so not a multiple of the SIMD width
+    std::vector<float> y;
+    std::vector<float> x;
+    for (int ii = -9; ii <= 9; ++ii) {
+        const float angle = static_cast<float>(ii)*0.35F;
+        y.push_back(sinf(angle)*static_cast<float>(ii + 10));
+        x.push_back(cosf(angle)*static_cast<float>(ii + 10));
+    }
+    y[9] = 0.0F;
+    x[9] = 0.0F;
+    // results are at most PI in magnitude, and may differ by a few ulps because of fused multiply-add contraction
+    const float delta = 8.0F*std::numeric_limits<float>::epsilon();
+    std::vector<float> a(x.size());
+    FastTrigonometry::atan2_batch(y, x, a);
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, a[9]);
+    for (size_t ii = 0; ii < x.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(delta, FastTrigonometry::atan2(y[ii], x[ii]), a[ii]);
+    }
+
+    std::vector<float> s(x.size());
+    for (size_t ii = 0; ii < s.size(); ++ii) { s[ii] = static_cast<float>(ii)*0.11F - 1.0F; }
+    FastTrigonometry::asin_batch(s, a);
+    for (size_t ii = 0; ii < x.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(delta, FastTrigonometry::asin(s[ii]), a[ii]);
+    }
+}
+// table of sines calculated at compile time, angles are multiples of PI/40, so include remainders of exactly ±0.5
+static constexpr size_t SIN_TABLE_SIZE = 321;
+static constexpr float sin_table_angle(size_t index) { return (static_cast<float>(index) - 160.0F)*(FastTrigonometry::M_PI_F/40.0F); }
+static constexpr std::array<float, SIN_TABLE_SIZE> sin_table = []() {
+    std::array<float, SIN_TABLE_SIZE> table {};
+    for (size_t ii = 0; ii < table.size(); ++ii) {
+        table[ii] = FastTrigonometry::sin(sin_table_angle(ii));
+    }
+    return table;
+}();
+
+void test_sin_cos_constexpr()
+{
+    static_assert(FastTrigonometry::sin(0.0F) == 0.0F);
+    static_assert(FastTrigonometry::cos(0.0F) == 1.0F);
+    // compile time results match run time results to within a few ulps, the run time code may use fused multiply-adds
+    const float delta = 4.0F*std::numeric_limits<float>::epsilon();
+    for (size_t ii = 0; ii < sin_table.size(); ++ii) {
+        const float angle = sin_table_angle(ii);
+        TEST_ASSERT_FLOAT_WITHIN(delta, FastTrigonometry::sin(angle), sin_table[ii]);
+    }
+    constexpr float cos_minus_0_3 = FastTrigonometry::cos(-0.3F);
+    TEST_ASSERT_FLOAT_WITHIN(delta, FastTrigonometry::cos(-0.3F), cos_minus_0_3);
+    constexpr float cos_123 = FastTrigonometry::cos(1.23F);
+    TEST_ASSERT_FLOAT_WITHIN(delta, FastTrigonometry::cos(1.23F), cos_123);
+}
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
 
 int main(int argc, char **argv)
@@ -243,6 +381,12 @@ int main(int argc, char **argv)
     RUN_TEST(test_sin);
     RUN_TEST(test_cos);
     RUN_TEST(test_sin_cos);
+    RUN_TEST(test_sin_cos_constexpr);
+    RUN_TEST(test_sin_cos_batch);
+    RUN_TEST(test_atan);
+    RUN_TEST(test_atan2);
+    RUN_TEST(test_asin_acos);
+    RUN_TEST(test_atan2_asin_batch);
 
     UNITY_END();
 }
@@ -0,0 +1,153 @@
+#include "lazy_expression.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+/*
+The expressions do the arithmetic in the same order as the ordinary operators, but the compiler may contract multiply-adds into
+fused multiply-adds differently in each, so the results are compared to within a few ulps of the largest element.
+*/
+template <typename T>
+static void assert_xyz_close(const xyz_type<T>& expected, const xyz_type<T>& actual)
+{
+    const T scale = std::max({ T(1), std::fabs(expected.x), std::fabs(expected.y), std::fabs(expected.z) });
+    const double delta = 8.0*static_cast<double>(std::numeric_limits<T>::epsilon()*scale);
+    TEST_ASSERT_DOUBLE_WITHIN(delta, expected.x, actual.x);
+    TEST_ASSERT_DOUBLE_WITHIN(delta, expected.y, actual.y);
+    TEST_ASSERT_DOUBLE_WITHIN(delta, expected.z, actual.z);
+}
+
+template <typename T>
+static void assert_matrix_close(const Matrix3x3T<T>& expected, const Matrix3x3T<T>& actual)
+{
+    T scale = T(1);
+    for (size_t ii = 0; ii < 9; ++ii) {
+        scale = std::max(scale, std::fabs(expected[ii]));
+    }
+    const double delta = 8.0*static_cast<double>(std::numeric_limits<T>::epsilon()*scale);
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_DOUBLE_WITHIN(delta, expected[ii], actual[ii]);
+    }
+}
+
+void test_lazy_expression_xyz()
+{
+    const xyz_t p1{1.0F, -2.0F, 3.5F};
+    const xyz_t ex{0.6F, 0.8F, 0.0F};
+    const xyz_t ey{-0.8F, 0.6F, 0.0F};
+    const xyz_t ez{0.0F, 0.0F, 1.0F};
+    const float x = 1.25F;
+    const float y = -0.75F;
+    const float z = 2.5F;
+
+    // the expression gives the same results as the ordinary operators
+    const xyz_t sol1 = lazy(p1) + x*lazy(ex) + y*lazy(ey) + z*lazy(ez);
+    assert_xyz_close(p1 + x*ex + y*ey + z*ez, sol1);
+    const xyz_t sol2 = lazy(p1) + x*lazy(ex) + y*lazy(ey) - z*lazy(ez);
+    assert_xyz_close(p1 + x*ex + y*ey - z*ez, sol2);
+
+    // plain vectors may be used once one operand is an expression
+    const xyz_t a = lazy(p1) + ex - ey*x;
+    assert_xyz_close(p1 + ex - ey*x, a);
+    const xyz_t b = ex - lazy(p1);
+    assert_xyz_close(ex - p1, b);
+    const xyz_t c = -(lazy(p1)*x) / y;
+    assert_xyz_close(-(p1*x) / y, c);
+
+    // expressions hold copies of their operands, so may be stored
+    const auto e = lazy(p1) + lazy(ex)*2.0F;
+    assert_xyz_close(p1 + ex*2.0F, e.eval());
+    TEST_ASSERT_EQUAL_FLOAT(p1.x + ex.x*2.0F, e.x());
+    TEST_ASSERT_EQUAL_FLOAT(p1.y + ex.y*2.0F, e.y());
+    TEST_ASSERT_EQUAL_FLOAT(p1.z + ex.z*2.0F, e.z());
+}
+
+void test_lazy_expression_matrix3x3()
+{
+    const Matrix3x3 F(1.0F, 0.01F, 0.0F, 0.0F, 1.0F, 0.01F, 0.0F, 0.0F, 1.0F);
+    const Matrix3x3 P(2.0F, 0.1F, 0.0F, 0.1F, 3.0F, 0.2F, 0.0F, 0.2F, 4.0F);
+    const Matrix3x3 Q(0.01F, 0.02F, 0.03F);
+    const Matrix3x3 M( 2,  3,  5,
+                       7, 11, 13,
+                      17, 19, 23);
+
+    // covariance prediction
+    const Matrix3x3 FPFt = lazy(F)*P*lazy(F).transpose() + Q;
+    assert_matrix_close(F*P*F.transpose() + Q, FPFt);
+
+    const Matrix3x3 A = lazy(M) - P*2.0F + Q;
+    assert_matrix_close(M - P*2.0F + Q, A);
+    const Matrix3x3 B = -(0.5F*lazy(M)).transpose() / 4.0F;
+    assert_matrix_close(-(0.5F*M).transpose() / 4.0F, B);
+    const Matrix3x3 C = M*lazy(P).transpose()*M;
+    assert_matrix_close(M*P.transpose()*M, C);
+    const Matrix3x3 D = P - lazy(M)*F;
+    assert_matrix_close(P - M*F, D);
+
+    // multiplication of a vector
+    const xyz_t v{1.0F, 2.0F, 3.0F};
+    const xyz_t w{-0.5F, 0.25F, 4.0F};
+    const xyz_t Mv = lazy(M)*v + w;
+    assert_xyz_close(M*v + w, Mv);
+    const xyz_t Mvw = M*(lazy(v) - w);
+    assert_xyz_close(M*(v - w), Mvw);
+    const xyz_t Pv = (lazy(P) + Q)*lazy(v);
+    assert_xyz_close((P + Q)*v, Pv);
+
+    const auto e = lazy(M).transpose();
+    TEST_ASSERT_EQUAL_FLOAT(M[3], e(0, 1));
+    TEST_ASSERT_EQUAL_FLOAT(M[1], e(1, 0));
+}
+
+void test_lazy_expression_constexpr()
+{
+    constexpr Matrix3x3 M(1, 2, 3, 4, 5, 6, 7, 8, 9);
+    constexpr Matrix3x3 A = lazy(M).transpose()*2.0F - Matrix3x3(1.0F);
+    static_assert(A == M.transpose()*2.0F - Matrix3x3(1.0F));
+    static_assert(A[1] == 8.0F);
+    constexpr Matrix3x3 B = lazy(M)*M + M;
+    static_assert(B == M*M + M);
+
+    constexpr xyz_t v{1.0F, 2.0F, 3.0F};
+    constexpr xyz_t w = lazy(v)*2.0F - M*lazy(v);
+    static_assert(w == v*2.0F - M*v);
+    assert_xyz_close(v*2.0F - M*v, w);
+}
+
+void test_lazy_expression_double()
+{
+    const xyzd_t p1{1.0, -2.0, 3.5};
+    const xyzd_t ex{0.6, 0.8, 0.0};
+    const xyzd_t sol = lazy(p1) + 0.1*lazy(ex);
+    assert_xyz_close(p1 + 0.1*ex, sol);
+
+    const Matrix3x3d F(1.0, 0.01, 0.0, 0.0, 1.0, 0.01, 0.0, 0.0, 1.0);
+    const Matrix3x3d P(2.0, 0.1, 0.0, 0.1, 3.0, 0.2, 0.0, 0.2, 4.0);
+    const Matrix3x3d Q(0.01, 0.02, 0.03);
+    const Matrix3x3d FPFt = lazy(F)*P*lazy(F).transpose() + Q;
+    assert_matrix_close(F*P*F.transpose() + Q, FPFt);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_lazy_expression_xyz);
+    RUN_TEST(test_lazy_expression_matrix3x3);
+    RUN_TEST(test_lazy_expression_constexpr);
+    RUN_TEST(test_lazy_expression_double);
+
+    UNITY_END();
+}
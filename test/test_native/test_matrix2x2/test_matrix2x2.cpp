@@ -320,6 +320,50 @@ void test_Matrix2x2_Eigen_interworking()
         5*29 +  7*37, + 5*31 +  7*41);
     TEST_ASSERT_TRUE(A_times_B == A * B);
 }
+void test_matrix2x2_constexpr()
+{
+    constexpr Matrix2x2 m(2, 3, 5, 7);
+    static_assert(Matrix2x2() == Matrix2x2(0.0F, 0.0F));
+    static_assert(m*Matrix2x2(1.0F) == m);
+    static_assert(m.transpose() == Matrix2x2(2, 5, 3, 7));
+    static_assert(m + m == m*2.0F);
+    static_assert(m*xy_t{1.0F, 1.0F} == xy_t{5.0F, 12.0F});
+    static_assert(m.determinant() == -1.0F);
+    TEST_ASSERT_TRUE(m.adjoint() == Matrix2x2(7, -3, -5, 2));
+}
+void test_matrix2x2_eigenvalues()
+{
+    const Matrix2x2 m(4, 1, 2, 3);
+    TEST_ASSERT_EQUAL_FLOAT(9.0F, m.discriminant());
+    const xy_t e = m.eigenvalues();
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, e.x);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, e.y);
+    TEST_ASSERT_EQUAL_FLOAT(m.trace(), e.x + e.y);
+    TEST_ASSERT_EQUAL_FLOAT(m.determinant(), e.x*e.y);
+
+    const xy_t s = Matrix2x2(2, 1, 1, 2).eigenvalues();
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, s.x);
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, s.y);
+
+    // a rotation by 90 degrees has complex eigenvalues
+    const xy_t c = Matrix2x2(0, -1, 1, 0).eigenvalues();
+    TEST_ASSERT_TRUE(std::isnan(c.x));
+    TEST_ASSERT_TRUE(std::isnan(c.y));
+}
+void test_matrix2x2_double()
+{
+    constexpr Matrix2x2d m(2, 3, 5, 7);
+    static_assert(m.determinant() == -1.0);
+    static_assert(m.adjoint() == Matrix2x2d(7, -3, -5, 2));
+    const Matrix2x2d p = m*Matrix2x2d(0.1, 0.3, 0.7, 1.1).inverse();
+    const Matrix2x2d q = p*Matrix2x2d(0.1, 0.3, 0.7, 1.1);
+    for (size_t ii = 0; ii < 4; ++ii) {
+        TEST_ASSERT_DOUBLE_WITHIN(1.0E-14, m[ii], q[ii]);
+    }
+    const xyd_t v = Matrix2x2d(0.0, -1.0, 1.0, 0.0)*xyd_t{0.1, 0.2};
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-17, -0.2, v.x);
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-17, 0.1, v.y);
+}
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
 
 int main(int argc, char **argv)
@@ -333,6 +377,9 @@ int main(int argc, char **argv)
     RUN_TEST(test_matrix2x2_constructors);
     RUN_TEST(test_Matrix2x2_unary);
     RUN_TEST(test_Matrix2x2_binary);
+    RUN_TEST(test_matrix2x2_constexpr);
+    RUN_TEST(test_matrix2x2_eigenvalues);
+    RUN_TEST(test_matrix2x2_double);
     RUN_TEST(test_Matrix2x2_Eigen_interworking);
 
     UNITY_END();
@@ -463,6 +463,89 @@ void test_matrix3x3_quaternion()
     TEST_ASSERT_EQUAL_FLOAT(qW.get_y(), mWq.get_y());
     TEST_ASSERT_EQUAL_FLOAT(qW.get_z(), mWq.get_z());
 }
+void test_matrix3x3_constexpr()
+{
+    constexpr Matrix3x3 m( 2,  3,  5,
+                           7, 11, 13,
+                          17, 19, 23);
+    static_assert(Matrix3x3() == Matrix3x3(0.0F, 0.0F, 0.0F));
+    static_assert(Matrix3x3(2.0F)[4] == 2.0F);
+    static_assert((m*Matrix3x3(1.0F)) == m);
+    static_assert(m.transpose()[1] == 7.0F);
+    static_assert((m + m - m*2.0F) == Matrix3x3());
+    static_assert((m*xyz_t{1.0F, 0.0F, 0.0F}) == xyz_t{2.0F, 7.0F, 17.0F});
+    static_assert(m.determinant() == -78.0F);
+
+    // rotation matrices calculated at compile time
+    constexpr Matrix3x3 r = Matrix3x3::from_euler_angles_degrees_constexpr(19.0F, -37.0F, 71.0F);
+    constexpr Matrix3x3 rq(Quaternion::from_euler_angles_degrees_constexpr(19.0F, -37.0F, 71.0F));
+    const Matrix3x3 s = Matrix3x3::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, s[ii], r[ii]);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, r[ii], rq[ii]);
+    }
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY)
+    TEST_ASSERT_TRUE(s == r);
+#endif
+}
+void test_matrix3x3_fused()
+{
+    const Matrix3x3 m( 2,  3,  5,
+                       7, 11, 13,
+                      17, 19, 23);
+    const Matrix3x3 n(29, 31, 37,
+                      41, 43, 47,
+                      53, 59, 61);
+    // the elements are integers, so the products are exact and the results are identical, even where multiply-adds are fused
+    TEST_ASSERT_TRUE(m.multiply_transpose(n) == m*n.transpose());
+    TEST_ASSERT_TRUE(m.transpose_multiply(n) == m.transpose()*n);
+    TEST_ASSERT_TRUE(m.multiply_add(n, m) == m*n + m);
+
+    // covariance prediction, the result is exactly symmetric, and agrees with the ordinary operators on and above the diagonal
+    const Matrix3x3 F(1.0F, 0.01F, 0.0F, 0.0F, 1.0F, 0.01F, 0.003F, 0.0F, 1.0F);
+    const Matrix3x3 P(2.0F, 0.1F, -0.3F, 0.1F, 3.0F, 0.2F, -0.3F, 0.2F, 4.0F);
+    const Matrix3x3 Q(0.01F, 0.02F, 0.03F);
+    const Matrix3x3 FPFt = F*P*F.transpose();
+    const Matrix3x3 FPFtQ = FPFt + Q;
+    const Matrix3x3 c = F.congruence(P);
+    const Matrix3x3 cq = F.congruence_add(P, Q);
+    TEST_ASSERT_TRUE(c == c.transpose());
+    TEST_ASSERT_TRUE(cq == cq.transpose());
+    for (size_t ii : {0, 1, 2, 4, 5, 8}) {
+        TEST_ASSERT_EQUAL_FLOAT(FPFt[ii], c[ii]);
+        TEST_ASSERT_EQUAL_FLOAT(FPFtQ[ii], cq[ii]);
+    }
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, FPFt[ii], c[ii]);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, FPFtQ[ii], cq[ii]);
+    }
+
+    static_assert(Matrix3x3(1.0F).multiply_transpose(Matrix3x3(2, 3, 5, 7, 11, 13, 17, 19, 23)) == Matrix3x3(2, 7, 17, 3, 11, 19, 5, 13, 23));
+    static_assert(Matrix3x3(2.0F).congruence_add(Matrix3x3(1.0F), Matrix3x3(1.0F)) == Matrix3x3(5.0F));
+}
+
+void test_matrix3x3_double()
+{
+    constexpr Matrix3x3d m( 2,  3,  5,
+                            7, 11, 13,
+                           17, 19, 23);
+    static_assert(m.determinant() == -78.0);
+    const Matrix3x3d p = m*m.inverse();
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_DOUBLE_WITHIN(1.0E-14, (ii % 4 == 0) ? 1.0 : 0.0, p[ii]);
+    }
+
+    // the double and float versions agree to float precision, and the double version round trips to double precision
+    const Matrix3x3d r = Matrix3x3d::from_euler_angles_degrees(19.0, -37.0, 71.0);
+    const Matrix3x3 s = Matrix3x3::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    const Matrix3x3d rq(r.quaternion());
+    const Matrix3x3d rqe(Quaterniond::from_euler_angles_degrees(19.0, -37.0, 71.0));
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, s[ii], static_cast<float>(r[ii]));
+        TEST_ASSERT_DOUBLE_WITHIN(1.0E-15, r[ii], rq[ii]);
+        TEST_ASSERT_DOUBLE_WITHIN(1.0E-15, r[ii], rqe[ii]);
+    }
+}
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
 
 int main(int argc, char **argv)
@@ -477,6 +560,9 @@ int main(int argc, char **argv)
     RUN_TEST(test_matrix3x3_unary);
     RUN_TEST(test_matrix3x3_binary);
     RUN_TEST(test_matrix3x3_quaternion);
+    RUN_TEST(test_matrix3x3_constexpr);
+    RUN_TEST(test_matrix3x3_fused);
+    RUN_TEST(test_matrix3x3_double);
 
     UNITY_END();
 }
@@ -0,0 +1,89 @@
+#include "matrix3x3_simd.h"
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+void test_matrix3x3_simd()
+{
+    const Matrix3x3 m( 2,  3,  5,
+                       7, 11, 13,
+                      17, 19, 23);
+    const Matrix3x3 n(29, 31, 37,
+                      41, 43, 47,
+                      53, 59, 61);
+    const Matrix3x3Simd M(m);
+    const Matrix3x3Simd N(n);
+
+    TEST_ASSERT_TRUE(m == M.matrix());
+    TEST_ASSERT_TRUE(Matrix3x3() == Matrix3x3Simd().matrix());
+    Matrix3x3Simd I;
+    I.set_to_identity();
+    TEST_ASSERT_TRUE(Matrix3x3(1.0F) == I.matrix());
+    TEST_ASSERT_TRUE(xyzw_t(2.0F, 7.0F, 17.0F) == M.column(0));
+    TEST_ASSERT_TRUE(xyzw_t(5.0F, 13.0F, 23.0F) == M.column(2));
+    TEST_ASSERT_TRUE(M == Matrix3x3Simd(m));
+    TEST_ASSERT_TRUE(M != N);
+
+    TEST_ASSERT_TRUE(-m == (-M).matrix());
+    TEST_ASSERT_TRUE(m + n == (M + N).matrix());
+    TEST_ASSERT_TRUE(m - n == (M - N).matrix());
+    TEST_ASSERT_TRUE(m*3.0F == (M*3.0F).matrix());
+    TEST_ASSERT_TRUE(3.0F*m == (3.0F*M).matrix());
+    TEST_ASSERT_TRUE(m*n == (M*N).matrix());
+    TEST_ASSERT_TRUE(n*m == (N*M).matrix());
+    TEST_ASSERT_TRUE(Matrix3x3(2, 7, 17, 3, 11, 19, 5, 13, 23) == M.transpose().matrix());
+
+    Matrix3x3Simd P = M;
+    P *= N;
+    P += M;
+    P -= N;
+    P *= 2.0F;
+    TEST_ASSERT_TRUE((m*n + m - n)*2.0F == P.matrix());
+
+    const xyz_t v{1.0F, -2.0F, 3.0F};
+    TEST_ASSERT_TRUE(m*v == M*v);
+    TEST_ASSERT_TRUE(m*v == (M*xyzw_t(v)).xyz());
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, (M*xyzw_t(v)).get_xyzw().get<3>());
+}
+
+void test_matrix3x3_simd_rotation()
+{
+    const Matrix3x3 r = Matrix3x3::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    const Matrix3x3 s = Matrix3x3::from_euler_angles_degrees(-101.0F, 53.0F, 7.0F);
+    const Matrix3x3Simd R(r);
+    const Matrix3x3Simd S(s);
+
+    const Matrix3x3 rs = r*s;
+    const Matrix3x3 RS = (R*S).matrix();
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_EQUAL_FLOAT(rs[ii], RS[ii]);
+    }
+    for (int ii = 0; ii < 16; ++ii) {
+        const auto f = static_cast<float>(ii);
+        const xyz_t v{f*0.3F - 3.0F, 0.5F - f*0.2F, 1.0F + f*0.1F};
+        const xyz_t expected = r*v;
+        const xyz_t actual = R*v;
+        TEST_ASSERT_EQUAL_FLOAT(expected.x, actual.x);
+        TEST_ASSERT_EQUAL_FLOAT(expected.y, actual.y);
+        TEST_ASSERT_EQUAL_FLOAT(expected.z, actual.z);
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_matrix3x3_simd);
+    RUN_TEST(test_matrix3x3_simd_rotation);
+
+    UNITY_END();
+}
@@ -0,0 +1,223 @@
+#include "matrix3x3_soa.h"
+#include <algorithm>
+#include <cmath>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+static std::vector<Matrix3x3> test_matrices(size_t count, float offset)
+{
+    // count deliberately not a multiple of the SIMD width, to exercise the padding
+    std::vector<Matrix3x3> m(count);
+    for (size_t ii = 0; ii < count; ++ii) {
+        const auto f = static_cast<float>(ii);
+        m[ii] = Matrix3x3(f + offset, 2.0F - f, 0.5F*f, 3.0F, f*offset, -1.0F - f, 0.25F*f + 1.0F, 7.0F - f, offset - f);
+    }
+    return m;
+}
+
+static std::vector<xyz_t> test_vectors(size_t count)
+{
+    std::vector<xyz_t> v(count);
+    for (size_t ii = 0; ii < count; ++ii) {
+        const auto f = static_cast<float>(ii);
+        v[ii] = xyz_t{f - 5.0F, 2.0F*f + 1.0F, 7.0F - 3.0F*f};
+    }
+    return v;
+}
+
+// the batch kernels use the same operation order as Matrix3x3, but the compiler may contract multiply-adds into fused multiply-adds
+// differently in each, so results are compared to within a few ulps of the largest element
+static void assert_xyz_close(const xyz_t& expected, const xyz_t& actual)
+{
+    const float delta = 1.0E-6F*std::max({ 1.0F, std::fabs(expected.x), std::fabs(expected.y), std::fabs(expected.z) });
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.x, actual.x);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.y, actual.y);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.z, actual.z);
+}
+
+static void assert_matrix_close(const Matrix3x3& expected, const Matrix3x3& actual)
+{
+    float scale = 1.0F;
+    for (size_t ii = 0; ii < 9; ++ii) {
+        scale = std::max(scale, std::fabs(expected[ii]));
+    }
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F*scale, expected[ii], actual[ii]);
+    }
+}
+
+void test_matrix3x3_soa_conversion()
+{
+    const std::vector<Matrix3x3> m = test_matrices(11, 0.5F);
+    matrix3x3_soa_t s(m);
+    TEST_ASSERT_EQUAL(11, s.size());
+    TEST_ASSERT_FALSE(s.empty());
+    for (size_t ii = 0; ii < m.size(); ++ii) {
+        TEST_ASSERT_TRUE(m[ii] == s[ii]);
+        TEST_ASSERT_EQUAL_FLOAT(m[ii][5], s.element(ii, 5));
+    }
+    TEST_ASSERT_TRUE(m == s.to_vector());
+
+    const Matrix3x3 a(2.0F, 3.0F, 5.0F, 7.0F, 11.0F, 13.0F, 17.0F, 19.0F, 23.0F);
+    s.set(3, a);
+    TEST_ASSERT_TRUE(a == s[3]);
+
+    s.resize(3);
+    TEST_ASSERT_EQUAL(3, s.size());
+    TEST_ASSERT_EQUAL(3, s.to_vector().size());
+    s.clear();
+    TEST_ASSERT_TRUE(s.empty());
+}
+
+void test_matrix3x3_soa_multiply()
+{
+    const std::vector<Matrix3x3> a = test_matrices(13, 0.5F);
+    const std::vector<Matrix3x3> b = test_matrices(13, -1.25F);
+    const std::vector<xyz_t> v = test_vectors(13);
+    const matrix3x3_soa_t sa(a);
+    const matrix3x3_soa_t sb(b);
+    const xyz_soa_t sv(v);
+
+    matrix3x3_soa_t sc;
+    sa.multiply(sb, sc);
+    TEST_ASSERT_EQUAL(a.size(), sc.size());
+    for (size_t ii = 0; ii < a.size(); ++ii) { assert_matrix_close(a[ii]*b[ii], sc[ii]); }
+
+    // in-place
+    matrix3x3_soa_t sd = sa;
+    sd.multiply(sb, sd);
+    for (size_t ii = 0; ii < a.size(); ++ii) { assert_matrix_close(a[ii]*b[ii], sd[ii]); }
+
+    xyz_soa_t su;
+    sa.multiply(sv, su);
+    TEST_ASSERT_EQUAL(v.size(), su.size());
+    for (size_t ii = 0; ii < a.size(); ++ii) { assert_xyz_close(a[ii]*v[ii], su[ii]); }
+
+    a[3].multiply(sv, su);
+    for (size_t ii = 0; ii < v.size(); ++ii) { assert_xyz_close(a[3]*v[ii], su[ii]); }
+}
+
+void test_matrix3x3_multiply_batch()
+{
+    const std::vector<Matrix3x3> a = test_matrices(13, 0.5F);
+    const std::vector<xyz_t> v = test_vectors(13);
+    const matrix3x3_soa_t sa(a);
+
+    std::vector<xyz_t> u(v.size());
+    sa.multiply(v, u);
+    for (size_t ii = 0; ii < v.size(); ++ii) { assert_xyz_close(a[ii]*v[ii], u[ii]); }
+
+    // in-place
+    std::vector<xyz_t> w = v;
+    a[5].multiply(w, w);
+    for (size_t ii = 0; ii < v.size(); ++ii) { assert_xyz_close(a[5]*v[ii], w[ii]); }
+}
+void test_matrix3x3_soa_inverse()
+{
+    std::vector<Matrix3x3> a = test_matrices(37, 0.5F);
+    // make some of the matrices singular, including ones in the second mask word
+    a[2] = Matrix3x3(1.0F, 2.0F, 3.0F, 2.0F, 4.0F, 6.0F, 7.0F, 8.0F, 9.0F);
+    a[9] = Matrix3x3(0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F, 0.0F);
+    a[33] = Matrix3x3(1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F, 8.0F, 9.0F);
+    const matrix3x3_soa_t sa(a);
+
+    std::vector<float> det(a.size());
+    sa.determinant(det);
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_EQUAL_FLOAT(a[ii].determinant(), det[ii]); }
+
+    TEST_ASSERT_EQUAL(2, sa.singular_mask_size());
+    std::vector<uint32_t> singular(sa.singular_mask_size(), 0xFFFFFFFF);
+    matrix3x3_soa_t sb;
+    const size_t singular_count = sa.inverse(sb, singular);
+    TEST_ASSERT_EQUAL(a.size(), sb.size());
+    TEST_ASSERT_EQUAL(3, singular_count);
+    TEST_ASSERT_EQUAL_HEX32((1U << 2U) | (1U << 9U), singular[0]);
+    TEST_ASSERT_EQUAL_HEX32(1U << 1U, singular[1]);
+    for (size_t ii = 0; ii < a.size(); ++ii) {
+        Matrix3x3 m = a[ii];
+        const bool invertible = m.invert_in_place();
+        TEST_ASSERT_EQUAL(!invertible, (singular[ii/32] >> (ii%32)) & 1U);
+        assert_matrix_close(m, sb[ii]);
+    }
+    // singular matrices are left unchanged
+    TEST_ASSERT_TRUE(a[9] == sb[9]);
+    TEST_ASSERT_TRUE(a[33] == sb[33]);
+
+    // in-place
+    matrix3x3_soa_t sc = sa;
+    TEST_ASSERT_EQUAL(3, sc.invert_in_place(singular));
+    for (size_t ii = 0; ii < a.size(); ++ii) { assert_matrix_close(a[ii].inverse(), sc[ii]); }
+}
+void test_matrix3x3_soa_quaternion()
+{
+    // a range of attitudes, so that all four forms used by Matrix3x3::quaternion are exercised
+    std::vector<Quaternion> q;
+    for (size_t ii = 0; ii < 29; ++ii) {
+        const auto f = static_cast<float>(ii);
+        q.push_back(Quaternion::from_euler_angles_radians(0.7F*f - 3.0F, 0.37F*f - 1.5F, 1.3F*f - 6.0F));
+    }
+    // rotations of 180 degrees about each axis
+    q.emplace_back(0.0F, 1.0F, 0.0F, 0.0F);
+    q.emplace_back(0.0F, 0.0F, 1.0F, 0.0F);
+    q.emplace_back(0.0F, 0.0F, 0.0F, 1.0F);
+    q.emplace_back(1.0F, 0.0F, 0.0F, 0.0F);
+
+    const matrix3x3_soa_t m(q);
+    TEST_ASSERT_EQUAL(q.size(), m.size());
+    for (size_t ii = 0; ii < q.size(); ++ii) { assert_matrix_close(Matrix3x3(q[ii]), m[ii]); }
+
+    std::vector<Quaternion> r(q.size());
+    m.to_quaternion(r);
+    // the scalar and batch square root estimates may each be out by RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR
+    const float delta = 1.0E-6F + 2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR;
+    for (size_t ii = 0; ii < q.size(); ++ii) {
+        const Quaternion expected = Matrix3x3(q[ii]).quaternion();
+        TEST_ASSERT_FLOAT_WITHIN(delta, expected.get_w(), r[ii].get_w());
+        TEST_ASSERT_FLOAT_WITHIN(delta, expected.get_x(), r[ii].get_x());
+        TEST_ASSERT_FLOAT_WITHIN(delta, expected.get_y(), r[ii].get_y());
+        TEST_ASSERT_FLOAT_WITHIN(delta, expected.get_z(), r[ii].get_z());
+    }
+}
+
+void test_matrix3x3_soa_resize()
+{
+    // from_quaternion writes identity matrices to the padding, growing must not expose them
+    const std::vector<Quaternion> q { Quaternion(1.0F, 0.0F, 0.0F, 0.0F) };
+    matrix3x3_soa_t s;
+    s.from_quaternion(q);
+    s.resize(2);
+    TEST_ASSERT_TRUE(Matrix3x3(1.0F) == s[0]);
+    TEST_ASSERT_TRUE(Matrix3x3() == s[1]);
+
+    // shrinking then growing must not expose the old values
+    const std::vector<Matrix3x3> a = test_matrices(13, 0.5F);
+    s = matrix3x3_soa_t(a);
+    s.resize(6);
+    s.resize(13);
+    for (size_t ii = 0; ii < 6; ++ii) { TEST_ASSERT_TRUE(a[ii] == s[ii]); }
+    for (size_t ii = 6; ii < 13; ++ii) { TEST_ASSERT_TRUE(Matrix3x3() == s[ii]); }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_matrix3x3_soa_conversion);
+    RUN_TEST(test_matrix3x3_soa_multiply);
+    RUN_TEST(test_matrix3x3_multiply_batch);
+    RUN_TEST(test_matrix3x3_soa_inverse);
+    RUN_TEST(test_matrix3x3_soa_quaternion);
+    RUN_TEST(test_matrix3x3_soa_resize);
+
+    UNITY_END();
+}
@@ -0,0 +1,207 @@
+#include "matrix_nxm.h"
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+template <size_t N, size_t M>
+static Matrix<N, M> test_matrix(float offset)
+{
+    Matrix<N, M> ret;
+    for (size_t ii = 0; ii < N*M; ++ii) {
+        ret[ii] = offset + static_cast<float>((ii*7) % 11) - 5.0F;
+    }
+    return ret;
+}
+
+//! Returns a symmetric positive definite matrix, A*A^T + N*I
+template <size_t N>
+static Matrix<N, N> test_spd_matrix()
+{
+    const Matrix<N, N> a = test_matrix<N, N>(0.25F)/8.0F;
+    return a.multiply_transpose(a) + Matrix<N, N>(static_cast<float>(N));
+}
+
+void test_matrix_nxm_constructors()
+{
+    static_assert(sizeof(Matrix<6, 6>) == 36*sizeof(float));
+    static_assert(Matrix<15, 15>::ROWS == 15);
+
+    const Matrix<3, 3> identity(1.0F);
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t column = 0; column < 3; ++column) {
+            TEST_ASSERT_EQUAL_FLOAT(row == column ? 1.0F : 0.0F, identity(row, column));
+        }
+    }
+    Matrix<4, 4> m = test_matrix<4, 4>(0.0F);
+    TEST_ASSERT_EQUAL_FLOAT(m[6], m(1, 2));
+    m(1, 2) = 100.0F;
+    TEST_ASSERT_EQUAL_FLOAT(100.0F, m[6]);
+    m.set_to_identity();
+    TEST_ASSERT_TRUE((m == Matrix<4, 4>(1.0F)));
+    TEST_ASSERT_EQUAL_FLOAT(4.0F, m.trace());
+    m.set_zero();
+    TEST_ASSERT_TRUE((m == Matrix<4, 4>()));
+}
+
+void test_matrix_nxm_arithmetic()
+{
+    const Matrix<2, 3> a(std::array<float, 6>{{ 1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F }});
+    const Matrix<2, 3> b(std::array<float, 6>{{ 0.5F, -1.0F, 2.0F, 0.0F, 1.0F, -3.0F }});
+    TEST_ASSERT_TRUE((a + b == Matrix<2, 3>(std::array<float, 6>{{ 1.5F, 1.0F, 5.0F, 4.0F, 6.0F, 3.0F }})));
+    TEST_ASSERT_TRUE((a - b == Matrix<2, 3>(std::array<float, 6>{{ 0.5F, 3.0F, 1.0F, 4.0F, 4.0F, 9.0F }})));
+    TEST_ASSERT_TRUE(-a == a*-1.0F);
+    TEST_ASSERT_TRUE(2.0F*a == a + a);
+    TEST_ASSERT_TRUE(a/2.0F == a*0.5F);
+    Matrix<2, 3> c = a;
+    c += b;
+    c -= b;
+    TEST_ASSERT_TRUE(c == a);
+
+    const Matrix<3, 2> t = a.transpose();
+    TEST_ASSERT_TRUE((t == Matrix<3, 2>(std::array<float, 6>{{ 1.0F, 4.0F, 2.0F, 5.0F, 3.0F, 6.0F }})));
+    TEST_ASSERT_TRUE(t.transpose() == a);
+}
+
+void test_matrix_nxm_multiply()
+{
+    const Matrix<2, 3> a(std::array<float, 6>{{ 1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F }});
+    const Matrix<3, 2> b(std::array<float, 6>{{ 7.0F, 8.0F, 9.0F, 10.0F, 11.0F, 12.0F }});
+    TEST_ASSERT_TRUE((a*b == Matrix<2, 2>(std::array<float, 4>{{ 58.0F, 64.0F, 139.0F, 154.0F }})));
+    TEST_ASSERT_TRUE(a.transpose_multiply(a) == a.transpose()*a);
+    TEST_ASSERT_TRUE(a.multiply_transpose(a) == a*a.transpose());
+
+    // rows of length 6 are multiplied in pairs, with the last row of an odd number of rows on its own
+    const Matrix<5, 4> d = test_matrix<5, 4>(0.5F);
+    const Matrix<4, 6> e = test_matrix<4, 6>(-1.5F);
+    const Matrix<5, 6> de = d*e;
+    const Matrix<5, 6> de_reference = d.multiply_transpose(e.transpose());
+    for (size_t ii = 0; ii < 30; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, de_reference[ii], de[ii]);
+    }
+
+    // agrees with Matrix3x3
+    const Matrix<3, 3> m = test_matrix<3, 3>(0.5F);
+    const Matrix<3, 3> n = test_matrix<3, 3>(-1.5F);
+    const Matrix3x3 m3 = m.get_matrix3x3<0, 0>();
+    const Matrix3x3 n3 = n.get_matrix3x3<0, 0>();
+    TEST_ASSERT_TRUE(((m*n).get_matrix3x3<0, 0>() == m3*n3));
+    TEST_ASSERT_TRUE((m.congruence(n).get_matrix3x3<0, 0>() == m3.congruence(n3)));
+
+    const Matrix<9, 9> f = test_matrix<9, 9>(0.25F);
+    const Matrix<9, 9> p = test_spd_matrix<9>();
+    const Matrix<9, 9> q(0.01F);
+    const Matrix<9, 9> fpft = f*p*f.transpose() + q;
+    const Matrix<9, 9> c = f.congruence_add(p, q);
+    for (size_t ii = 0; ii < 81; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-3F, fpft[ii], c[ii]);
+    }
+    TEST_ASSERT_TRUE(c == c.transpose());
+    TEST_ASSERT_TRUE(f.congruence(p) + q == c);
+}
+
+void test_matrix_nxm_blocks()
+{
+    Matrix<15, 15> m;
+    const Matrix3x3 a(1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F, 8.0F, 9.0F);
+    m.set_matrix3x3<3, 6>(a);
+    TEST_ASSERT_TRUE((m.get_matrix3x3<3, 6>() == a));
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, m(3, 6));
+    TEST_ASSERT_EQUAL_FLOAT(9.0F, m(5, 8));
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, m(2, 6));
+
+    const xyz_t v{1.0F, -2.0F, 3.0F};
+    m.set_xyz<12, 14>(v);
+    TEST_ASSERT_TRUE((m.get_xyz<12, 14>() == v));
+    TEST_ASSERT_EQUAL_FLOAT(-2.0F, m(13, 14));
+
+    const Matrix<2, 4> b = m.get_block<3, 5, 2, 4>();
+    TEST_ASSERT_TRUE((b == Matrix<2, 4>(std::array<float, 8>{{ 0.0F, 1.0F, 2.0F, 3.0F, 0.0F, 4.0F, 5.0F, 6.0F }})));
+    Matrix<6, 6> s;
+    s.set_block<4, 2>(b);
+    TEST_ASSERT_TRUE((s.get_block<4, 2, 2, 4>()) == b);
+
+    Matrix<6, 1> state;
+    state.set_xyz<3, 0>(v);
+    TEST_ASSERT_TRUE((state.get_xyz<3, 0>() == v));
+}
+
+void test_matrix_nxm_cholesky()
+{
+    const Matrix<6, 6> a = test_spd_matrix<6>();
+    Matrix<6, 6> l = a;
+    TEST_ASSERT_TRUE(l.cholesky_in_place());
+    for (size_t row = 0; row < 6; ++row) {
+        for (size_t column = row + 1; column < 6; ++column) {
+            TEST_ASSERT_EQUAL_FLOAT(0.0F, l(row, column));
+        }
+    }
+    const Matrix<6, 6> llt = l.multiply_transpose(l);
+    for (size_t ii = 0; ii < 36; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, a[ii], llt[ii]);
+    }
+
+    const Matrix<6, 2> b = test_matrix<6, 2>(1.0F);
+    Matrix<6, 2> x = b;
+    TEST_ASSERT_TRUE(a.cholesky_solve_in_place(x));
+    const Matrix<6, 2> ax = a*x;
+    for (size_t ii = 0; ii < 12; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, b[ii], ax[ii]);
+    }
+
+    // not positive definite, so a and b are unchanged
+    Matrix<6, 6> n = -a;
+    x = b;
+    TEST_ASSERT_FALSE(n.cholesky_solve_in_place(x));
+    TEST_ASSERT_TRUE(x == b);
+    TEST_ASSERT_FALSE(n.cholesky_in_place());
+    TEST_ASSERT_TRUE(n == -a);
+}
+
+void test_matrix_nxm_double()
+{
+    const Matrixd<15, 15> a = Matrixd<15, 15>(2.0) + Matrixd<15, 15>(std::array<double, 225>{{ 0.1, 0.2 }}).multiply_transpose(Matrixd<15, 15>(std::array<double, 225>{{ 0.1, 0.2 }}));
+    Matrixd<15, 1> x;
+    for (size_t ii = 0; ii < 15; ++ii) {
+        x[ii] = static_cast<double>(ii);
+    }
+    const Matrixd<15, 1> b = x;
+    TEST_ASSERT_TRUE(a.cholesky_solve_in_place(x));
+    const Matrixd<15, 1> ax = a*x;
+    for (size_t ii = 0; ii < 15; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-7F, 0.0F, static_cast<float>(ax[ii] - b[ii]));
+    }
+}
+
+void test_matrix_nxm_constexpr()
+{
+    constexpr Matrix<3, 3> m(2.0F);
+    static_assert(m.trace() == 6.0F);
+    static_assert(m.transpose() == m);
+    static_assert((m + m - m*2.0F) == Matrix<3, 3>());
+    static_assert(m.get_matrix3x3<0, 0>() == Matrix3x3(2.0F));
+    TEST_ASSERT_TRUE((m*m == Matrix<3, 3>(4.0F)));
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_matrix_nxm_constructors);
+    RUN_TEST(test_matrix_nxm_arithmetic);
+    RUN_TEST(test_matrix_nxm_multiply);
+    RUN_TEST(test_matrix_nxm_blocks);
+    RUN_TEST(test_matrix_nxm_cholesky);
+    RUN_TEST(test_matrix_nxm_double);
+    RUN_TEST(test_matrix_nxm_constexpr);
+
+    UNITY_END();
+}
@@ -0,0 +1,281 @@
+#include "fast_trigonometry.h"
+#include "q2_30_type.h"
+#include "reciprocal_sqrt.h"
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+static double to_double(int32_t raw)
+{
+    return static_cast<double>(raw) / static_cast<double>(q2_30_t::ONE);
+}
+
+static xyz_q2_30_t to_q2_30(const xyz_t& v)
+{
+    return xyz_q2_30_t{q2_30_t(v.x), q2_30_t(v.y), q2_30_t(v.z)};
+}
+
+static Quaternion_q2_30 to_q2_30(const Quaternion& q)
+{
+    return Quaternion_q2_30(q2_30_t(q.w), q2_30_t(q.x), q2_30_t(q.y), q2_30_t(q.z));
+}
+
+static void assert_xyz_within(float delta, const xyz_t& expected, const xyz_q2_30_t& actual)
+{
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.x, actual.x.to_float());
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.y, actual.y.to_float());
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.z, actual.z.to_float());
+}
+
+static void assert_quaternion_within(float delta, const Quaternion& expected, const Quaternion_q2_30& actual)
+{
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.w, actual.w.to_float());
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.x, actual.x.to_float());
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.y, actual.y.to_float());
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.z, actual.z.to_float());
+}
+
+void test_q2_30_t_conversions()
+{
+    static_assert(sizeof(q2_30_t) == sizeof(int32_t));
+    static_assert(q2_30_t(1).raw == 0x40000000);
+    static_assert(q2_30_t(-2).raw == INT32_MIN);
+    static_assert(q2_30_t(2) == q2_30_t::max());
+    static_assert(q2_30_t(-3) == q2_30_t::min());
+    static_assert(q2_30_t(0.5F).raw == 0x20000000);
+    static_assert(q2_30_t(-0.25).raw == -0x10000000);
+    static_assert(q2_30_t(5.0F) == q2_30_t::max());
+    static_assert(q2_30_t(-5.0F) == q2_30_t::min());
+
+    TEST_ASSERT_EQUAL_FLOAT(1.0F, q2_30_t(1).to_float());
+    TEST_ASSERT_EQUAL_FLOAT(-0.75F, q2_30_t(-0.75F).to_float());
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-9F, 0.1F, q2_30_t(0.1F).to_float());
+    // conversion rounds to nearest
+    TEST_ASSERT_EQUAL_INT32(1, q2_30_t(0.6/static_cast<double>(q2_30_t::ONE)).raw);
+    TEST_ASSERT_EQUAL_INT32(-1, q2_30_t(-0.6/static_cast<double>(q2_30_t::ONE)).raw);
+    TEST_ASSERT_EQUAL_INT32(0, q2_30_t(0.4/static_cast<double>(q2_30_t::ONE)).raw);
+}
+
+void test_q2_30_t_arithmetic()
+{
+    static_assert(q2_30_t(0.5F) + q2_30_t(0.25F) == q2_30_t(0.75F));
+    static_assert(q2_30_t(0.5F) - q2_30_t(0.75F) == q2_30_t(-0.25F));
+    static_assert(q2_30_t(0.5F) * q2_30_t(-0.5F) == q2_30_t(-0.25F));
+    static_assert(q2_30_t(0.75F) / q2_30_t(1.5F) == q2_30_t(0.5F));
+    static_assert(-q2_30_t(0.5F) == q2_30_t(-0.5F));
+    static_assert(q2_30_t(0.25F) < q2_30_t(0.5F));
+
+    // saturation
+    static_assert(q2_30_t(1.5F) + q2_30_t(1.5F) == q2_30_t::max());
+    static_assert(q2_30_t(-1.5F) - q2_30_t(1.5F) == q2_30_t::min());
+    static_assert(q2_30_t(1.5F) * q2_30_t(-1.5F) == q2_30_t::min());
+    static_assert(q2_30_t(1.5F) * q2_30_t(1.5F) == q2_30_t::max());
+    static_assert(-q2_30_t::min() == q2_30_t::max());
+    static_assert(abs(q2_30_t::min()) == q2_30_t::max());
+    static_assert(q2_30_t(1.5F) / q2_30_t(0.5F) == q2_30_t::max());
+    static_assert(q2_30_t(-1.5F) / q2_30_t(0.5F) == q2_30_t::min());
+    static_assert(q2_30_t(0.5F) / q2_30_t(0) == q2_30_t::max());
+    static_assert(q2_30_t(-0.5F) / q2_30_t(0) == q2_30_t::min());
+
+    // multiplication and division round to nearest
+    static_assert((q2_30_t::from_raw(3) * q2_30_t(0.5F)).raw == 2);
+    static_assert((q2_30_t::from_raw(-3) * q2_30_t(0.5F)).raw == -1);
+    static_assert((q2_30_t::from_raw(1) / q2_30_t(1.5F)).raw == 1);
+    static_assert((q2_30_t::from_raw(-1) / q2_30_t(1.5F)).raw == -1);
+    static_assert((q2_30_t(1) / q2_30_t(1.5F)).raw == 0x2AAAAAAB);
+    static_assert((q2_30_t(-1) / q2_30_t(1.5F)).raw == -0x2AAAAAAB);
+
+    q2_30_t k(0.5F);
+    k += q2_30_t(0.25F);
+    TEST_ASSERT_EQUAL_FLOAT(0.75F, k.to_float());
+    k *= q2_30_t(-1);
+    TEST_ASSERT_EQUAL_FLOAT(-0.75F, k.to_float());
+    k /= q2_30_t(0.5F);
+    TEST_ASSERT_EQUAL_FLOAT(-1.5F, k.to_float());
+    k -= q2_30_t(1);
+    TEST_ASSERT_TRUE(k == q2_30_t::min());
+}
+
+void test_q2_30_t_sqrt()
+{
+    TEST_ASSERT_TRUE(sqrt(q2_30_t(0)) == q2_30_t(0));
+    TEST_ASSERT_TRUE(sqrt(q2_30_t(-0.5F)) == q2_30_t(0));
+    TEST_ASSERT_TRUE(sqrt(q2_30_t(1)) == q2_30_t(1));
+    TEST_ASSERT_TRUE(sqrt(q2_30_t(0.25F)) == q2_30_t(0.5F));
+    TEST_ASSERT_TRUE(sqrt(q2_30_t(0.5625F)) == q2_30_t(0.75F));
+    // compare against the double precision square root, rounded down
+    for (int32_t raw = 1; raw < INT32_MAX - 3000017; raw = raw < 10000 ? raw*3 : raw + 3000017) {
+        const double expected = std::floor(std::sqrt(to_double(raw)) * static_cast<double>(q2_30_t::ONE));
+        TEST_ASSERT_INT32_WITHIN(1, static_cast<int32_t>(expected), sqrt(q2_30_t::from_raw(raw)).raw);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-7F, sqrtf(2.0F), sqrt(q2_30_t::max()).to_float());
+}
+
+void test_q2_30_t_reciprocal_sqrt()
+{
+    TEST_ASSERT_TRUE(reciprocal_sqrt(q2_30_t(1)) == q2_30_t(1));
+    TEST_ASSERT_TRUE(reciprocal_sqrt(q2_30_t(0.25F)) == q2_30_t::max());
+    TEST_ASSERT_TRUE(reciprocal_sqrt(q2_30_t(0)) == q2_30_t::max());
+    TEST_ASSERT_TRUE(reciprocal_sqrt(q2_30_t(-1)) == q2_30_t::max());
+    TEST_ASSERT_TRUE(reciprocal_sqrt(q2_30_t(0.1F)) == q2_30_t::max());
+    // compare against the double precision reciprocal square root, covering every table entry and every normalization shift
+    for (int32_t raw = 0x10000001; raw < INT32_MAX - 1000003; raw += 1000003) {
+        const double expected = std::round(static_cast<double>(q2_30_t::ONE) / std::sqrt(to_double(raw)));
+        TEST_ASSERT_INT32_WITHIN(1, static_cast<int32_t>(expected), reciprocal_sqrt(q2_30_t::from_raw(raw)).raw);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-7F, 1.0F/sqrtf(2.0F), reciprocal_sqrt(q2_30_t::max()).to_float());
+    // values close to 1, as occur when renormalizing
+    for (int32_t raw = 0x40000000 - 100000; raw <= 0x40000000 + 100000; raw += 1000) {
+        const double expected = std::round(static_cast<double>(q2_30_t::ONE) / std::sqrt(to_double(raw)));
+        TEST_ASSERT_INT32_WITHIN(1, static_cast<int32_t>(expected), reciprocal_sqrt(q2_30_t::from_raw(raw)).raw);
+    }
+}
+
+void test_q2_30_t_sin_cos()
+{
+    for (float x = -1.99F; x < 1.99F; x += 0.0137F) {
+        const q2_30_t k(x);
+        // same polynomial as FastTrigonometry, so agrees with it to close to float precision
+        TEST_ASSERT_FLOAT_WITHIN(2.0E-7F, FastTrigonometry::sin(x), Trigonometry<q2_30_t>::sin(k).to_float());
+        TEST_ASSERT_FLOAT_WITHIN(2.0E-7F, FastTrigonometry::cos(x), Trigonometry<q2_30_t>::cos(k).to_float());
+        // and with the standard library to the accuracy of the polynomial
+        TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, sinf(x), Trigonometry<q2_30_t>::sin(k).to_float());
+        TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, cosf(x), Trigonometry<q2_30_t>::cos(k).to_float());
+        q2_30_t s;
+        q2_30_t c;
+        Trigonometry<q2_30_t>::sin_cos(k, s, c);
+        TEST_ASSERT_TRUE(s == Trigonometry<q2_30_t>::sin(k));
+        TEST_ASSERT_TRUE(c == Trigonometry<q2_30_t>::cos(k));
+    }
+    TEST_ASSERT_TRUE(Trigonometry<q2_30_t>::sin(q2_30_t(0)) == q2_30_t(0));
+}
+
+void test_q2_30_t_xyz()
+{
+    const xyz_t a{0.3F, -0.4F, 0.5F};
+    const xyz_t b{-0.7F, 0.1F, 0.2F};
+    const xyz_q2_30_t aq = to_q2_30(a);
+    const xyz_q2_30_t bq = to_q2_30(b);
+
+    assert_xyz_within(2.0E-8F, a + b, aq + bq);
+    assert_xyz_within(2.0E-8F, a.cross(b), aq.cross(bq));
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-8F, a.dot(b), aq.dot(bq).to_float());
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-8F, a.magnitude(), aq.magnitude().to_float());
+    assert_xyz_within(2.0E-7F, a/a.magnitude(), aq.normalized()); // float normalized() may use the fast reciprocal square root, so compare with the exact value
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-8F, 1.0F, aq.normalized().magnitude_squared().to_float());
+
+    const xy_q2_30_t v = xy_q2_30_t{q2_30_t(0.6F), q2_30_t(-0.8F)}*q2_30_t(0.5F);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-8F, 0.6F, v.normalized().x.to_float());
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-8F, -0.8F, v.normalized().y.to_float());
+
+    // vectors shorter than 0.5, for which the reciprocal square root of the squared magnitude saturates, and longer than sqrt(2)
+    assert_xyz_within(1.0E-8F, xyz_t{0.6F, 0.8F, 0.0F}, to_q2_30(xyz_t{0.24F, 0.32F, 0.0F}).normalized());
+    assert_xyz_within(1.0E-6F, xyz_t{-0.6F, 0.0F, 0.8F}, to_q2_30(xyz_t{-0.0003F, 0.0F, 0.0004F}).normalized()); // limited by the rounding of the components
+    assert_xyz_within(1.0E-8F, xyz_t{0.6F, -0.8F, 0.0F}, to_q2_30(xyz_t{1.2F, -1.6F, 0.0F}).normalized());
+    for (const float scale : {1.0E-6F, 0.01F, 0.3F, 0.49F, 0.5F, 0.51F, 0.8F, 1.2F, 1.5F, 1.9F}) {
+        const xyz_q2_30_t n = to_q2_30(a*(scale/a.magnitude())).normalized();
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 1.0F, n.magnitude_squared().to_float());
+        assert_xyz_within(2.0E-6F/scale, a/a.magnitude(), n);
+    }
+    const xy_q2_30_t u = xy_q2_30_t{q2_30_t(0.6F), q2_30_t(-0.8F)}*q2_30_t(0.01F);
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-7F, 0.6F, u.normalized().x.to_float());
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-7F, -0.8F, u.normalized().y.to_float());
+    TEST_ASSERT_TRUE(xyz_q2_30_t{}.normalized() == xyz_q2_30_t{});
+}
+
+void test_q2_30_t_quaternion()
+{
+    const Quaternion a = Quaternion::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    const Quaternion b = Quaternion::from_euler_angles_degrees(-43.0F, 11.0F, -157.0F);
+    const Quaternion_q2_30 aq = to_q2_30(a);
+    const Quaternion_q2_30 bq = to_q2_30(b);
+
+    assert_quaternion_within(2.0E-7F, a*b, aq*bq);
+    assert_quaternion_within(2.0E-7F, b*a, bq*aq);
+    assert_quaternion_within(2.0E-7F, a.conjugate()*b, aq.conjugate()*bq);
+    assert_quaternion_within(2.0E-7F, a, (aq*q2_30_t(1.1F)).normalized());
+    // quaternions shorter than 0.5, for which the reciprocal square root of the squared magnitude saturates
+    const Quaternion_q2_30 s = Quaternion_q2_30(q2_30_t(0.2F), q2_30_t(0.1F), q2_30_t(0), q2_30_t(0)).normalized();
+    assert_quaternion_within(1.0E-8F, Quaternion(2.0F/std::sqrt(5.0F), 1.0F/std::sqrt(5.0F), 0.0F, 0.0F), s);
+    assert_quaternion_within(2.0E-7F, a, (aq*q2_30_t(0.01F)).normalized());
+
+    const xyz_t v{0.3F, -0.4F, 0.5F};
+    assert_xyz_within(2.0E-7F, a.rotate(v), aq.rotate(to_q2_30(v)));
+    assert_xyz_within(2.0E-7F, b.rotate(v), bq.rotate(to_q2_30(v)));
+    // rotating a unit vector does not saturate
+    const xyz_t u{0.0F, 0.0F, 1.0F};
+    assert_xyz_within(2.0E-7F, a.rotate(u), aq.rotate(to_q2_30(u)));
+}
+
+void test_q2_30_t_matrix3x3()
+{
+    const Matrix3x3 a(Quaternion::from_euler_angles_degrees(19.0F, -37.0F, 71.0F));
+    const Matrix3x3 b(Quaternion::from_euler_angles_degrees(-43.0F, 11.0F, -157.0F));
+    Matrix3x3_q2_30 aq;
+    Matrix3x3_q2_30 bq;
+    for (size_t ii = 0; ii < 9; ++ii) {
+        aq[ii] = q2_30_t(a[ii]);
+        bq[ii] = q2_30_t(b[ii]);
+    }
+    // matrix constructed from quaternion
+    const Matrix3x3_q2_30 cq(to_q2_30(Quaternion::from_euler_angles_degrees(19.0F, -37.0F, 71.0F)));
+    const Matrix3x3 ab = a*b;
+    const Matrix3x3_q2_30 abq = aq*bq;
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(2.0E-7F, a[ii], cq[ii].to_float());
+        TEST_ASSERT_FLOAT_WITHIN(2.0E-7F, ab[ii], abq[ii].to_float());
+    }
+
+    const xyz_t v{0.3F, -0.4F, 0.5F};
+    assert_xyz_within(2.0E-7F, a*v, aq*to_q2_30(v));
+    assert_xyz_within(2.0E-7F, b*(a*v), bq*(aq*to_q2_30(v)));
+}
+
+void test_q2_30_t_attitude_update()
+{
+    // integrate a constant rotation rate, renormalizing after every update, as in an AHRS
+    const Quaternion delta(1.0F, 0.3F*0.0005F, -0.5F*0.0005F, 0.7F*0.0005F);
+    const Quaternion_q2_30 delta_q = to_q2_30(delta);
+    const Quaterniond delta_d(1.0, delta.x, delta.y, delta.z);
+
+    Quaternion orientation(1.0F, 0.0F, 0.0F, 0.0F);
+    Quaternion_q2_30 orientation_q = to_q2_30(orientation);
+    Quaterniond orientation_d(1.0, 0.0, 0.0, 0.0);
+    for (int ii = 0; ii < 1000; ++ii) {
+        orientation = (orientation*delta).normalized();
+        orientation_q = (orientation_q*delta_q).normalized();
+        orientation_d = (orientation_d*delta_d).normalized();
+    }
+    // the fixed point version drifts less than the float version, whose normalized uses reciprocal_sqrtf
+    const Quaternion expected(static_cast<float>(orientation_d.w), static_cast<float>(orientation_d.x), static_cast<float>(orientation_d.y), static_cast<float>(orientation_d.z));
+    TEST_ASSERT_FLOAT_WITHIN(5.0E-6F + RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, expected.w, orientation.w);
+    TEST_ASSERT_FLOAT_WITHIN(5.0E-6F + RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, expected.z, orientation.z);
+    assert_quaternion_within(1.0E-6F, expected, orientation_q);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-8F, 1.0F, orientation_q.magnitude_squared().to_float());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_q2_30_t_conversions);
+    RUN_TEST(test_q2_30_t_arithmetic);
+    RUN_TEST(test_q2_30_t_sqrt);
+    RUN_TEST(test_q2_30_t_reciprocal_sqrt);
+    RUN_TEST(test_q2_30_t_sin_cos);
+    RUN_TEST(test_q2_30_t_xyz);
+    RUN_TEST(test_q2_30_t_quaternion);
+    RUN_TEST(test_q2_30_t_matrix3x3);
+    RUN_TEST(test_q2_30_t_attitude_update);
+
+    UNITY_END();
+}
@@ -1,4 +1,8 @@
+#include "fast_trigonometry.h"
 #include "quaternion.h"
+#include "xyz_soa.h"
+#include <algorithm>
+#include <cmath>
 #include <unity.h>
 
 void setUp() {
@@ -150,7 +154,7 @@ void test_quaternion_angles()
     const Quaternion q3 = Quaternion::from_euler_angles_degrees(21.0F, -39.0F);
     TEST_ASSERT_EQUAL_FLOAT(21.0, q3.calculate_roll_degrees());
     TEST_ASSERT_EQUAL_FLOAT(-39.0, q3.calculate_pitch_degrees());
-    TEST_ASSERT_EQUAL_FLOAT(0.0, q3.calculate_yaw_degrees());
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 0.0F, q3.calculate_yaw_degrees());
     TEST_ASSERT_EQUAL_FLOAT(1.0, q3.magnitude_squared());
 
     const Quaternion q4 = Quaternion::from_euler_angles_degrees(21.0F, -39.0F, -37.0F);
@@ -299,14 +303,129 @@ void test_quaternion_rotate()
     TEST_ASSERT_EQUAL_FLOAT(0.0F, qZ.rotate(vy).z);
 }
 
+// the batch and single vector rotations may round differently when multiply-adds are contracted into fused multiply-adds
+static void assert_xyz_close(const xyz_t& expected, const xyz_t& actual)
+{
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F*std::max(1.0F, std::fabs(expected.x)), expected.x, actual.x);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F*std::max(1.0F, std::fabs(expected.y)), expected.y, actual.y);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F*std::max(1.0F, std::fabs(expected.z)), expected.z, actual.z);
+}
+
+void test_quaternion_rotate_batch()
+{
+    const Quaternion q = Quaternion::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    // count not a multiple of the SIMD width, so the scalar tail is also exercised
+    std::vector<xyz_t> v(19);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        v[ii] = xyz_t{f - 3.0F, 0.5F*f, 11.0F - 2.0F*f};
+    }
+
+    std::vector<xyz_t> out(v.size());
+    q.rotate(v, out);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        assert_xyz_close(q.rotate(v[ii]), out[ii]);
+    }
+
+    // rotate in-place
+    std::vector<xyz_t> w = v;
+    q.rotate(w, w);
+    TEST_ASSERT_TRUE(w == out);
+
+    const xyz_soa_t s(v);
+    xyz_soa_t sOut;
+    q.rotate(s, sOut);
+    TEST_ASSERT_EQUAL(v.size(), sOut.size());
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        assert_xyz_close(q.rotate(v[ii]), sOut[ii]);
+    }
+}
+
+void test_quaternion_normalize_batch()
+{
+    // count not a multiple of the SIMD width, so the last partial block is also exercised
+    std::vector<Quaternion> q(9);
+    for (size_t ii = 0; ii < q.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        q[ii] = Quaternion(1.0F + 0.1F*f, f - 3.5F, 2.0F + 0.25F*f, 7.0F - 1.5F*f);
+    }
+    std::vector<Quaternion> out(q.size());
+    Quaternion::normalize_batch(q, out);
+    for (size_t ii = 0; ii < q.size(); ++ii) {
+        // normalized uses reciprocal_sqrtf, which is approximate if a FAST_RECIPROCAL_SQUARE_ROOT macro is defined
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, q[ii].normalized().get_w(), out[ii].get_w());
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, q[ii].normalized().get_x(), out[ii].get_x());
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, q[ii].normalized().get_y(), out[ii].get_y());
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, q[ii].normalized().get_z(), out[ii].get_z());
+    }
+
+    std::vector<Quaternion> r = q;
+    Quaternion::normalize_batch(r, r, rsqrt_precision_e::ONE_ITERATION);
+    for (size_t ii = 0; ii < q.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, out[ii].get_w(), r[ii].get_w());
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, out[ii].get_x(), r[ii].get_x());
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, out[ii].get_y(), r[ii].get_y());
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, out[ii].get_z(), r[ii].get_z());
+    }
+}
+
+void test_quaternion_attitude()
+{
+    std::vector<Quaternion> q;
+    for (size_t ii = 0; ii < 23; ++ii) {
+        const auto f = static_cast<float>(ii);
+        q.push_back(Quaternion::from_euler_angles_radians(0.7F*f - 3.0F, 0.13F*f - 1.4F, 1.3F*f - 6.0F));
+    }
+    q.emplace_back(); // identity
+
+    for (const Quaternion& p : q) {
+        const attitude_t a = p.attitude();
+        TEST_ASSERT_EQUAL_FLOAT(p.calculate_roll_radians(), a.roll);
+        TEST_ASSERT_EQUAL_FLOAT(p.calculate_pitch_radians(), a.pitch);
+        TEST_ASSERT_EQUAL_FLOAT(p.calculate_yaw_radians(), a.yaw);
+        TEST_ASSERT_EQUAL_FLOAT(p.sin_roll(), a.sin_roll);
+        TEST_ASSERT_EQUAL_FLOAT(p.cos_roll(), a.cos_roll);
+        TEST_ASSERT_EQUAL_FLOAT(p.tan_roll(), a.tan_roll);
+        TEST_ASSERT_EQUAL_FLOAT(p.sin_pitch(), a.sin_pitch);
+        TEST_ASSERT_EQUAL_FLOAT(p.cos_pitch(), a.cos_pitch);
+        // tan_pitch() uses reciprocal_sqrt, attitude() shares the square root of cos_pitch
+        TEST_ASSERT_FLOAT_WITHIN((1.0E-5F + RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR)*std::fabs(a.tan_pitch), p.tan_pitch(), a.tan_pitch);
+        TEST_ASSERT_EQUAL_FLOAT(p.sin_yaw(), a.sin_yaw);
+        TEST_ASSERT_EQUAL_FLOAT(p.cos_yaw(), a.cos_yaw);
+        TEST_ASSERT_EQUAL_FLOAT(p.tan_yaw(), a.tan_yaw);
+    }
+
+    std::vector<attitude_t> b(q.size());
+    Quaternion::attitude_batch(q, b);
+    const float rsqrt_delta = 1.0E-5F + RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR;
+    for (size_t ii = 0; ii < q.size(); ++ii) {
+        const attitude_t a = q[ii].attitude();
+        TEST_ASSERT_FLOAT_WITHIN(FastTrigonometry::ATAN_MAX_ERROR, a.roll, b[ii].roll);
+        // rounding differences in sin_pitch (eg from fused multiply-adds) are magnified by 1/cos_pitch in the pitch angle
+        TEST_ASSERT_FLOAT_WITHIN(FastTrigonometry::ASIN_MAX_ERROR + 1.0E-6F/a.cos_pitch, a.pitch, b[ii].pitch);
+        TEST_ASSERT_FLOAT_WITHIN(FastTrigonometry::ATAN_MAX_ERROR, a.yaw, b[ii].yaw);
+        // attitude_batch always uses the full precision reciprocal square root
+        TEST_ASSERT_FLOAT_WITHIN(rsqrt_delta, a.sin_roll, b[ii].sin_roll);
+        TEST_ASSERT_FLOAT_WITHIN(rsqrt_delta, a.cos_roll, b[ii].cos_roll);
+        TEST_ASSERT_EQUAL_FLOAT(a.tan_roll, b[ii].tan_roll);
+        TEST_ASSERT_EQUAL_FLOAT(a.sin_pitch, b[ii].sin_pitch);
+        TEST_ASSERT_EQUAL_FLOAT(a.cos_pitch, b[ii].cos_pitch);
+        TEST_ASSERT_EQUAL_FLOAT(a.tan_pitch, b[ii].tan_pitch);
+        TEST_ASSERT_FLOAT_WITHIN(rsqrt_delta, a.sin_yaw, b[ii].sin_yaw);
+        TEST_ASSERT_FLOAT_WITHIN(rsqrt_delta, a.cos_yaw, b[ii].cos_yaw);
+        TEST_ASSERT_EQUAL_FLOAT(a.tan_yaw, b[ii].tan_yaw);
+    }
+}
+
 void test_quaternion_rotate_x()
 {
     const Quaternion qI(1.0F, 0.0F, 0.0F, 0.0F);
     const float delta = degrees19inRadians;
     Quaternion qD = qI;
     qD.rotate_x(delta);
+    // rotate_x uses Trigonometry<float>, so uses FastTrigonometry if LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY is defined
 
-    const Quaternion qDExpected = Quaternion(cosf(delta/2.0F), sinf(delta/2.0F), 0, 0) * qI;
+    const Quaternion qDExpected = Quaternion(Trigonometry<float>::cos(delta/2.0F), Trigonometry<float>::sin(delta/2.0F), 0, 0) * qI;
     TEST_ASSERT_EQUAL_FLOAT(qDExpected.get_w(), qD.get_w());
     TEST_ASSERT_EQUAL_FLOAT(qDExpected.get_x(), qD.get_x());
     TEST_ASSERT_EQUAL_FLOAT(qDExpected.get_y(), qD.get_y());
@@ -330,7 +449,7 @@ void test_quaternion_rotate_y()
     Quaternion qD = qI;
     qD.rotate_y(delta);
 
-    const Quaternion qDExpected = Quaternion(cosf(delta/2.0F), 0, sinf(delta/2.0F), 0) *qI;
+    const Quaternion qDExpected = Quaternion(Trigonometry<float>::cos(delta/2.0F), 0, Trigonometry<float>::sin(delta/2.0F), 0) *qI;
     TEST_ASSERT_EQUAL_FLOAT(qDExpected.get_w(), qD.get_w());
     TEST_ASSERT_EQUAL_FLOAT(qDExpected.get_x(), qD.get_x());
     TEST_ASSERT_EQUAL_FLOAT(qDExpected.get_y(), qD.get_y());
@@ -354,7 +473,7 @@ void test_quaternion_rotate_z()
     Quaternion qD = qI;
     qD.rotate_z(delta);
 
-    const Quaternion qDExpected = Quaternion(cosf(delta/2.0F), 0, 0, sinf(delta/2.0F)) *qI;
+    const Quaternion qDExpected = Quaternion(Trigonometry<float>::cos(delta/2.0F), 0, 0, Trigonometry<float>::sin(delta/2.0F)) *qI;
     TEST_ASSERT_EQUAL_FLOAT(qDExpected.get_w(), qD.get_w());
     TEST_ASSERT_EQUAL_FLOAT(qDExpected.get_x(), qD.get_x());
     TEST_ASSERT_EQUAL_FLOAT(qDExpected.get_y(), qD.get_y());
@@ -523,6 +642,78 @@ void test_pitch_angle_clip()
     TEST_ASSERT_EQUAL_FLOAT(-85.0F, q4.calculate_pitch_degrees());
 }
 
+void test_quaternion_constexpr()
+{
+    // board alignment, calculated at compile time
+    constexpr Quaternion alignment = Quaternion::from_euler_angles_degrees_constexpr(0.0F, 180.0F, 90.0F);
+    constexpr Quaternion product = alignment*alignment.conjugate();
+    static_assert(product.w > 0.99999F && product.w < 1.00001F);
+    static_assert(Quaternion(2, 3, 5, 7)*Quaternion(11, 13, 17, 23) == Quaternion(-263, 55, 111, 109));
+    static_assert((Quaternion(2, 3, 5, 7) + Quaternion(1, 1, 1, 1)).dot(Quaternion(1, 0, 0, 0)) == 3.0F);
+
+    const Quaternion q = Quaternion::from_euler_angles_degrees(0.0F, 180.0F, 90.0F);
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, q.w, alignment.w);
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, q.x, alignment.x);
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, q.y, alignment.y);
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, q.z, alignment.z);
+
+    constexpr Quaternion r = Quaternion::from_euler_angles_degrees_constexpr(19.0F, -37.0F, 71.0F);
+    const Quaternion s = Quaternion::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY)
+    // the same calculation as at run time, but the run time code may use fused multiply-adds
+    constexpr float delta = 1.0E-6F;
+#else
+    constexpr float delta = 2.0E-6F;
+#endif
+    TEST_ASSERT_FLOAT_WITHIN(delta, s.w, r.w);
+    TEST_ASSERT_FLOAT_WITHIN(delta, s.x, r.x);
+    TEST_ASSERT_FLOAT_WITHIN(delta, s.y, r.y);
+    TEST_ASSERT_FLOAT_WITHIN(delta, s.z, r.z);
+}
+void test_quaternion_double()
+{
+    static_assert(Quaterniond(2, 3, 5, 7)*Quaterniond(11, 13, 17, 23) == Quaterniond(-263, 55, 111, 109));
+
+    // the double and float versions agree to float precision
+    const Quaterniond qd = Quaterniond::from_euler_angles_degrees(19.0, -37.0, 71.0);
+    const Quaternion q = Quaternion::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, q.w, static_cast<float>(qd.w));
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, q.x, static_cast<float>(qd.x));
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, q.y, static_cast<float>(qd.y));
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-6F, q.z, static_cast<float>(qd.z));
+
+    // the double version round trips to double precision
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-12, 19.0, qd.calculate_roll_degrees());
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-12, -37.0, qd.calculate_pitch_degrees());
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-12, 71.0, qd.calculate_yaw_degrees());
+    const attituded_t a = qd.attitude();
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-14, std::sin(19.0*Quaterniond::DEGREES_TO_RADIANS), a.sin_roll);
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-14, std::cos(-37.0*Quaterniond::DEGREES_TO_RADIANS), a.cos_pitch);
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-14, std::tan(71.0*Quaterniond::DEGREES_TO_RADIANS), a.tan_yaw);
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-15, 1.0, qd.normalized().magnitude());
+
+    // exp and log are inverses, both with and without the small angle Taylor series
+    const Quaterniond v {0.0, 0.1, -0.2, 0.3};
+    const Quaterniond v_small {0.0, 1.0E-5, 2.0E-5, -1.0E-5};
+    for (const Quaterniond& u : {v, v_small}) {
+        const Quaterniond l = u.exp().log();
+        TEST_ASSERT_DOUBLE_WITHIN(1.0E-16, u.w, l.w);
+        TEST_ASSERT_DOUBLE_WITHIN(1.0E-16, u.x, l.x);
+        TEST_ASSERT_DOUBLE_WITHIN(1.0E-16, u.y, l.y);
+        TEST_ASSERT_DOUBLE_WITHIN(1.0E-16, u.z, l.z);
+    }
+
+    // long horizon integration, 100000 small rotations about the z-axis, normalizing at each step
+    const Quaterniond dq = Quaterniond::from_euler_angles_radians(0.0, 0.0, 1.0E-5);
+    Quaterniond p;
+    for (int ii = 0; ii < 100000; ++ii) {
+        p = (p*dq).normalized();
+    }
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-10, 1.0, p.calculate_yaw_radians());
+    const xyzd_t r = p.rotate(xyzd_t{1.0, 0.0, 0.0});
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-10, std::cos(1.0), r.x);
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-10, std::sin(1.0), r.y);
+}
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
 
 int main(int argc, char **argv)
@@ -539,6 +730,11 @@ int main(int argc, char **argv)
 
     RUN_TEST(test_quaternion_rotation);
     RUN_TEST(test_quaternion_rotate);
+    RUN_TEST(test_quaternion_rotate_batch);
+    RUN_TEST(test_quaternion_normalize_batch);
+    RUN_TEST(test_quaternion_attitude);
+    RUN_TEST(test_quaternion_constexpr);
+    RUN_TEST(test_quaternion_double);
     RUN_TEST(test_quaternion_rotate_x);
     RUN_TEST(test_quaternion_rotate_y);
     RUN_TEST(test_quaternion_rotate_z);
@@ -0,0 +1,162 @@
+#include "quaternion_interpolator.h"
+#include "reciprocal_sqrt.h"
+#include <unity.h>
+#include <vector>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+#if defined(LIBRARY_VECTOR_QUATERNION_MATRIX_USE_FAST_TRIGONOMETRY)
+static constexpr float DELTA = 2.0E-5F;
+static constexpr float SMALL_ANGLE_DELTA = 2.0E-6F;
+static constexpr float DEGREES_DELTA = 2.0E-3F;
+#else
+static constexpr float DELTA = 1.0E-6F;
+static constexpr float SMALL_ANGLE_DELTA = 1.0E-7F;
+static constexpr float DEGREES_DELTA = 1.0E-4F;
+#endif
+// nlerp uses reciprocal_sqrtf, which is approximate if a FAST_RECIPROCAL_SQUARE_ROOT macro is defined
+static constexpr float NLERP_DELTA = DELTA + RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR;
+
+static void assert_quaternion_within(float delta, const Quaternion& expected, const Quaternion& actual)
+{
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.w, actual.w);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.x, actual.x);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.y, actual.y);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.z, actual.z);
+}
+
+void test_quaternion_exp_log()
+{
+    // exp of a pure quaternion is a rotation of twice its magnitude
+    const Quaternion e = Quaternion(0.0F, 0.3F, 0.0F, 0.0F).exp();
+    assert_quaternion_within(DELTA, Quaternion(cosf(0.3F), sinf(0.3F), 0.0F, 0.0F), e);
+    // log is the inverse of exp
+    assert_quaternion_within(DELTA, Quaternion(0.0F, 0.3F, 0.0F, 0.0F), e.log());
+
+    const Quaternion q = Quaternion::from_euler_angles_degrees(30.0F, -60.0F, 135.0F);
+    assert_quaternion_within(DELTA, q, q.log().exp());
+    const Quaternion p = Quaternion(0.5F, -0.7F, 1.2F, 2.0F);
+    assert_quaternion_within(2.0F*DELTA, p, p.log().exp());
+    // non-unit quaternion, the real part of the log is ln|q|
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, logf(p.magnitude()), p.log().w);
+
+    // small angle paths, either side of the threshold
+    for (float a : { 0.0F, 1.0E-6F, 0.01F, 0.0316F, 0.0317F, 0.05F }) {
+        const Quaternion v(0.0F, a*0.6F, -a*0.8F, 0.0F);
+        assert_quaternion_within(SMALL_ANGLE_DELTA, Quaternion(cosf(a), sinf(a)*0.6F, -sinf(a)*0.8F, 0.0F), v.exp());
+        assert_quaternion_within(SMALL_ANGLE_DELTA, v, v.exp().log());
+    }
+    TEST_ASSERT_TRUE(Quaternion(1.0F, 0.0F, 0.0F, 0.0F) == Quaternion(0.0F, 0.0F, 0.0F, 0.0F).exp());
+    TEST_ASSERT_TRUE(Quaternion(0.0F, 0.0F, 0.0F, 0.0F) == Quaternion(1.0F, 0.0F, 0.0F, 0.0F).log());
+    // log of negative real quaternion
+    assert_quaternion_within(DELTA, Quaternion(0.0F, Quaternion::M_PI_F, 0.0F, 0.0F), Quaternion(-1.0F, 0.0F, 0.0F, 0.0F).log());
+}
+
+void test_quaternion_slerp_nlerp()
+{
+    const Quaternion q0 = Quaternion::from_euler_angles_degrees(10.0F, 20.0F, 30.0F);
+    const Quaternion q1 = Quaternion::from_euler_angles_degrees(-40.0F, 50.0F, 160.0F);
+
+    assert_quaternion_within(DELTA, q0, Quaternion::slerp(q0, q1, 0.0F));
+    assert_quaternion_within(DELTA, q1, Quaternion::slerp(q0, q1, 1.0F));
+    assert_quaternion_within(NLERP_DELTA, q0, Quaternion::nlerp(q0, q1, 0.0F));
+    assert_quaternion_within(NLERP_DELTA, q1, Quaternion::nlerp(q0, q1, 1.0F));
+
+    // slerp about a single axis interpolates the angle linearly
+    const Quaternion z0 = Quaternion::from_euler_angles_degrees(0.0F, 0.0F, 10.0F);
+    const Quaternion z1 = Quaternion::from_euler_angles_degrees(0.0F, 0.0F, 130.0F);
+    for (float t : { 0.1F, 0.25F, 0.5F, 0.9F }) {
+        TEST_ASSERT_FLOAT_WITHIN(DEGREES_DELTA, 10.0F + 120.0F*t, Quaternion::slerp(z0, z1, t).calculate_yaw_degrees());
+        TEST_ASSERT_FLOAT_WITHIN(DELTA, 1.0F, Quaternion::slerp(q0, q1, t).magnitude());
+        TEST_ASSERT_FLOAT_WITHIN(NLERP_DELTA, 1.0F, Quaternion::nlerp(q0, q1, t).magnitude());
+    }
+    // nlerp and slerp agree at the midpoint
+    assert_quaternion_within(NLERP_DELTA, Quaternion::slerp(q0, q1, 0.5F), Quaternion::nlerp(q0, q1, 0.5F));
+
+    // shortest path: -z1 represents the same rotation as z1
+    assert_quaternion_within(DELTA, Quaternion::slerp(z0, z1, 0.3F), Quaternion::slerp(z0, -z1, 0.3F));
+    assert_quaternion_within(NLERP_DELTA, Quaternion::nlerp(z0, z1, 0.3F), Quaternion::nlerp(z0, -z1, 0.3F));
+
+    // small angle, slerp uses nlerp
+    const Quaternion s1 = Quaternion::from_euler_angles_degrees(10.0F, 20.0F, 31.0F);
+    TEST_ASSERT_TRUE(Quaternion::nlerp(q0, s1, 0.3F) == Quaternion::slerp(q0, s1, 0.3F));
+}
+
+void test_quaternion_interpolator()
+{
+    std::vector<float> times;
+    std::vector<Quaternion> keyframes;
+    for (size_t ii = 0; ii < 10; ++ii) {
+        const auto f = static_cast<float>(ii);
+        times.push_back(f*f*0.1F);
+        // includes a segment small enough for slerp to use nlerp
+        keyframes.push_back(Quaternion::from_euler_angles_degrees(25.0F*f, ii == 5 ? 4.5F*4.0F : 4.5F*f, 170.0F*f));
+    }
+    QuaternionInterpolator interpolator(times, keyframes);
+    QuaternionInterpolator nlerp_interpolator(times, keyframes, QuaternionInterpolator::interpolation_e::NLERP);
+
+    std::vector<float> query;
+    for (int ii = -5; ii < 100; ++ii) {
+        query.push_back(static_cast<float>(ii)*0.09F);
+    }
+    std::vector<Quaternion> out(query.size());
+    interpolator.interpolate(query, out);
+    std::vector<Quaternion> out_nlerp(query.size());
+    nlerp_interpolator.interpolate(query, out_nlerp);
+
+    for (size_t ii = 0; ii < query.size(); ++ii) {
+        const float time = query[ii];
+        if (time <= times.front()) {
+            TEST_ASSERT_TRUE(keyframes.front() == out[ii]);
+            continue;
+        }
+        if (time >= times.back()) {
+            TEST_ASSERT_TRUE(keyframes.back() == out[ii]);
+            continue;
+        }
+        size_t segment = 0;
+        while (time >= times[segment + 1]) {
+            ++segment;
+        }
+        const float t = (time - times[segment])*(1.0F/(times[segment + 1] - times[segment]));
+        // same operation order as slerp and nlerp, but fused multiply-add contraction may differ, so not necessarily bit-identical
+        assert_quaternion_within(DELTA, Quaternion::slerp(keyframes[segment], keyframes[segment + 1], t), out[ii]);
+        assert_quaternion_within(DELTA, Quaternion::nlerp(keyframes[segment], keyframes[segment + 1], t), out_nlerp[ii]);
+    }
+    TEST_ASSERT_EQUAL(8, interpolator.segment());
+
+    // at a keyframe time
+    assert_quaternion_within(DELTA, keyframes[3], interpolator.interpolate(times[3]));
+    TEST_ASSERT_EQUAL(3, interpolator.segment());
+    // queries that go backwards still work
+    assert_quaternion_within(DELTA, Quaternion::slerp(keyframes[1], keyframes[2], 0.5F), interpolator.interpolate(0.25F));
+    TEST_ASSERT_EQUAL(1, interpolator.segment());
+
+    // degenerate keyframe arrays
+    QuaternionInterpolator empty({}, {});
+    TEST_ASSERT_TRUE(Quaternion() == empty.interpolate(1.0F));
+    const std::vector<float> one_time { 2.0F };
+    QuaternionInterpolator one(one_time, std::span<const Quaternion>(&keyframes[4], 1));
+    TEST_ASSERT_TRUE(keyframes[4] == one.interpolate(1.0F));
+    TEST_ASSERT_TRUE(keyframes[4] == one.interpolate(3.0F));
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_quaternion_exp_log);
+    RUN_TEST(test_quaternion_slerp_nlerp);
+    RUN_TEST(test_quaternion_interpolator);
+
+    UNITY_END();
+}
@@ -0,0 +1,142 @@
+#include "quaternion_packed.h"
+#include <cfloat>
+#include <unity.h>
+#include <vector>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+//! Angle between the rotations q and p, in degrees, calculated in double precision so it is accurate for small angles
+static float angle_degrees(const Quaternion& q, const Quaternion& p)
+{
+    const Quaterniond e = Quaterniond(q.w, q.x, q.y, q.z).conjugate()*Quaterniond(p.w, p.x, p.y, p.z);
+    return static_cast<float>(2.0*std::atan2(std::sqrt(e.x*e.x + e.y*e.y + e.z*e.z), std::fabs(e.w))*Quaterniond::RADIANS_TO_DEGREES);
+}
+
+static void assert_quaternion_within(float delta, const Quaternion& expected, const Quaternion& actual)
+{
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.w, actual.w);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.x, actual.x);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.y, actual.y);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.z, actual.z);
+}
+
+static std::vector<Quaternion> test_quaternions()
+{
+    std::vector<Quaternion> ret;
+    for (float roll = -180.0F; roll < 180.0F; roll += 17.0F) {
+        for (float pitch = -89.0F; pitch < 90.0F; pitch += 13.0F) {
+            for (float yaw = -180.0F; yaw < 180.0F; yaw += 23.0F) {
+                ret.push_back(Quaternion::from_euler_angles_degrees(roll, pitch, yaw));
+            }
+        }
+    }
+    // quaternions with all components close to 0.5, which have the largest error, and negative largest components
+    ret.push_back(Quaternion(0.5F, 0.5F, 0.5F, 0.5F));
+    ret.push_back(Quaternion(0.5F, -0.5F, 0.5F, -0.5F));
+    // divide by the magnitude, since normalized is approximate if a FAST_RECIPROCAL_SQUARE_ROOT macro is defined
+    const Quaternion a(0.49F, 0.51F, -0.5F, 0.5F);
+    ret.push_back(a/a.magnitude());
+    const Quaternion b(-0.1F, 0.2F, -0.9F, 0.3F);
+    ret.push_back(b/b.magnitude());
+    return ret;
+}
+
+void test_quaternion_packed_sizes()
+{
+    static_assert(sizeof(quaternion_packed32_t) == 4);
+    static_assert(sizeof(quaternion_packed48_t) == 6);
+    static_assert(quaternion_packed32_t::pack(3, {{1, 2, 1023}}).index() == 3);
+    static_assert(quaternion_packed32_t::pack(3, {{1, 2, 1023}}).components()[2] == 1023);
+    static_assert(quaternion_packed48_t::pack(2, {{32767, 2, 3}}).index() == 2);
+    static_assert(quaternion_packed48_t::pack(2, {{32767, 2, 3}}).components()[0] == 32767);
+    TEST_ASSERT_TRUE(true);
+}
+
+void test_quaternion_packed_exact()
+{
+    // identity, and quaternions with zero components, are encoded exactly
+    const Quaternion identity(1.0F, 0.0F, 0.0F, 0.0F);
+    TEST_ASSERT_TRUE(quaternion_packed32_t::encode(identity).decode() == identity);
+    TEST_ASSERT_TRUE(quaternion_packed48_t::encode(identity).decode() == identity);
+    TEST_ASSERT_TRUE(quaternion_packed32_t::encode(-identity).decode() == identity);
+    TEST_ASSERT_TRUE(quaternion_packed48_t::encode(-identity).decode() == identity);
+
+    const Quaternion qz(0.0F, 0.0F, 0.0F, 1.0F);
+    TEST_ASSERT_EQUAL_UINT32(3, quaternion_packed32_t::encode(qz).index());
+    TEST_ASSERT_TRUE(quaternion_packed32_t::encode(qz).decode() == qz);
+    TEST_ASSERT_TRUE(quaternion_packed48_t::encode(-qz).decode() == qz);
+
+    // ties go to the first component
+    TEST_ASSERT_EQUAL_UINT32(0, quaternion_packed32_t::encode(Quaternion(0.5F, 0.5F, 0.5F, 0.5F)).index());
+    TEST_ASSERT_EQUAL_UINT32(1, quaternion_packed48_t::encode(Quaternion(0.5F, -0.7F, 0.5F, 0.1F)).index());
+}
+
+void test_quaternion_packed_error()
+{
+    const std::vector<Quaternion> qs = test_quaternions();
+    float max32 = 0.0F;
+    float max48 = 0.0F;
+    for (const Quaternion& q : qs) {
+        const Quaternion q32 = quaternion_packed32_t::encode(q).decode();
+        const Quaternion q48 = quaternion_packed48_t::encode(q).decode();
+        max32 = std::max(max32, angle_degrees(q, q32));
+        max48 = std::max(max48, angle_degrees(q, q48));
+        TEST_ASSERT_FLOAT_WITHIN(4.0E-7F, 1.0F, q32.magnitude_squared());
+        TEST_ASSERT_FLOAT_WITHIN(4.0E-7F, 1.0F, q48.magnitude_squared());
+        // the decoded quaternion has a positive largest component, so may be -q
+        const float sign = q.w*q32.w + q.x*q32.x + q.y*q32.y + q.z*q32.z < 0.0F ? -1.0F : 1.0F;
+        TEST_ASSERT_FLOAT_WITHIN(3.0E-3F, q.w, sign*q32.w);
+        TEST_ASSERT_FLOAT_WITHIN(3.0E-3F, q.z, sign*q32.z);
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(quaternion_packed32_t::MAX_ANGULAR_ERROR_DEGREES, max32);
+    TEST_ASSERT_LESS_THAN_FLOAT(quaternion_packed48_t::MAX_ANGULAR_ERROR_DEGREES, max48);
+    // the documented bound is reasonably tight
+    TEST_ASSERT_GREATER_THAN_FLOAT(quaternion_packed32_t::MAX_ANGULAR_ERROR_DEGREES*0.5F, max32);
+    TEST_ASSERT_GREATER_THAN_FLOAT(quaternion_packed48_t::MAX_ANGULAR_ERROR_DEGREES*0.5F, max48);
+}
+
+void test_quaternion_packed_batch()
+{
+    const std::vector<Quaternion> all = test_quaternions();
+    // include sizes that are not a multiple of the SIMD width, to test the padded last block
+    for (size_t size : { size_t{0}, size_t{1}, size_t{3}, size_t{7}, size_t{17}, all.size() }) {
+        const std::span<const Quaternion> qs(all.data(), size);
+        std::vector<quaternion_packed32_t> p32(size);
+        std::vector<quaternion_packed48_t> p48(size);
+        quaternion_packed32_t::encode_batch(qs, p32);
+        quaternion_packed48_t::encode_batch(qs, p48);
+        std::vector<Quaternion> d32(size);
+        std::vector<Quaternion> d48(size);
+        quaternion_packed32_t::decode_batch(p32, d32);
+        quaternion_packed48_t::decode_batch(p48, d48);
+        for (size_t ii = 0; ii < size; ++ii) {
+            // the encodings are identical to those of the single quaternion functions, the decoded quaternions agree to within a few ulps
+            // (they are identical unless the compiler contracts multiply-adds into fused multiply-adds differently)
+            TEST_ASSERT_TRUE(p32[ii] == quaternion_packed32_t::encode(qs[ii]));
+            TEST_ASSERT_TRUE(p48[ii] == quaternion_packed48_t::encode(qs[ii]));
+            assert_quaternion_within(4.0F*FLT_EPSILON, p32[ii].decode(), d32[ii]);
+            assert_quaternion_within(4.0F*FLT_EPSILON, p48[ii].decode(), d48[ii]);
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_quaternion_packed_sizes);
+    RUN_TEST(test_quaternion_packed_exact);
+    RUN_TEST(test_quaternion_packed_error);
+    RUN_TEST(test_quaternion_packed_batch);
+
+    UNITY_END();
+}
@@ -0,0 +1,123 @@
+#include "quaternion_simd.h"
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+static void assert_quaternion_equal(const Quaternion& expected, const QuaternionSimd& actual)
+{
+    TEST_ASSERT_EQUAL_FLOAT(expected.w, actual.get_w());
+    TEST_ASSERT_EQUAL_FLOAT(expected.x, actual.get_x());
+    TEST_ASSERT_EQUAL_FLOAT(expected.y, actual.get_y());
+    TEST_ASSERT_EQUAL_FLOAT(expected.z, actual.get_z());
+}
+
+void test_quaternion_simd()
+{
+    const QuaternionSimd i;
+    TEST_ASSERT_TRUE(Quaternion() == i.quaternion());
+
+    const Quaternion a(2.0F, 3.0F, 5.0F, 7.0F);
+    const QuaternionSimd A(a);
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, A.get_w());
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, A.get_x());
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, A.get_y());
+    TEST_ASSERT_EQUAL_FLOAT(7.0F, A.get_z());
+    TEST_ASSERT_TRUE(a == A.quaternion());
+    TEST_ASSERT_TRUE(A == QuaternionSimd(2.0F, 3.0F, 5.0F, 7.0F));
+    TEST_ASSERT_TRUE(A != QuaternionSimd(2.0F, 3.0F, 5.0F, 11.0F));
+
+    const Quaternion b(11.0F, -13.0F, 17.0F, -19.0F);
+    const QuaternionSimd B(b);
+    TEST_ASSERT_TRUE(-a == (-A).quaternion());
+    TEST_ASSERT_TRUE(a.conjugate() == A.conjugate().quaternion());
+    TEST_ASSERT_TRUE(a + b == (A + B).quaternion());
+    TEST_ASSERT_TRUE(a - b == (A - B).quaternion());
+    TEST_ASSERT_TRUE(a*3.0F == (A*3.0F).quaternion());
+    TEST_ASSERT_TRUE(3.0F*a == (3.0F*A).quaternion());
+    TEST_ASSERT_EQUAL_FLOAT(a.magnitude_squared(), A.magnitude_squared());
+    TEST_ASSERT_EQUAL_FLOAT(a.dot(b), A.dot(B));
+
+    // Hamilton product, values are small integers so the products are exact
+    TEST_ASSERT_TRUE(a*b == (A*B).quaternion());
+    TEST_ASSERT_TRUE(b*a == (B*A).quaternion());
+    QuaternionSimd C = A;
+    C *= B;
+    TEST_ASSERT_TRUE(a*b == C.quaternion());
+    C += A;
+    C -= B;
+    C *= 2.0F;
+    TEST_ASSERT_TRUE((a*b + a - b)*2.0F == C.quaternion());
+}
+
+void test_quaternion_simd_product()
+{
+    const Quaternion a = Quaternion::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    const Quaternion b = Quaternion::from_euler_angles_degrees(-101.0F, 53.0F, 7.0F);
+    const QuaternionSimd A(a);
+    const QuaternionSimd B(b);
+    assert_quaternion_equal(a*b, A*B);
+    assert_quaternion_equal(b*a, B*A);
+    assert_quaternion_equal((a*b).conjugate()*a, (A*B).conjugate()*A);
+
+    const Quaternion p(0.5F, -0.7F, 1.2F, 2.0F);
+    const QuaternionSimd P(p);
+    assert_quaternion_equal(p.normalized(), P.normalized());
+    QuaternionSimd Q = P;
+    Q.normalize_in_place();
+    TEST_ASSERT_TRUE(Q == P.normalized());
+    TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, 1.0F, Q.magnitude());
+
+    // chained attitude updates
+    Quaternion q = a;
+    QuaternionSimd S(a);
+    for (int ii = 0; ii < 100; ++ii) {
+        q = (q*b).normalized();
+        S = (S*B).normalized();
+    }
+    assert_quaternion_equal(q, S);
+}
+
+void test_quaternion_simd_rotate()
+{
+    const QuaternionSimd I;
+    const xyz_t v{1.0F, -2.0F, 3.0F};
+    TEST_ASSERT_TRUE(v == I.rotate(v));
+
+    // rotate 90 degrees about the z-axis
+    const xyz_t r = QuaternionSimd(Quaternion::from_euler_angles_degrees(0.0F, 0.0F, 90.0F)).rotate(v);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 2.0F, r.x);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 1.0F, r.y);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 3.0F, r.z);
+
+    const Quaternion q = Quaternion::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    const QuaternionSimd Q(q);
+    for (int ii = 0; ii < 32; ++ii) {
+        const auto f = static_cast<float>(ii);
+        const xyz_t u{f*0.3F - 3.0F, 0.5F - f*0.2F, 1.0F + f*0.1F};
+        const xyz_t expected = q.rotate(u);
+        const xyz_t actual = Q.rotate(u);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, expected.x, actual.x);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, expected.y, actual.y);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, expected.z, actual.z);
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_quaternion_simd);
+    RUN_TEST(test_quaternion_simd_product);
+    RUN_TEST(test_quaternion_simd_rotate);
+
+    UNITY_END();
+}
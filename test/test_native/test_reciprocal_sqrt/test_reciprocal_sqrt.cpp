@@ -0,0 +1,76 @@
+#include "reciprocal_sqrt.h"
+#include "simd_float.h"
+
+#include <cmath>
+#include <vector>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+static std::vector<float> test_values()
+{
+    // values spanning several orders of magnitude, count deliberately not a multiple of the SIMD width
+    std::vector<float> x;
+    for (float f = 1.0E-6F; f < 1.0E6F; f *= 1.37F) {
+        x.push_back(f);
+    }
+    x.push_back(1.0F);
+    x.push_back(4.0F);
+    return x;
+}
+
+void test_reciprocal_sqrtf()
+{
+    // reciprocal_sqrtf is approximate if a FAST_RECIPROCAL_SQUARE_ROOT macro is defined
+    TEST_ASSERT_FLOAT_WITHIN(RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, 1.0F, reciprocal_sqrtf(1.0F));
+    TEST_ASSERT_FLOAT_WITHIN(0.5F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, 0.5F, reciprocal_sqrtf(4.0F));
+    TEST_ASSERT_FLOAT_WITHIN(0.1F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, 0.1F, reciprocal_sqrtf(100.0F));
+}
+
+void test_reciprocal_sqrt_batch_full()
+{
+    const std::vector<float> x = test_values();
+    std::vector<float> out(x.size());
+    reciprocal_sqrt_batch(x, out);
+    for (size_t ii = 0; ii < x.size(); ++ii) {
+        TEST_ASSERT_TRUE(1.0F / sqrtf(x[ii]) == out[ii]);
+    }
+    // in-place
+    std::vector<float> y = x;
+    reciprocal_sqrt_batch(y, y, rsqrt_precision_e::FULL);
+    TEST_ASSERT_TRUE(y == out);
+}
+
+void test_reciprocal_sqrt_batch_approximate()
+{
+    const std::vector<float> x = test_values();
+    std::vector<float> estimate(x.size());
+    std::vector<float> one_iteration(x.size());
+    reciprocal_sqrt_batch(x, estimate, rsqrt_precision_e::ESTIMATE);
+    reciprocal_sqrt_batch(x, one_iteration, rsqrt_precision_e::ONE_ITERATION);
+    for (size_t ii = 0; ii < x.size(); ++ii) {
+        const float expected = 1.0F / sqrtf(x[ii]);
+        TEST_ASSERT_FLOAT_WITHIN(simd_float_t::RSQRT_ESTIMATE_MAX_RELATIVE_ERROR, 1.0F, estimate[ii] / expected);
+        TEST_ASSERT_FLOAT_WITHIN(simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, 1.0F, one_iteration[ii] / expected);
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_reciprocal_sqrtf);
+    RUN_TEST(test_reciprocal_sqrt_batch_full);
+    RUN_TEST(test_reciprocal_sqrt_batch_approximate);
+
+    UNITY_END();
+}
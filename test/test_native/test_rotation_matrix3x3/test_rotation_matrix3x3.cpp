@@ -0,0 +1,195 @@
+#include "rotation_matrix3x3.h"
+#include <array>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+void test_rotation_matrix3x3_constructors()
+{
+    static_assert(sizeof(RotationMatrix3x3) == 9*sizeof(float));
+
+    TEST_ASSERT_TRUE(RotationMatrix3x3().matrix() == Matrix3x3(1.0F));
+
+    const Quaternion q = Quaternion::from_euler_angles_degrees(10.0F, 20.0F, 30.0F);
+    const RotationMatrix3x3 r(q);
+    TEST_ASSERT_TRUE(r.matrix() == Matrix3x3(q));
+    const Quaternion qr = r.quaternion();
+    // the conversion to a quaternion uses reciprocal_sqrt, which may be the fast reciprocal square root
+    const float delta = 1.0E-6F + 2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR;
+    TEST_ASSERT_FLOAT_WITHIN(delta, q.w, qr.w);
+    TEST_ASSERT_FLOAT_WITHIN(delta, q.x, qr.x);
+    TEST_ASSERT_FLOAT_WITHIN(delta, q.y, qr.y);
+    TEST_ASSERT_FLOAT_WITHIN(delta, q.z, qr.z);
+
+    const RotationMatrix3x3 e = RotationMatrix3x3::from_euler_angles_degrees(10.0F, 20.0F, 30.0F);
+    TEST_ASSERT_TRUE(e.matrix() == Matrix3x3::from_euler_angles_degrees(10.0F, 20.0F, 30.0F));
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, r[ii], e[ii]);
+    }
+
+    // construction from a full matrix orthonormalizes it
+    const Matrix3x3 m(1.1F, 0.1F, 0.0F, 0.0F, 0.9F, 0.05F, 0.02F, 0.0F, 1.0F);
+    const RotationMatrix3x3 o(m);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-12F, 0.0F, o.orthonormality_error());
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 1.0F, o.matrix().determinant());
+    TEST_ASSERT_TRUE(RotationMatrix3x3(e.matrix()).orthonormality_error() <= e.orthonormality_error() + 1.0E-12F);
+}
+
+void test_rotation_matrix3x3_inverse()
+{
+    const RotationMatrix3x3 r = RotationMatrix3x3::from_euler_angles_degrees(10.0F, -20.0F, 130.0F);
+    TEST_ASSERT_TRUE(r.inverse().matrix() == r.matrix().transpose());
+    const Matrix3x3 inverse = r.matrix().inverse();
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, inverse[ii], r.inverse()[ii]);
+    }
+    RotationMatrix3x3 s = r;
+    s.invert_in_place();
+    TEST_ASSERT_TRUE(s == r.inverse());
+
+    const xyz_t v{1.0F, -2.0F, 3.0F};
+    TEST_ASSERT_TRUE(r*v == r.matrix()*v);
+    TEST_ASSERT_TRUE(r.inverse_rotate(v) == r.matrix().transpose()*v);
+    const xyz_t u = r.inverse_rotate(r*v);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, v.x, u.x);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, v.y, u.y);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, v.z, u.z);
+}
+
+void test_rotation_matrix3x3_composition()
+{
+    const RotationMatrix3x3 a = RotationMatrix3x3::from_euler_angles_degrees(10.0F, 20.0F, 30.0F);
+    const RotationMatrix3x3 b = RotationMatrix3x3::from_euler_angles_degrees(-5.0F, 45.0F, 170.0F);
+    TEST_ASSERT_TRUE((a*b).matrix() == a.matrix()*b.matrix());
+    TEST_ASSERT_TRUE(a.transpose_multiply(b).matrix() == a.matrix().transpose()*b.matrix());
+    RotationMatrix3x3 c = a;
+    c *= b;
+    TEST_ASSERT_TRUE(c == a*b);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-12F, 0.0F, (a*b).orthonormality_error());
+
+    const Matrix3x3 m(1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F, 8.0F, 10.0F);
+    TEST_ASSERT_TRUE(a*m == a.matrix()*m);
+    TEST_ASSERT_TRUE(m*a == m*a.matrix());
+}
+
+void test_rotation_matrix3x3_renormalize()
+{
+    // a slightly perturbed rotation, as would result from integration
+    const Matrix3x3 m = RotationMatrix3x3::from_euler_angles_degrees(10.0F, 20.0F, 30.0F).matrix() + Matrix3x3(0.001F, 0.002F, -0.001F, 0.0F, -0.002F, 0.001F, 0.001F, 0.0F, 0.002F);
+    RotationMatrix3x3 r = RotationMatrix3x3::from_orthonormal(m);
+    const float error = r.orthonormality_error();
+    TEST_ASSERT_TRUE(error > 1.0E-6F);
+    r.renormalize_in_place();
+    TEST_ASSERT_TRUE(r.orthonormality_error() < error*1.0E-3F);
+    // the rotation is close to the Gram-Schmidt orthonormalized one
+    const RotationMatrix3x3 o(m);
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(5.0E-3F, o[ii], r[ii]);
+    }
+}
+
+void test_rotation_matrix3x3_integrate()
+{
+    // rotate at 1 radian per second about z for one second, in 1000 steps
+    RotationMatrix3x3 r;
+    const xyz_t angular_velocity{0.0F, 0.0F, 1.0F};
+    for (int ii = 0; ii < 1000; ++ii) {
+        r.integrate(angular_velocity, 0.001F);
+    }
+    const RotationMatrix3x3 expected = RotationMatrix3x3::from_euler_angles_radians(0.0F, 0.0F, 1.0F);
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-3F, expected[ii], r[ii]);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-10F, 0.0F, r.orthonormality_error());
+}
+
+void test_rotation_matrix3x3_batch()
+{
+    std::array<RotationMatrix3x3, 5> r {};
+    std::array<RotationMatrix3x3, 5> expected {};
+    std::array<xyz_t, 5> angular_velocity {};
+    for (size_t ii = 0; ii < r.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        r[ii] = RotationMatrix3x3::from_euler_angles_degrees(f*10.0F, -f*5.0F, f*30.0F);
+        angular_velocity[ii] = xyz_t{0.1F*f, -0.2F, 0.3F*f};
+        expected[ii] = r[ii];
+        expected[ii].integrate(angular_velocity[ii], 0.01F);
+    }
+    RotationMatrix3x3::integrate_batch(r, angular_velocity, 0.01F);
+    TEST_ASSERT_TRUE(r == expected);
+
+    for (size_t ii = 0; ii < r.size(); ++ii) {
+        expected[ii].renormalize_in_place();
+    }
+    RotationMatrix3x3::renormalize_batch(r);
+    TEST_ASSERT_TRUE(r == expected);
+
+    for (size_t ii = 0; ii < r.size(); ++ii) {
+        expected[ii].orthonormalize_in_place();
+    }
+    RotationMatrix3x3::orthonormalize_batch(r);
+    TEST_ASSERT_TRUE(r == expected);
+
+    const std::array<xyz_t, 5> v {{ {1.0F, 2.0F, 3.0F}, {-1.0F, 0.5F, 0.0F}, {0.0F, 0.0F, 1.0F}, {4.0F, -3.0F, 2.0F}, {0.1F, 0.2F, 0.3F} }};
+    std::array<xyz_t, 5> out {};
+    r[3].rotate(v, out);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        const xyz_t e = r[3]*v[ii];
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, e.x, out[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, e.y, out[ii].y);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, e.z, out[ii].z);
+    }
+    r[3].inverse_rotate(out, out);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, v[ii].x, out[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, v[ii].y, out[ii].y);
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, v[ii].z, out[ii].z);
+    }
+}
+
+void test_rotation_matrix3x3_double()
+{
+    RotationMatrix3x3d r(Matrix3x3d(1.1, 0.1, 0.0, 0.0, 0.9, 0.05, 0.02, 0.0, 1.0));
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-12F, 0.0F, static_cast<float>(r.orthonormality_error()));
+    const RotationMatrix3x3d identity = r*r.inverse();
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-7F, (ii % 4 == 0) ? 1.0F : 0.0F, static_cast<float>(identity[ii]));
+    }
+    r.integrate(xyzd_t{0.1, 0.2, 0.3}, 0.01);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-12F, 0.0F, static_cast<float>(r.orthonormality_error()));
+}
+
+void test_rotation_matrix3x3_constexpr()
+{
+    constexpr RotationMatrix3x3 r = RotationMatrix3x3::from_orthonormal(Matrix3x3(0.0F, -1.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F));
+    static_assert(r.orthonormality_error() == 0.0F);
+    static_assert(r*r.inverse() == RotationMatrix3x3());
+    static_assert(r*(xyz_t{1.0F, 0.0F, 0.0F}) == (xyz_t{0.0F, 1.0F, 0.0F}));
+    static_assert(r.inverse_rotate(xyz_t{0.0F, 1.0F, 0.0F}) == (xyz_t{1.0F, 0.0F, 0.0F}));
+    TEST_ASSERT_TRUE(r.transpose().matrix() == r.matrix().transpose());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_rotation_matrix3x3_constructors);
+    RUN_TEST(test_rotation_matrix3x3_inverse);
+    RUN_TEST(test_rotation_matrix3x3_composition);
+    RUN_TEST(test_rotation_matrix3x3_renormalize);
+    RUN_TEST(test_rotation_matrix3x3_integrate);
+    RUN_TEST(test_rotation_matrix3x3_batch);
+    RUN_TEST(test_rotation_matrix3x3_double);
+    RUN_TEST(test_rotation_matrix3x3_constexpr);
+
+    UNITY_END();
+}
@@ -0,0 +1,181 @@
+#include "symmetric_eigen3x3.h"
+#include <array>
+#include <cmath>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+static void assert_xyz_within(float delta, const xyz_t& expected, const xyz_t& actual)
+{
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.x, actual.x);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.y, actual.y);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.z, actual.z);
+}
+
+static void assert_symmetric_within(float delta, const SymmetricMatrix3x3& expected, const SymmetricMatrix3x3& actual)
+{
+    for (size_t ii = 0; ii < 6; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(delta, expected[ii], actual[ii]);
+    }
+}
+
+// checks S*v = lambda*v for each eigenvector, and that the eigenvectors form a rotation matrix
+static void assert_decomposition(float delta, const SymmetricMatrix3x3& s, const SymmetricEigen3x3& eigen)
+{
+    const xyz_t e = eigen.eigenvalues();
+    TEST_ASSERT_TRUE(e.x >= e.y);
+    TEST_ASSERT_TRUE(e.y >= e.z);
+    for (size_t ii = 0; ii < 3; ++ii) {
+        const xyz_t v = eigen.eigenvector(ii);
+        assert_xyz_within(delta, v*e[ii], s*v);
+    }
+    const Matrix3x3& V = eigen.eigenvectors();
+    const Matrix3x3 VtV = V.transpose_multiply(V);
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, Matrix3x3(1.0F)[ii], VtV[ii]);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 1.0F, V.determinant());
+    assert_symmetric_within(delta, s, eigen.matrix());
+}
+
+void test_symmetric_eigen3x3_decompose()
+{
+    // eigenvalues 5, 3, 1, with eigenvectors {0, 0, 1}, {1, 1, 0}/sqrt(2), and {1, -1, 0}/sqrt(2)
+    const SymmetricMatrix3x3 s(2.0F, 1.0F, 0.0F, 2.0F, 0.0F, 5.0F);
+    const SymmetricEigen3x3 eigen(s);
+    assert_xyz_within(1.0E-6F, xyz_t{ 5.0F, 3.0F, 1.0F }, eigen.eigenvalues());
+    const float r = 1.0F/std::sqrt(2.0F);
+    const xyz_t v0 = eigen.eigenvector(0);
+    const xyz_t v1 = eigen.eigenvector(1);
+    const xyz_t v2 = eigen.eigenvector(2);
+    // eigenvectors are determined only up to sign
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 1.0F, std::fabs(v0.z));
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 1.0F, std::fabs(v1.dot(xyz_t{ r, r, 0.0F })));
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, 1.0F, std::fabs(v2.dot(xyz_t{ r, -r, 0.0F })));
+    assert_decomposition(1.0E-5F, s, eigen);
+
+    const SymmetricMatrix3x3 t(4.0F, 1.0F, 2.0F, 3.0F, -0.5F, 5.0F);
+    const SymmetricEigen3x3 eigen_t(t);
+    assert_decomposition(1.0E-5F, t, eigen_t);
+    const xyz_t e = eigen_t.eigenvalues();
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, t.trace(), e.x + e.y + e.z);
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-4F, t.determinant(), e.x*e.y*e.z);
+
+    // an indefinite matrix
+    const SymmetricMatrix3x3 u(1.0F, 2.0F, 3.0F, -4.0F, 5.0F, 6.0F);
+    assert_decomposition(1.0E-5F, u, SymmetricEigen3x3(u));
+}
+
+void test_symmetric_eigen3x3_repeated()
+{
+    // a multiple of the identity needs no rotations
+    const SymmetricMatrix3x3 s(2.0F);
+    const SymmetricEigen3x3 eigen(s);
+    TEST_ASSERT_TRUE(eigen.eigenvalues() == (xyz_t{ 2.0F, 2.0F, 2.0F }));
+    TEST_ASSERT_TRUE(eigen.eigenvectors() == Matrix3x3(1.0F));
+    TEST_ASSERT_TRUE(SymmetricEigen3x3::calculate_eigenvalues(s) == (xyz_t{ 2.0F, 2.0F, 2.0F }));
+
+    // a diagonal matrix is sorted
+    const SymmetricMatrix3x3 d(1.0F, 3.0F, 2.0F);
+    const SymmetricEigen3x3 eigen_d(d);
+    TEST_ASSERT_TRUE(eigen_d.eigenvalues() == (xyz_t{ 3.0F, 2.0F, 1.0F }));
+    assert_decomposition(0.0F, d, eigen_d);
+
+    // R*diag(3, 1, 1)*R^T, which has a repeated eigenvalue
+    const Matrix3x3 R = Matrix3x3::from_euler_angles_degrees(19.0F, -37.0F, 71.0F);
+    const SymmetricMatrix3x3 r(R*Matrix3x3(3.0F, 1.0F, 1.0F)*R.transpose());
+    const SymmetricEigen3x3 eigen_r(r);
+    assert_xyz_within(1.0E-5F, xyz_t{ 3.0F, 1.0F, 1.0F }, eigen_r.eigenvalues());
+    assert_decomposition(1.0E-5F, r, eigen_r);
+    // the principal axis is the first column of R
+    TEST_ASSERT_FLOAT_WITHIN(1.0E-5F, 1.0F, std::fabs(eigen_r.eigenvector(0).dot(xyz_t{ R[0], R[3], R[6] })));
+}
+
+void test_symmetric_eigen3x3_calculate_eigenvalues()
+{
+    const SymmetricMatrix3x3 s(2.0F, 1.0F, 0.0F, 2.0F, 0.0F, 5.0F);
+    assert_xyz_within(1.0E-5F, xyz_t{ 5.0F, 3.0F, 1.0F }, SymmetricEigen3x3::calculate_eigenvalues(s));
+
+    const std::array<SymmetricMatrix3x3, 3> m {
+        SymmetricMatrix3x3(4.0F, 1.0F, 2.0F, 3.0F, -0.5F, 5.0F),
+        SymmetricMatrix3x3(1.0F, 2.0F, 3.0F, -4.0F, 5.0F, 6.0F),
+        SymmetricMatrix3x3(0.02F, 0.001F, -0.003F, 0.03F, 0.002F, 0.01F),
+    };
+    for (const SymmetricMatrix3x3& a : m) {
+        const xyz_t e = SymmetricEigen3x3::calculate_eigenvalues(a);
+        const xyz_t expected = SymmetricEigen3x3(a).eigenvalues();
+        const float scale = std::fabs(expected.x) + std::fabs(expected.z);
+        assert_xyz_within(1.0E-4F*scale, expected, e);
+        TEST_ASSERT_TRUE(e.x >= e.y);
+        TEST_ASSERT_TRUE(e.y >= e.z);
+    }
+}
+
+void test_symmetric_eigen3x3_covariance_shaping()
+{
+    // clamp the eigenvalues of a covariance matrix that has become indefinite
+    const SymmetricMatrix3x3 p(1.0F, 0.9F, 0.0F, 0.5F, 0.0F, 2.0F);
+    SymmetricEigen3x3 eigen(p);
+    const xyz_t e = eigen.eigenvalues();
+    TEST_ASSERT_TRUE(e.z < 0.0F);
+    eigen.set_eigenvalues(xyz_t{ e.x, e.y, 0.01F });
+    const SymmetricMatrix3x3 shaped = eigen.matrix();
+    assert_xyz_within(1.0E-5F, xyz_t{ e.x, e.y, 0.01F }, SymmetricEigen3x3(shaped).eigenvalues());
+}
+
+void test_symmetric_eigen3x3_batch()
+{
+    std::array<SymmetricMatrix3x3, 5> s {};
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        s[ii] = SymmetricMatrix3x3(2.0F + f, 0.5F, -0.3F*f, 3.0F, 0.2F + f, 4.0F - f);
+    }
+    std::array<SymmetricEigen3x3, 5> out {};
+    SymmetricEigen3x3::decompose_batch(s, out);
+    std::array<xyz_t, 5> eigenvalues {};
+    SymmetricEigen3x3::eigenvalues_batch(s, eigenvalues);
+    for (size_t ii = 0; ii < s.size(); ++ii) {
+        const SymmetricEigen3x3 eigen(s[ii]);
+        TEST_ASSERT_TRUE(eigen.eigenvalues() == out[ii].eigenvalues());
+        TEST_ASSERT_TRUE(eigen.eigenvectors() == out[ii].eigenvectors());
+        TEST_ASSERT_TRUE(SymmetricEigen3x3::calculate_eigenvalues(s[ii]) == eigenvalues[ii]);
+        assert_decomposition(1.0E-5F, s[ii], out[ii]);
+    }
+}
+
+void test_symmetric_eigen3x3_double()
+{
+    const SymmetricMatrix3x3d s(4.0, 1.0, 2.0, 3.0, -0.5, 5.0);
+    const SymmetricEigen3x3d eigen(s);
+    const xyzd_t e = eigen.eigenvalues();
+    for (size_t ii = 0; ii < 3; ++ii) {
+        const xyzd_t v = eigen.eigenvector(ii);
+        const xyzd_t residual = s*v - v*e[ii];
+        TEST_ASSERT_TRUE(residual.norm() < 1.0E-14);
+    }
+    const xyzd_t a = SymmetricEigen3x3d::calculate_eigenvalues(s);
+    TEST_ASSERT_TRUE((a - e).norm() < 1.0E-13);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_symmetric_eigen3x3_decompose);
+    RUN_TEST(test_symmetric_eigen3x3_repeated);
+    RUN_TEST(test_symmetric_eigen3x3_calculate_eigenvalues);
+    RUN_TEST(test_symmetric_eigen3x3_covariance_shaping);
+    RUN_TEST(test_symmetric_eigen3x3_batch);
+    RUN_TEST(test_symmetric_eigen3x3_double);
+
+    UNITY_END();
+}
@@ -0,0 +1,171 @@
+#include "symmetric_matrix3x3.h"
+#include <cfloat>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+// the elements of the matrices below are no larger than 10, so a few ulps of the largest element
+static constexpr float DELTA = 80.0F*FLT_EPSILON;
+
+static void assert_matrix_within(float delta, const Matrix3x3& expected, const Matrix3x3& actual)
+{
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(delta, expected[ii], actual[ii]);
+    }
+}
+
+void test_symmetric_matrix3x3_constructors()
+{
+    static_assert(sizeof(SymmetricMatrix3x3) == 6*sizeof(float));
+
+    const SymmetricMatrix3x3 p(2.0F, 0.1F, -0.3F, 3.0F, 0.2F, 4.0F);
+    const Matrix3x3 m = p.matrix();
+    TEST_ASSERT_TRUE(m == Matrix3x3(2.0F, 0.1F, -0.3F, 0.1F, 3.0F, 0.2F, -0.3F, 0.2F, 4.0F));
+    TEST_ASSERT_TRUE(SymmetricMatrix3x3(m) == p);
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t column = 0; column < 3; ++column) {
+            TEST_ASSERT_EQUAL_FLOAT(m[row*3 + column], p(row, column));
+        }
+    }
+    // elements below the diagonal are ignored
+    TEST_ASSERT_TRUE(SymmetricMatrix3x3(Matrix3x3(1, 2, 3, 4, 5, 6, 7, 8, 9)) == SymmetricMatrix3x3(1, 2, 3, 5, 6, 9));
+
+    TEST_ASSERT_TRUE(SymmetricMatrix3x3(2.0F).matrix() == Matrix3x3(2.0F));
+    TEST_ASSERT_TRUE(SymmetricMatrix3x3(1.0F, 2.0F, 3.0F).matrix() == Matrix3x3(1.0F, 2.0F, 3.0F));
+    TEST_ASSERT_TRUE(SymmetricMatrix3x3().matrix() == Matrix3x3());
+    TEST_ASSERT_TRUE(p.diagonal() == (xyz_t{2.0F, 3.0F, 4.0F}));
+
+    SymmetricMatrix3x3 s = p;
+    s.set_to_identity();
+    TEST_ASSERT_TRUE(s == SymmetricMatrix3x3(1.0F));
+    s.set_to_scaled_identity(5.0F);
+    TEST_ASSERT_TRUE(s == SymmetricMatrix3x3(5.0F));
+    s.set_zero();
+    TEST_ASSERT_TRUE(s == SymmetricMatrix3x3());
+}
+
+void test_symmetric_matrix3x3_arithmetic()
+{
+    const SymmetricMatrix3x3 p(2.0F, 0.1F, -0.3F, 3.0F, 0.2F, 4.0F);
+    const SymmetricMatrix3x3 q(0.5F, -1.0F, 0.25F, 7.0F, 1.5F, -2.0F);
+    const Matrix3x3 P = p.matrix();
+    const Matrix3x3 Q = q.matrix();
+
+    TEST_ASSERT_TRUE((p + q).matrix() == P + Q);
+    TEST_ASSERT_TRUE((p - q).matrix() == P - Q);
+    TEST_ASSERT_TRUE((-p).matrix() == -P);
+    TEST_ASSERT_TRUE((p*3.0F).matrix() == P*3.0F);
+    TEST_ASSERT_TRUE((3.0F*p).matrix() == 3.0F*P);
+    TEST_ASSERT_TRUE((p/4.0F).matrix() == P/4.0F);
+
+    SymmetricMatrix3x3 s = p;
+    s += q;
+    TEST_ASSERT_TRUE(s == p + q);
+    s -= q;
+    s -= q;
+    TEST_ASSERT_TRUE(s.matrix() == P + Q - Q - Q);
+    s = p;
+    s *= 2.0F;
+    TEST_ASSERT_TRUE(s == p*2.0F);
+    s /= 2.0F;
+    TEST_ASSERT_TRUE(s == p);
+
+    const xyz_t v{1.0F, -2.0F, 3.0F};
+    const xyz_t pv = p*v;
+    const xyz_t Pv = P*v;
+    TEST_ASSERT_FLOAT_WITHIN(DELTA, Pv.x, pv.x);
+    TEST_ASSERT_FLOAT_WITHIN(DELTA, Pv.y, pv.y);
+    TEST_ASSERT_FLOAT_WITHIN(DELTA, Pv.z, pv.z);
+    TEST_ASSERT_EQUAL_FLOAT(v.dot(P*v), p.quadratic_form(v));
+    TEST_ASSERT_TRUE(p.add_to_diagonal(v).matrix() == P.add_to_diagonal(v));
+    s = p;
+    s.add_to_diagonal_in_place(v);
+    TEST_ASSERT_TRUE(s == p.add_to_diagonal(v));
+
+    TEST_ASSERT_EQUAL_FLOAT(P.determinant(), p.determinant());
+    TEST_ASSERT_EQUAL_FLOAT(P.trace(), p.trace());
+}
+
+void test_symmetric_matrix3x3_congruence()
+{
+    const Matrix3x3 F(1.0F, 0.01F, 0.0F, 0.0F, 1.0F, 0.01F, 0.003F, 0.0F, 1.0F);
+    const SymmetricMatrix3x3 p(2.0F, 0.1F, -0.3F, 3.0F, 0.2F, 4.0F);
+    const SymmetricMatrix3x3 q(0.01F, 0.0F, 0.0F, 0.02F, 0.0F, 0.03F);
+
+    // agrees with the full matrix congruence transforms to within a few ulps
+    // (they are identical unless the compiler contracts multiply-adds into fused multiply-adds differently in each)
+    assert_matrix_within(DELTA, F.congruence(p.matrix()), p.congruence(F).matrix());
+    assert_matrix_within(DELTA, F.congruence_add(p.matrix(), q.matrix()), p.congruence_add(F, q).matrix());
+
+    const Matrix3x3 FPFtQ = F*p.matrix()*F.transpose() + q.matrix();
+    const Matrix3x3 c = p.congruence_add(F, q).matrix();
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, FPFtQ[ii], c[ii]);
+    }
+}
+
+void test_symmetric_matrix3x3_inverse()
+{
+    const SymmetricMatrix3x3 p(2.0F, 0.1F, -0.3F, 3.0F, 0.2F, 4.0F);
+    const SymmetricMatrix3x3 inverse = p.inverse();
+    const Matrix3x3 expected = p.matrix().inverse();
+    const Matrix3x3 actual = inverse.matrix();
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-7F, expected[ii], actual[ii]);
+    }
+    const Matrix3x3 identity = p.matrix()*actual;
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(1.0E-6F, (ii % 4 == 0) ? 1.0F : 0.0F, identity[ii]);
+    }
+
+    // singular matrices are left unchanged
+    SymmetricMatrix3x3 s(1.0F, 2.0F, 3.0F, 4.0F, 6.0F, 9.0F);
+    TEST_ASSERT_FALSE(s.invert_in_place());
+    TEST_ASSERT_TRUE(s == SymmetricMatrix3x3(1.0F, 2.0F, 3.0F, 4.0F, 6.0F, 9.0F));
+    TEST_ASSERT_TRUE(s.inverse() == s);
+}
+
+void test_symmetric_matrix3x3_constexpr()
+{
+    constexpr SymmetricMatrix3x3 p(2.0F, 1.0F, 0.0F, 3.0F, 0.0F, 4.0F);
+    static_assert(p(1, 0) == 1.0F);
+    static_assert((p + p - p*2.0F) == SymmetricMatrix3x3());
+    static_assert(p.quadratic_form(xyz_t{1.0F, 1.0F, 0.0F}) == 7.0F);
+    static_assert(p.determinant() == 20.0F);
+    TEST_ASSERT_TRUE(p.congruence(Matrix3x3(1.0F)) == p);
+}
+
+void test_symmetric_matrix3x3_double()
+{
+    const SymmetricMatrix3x3d p(2.0, 0.1, -0.3, 3.0, 0.2, 4.0);
+    const SymmetricMatrix3x3d inverse = p.inverse();
+    const Matrix3x3d identity = p.matrix()*inverse.matrix();
+    for (size_t ii = 0; ii < 9; ++ii) {
+        TEST_ASSERT_DOUBLE_WITHIN(1.0E-15, (ii % 4 == 0) ? 1.0 : 0.0, identity[ii]);
+    }
+    const xyzd_t v{1.0, -2.0, 3.0};
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-15, 1.0, p.quadratic_form(inverse*v) / v.dot(inverse*v));
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_symmetric_matrix3x3_constructors);
+    RUN_TEST(test_symmetric_matrix3x3_arithmetic);
+    RUN_TEST(test_symmetric_matrix3x3_congruence);
+    RUN_TEST(test_symmetric_matrix3x3_inverse);
+    RUN_TEST(test_symmetric_matrix3x3_constexpr);
+    RUN_TEST(test_symmetric_matrix3x3_double);
+
+    UNITY_END();
+}
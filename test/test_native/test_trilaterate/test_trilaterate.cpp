@@ -1,5 +1,5 @@
 #include "xyz_type.h"
-#include "Matrix3x3.h"
+#include "matrix3x3.h"
 #include <unity.h>
 
 void setUp() {
@@ -7,13 +7,6 @@ void setUp() {
 
 void tearDown() {
 }
-/*
-xy_t calculateEigenvalues() const {
-    const float d = discriminant();
-    const float t = trace();
-    return (d >= 0) ? xy_t{t + std::sqrt(d), t - std::sqrt(d)} : xy_t{std::nanf(""), std::nanf("")};
-}
-*/
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
 bool trilaterate(
@@ -1,4 +1,6 @@
 #include "xy_type.h"
+#include "simd_float.h"
+#include <vector>
 #include <unity.h>
 
 void setUp() {
@@ -151,6 +153,47 @@ void test_xy_t_functions()
     const xy_t f_clamped = xy_t{-20, 20};
     TEST_ASSERT_TRUE(f == f_clamped);
 }
+
+void test_xy_t_normalize_batch()
+{
+    // count not a multiple of the SIMD width, so the last partial block is also exercised
+    std::vector<xy_t> v(11);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        v[ii] = xy_t{f - 3.5F, 2.0F + 0.25F*f};
+    }
+    std::vector<xy_t> out(v.size());
+    xy_t::normalize_batch(v, out);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        // normalized uses reciprocal_sqrtf, which is approximate if a FAST_RECIPROCAL_SQUARE_ROOT macro is defined
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, v[ii].normalized().x, out[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, v[ii].normalized().y, out[ii].y);
+    }
+
+    std::vector<xy_t> w = v;
+    xy_t::normalize_batch(w, w, rsqrt_precision_e::ONE_ITERATION);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, out[ii].x, w[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, out[ii].y, w[ii].y);
+    }
+    xy_t::normalize_batch(v, w, rsqrt_precision_e::ESTIMATE);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ESTIMATE_MAX_RELATIVE_ERROR, out[ii].x, w[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ESTIMATE_MAX_RELATIVE_ERROR, out[ii].y, w[ii].y);
+    }
+}
+void test_xy_t_constexpr()
+{
+    constexpr xy_t a{2.0F, 3.0F};
+    constexpr xy_t b{7.0F, 11.0F};
+    static_assert(a + b == xy_t{9.0F, 14.0F});
+    static_assert(2.0F*a - b == xy_t{-3.0F, -5.0F});
+    static_assert(a.dot(b) == 47.0F);
+    static_assert(a.cross(b) == 1.0F);
+    static_assert(a.magnitude_squared() == 13.0F);
+    constexpr xy_t c = []() { xy_t v{1.0F, 2.0F}; v += xy_t{1.0F, 1.0F}; v *= 2.0F; return v; }();
+    TEST_ASSERT_TRUE(c == (xy_t{2.0F, 3.0F}*2.0F));
+}
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
 
 int main(int argc, char **argv)
@@ -163,6 +206,8 @@ int main(int argc, char **argv)
     RUN_TEST(test_xy_t_assignment);
     RUN_TEST(test_xy_t_operators);
     RUN_TEST(test_xy_t_functions);
+    RUN_TEST(test_xy_t_constexpr);
+    RUN_TEST(test_xy_t_normalize_batch);
 
     UNITY_END();
 }
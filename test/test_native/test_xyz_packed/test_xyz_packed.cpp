@@ -0,0 +1,167 @@
+#include "xyz_packed.h"
+#include <cfloat>
+#include <limits>
+#include <unity.h>
+#include <vector>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+//! Angle between the unit vectors v and p, in degrees, calculated in double precision so it is accurate for small angles
+static float angle_degrees(const xyz_t& v, const xyz_t& p)
+{
+    const xyzd_t a { v.x, v.y, v.z };
+    const xyzd_t b { p.x, p.y, p.z };
+    return static_cast<float>(std::atan2(a.cross(b).magnitude(), a.dot(b))*180.0/3.14159265358979323846);
+}
+
+static void assert_xyz_within(float delta, const xyz_t& expected, const xyz_t& actual)
+{
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.x, actual.x);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.y, actual.y);
+    TEST_ASSERT_FLOAT_WITHIN(delta, expected.z, actual.z);
+}
+
+static std::vector<xyz_t> test_vectors()
+{
+    std::vector<xyz_t> ret;
+    // points spread over the sphere, including both halves of the octahedron and its edges
+    for (float z = -1.0F; z <= 1.0F; z += 0.0625F) {
+        const float r = std::sqrt(std::max(1.0F - z*z, 0.0F));
+        for (float phi = -3.1F; phi < 3.2F; phi += 0.05F) {
+            ret.push_back(xyz_t{r*std::cos(phi), r*std::sin(phi), z});
+        }
+    }
+    return ret;
+}
+
+void test_xyz_octahedral_exact()
+{
+    static_assert(sizeof(xyz_octahedral16_t) == 2);
+    static_assert(sizeof(xyz_octahedral32_t) == 4);
+    static_assert(xyz_octahedral16_t::pack(254, 3).coordinates()[0] == 254);
+    static_assert(xyz_octahedral32_t::pack(3, 65534).coordinates()[1] == 65534);
+
+    // the coordinate axes are encoded exactly
+    const std::array<xyz_t, 6> axes {{ {1.0F, 0.0F, 0.0F}, {-1.0F, 0.0F, 0.0F}, {0.0F, 1.0F, 0.0F}, {0.0F, -1.0F, 0.0F}, {0.0F, 0.0F, 1.0F}, {0.0F, 0.0F, -1.0F} }};
+    for (const xyz_t& v : axes) {
+        TEST_ASSERT_TRUE(xyz_octahedral16_t::encode(v).decode() == v);
+        TEST_ASSERT_TRUE(xyz_octahedral32_t::encode(v).decode() == v);
+    }
+    // the zero vector is encoded as {0, 0, 1}
+    TEST_ASSERT_TRUE(xyz_octahedral16_t::encode(xyz_t{0.0F, 0.0F, 0.0F}).decode() == (xyz_t{0.0F, 0.0F, 1.0F}));
+    // non-unit vectors are encoded by their direction
+    TEST_ASSERT_TRUE(xyz_octahedral32_t::encode(xyz_t{3.0F, -4.0F, 5.0F}) == xyz_octahedral32_t::encode(xyz_t{0.3F, -0.4F, 0.5F}));
+}
+
+void test_xyz_octahedral_error()
+{
+    float max16 = 0.0F;
+    float max32 = 0.0F;
+    for (const xyz_t& v : test_vectors()) {
+        const xyz_t v16 = xyz_octahedral16_t::encode(v).decode();
+        const xyz_t v32 = xyz_octahedral32_t::encode(v).decode();
+        max16 = std::max(max16, angle_degrees(v, v16));
+        max32 = std::max(max32, angle_degrees(v, v32));
+        TEST_ASSERT_FLOAT_WITHIN(4.0E-7F, 1.0F, v16.magnitude_squared());
+        TEST_ASSERT_FLOAT_WITHIN(4.0E-7F, 1.0F, v32.magnitude_squared());
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(xyz_octahedral16_t::MAX_ANGULAR_ERROR_DEGREES, max16);
+    TEST_ASSERT_LESS_THAN_FLOAT(xyz_octahedral32_t::MAX_ANGULAR_ERROR_DEGREES, max32);
+    TEST_ASSERT_GREATER_THAN_FLOAT(xyz_octahedral16_t::MAX_ANGULAR_ERROR_DEGREES*0.5F, max16);
+    TEST_ASSERT_GREATER_THAN_FLOAT(xyz_octahedral32_t::MAX_ANGULAR_ERROR_DEGREES*0.5F, max32);
+}
+
+void test_xyz_half()
+{
+    static_assert(sizeof(xyz_half_t) == 6);
+    // exact values
+    TEST_ASSERT_EQUAL_UINT16(0x0000, xyz_half_t::float_to_half(0.0F));
+    TEST_ASSERT_EQUAL_UINT16(0x8000, xyz_half_t::float_to_half(-0.0F));
+    TEST_ASSERT_EQUAL_UINT16(0x3C00, xyz_half_t::float_to_half(1.0F));
+    TEST_ASSERT_EQUAL_UINT16(0xC000, xyz_half_t::float_to_half(-2.0F));
+    TEST_ASSERT_EQUAL_UINT16(0x7BFF, xyz_half_t::float_to_half(65504.0F));
+    TEST_ASSERT_EQUAL_UINT16(0x0400, xyz_half_t::float_to_half(6.103515625E-5F)); // smallest normal
+    TEST_ASSERT_EQUAL_UINT16(0x0001, xyz_half_t::float_to_half(5.9604645E-8F)); // smallest subnormal
+    // rounding to nearest even
+    TEST_ASSERT_EQUAL_UINT16(0x3C00, xyz_half_t::float_to_half(1.0F + 0x1p-11F)); // halfway, rounds down to even
+    TEST_ASSERT_EQUAL_UINT16(0x3C02, xyz_half_t::float_to_half(1.0F + 3*0x1p-11F)); // halfway, rounds up to even
+    TEST_ASSERT_EQUAL_UINT16(0x3C01, xyz_half_t::float_to_half(1.0F + 0x1p-11F + 0x1p-20F));
+    TEST_ASSERT_EQUAL_UINT16(0x0000, xyz_half_t::float_to_half(0x1p-25F)); // halfway, rounds down to even
+    TEST_ASSERT_EQUAL_UINT16(0x0002, xyz_half_t::float_to_half(3*0x1p-25F)); // halfway, rounds up to even
+    // overflow, infinity, and NaN
+    TEST_ASSERT_EQUAL_UINT16(0x7BFF, xyz_half_t::float_to_half(65519.0F));
+    TEST_ASSERT_EQUAL_UINT16(0x7C00, xyz_half_t::float_to_half(65520.0F));
+    TEST_ASSERT_EQUAL_UINT16(0xFC00, xyz_half_t::float_to_half(-1.0E10F));
+    TEST_ASSERT_EQUAL_UINT16(0x7C00, xyz_half_t::float_to_half(std::numeric_limits<float>::infinity()));
+    TEST_ASSERT_TRUE(std::isnan(xyz_half_t::half_to_float(xyz_half_t::float_to_half(std::numeric_limits<float>::quiet_NaN()))));
+
+    // every half precision value (other than NaN) converts to float and back exactly
+    for (uint32_t h = 0; h < 0x10000; ++h) {
+        if ((h & 0x7C00U) == 0x7C00U && (h & 0x3FFU) != 0) {
+            continue;
+        }
+        TEST_ASSERT_EQUAL_UINT16(h, xyz_half_t::float_to_half(xyz_half_t::half_to_float(static_cast<uint16_t>(h))));
+    }
+    TEST_ASSERT_EQUAL_FLOAT(-2.0F, xyz_half_t::half_to_float(0xC000));
+    TEST_ASSERT_EQUAL_FLOAT(5.9604645E-8F, xyz_half_t::half_to_float(0x0001));
+
+    const xyz_t v{3.14159F, -0.001F, 1000.0F};
+    const xyz_t d = xyz_half_t::encode(v).decode();
+    TEST_ASSERT_FLOAT_WITHIN(3.14159F*4.9E-4F, v.x, d.x);
+    TEST_ASSERT_FLOAT_WITHIN(0.001F*4.9E-4F, v.y, d.y);
+    TEST_ASSERT_FLOAT_WITHIN(1000.0F*4.9E-4F, v.z, d.z);
+}
+
+void test_xyz_packed_batch()
+{
+    std::vector<xyz_t> all = test_vectors();
+    all.push_back(xyz_t{0.0F, 0.0F, 0.0F});
+    all.push_back(xyz_t{1.0E-6F, 7.0E4F, -FLT_MIN});
+    // include sizes that are not a multiple of the SIMD width, to test the padded last block
+    for (size_t size : { size_t{0}, size_t{1}, size_t{3}, size_t{7}, size_t{17}, all.size() }) {
+        const std::span<const xyz_t> vs(all.data() + all.size() - size, size);
+        std::vector<xyz_octahedral16_t> p16(size);
+        std::vector<xyz_octahedral32_t> p32(size);
+        std::vector<xyz_half_t> ph(size);
+        xyz_octahedral16_t::encode_batch(vs, p16);
+        xyz_octahedral32_t::encode_batch(vs, p32);
+        xyz_half_t::encode_batch(vs, ph);
+        std::vector<xyz_t> d16(size);
+        std::vector<xyz_t> d32(size);
+        std::vector<xyz_t> dh(size);
+        xyz_octahedral16_t::decode_batch(p16, d16);
+        xyz_octahedral32_t::decode_batch(p32, d32);
+        xyz_half_t::decode_batch(ph, dh);
+        for (size_t ii = 0; ii < size; ++ii) {
+            // the encodings are identical to those of the single vector functions, the decoded octahedral vectors agree to within a few ulps
+            // (they are identical unless the compiler contracts multiply-adds into fused multiply-adds differently)
+            TEST_ASSERT_TRUE(p16[ii] == xyz_octahedral16_t::encode(vs[ii]));
+            TEST_ASSERT_TRUE(p32[ii] == xyz_octahedral32_t::encode(vs[ii]));
+            TEST_ASSERT_TRUE(ph[ii] == xyz_half_t::encode(vs[ii]));
+            assert_xyz_within(4.0F*FLT_EPSILON, p16[ii].decode(), d16[ii]);
+            assert_xyz_within(4.0F*FLT_EPSILON, p32[ii].decode(), d32[ii]);
+            TEST_ASSERT_TRUE(dh[ii] == ph[ii].decode());
+        }
+    }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_xyz_octahedral_exact);
+    RUN_TEST(test_xyz_octahedral_error);
+    RUN_TEST(test_xyz_half);
+    RUN_TEST(test_xyz_packed_batch);
+
+    UNITY_END();
+}
@@ -0,0 +1,142 @@
+#include "reciprocal_sqrt.h"
+#include "xyz_soa.h"
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+static std::vector<xyz_t> test_vectors(size_t count, float offset)
+{
+    // count deliberately not a multiple of the SIMD width, to exercise the padding
+    std::vector<xyz_t> v(count);
+    for (size_t ii = 0; ii < count; ++ii) {
+        const auto f = static_cast<float>(ii);
+        v[ii] = xyz_t{f - 5.0F + offset, 2.0F*f + 1.0F, 7.0F - 3.0F*f*offset};
+    }
+    return v;
+}
+
+void test_xyz_soa_conversion()
+{
+    const std::vector<xyz_t> a = test_vectors(11, 0.5F);
+    xyz_soa_t s(a);
+    TEST_ASSERT_EQUAL(11, s.size());
+    TEST_ASSERT_FALSE(s.empty());
+    for (size_t ii = 0; ii < a.size(); ++ii) {
+        TEST_ASSERT_TRUE(a[ii] == s[ii]);
+        TEST_ASSERT_EQUAL_FLOAT(a[ii].x, s.x()[ii]);
+        TEST_ASSERT_EQUAL_FLOAT(a[ii].y, s.y()[ii]);
+        TEST_ASSERT_EQUAL_FLOAT(a[ii].z, s.z()[ii]);
+    }
+    const std::vector<xyz_t> b = s.to_vector();
+    TEST_ASSERT_TRUE(a == b);
+
+    s.set(3, xyz_t{2.0F, 3.0F, 5.0F});
+    TEST_ASSERT_TRUE((xyz_t{2.0F, 3.0F, 5.0F} == s[3]));
+
+    s.resize(3);
+    TEST_ASSERT_EQUAL(3, s.size());
+    TEST_ASSERT_EQUAL(3, s.to_vector().size());
+    s.clear();
+    TEST_ASSERT_TRUE(s.empty());
+}
+
+void test_xyz_soa_arithmetic()
+{
+    const std::vector<xyz_t> a = test_vectors(13, 0.5F);
+    const std::vector<xyz_t> b = test_vectors(13, -1.25F);
+    const xyz_soa_t sa(a);
+    const xyz_soa_t sb(b);
+
+    xyz_soa_t s = sa;
+    s += sb;
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_TRUE(a[ii] + b[ii] == s[ii]); }
+    s = sa;
+    s -= sb;
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_TRUE(a[ii] - b[ii] == s[ii]); }
+    s = sa;
+    s *= 3.0F;
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_TRUE(a[ii]*3.0F == s[ii]); }
+    s = sa;
+    s /= 4.0F;
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_TRUE(a[ii]/4.0F == s[ii]); }
+    s = sa;
+    s.add_scaled(0.25F, sb);
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_TRUE(a[ii] + 0.25F*b[ii] == s[ii]); }
+}
+
+void test_xyz_soa_functions()
+{
+    const std::vector<xyz_t> a = test_vectors(13, 0.5F);
+    const std::vector<xyz_t> b = test_vectors(13, -1.25F);
+    const xyz_soa_t sa(a);
+    const xyz_soa_t sb(b);
+    std::vector<float> out(a.size());
+
+    sa.dot(sb, out);
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_EQUAL_FLOAT(a[ii].dot(b[ii]), out[ii]); }
+    sa.distance_squared(sb, out);
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_EQUAL_FLOAT(a[ii].distance_squared(b[ii]), out[ii]); }
+    sa.distance(sb, out);
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_EQUAL_FLOAT(a[ii].distance(b[ii]), out[ii]); }
+    sa.magnitude_squared(out);
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_EQUAL_FLOAT(a[ii].magnitude_squared(), out[ii]); }
+    sa.magnitude(out);
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_EQUAL_FLOAT(a[ii].magnitude(), out[ii]); }
+
+    xyz_soa_t c;
+    sa.cross(sb, c);
+    TEST_ASSERT_EQUAL(a.size(), c.size());
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_TRUE(a[ii].cross(b[ii]) == c[ii]); }
+
+    const xyz_soa_t n = sa.normalized();
+    for (size_t ii = 0; ii < a.size(); ++ii) {
+        // xyz_t::normalized uses reciprocal_sqrtf, which is approximate if a FAST_RECIPROCAL_SQUARE_ROOT macro is defined
+        const xyz_t e = a[ii].normalized();
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, e.x, n[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, e.y, n[ii].y);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, e.z, n[ii].z);
+    }
+
+    xyz_soa_t d = sa;
+    d.clamp_in_place(-4.0F, 6.0F);
+    for (size_t ii = 0; ii < a.size(); ++ii) { TEST_ASSERT_TRUE(xyz_t::clamp(a[ii], -4.0F, 6.0F) == d[ii]); }
+}
+
+void test_xyz_soa_resize()
+{
+    // normalizing the zero padding writes NaNs to it, growing must not expose them
+    xyz_soa_t s(std::vector<xyz_t>{ xyz_t{ 3.0F, 0.0F, 4.0F } });
+    s.normalize_in_place();
+    s.resize(2);
+    TEST_ASSERT_TRUE((xyz_t{ 0.6F, 0.0F, 0.8F }) == s[0]);
+    TEST_ASSERT_TRUE((xyz_t{ 0.0F, 0.0F, 0.0F }) == s[1]);
+
+    // shrinking then growing must not expose the old values
+    const std::vector<xyz_t> a = test_vectors(13, 0.5F);
+    s = xyz_soa_t(a);
+    s.resize(5);
+    s.resize(13);
+    for (size_t ii = 0; ii < 5; ++ii) { TEST_ASSERT_TRUE(a[ii] == s[ii]); }
+    for (size_t ii = 5; ii < 13; ++ii) { TEST_ASSERT_TRUE((xyz_t{ 0.0F, 0.0F, 0.0F }) == s[ii]); }
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_xyz_soa_conversion);
+    RUN_TEST(test_xyz_soa_arithmetic);
+    RUN_TEST(test_xyz_soa_functions);
+    RUN_TEST(test_xyz_soa_resize);
+
+    UNITY_END();
+}
@@ -1,4 +1,6 @@
 #include "xyz_type.h"
+#include "simd_float.h"
+#include <vector>
 #include <unity.h>
 
 void setUp() {
@@ -170,6 +172,65 @@ void test_xyz_t_functions()
     const xyz_t f_clamped = xyz_t{-20, 20, 20};
     TEST_ASSERT_TRUE(f == f_clamped);
 }
+
+void test_xyz_t_normalize_batch()
+{
+    // count not a multiple of the SIMD width, so the last partial block is also exercised
+    std::vector<xyz_t> v(13);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        const auto f = static_cast<float>(ii);
+        v[ii] = xyz_t{f - 3.5F, 2.0F + 0.25F*f, 7.0F - 1.5F*f};
+    }
+    std::vector<xyz_t> out(v.size());
+    xyz_t::normalize_batch(v, out);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        // normalized uses reciprocal_sqrtf, which is approximate if a FAST_RECIPROCAL_SQUARE_ROOT macro is defined
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, v[ii].normalized().x, out[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, v[ii].normalized().y, out[ii].y);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, v[ii].normalized().z, out[ii].z);
+    }
+
+    std::vector<xyz_t> w = v;
+    xyz_t::normalize_batch(w, w, rsqrt_precision_e::ONE_ITERATION);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, out[ii].x, w[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, out[ii].y, w[ii].y);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ONE_ITERATION_MAX_RELATIVE_ERROR, out[ii].z, w[ii].z);
+    }
+    xyz_t::normalize_batch(v, w, rsqrt_precision_e::ESTIMATE);
+    for (size_t ii = 0; ii < v.size(); ++ii) {
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ESTIMATE_MAX_RELATIVE_ERROR, out[ii].x, w[ii].x);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ESTIMATE_MAX_RELATIVE_ERROR, out[ii].y, w[ii].y);
+        TEST_ASSERT_FLOAT_WITHIN(2.0F*simd_float_t::RSQRT_ESTIMATE_MAX_RELATIVE_ERROR, out[ii].z, w[ii].z);
+    }
+}
+void test_xyz_t_constexpr()
+{
+    constexpr xyz_t a{2.0F, 3.0F, 5.0F};
+    constexpr xyz_t b{7.0F, 11.0F, 13.0F};
+    static_assert(a + b == xyz_t{9.0F, 14.0F, 18.0F});
+    static_assert(2.0F*a - b == xyz_t{-3.0F, -5.0F, -3.0F});
+    static_assert(a.dot(b) == 112.0F);
+    static_assert(a.cross(b) == xyz_t{-16.0F, 9.0F, 1.0F});
+    static_assert(a.magnitude_squared() == 38.0F);
+    static_assert(xyz_t::clamp(b, 8.0F, 12.0F) == xyz_t{8.0F, 11.0F, 12.0F});
+    constexpr xyz_t c = []() { xyz_t v{1.0F, 2.0F, 3.0F}; v += xyz_t{1.0F, 1.0F, 1.0F}; v *= 2.0F; return v; }();
+    TEST_ASSERT_TRUE(c == (xyz_t{2.0F, 3.0F, 4.0F}*2.0F));
+}
+void test_xyz_t_double()
+{
+    static_assert(xyzd_t{2.0, 3.0, 5.0}.cross(xyzd_t{7.0, 11.0, 13.0}) == xyzd_t{-16.0, 9.0, 1.0});
+    const xyzd_t v {0.1, -0.2, 0.3};
+    // 1/sqrt is calculated in double precision, regardless of the FAST_RECIPROCAL_SQUARE_ROOT macros
+    const xyzd_t n = v.normalized();
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-15, 1.0, n.magnitude());
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-15, 0.1/std::sqrt(0.14), n.x);
+    // the float version uses reciprocal_sqrtf
+    const xyz_t f = xyz_t{0.1F, -0.2F, 0.3F}.normalized();
+    TEST_ASSERT_FLOAT_WITHIN(2.0E-6F + RECIPROCAL_SQRTF_MAX_RELATIVE_ERROR, f.z, static_cast<float>(n.z));
+    TEST_ASSERT_TRUE(v.absolute() == (xyzd_t{0.1, 0.2, 0.3}));
+    TEST_ASSERT_DOUBLE_WITHIN(1.0E-15, std::sqrt(0.14), v.distance(xyzd_t{}));
+}
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
 
 int main(int argc, char **argv)
@@ -182,6 +243,9 @@ int main(int argc, char **argv)
     RUN_TEST(test_xyz_t_assignment);
     RUN_TEST(test_xyz_t_operators);
     RUN_TEST(test_xyz_t_functions);
+    RUN_TEST(test_xyz_t_constexpr);
+    RUN_TEST(test_xyz_t_normalize_batch);
+    RUN_TEST(test_xyz_t_double);
 
     UNITY_END();
 }
@@ -0,0 +1,140 @@
+#include "xyzw_type.h"
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <unity.h>
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+static void assert_xyz_equal(const xyz_t& expected, const xyzw_t& actual)
+{
+    TEST_ASSERT_EQUAL_FLOAT(expected.x, actual.get_x());
+    TEST_ASSERT_EQUAL_FLOAT(expected.y, actual.get_y());
+    TEST_ASSERT_EQUAL_FLOAT(expected.z, actual.get_z());
+    // the padding lane stays zero
+    TEST_ASSERT_EQUAL_FLOAT(0.0F, actual.get_xyzw().get<3>());
+}
+
+void test_xyzw_t_assignment()
+{
+    xyzw_t a(2.0F, 3.0F, 5.0F);
+    TEST_ASSERT_EQUAL_FLOAT(10.0F, a.sum());
+    TEST_ASSERT_EQUAL_FLOAT(10.F/3.0F, a.mean());
+    TEST_ASSERT_EQUAL_FLOAT(30.0F, a.prod());
+    TEST_ASSERT_EQUAL_FLOAT(2.0F, a[0]);
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, a[1]);
+    TEST_ASSERT_EQUAL_FLOAT(5.0F, a[2]);
+    TEST_ASSERT_TRUE(xyzw_t() == xyzw_t(0.0F, 0.0F, 0.0F));
+    a[0] = 7.0F;
+    a[1] += 4.0F;
+    a[2] *= 3.0F;
+    assert_xyz_equal(xyz_t{7.0F, 7.0F, 15.0F}, a);
+
+    const xyz_t b{7.0F, 11.0F, 13.0F};
+    a = xyzw_t(b);
+    TEST_ASSERT_TRUE(b == a.xyz());
+    TEST_ASSERT_TRUE(a == xyzw_t(7.0F, 11.0F, 13.0F));
+    TEST_ASSERT_TRUE(a != xyzw_t(7.0F, 11.0F, 17.0F));
+
+    a = 17.0F;
+    assert_xyz_equal(xyz_t{17.0F, 17.0F, 17.0F}, a);
+    a.set_ones();
+    assert_xyz_equal(xyz_t{1.0F, 1.0F, 1.0F}, a);
+    a.set_constant(-0.7F);
+    assert_xyz_equal(xyz_t{-0.7F, -0.7F, -0.7F}, a);
+    a.set_zero();
+    assert_xyz_equal(xyz_t{0.0F, 0.0F, 0.0F}, a);
+
+    const std::vector<xyz_t> v { {1.0F, 2.0F, 3.0F}, {-4.0F, 5.0F, -6.0F}, {7.0F, -8.0F, 9.0F} };
+    std::vector<xyzw_t> w(v.size());
+    xyzw_t::from_xyz(v, w);
+    std::vector<xyz_t> u(v.size());
+    xyzw_t::to_xyz(w, u);
+    TEST_ASSERT_TRUE(v == u);
+    TEST_ASSERT_EQUAL(0, reinterpret_cast<uintptr_t>(w.data()) % 16); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+void test_xyzw_t_operators()
+{
+    const xyz_t a{2.0F, -3.0F, 5.0F};
+    const xyz_t b{7.0F, 11.0F, -13.0F};
+    const xyzw_t A(a);
+    const xyzw_t B(b);
+
+    assert_xyz_equal(a, +A);
+    assert_xyz_equal(-a, -A);
+    assert_xyz_equal(a + b, A + B);
+    assert_xyz_equal(a - b, A - B);
+    assert_xyz_equal(a*3.0F, A*3.0F);
+    assert_xyz_equal(3.0F*a, 3.0F*A);
+    assert_xyz_equal(a/3.0F, A/3.0F);
+    assert_xyz_equal(a.cross(b), A.cross(B));
+    TEST_ASSERT_EQUAL_FLOAT(a.dot(b), A.dot(B));
+    TEST_ASSERT_EQUAL_FLOAT(a.distance_squared(b), A.distance_squared(B));
+    TEST_ASSERT_EQUAL_FLOAT(a.distance(b), A.distance(B));
+
+    xyz_t c = a;
+    xyzw_t C = A;
+    c += b; C += B;
+    assert_xyz_equal(c, C);
+    c -= a*2.0F; C -= A*2.0F;
+    assert_xyz_equal(c, C);
+    c *= 0.3F; C *= 0.3F;
+    assert_xyz_equal(c, C);
+    c /= 7.0F; C /= 7.0F;
+    assert_xyz_equal(c, C);
+}
+
+void test_xyzw_t_functions()
+{
+    const xyz_t a{2.0F, -3.0F, 5.0F};
+    const xyzw_t A(a);
+
+    TEST_ASSERT_EQUAL_FLOAT(a.magnitude_squared(), A.magnitude_squared());
+    TEST_ASSERT_EQUAL_FLOAT(a.magnitude(), A.magnitude());
+    TEST_ASSERT_EQUAL_FLOAT(a.squared_norm(), A.squared_norm());
+    TEST_ASSERT_EQUAL_FLOAT(a.norm(), A.norm());
+    assert_xyz_equal(a.normalized(), A.normalized());
+    xyzw_t B = A;
+    B.normalize();
+    TEST_ASSERT_TRUE(A.normalized() == B);
+
+    assert_xyz_equal(a.absolute(), A.absolute());
+    B = -A;
+    B.absolute_in_place();
+    TEST_ASSERT_TRUE(A.absolute() == B);
+
+    assert_xyz_equal(xyz_t::clamp(a, -2.5F, 3.0F), xyzw_t::clamp(A, -2.5F, 3.0F));
+    assert_xyz_equal(xyz_t::clamp(a, 1.0F, 3.0F), xyzw_t::clamp(A, 1.0F, 3.0F));
+    B = A;
+    B.clamp_in_place(-2.5F, 3.0F);
+    assert_xyz_equal(xyz_t{2.0F, -2.5F, 3.0F}, B);
+    // NaN components are passed through unchanged, as by xyz_t::clamp
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    B = xyzw_t(nan, -3.0F, 5.0F);
+    B.clamp_in_place(-2.5F, 3.0F);
+    TEST_ASSERT_TRUE(std::isnan(B.get_x()));
+    TEST_ASSERT_EQUAL_FLOAT(-2.5F, B.get_y());
+    TEST_ASSERT_EQUAL_FLOAT(3.0F, B.get_z());
+    TEST_ASSERT_TRUE(std::isnan(xyz_t::clamp(xyz_t{nan, 0.0F, 0.0F}, -2.5F, 3.0F).x));
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers,cppcoreguidelines-init-variables,readability-magic-numbers)
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_xyzw_t_assignment);
+    RUN_TEST(test_xyzw_t_operators);
+    RUN_TEST(test_xyzw_t_functions);
+
+    UNITY_END();
+}